@@ -28,6 +28,9 @@ extern "C" {
 //     - :logging    | logging interface
 //     - :filesystem | filesystem + file io interface
 //     - :threading  | operating system threading primitives
+//     - :jobs       | work-stealing job system
+//     - :hash       | fast non-cryptographic hashing
+//     - :hash_map   | open addressing hash map
 //
 // This header can be included in one of three ways:
 //
@@ -461,6 +464,48 @@ typedef void VoidProc(void);
 //
 function void OS_Init();
 
+// system information, this is queried once by OS_Init and cached for the lifetime of the
+// process so it is cheap to call from anywhere
+//
+typedef U32 OS_CpuFeatures;
+enum {
+    OS_CPU_FEATURE_SSE2   = (1 << 0),
+    OS_CPU_FEATURE_SSE42  = (1 << 1),
+    OS_CPU_FEATURE_AVX    = (1 << 2),
+    OS_CPU_FEATURE_AVX2   = (1 << 3),
+    OS_CPU_FEATURE_AVX512 = (1 << 4), // foundation + byte/word instructions
+    OS_CPU_FEATURE_NEON   = (1 << 5)
+};
+
+typedef struct OS_SystemInfo OS_SystemInfo;
+struct OS_SystemInfo {
+    U64 page_size;
+    U64 huge_page_size; // zero if huge pages are not supported
+    U64 allocation_granularity;
+
+    U32 num_logical_cores;
+    U32 num_physical_cores;
+
+    // cache sizes are in bytes, the l1 size is for the data cache only
+    //
+    U32 cache_line_size;
+    U64 l1_cache_size;
+    U64 l2_cache_size;
+    U64 l3_cache_size;
+
+    OS_CpuFeatures features;
+};
+
+// will be all zero if OS_Init has not been called
+//
+function OS_SystemInfo *OS_GetSystemInfo();
+
+// high resolution monotonic timer, ticks are only meaningful relative to each other and can be
+// read without calling OS_Init first
+//
+function U64 OS_GetTicks();
+function F64 OS_TicksToSeconds(U64 ticks);
+
 // os handle utilities
 //
 function OS_Handle OS_NilHandle();
@@ -493,6 +538,10 @@ function U64 RotateRight_U64(U64 x, U32 count);
 function U32 PopCount_U32(U32 x);
 function U64 PopCount_U64(U64 x);
 
+// full 64x64 -> 128-bit multiply, returns the low 64 bits and stores the high 64 bits in 'hi'
+//
+function U64 MulWide_U64(U64 a, U64 b, U64 *hi);
+
 // atomics
 //
 // all return the value stored in the 'ptr' before the operation
@@ -500,6 +549,17 @@ function U64 PopCount_U64(U64 x);
 function U32 AtomicAdd_U32(volatile U32 *ptr, U32 value);
 function U64 AtomicAdd_U64(volatile U64 *ptr, U64 value);
 
+// loads have acquire semantics and stores have release semantics, unlike the other
+// operations loads don't write to 'value' so can be used on read-only memory
+//
+function U32  AtomicLoad_U32(volatile U32 *value);
+function U64  AtomicLoad_U64(volatile U64 *value);
+function void AtomicStore_U32(volatile U32 *value, U32 store);
+function void AtomicStore_U64(volatile U64 *value, U64 store);
+
+function void *AtomicLoad_Ptr(void *volatile *value);
+function void  AtomicStore_Ptr(void *volatile *value, void *store);
+
 function U32   AtomicExchange_U32(volatile U32   *value, U32   exchange);
 function U64   AtomicExchange_U64(volatile U64   *value, U64   exchange);
 function void *AtomicExchange_Ptr(void *volatile *value, void *exchange);
@@ -511,6 +571,14 @@ function B32 AtomicCompareExchange_U32(volatile U32   *value, U32   exchange, U3
 function B32 AtomicCompareExchange_U64(volatile U64   *value, U64   exchange, U64   comparand);
 function B32 AtomicCompareExchange_Ptr(void *volatile *value, void *exchange, void *comparand);
 
+// full memory barrier, no loads or stores are reordered across it in either direction
+//
+function void AtomicFence();
+
+// hints to the processor that it is in a spin-wait loop
+//
+function void SpinPause();
+
 //
 // --------------------------------------------------------------------------------
 // :utilities
@@ -569,12 +637,37 @@ function U64 ReverseBits_U64(U64 x);
 
 // all return a pointer to the beginning of dst
 //
+// these use the widest vector instructions available, large copies and fills will use
+// non-temporal stores to avoid polluting the cache. 'dst' and 'src' must not overlap
+// for M_CopySize
+//
 function void *M_CopySize(void *dst, void *src, U64 size);
+
+// copies front to back as if one byte at a time, this is well defined when 'dst' overlaps
+// the end of 'src' and will repeat the pattern as required by lz77 style decoders
+//
+function void *M_CopySizeForward(void *dst, void *src, U64 size);
+
+// copies correctly regardless of how 'dst' and 'src' overlap, as with memmove
+//
+function void *M_MoveSize(void *dst, void *src, U64 size);
 function void *M_FillSize(void *dst, U8 value, U64 size);
 function void *M_ZeroSize(void *dst, U64 size);
 
 function B32 M_CompareSize(void *a, void *b, U64 size);
 
+// copies a small, constant number of bytes between addresses of any alignment. this is how words
+// should be moved in and out of untyped storage rather than through a pointer cast, which would be
+// undefined if the storage is misaligned or of a different type. the compiler turns it into plain
+// loads and stores
+//
+#if COMPILER_MSVC
+    #include <string.h>
+    #define M_CopyFixed(dst, src, size) memcpy((dst), (src), (size))
+#else
+    #define M_CopyFixed(dst, src, size) __builtin_memcpy((dst), (src), (size))
+#endif
+
 // return -1 for a < b, 0 for a == b, 1 for a > b
 //
 #define COMPARE_FUNC(name) S32 name(void *a, void *b)
@@ -588,6 +681,197 @@ function void _QuickSort(void *array, S64 count, CompareFunc *Compare, U64 eleme
 #define MergeSort(array, count, Compare) _MergeSort((void *) (array), (count), Compare, sizeof(*(array)))
 #define QuickSort(array, count, Compare) _QuickSort((void *) (array), (count), Compare, sizeof(*(array)))
 
+#define QUICK_SORT_INSERTION_THRESHOLD 24
+#define QUICK_SORT_NINTHER_THRESHOLD   128
+#define QUICK_SORT_PARTIAL_LIMIT       8
+
+// typed sorts
+//
+// the sorts above call the compare function through a pointer and move elements by size, which
+// prevents the compiler from inlining either. SORT_DEFINE stamps out a quick sort specialised
+// for a type with the comparison inlined, 'less' is an expression that is true when the element
+// pointed to by 'a' orders before the one pointed to by 'b'
+//
+//     SORT_DEFINE(SortByKey, Record, a->key < b->key)
+//     ...
+//     SortByKey(records, count);
+//
+// this defines an internal function 'name' along with some internal helpers prefixed with
+// 'name_', so it should be placed at file scope. the sort is not stable
+//
+// in c++ a templated Sort(array, count, less) is also available which takes a functor called as
+// less(a, b) on element references like std::sort, without the functor operator< is used. both
+// compile to the same kernel below
+//
+#define SORT_DEFINE(name, T, less) \
+    internal B32 name##_Less(T *a, T *b) { B32 result = (less); return result; } \
+    __SORT_KERNEL(internal, name, T, , , name##_Less)
+
+#define __SORT_SWAP(T, a, b) { T __t = *(a); *(a) = *(b); *(b) = __t; }
+
+// the same pattern-defeating quick sort as _QuickSort without the partial insertion sort, the
+// pivot is copied into a local and elements are shifted rather than swapped during insertion
+//
+#define __SORT_KERNEL(decl, name, T, PARAM, ARG, LESS) \
+    decl void name##_Insertion(T *begin, T *end PARAM) { \
+        for (T *it = begin + 1; it < end; ++it) { \
+            if (LESS(it, it - 1)) { \
+                T value = *it; \
+                T *j    = it; \
+                do { *j = *(j - 1); --j; } while (j > begin && LESS(&value, j - 1)); \
+                *j = value; \
+            } \
+        } \
+    } \
+    decl void name##_Sort3(T *a, T *b, T *c PARAM) { \
+        if (LESS(b, a)) __SORT_SWAP(T, a, b) \
+        if (LESS(c, b)) __SORT_SWAP(T, b, c) \
+        if (LESS(b, a)) __SORT_SWAP(T, a, b) \
+    } \
+    decl void name##_SiftDown(T *array, S64 root, S64 count PARAM) { \
+        for (S64 child = (2 * root) + 1; child < count; child = (2 * root) + 1) { \
+            if ((child + 1) < count && LESS(array + child, array + child + 1)) { child += 1; } \
+            if (!LESS(array + root, array + child)) { break; } \
+            __SORT_SWAP(T, array + root, array + child) \
+            root = child; \
+        } \
+    } \
+    decl void name##_Heap(T *begin, T *end PARAM) { \
+        S64 count = end - begin; \
+        for (S64 it = (count >> 1) - 1; it >= 0; --it) { name##_SiftDown(begin, it, count ARG); } \
+        for (S64 it = count - 1; it > 0; --it) { \
+            __SORT_SWAP(T, begin, begin + it) \
+            name##_SiftDown(begin, 0, it ARG); \
+        } \
+    } \
+    decl void name##_Range(T *begin, T *end, S32 bad_allowed, B32 leftmost PARAM) { \
+        for (;;) { \
+            S64 count = end - begin; \
+            if (count < QUICK_SORT_INSERTION_THRESHOLD) { \
+                name##_Insertion(begin, end ARG); \
+                break; \
+            } \
+            T *mid = begin + (count >> 1); \
+            if (count > QUICK_SORT_NINTHER_THRESHOLD) { \
+                name##_Sort3(begin,     mid,     end - 1 ARG); \
+                name##_Sort3(begin + 1, mid - 1, end - 2 ARG); \
+                name##_Sort3(begin + 2, mid + 1, end - 3 ARG); \
+                name##_Sort3(mid - 1,   mid,     mid + 1 ARG); \
+                __SORT_SWAP(T, begin, mid) \
+            } \
+            else { \
+                name##_Sort3(mid, begin, end - 1 ARG); \
+            } \
+            T  pivot = *begin; \
+            T *first = begin; \
+            T *last  = end; \
+            if (!leftmost && !LESS(begin - 1, &pivot)) { \
+                while (LESS(&pivot, --last)) {} \
+                if ((last + 1) == end) { while (first < last && !LESS(&pivot, ++first)) {} } \
+                else { while (!LESS(&pivot, ++first)) {} } \
+                while (first < last) { \
+                    __SORT_SWAP(T, first, last) \
+                    while (LESS(&pivot, --last)) {} \
+                    while (!LESS(&pivot, ++first)) {} \
+                } \
+                *begin = *last; \
+                *last  = pivot; \
+                begin  = last + 1; \
+                continue; \
+            } \
+            while (LESS(++first, &pivot)) {} \
+            if ((first - 1) == begin) { while (first < last && !LESS(--last, &pivot)) {} } \
+            else { while (!LESS(--last, &pivot)) {} } \
+            while (first < last) { \
+                __SORT_SWAP(T, first, last) \
+                while (LESS(++first, &pivot)) {} \
+                while (!LESS(--last, &pivot)) {} \
+            } \
+            T *split = first - 1; \
+            *begin = *split; \
+            *split = pivot; \
+            S64 lcount = split - begin; \
+            S64 rcount = end - (split + 1); \
+            if (lcount < (count >> 3) || rcount < (count >> 3)) { \
+                bad_allowed -= 1; \
+                if (bad_allowed <= 0) { \
+                    name##_Heap(begin, end ARG); \
+                    break; \
+                } \
+                if (lcount >= QUICK_SORT_INSERTION_THRESHOLD) { \
+                    __SORT_SWAP(T, begin,     begin + (lcount >> 2)) \
+                    __SORT_SWAP(T, split - 1, split - (lcount >> 2)) \
+                } \
+                if (rcount >= QUICK_SORT_INSERTION_THRESHOLD) { \
+                    __SORT_SWAP(T, split + 1, split + 1 + (rcount >> 2)) \
+                    __SORT_SWAP(T, end - 1,   end - (rcount >> 2)) \
+                } \
+            } \
+            if (lcount < rcount) { \
+                name##_Range(begin, split, bad_allowed, leftmost ARG); \
+                begin    = split + 1; \
+                leftmost = false; \
+            } \
+            else { \
+                name##_Range(split + 1, end, bad_allowed, false ARG); \
+                end = split; \
+            } \
+        } \
+    } \
+    decl void name(T *array, S64 count PARAM) { \
+        if (count > 1) { \
+            S32 bad_allowed = (S32) (63 - CountLeadingZeros_U64((U64) count)); \
+            name##_Range(array, array + count, bad_allowed, true ARG); \
+        } \
+    }
+
+#if LANG_CPP
+
+c_linkage_end
+
+#define __SORT_TEMPLATE      template <typename T, typename Less> internal
+#define __SORT_PARAM         , const Less &less
+#define __SORT_ARG           , less
+#define __SORT_LESS(a, b)    less(*(a), *(b))
+
+__SORT_KERNEL(__SORT_TEMPLATE, Sort, T, __SORT_PARAM, __SORT_ARG, __SORT_LESS)
+
+struct __SortDefaultLess {
+    template <typename T> bool operator()(const T &a, const T &b) const { return a < b; }
+};
+
+template <typename T> internal void Sort(T *array, S64 count) {
+    Sort(array, count, __SortDefaultLess());
+}
+
+c_linkage_begin
+
+#endif
+
+// the arena is defined in :arena, it's needed here for scratch memory
+//
+typedef union M_Arena M_Arena;
+
+// lsd radix sorts, these don't call a compare function so are much faster than the comparison
+// sorts for plain integer and float keys. all of them are stable and take a scratch buffer the
+// same size as the input from 'arena', which is popped before returning
+//
+// floats are ordered by their bits with negative zero before zero, nans are placed at either
+// end depending on their sign bit
+//
+function void RadixSort_U32(M_Arena *arena, U32 *keys, S64 count);
+function void RadixSort_U64(M_Arena *arena, U64 *keys, S64 count);
+function void RadixSort_S32(M_Arena *arena, S32 *keys, S64 count);
+function void RadixSort_S64(M_Arena *arena, S64 *keys, S64 count);
+function void RadixSort_F32(M_Arena *arena, F32 *keys, S64 count);
+
+// key and payload, 'values' are moved along with their keys, sorting an array of indices with
+// the keys is a fast way to sort records by a field
+//
+function void RadixSortPairs_U32(M_Arena *arena, U32 *keys, U32 *values, S64 count);
+function void RadixSortPairs_U64(M_Arena *arena, U64 *keys, U64 *values, S64 count);
+function void RadixSortPairs_F32(M_Arena *arena, F32 *keys, U32 *values, S64 count);
+
 //
 // --------------------------------------------------------------------------------
 // :arena
@@ -623,10 +907,56 @@ enum {
     //
     // provided per push call
     //
-    M_ARENA_NO_ZERO = (1 << 1)
+    M_ARENA_NO_ZERO = (1 << 1),
+
+    // aligns the reservation to the huge page size and advises the system to back it with
+    // transparent huge pages, commits are made in huge page sized steps
+    //
+    // provided when arena is allocated
+    //
+    M_ARENA_HUGE_PAGES = (1 << 2),
+
+    // reserves the arena from the explicit huge page pool (MAP_HUGETLB), if the pool can't satisfy
+    // the reservation this falls back to M_ARENA_HUGE_PAGES
+    //
+    // provided when arena is allocated
+    //
+    M_ARENA_HUGE_TLB = (1 << 3),
+
+    // pre-faults pages as they are committed so accessing them later will never page fault
+    //
+    // provided when arena is allocated
+    //
+    M_ARENA_PREFAULT = (1 << 4),
+
+    // allows multiple threads to push to the arena at the same time, space is reserved with an
+    // atomic add on the offset and only committing or growing the arena takes a lock
+    //
+    // pops, resets and M_GetArenaOffset must not be called while other threads are pushing and
+    // M_ArenaPopLast does nothing as there is no single last allocation
+    //
+    // provided when arena is allocated
+    //
+    M_ARENA_CONCURRENT = (1 << 5),
+
+    // the arena is backed by shared memory and preceded by a header page readable by other
+    // processes
+    //
+    // set by M_AllocSharedArena
+    //
+    M_ARENA_SHARED = (1 << 6)
 };
 
-typedef union M_Arena M_Arena;
+// arena instrumentation, when enabled every arena allocated with M_AllocArenaArgs is tracked in
+// a global registry and counts its pushes, pops, commits and bytes zeroed. when disabled the
+// counters compile away entirely
+//
+#if !defined(M_ARENA_INSTRUMENT)
+    #define M_ARENA_INSTRUMENT 0
+#endif
+
+typedef struct M_ArenaInfo M_ArenaInfo;
+
 union M_Arena {
     struct {
         M_Arena *current;
@@ -639,22 +969,65 @@ union M_Arena {
 
         U64 committed;
 
+        // everything from this offset up to 'committed' is known to be zero, either because it
+        // was freshly committed or decommitted, thus pushes beyond it don't need to be cleared
+        //
+        U64 zero_offset;
+
         M_ArenaFlags flags;
+
+        // serialises commits and growth for M_ARENA_CONCURRENT arenas
+        //
+        volatile U32 lock;
+
+        // commit policy, the amount committed when the arena runs out of committed memory
+        // doubles from 'commit_step' up to 'commit_max_step'
+        //
+        U64 commit_step;
+        U64 commit_max_step;
+
+        // decommit hysteresis, the highest offset reached since the last reset or outermost temp
+        // release and a slowly decaying history of it, memory is only decommitted when it
+        // exceeds twice that. see __M_ArenaDecommitExcess
+        //
+        U64 peak_offset;
+        U64 retain_size;
+
+        // side-chain of dedicated blocks for allocations too large for a growth block, each
+        // is linked through 'prev' and its 'base' is the arena offset directly after the
+        // allocation was made so pops can release them in order
+        //
+        M_Arena *large;
+
+        // registry entry when instrumentation is enabled, null otherwise
+        //
+        M_ArenaInfo *info;
+
+        // size of the region mapped copy-on-write from a snapshot file by M_ArenaLoad, this
+        // is never decommitted as it would revert to the file contents rather than zero
+        //
+        U64 mapped_size;
     };
 
-    // make sure arena is padded to 64 bytes, can increase to 128 bytes if needed
-    // this currently fits into a single cache line which is nice
+    // make sure arena is padded to 128 bytes, this spans two cache lines but the hot fields
+    // used by push/pop are all in the first one
     //
-    U8 pad[64];
+    U8 pad[128];
 };
 
-StaticAssert(sizeof(M_Arena) == 64, "M_Arena is not 64-bytes in size");
+StaticAssert(sizeof(M_Arena) == 128, "M_Arena is not 128-bytes in size");
 
 // allocation
 //
 function M_Arena *M_AllocArenaArgs(U64 limit, U64 initial_commit, M_ArenaFlags flags);
 function M_Arena *M_AllocArena(U64 limit);
 
+// set the commit policy for the arena, each time the arena needs to commit more memory it
+// will commit at least 'step' bytes and double 'step' for the next commit until it reaches
+// 'max_step'. passing the same value for both gives a fixed commit size
+//
+function void M_SetArenaCommitPolicy(M_Arena *arena, U64 step, U64 max_step);
+
 // reset will clear all allocations from the arena, but it will remain valid to use for
 // further allocations
 //
@@ -675,6 +1048,137 @@ function void *M_ArenaPushCopyFrom(M_Arena *arena, void *src, U64 size, M_ArenaF
 
 function U64 M_GetArenaOffset(M_Arena *arena);
 
+// statistics about the memory backing an arena, these are totals across all of the chained
+// blocks
+//
+typedef struct M_ArenaStats M_ArenaStats;
+struct M_ArenaStats {
+    U64 reserved;
+    U64 committed;
+    U64 offset;
+
+    U32 chain_length;
+    U32 large_blocks;
+
+    // the number of committed bytes the system has actually backed with huge pages, this
+    // will be zero if huge pages were requested but couldn't be obtained
+    //
+    U64 huge_page_bytes;
+
+    // the following are only available with M_ARENA_INSTRUMENT enabled, they will be zero
+    // otherwise
+    //
+    Str8 name;
+
+    U64 high_water; // highest offset reached
+    U64 pushes;
+    U64 pops;
+    U64 resets;
+    U64 commits;    // commit and decommit system calls
+    U64 decommits;
+    U64 bytes_zeroed;
+};
+
+function M_ArenaStats M_GetArenaStats(M_Arena *arena);
+
+// set a debug name for the arena, this is displayed by M_DumpArenaStats. does nothing if
+// M_ARENA_INSTRUMENT isn't enabled
+//
+function void M_SetArenaName(M_Arena *arena, Str8 name);
+
+// formats the statistics of all registered arenas into a table, one line per arena
+//
+function Str8 M_DumpArenaStats(M_Arena *arena);
+
+// persistent arenas
+//
+// an arena can be saved to a snapshot file and loaded again later, on linux loading maps the
+// file copy-on-write directly into the arena so it only costs page faults on the memory that
+// is actually used, other platforms read the file in
+//
+// only arenas that consist of a single block can be saved, so they should be allocated with
+// M_ARENA_DONT_GROW and a limit large enough for their contents. the loaded arena can be
+// used as normal for further allocations
+//
+// the loaded arena will likely be at a different address so pointers into the arena are not
+// valid, store offsets instead and convert them with the functions below. 'version' is user
+// defined, loading a snapshot saved with a different version, or one with a modified or
+// corrupted header, will fail and return null
+//
+// checksumming the data would touch every page of a mapped snapshot so it is only verified
+// when the file had to be read in anyway, define M_ARENA_LOAD_VERIFY to 1 to also verify
+// mapped snapshots
+//
+#if !defined(M_ARENA_LOAD_VERIFY)
+    #define M_ARENA_LOAD_VERIFY 0
+#endif
+
+function B32      M_ArenaSave(M_Arena *arena, Str8 path, U32 version);
+function M_Arena *M_ArenaLoad(Str8 path, U32 version);
+
+// convert between pointers and arena offsets, these are stable across save and load.
+// allocations on the large side-chain are not addressable by offset
+//
+function U64   M_ArenaOffsetFromPointer(M_Arena *arena, void *ptr);
+function void *M_ArenaPointerFromOffset(M_Arena *arena, U64 offset);
+
+// shared arenas
+//
+// an arena backed by shared memory which other processes can map to read its contents with
+// zero copies. if 'path' is empty an anonymous memfd is created and the returned 'handle' must
+// be passed to the other process, for example by inheriting it, otherwise the file at 'path'
+// is created, usually somewhere in /dev/shm, which other processes can open by name
+//
+// shared arenas never grow and are never decommitted. the producer calls
+// M_PublishSharedArena to make everything allocated so far visible, consumers then read the
+// published offset and can access anything below it. data should be referenced by offset, see
+// M_ArenaOffsetFromPointer, as each process maps the arena at a different address
+//
+// currently only supported on linux, other platforms will fail to allocate
+//
+typedef struct M_SharedView M_SharedView;
+struct M_SharedView {
+    U8 *base;
+    U64 limit;
+};
+
+function M_Arena *M_AllocSharedArena(U64 limit, Str8 path, OS_Handle *handle);
+function void     M_PublishSharedArena(M_Arena *arena);
+
+function M_SharedView M_OpenSharedView(OS_Handle handle);
+function M_SharedView M_OpenSharedViewFromPath(Str8 path);
+function void         M_CloseSharedView(M_SharedView view);
+
+// get the published offset and committed size of the shared arena, it is safe to read data
+// below the offset
+//
+function U64 M_SharedViewOffset(M_SharedView view);
+function U64 M_SharedViewCommitted(M_SharedView view);
+
+function void *M_SharedViewPointer(M_SharedView view, U64 offset);
+
+// blocks released by reset, pop and release calls are kept in a process wide cache rather
+// than being returned to the system immediately, new arenas and growth blocks will be taken
+// from this cache before reserving more memory
+//
+// the cache will hold at most 'budget' bytes of reserved blocks, setting the budget to zero
+// disables the cache
+//
+typedef struct M_BlockCacheStats M_BlockCacheStats;
+struct M_BlockCacheStats {
+    U64 hits;
+    U64 misses;
+
+    U64 budget;
+    U64 cached_bytes;
+    U32 cached_blocks;
+};
+
+function void M_SetBlockCacheBudget(U64 budget);
+function void M_FlushBlockCache();
+
+function M_BlockCacheStats M_GetBlockCacheStats();
+
 // pop calls to remove allocations from the end of arenas
 //
 function void M_ArenaPopTo(M_Arena *arena, U64 offset);
@@ -697,11 +1201,140 @@ struct M_Temp {
 // will not be re-acquired by this call
 //
 // releasing a temp arena will relinquish control of the memory allocated from
-// it, signalling to the system it is no longer needed
+// it, signalling to the system it is no longer needed. each time the outermost temp on an
+// arena is released the decommit hysteresis is updated, memory beyond twice the decaying
+// peak usage, and at least M_TEMP_ARENA_RETAIN_SIZE, is decommitted. a single large operation
+// therefore doesn't keep its peak usage for the lifetime of the thread, while alternating
+// large and small scopes don't decommit and recommit the large region each time
 //
 function M_Temp M_AcquireTemp(U32 count, M_Arena **conflicts);
 function void   M_ReleaseTemp(M_Temp temp);
 
+// set the number of temp arenas available to the calling thread, defaults to
+// M_TEMP_ARENA_COUNT and is limited to M_TEMP_ARENA_MAX_COUNT. arenas are only created
+// once a call actually needs them so a larger count is free until deep call chains with
+// many conflicts use it
+//
+function void M_SetTempArenaCount(U32 count);
+
+// decommit all temp arenas for the calling thread back to the retained size, this can be
+// called from idle points, such as between frames or jobs, to release memory used by
+// temps that are still active
+//
+function void M_TrimTempArenas();
+
+// fixed-size object pools
+//
+// elements are allocated in chunks from the backing arena and are recycled through an intrusive
+// free list, allocating and freeing are both O(1)
+//
+// with M_POOL_THREAD_SAFE the free list is lock-free and allocations can be made and freed from
+// any thread. refilling the free list pushes to the arena while holding only the pool's lock, so
+// the arena must either be dedicated to the pool or be an M_ARENA_CONCURRENT arena, this is
+// asserted on each refill
+//
+typedef U32 M_PoolFlags;
+enum {
+    M_POOL_THREAD_SAFE = (1 << 0)
+};
+
+typedef struct M_PoolNode M_PoolNode;
+struct M_PoolNode {
+    M_PoolNode *next;
+};
+
+typedef struct M_PoolChunk M_PoolChunk;
+struct M_PoolChunk {
+    M_PoolChunk *next;
+};
+
+typedef struct M_Pool M_Pool;
+struct M_Pool {
+    M_Arena *arena;
+
+    U64 element_size; // including padding for alignment
+    U64 alignment;
+    U32 chunk_count;  // elements per chunk
+
+    M_PoolFlags flags;
+
+    // the free list head, the upper 16 bits contain a tag which is incremented each time the head
+    // changes so the lock-free compare exchange doesn't succeed if the head is freed and
+    // re-allocated between reading it and swapping it out (aba problem)
+    //
+    // :note the tag wraps after 65536 changes, so a thread stalled between reading the head and
+    // its exchange while exactly a multiple of that many pushes and pops happen, ending with the
+    // same node at the head, can still corrupt the list. pointers only have 48 significant bits
+    // on the supported platforms so the tag can't be widened without a double-width exchange
+    //
+    void *volatile free_list;
+
+    volatile U32 lock;
+
+    // arena offset after the pool's last push, thread-safe pools on arenas which aren't
+    // M_ARENA_CONCURRENT use this to assert nothing else is pushing to the arena
+    //
+    U64 arena_offset;
+
+    M_PoolChunk *chunks;
+    M_PoolChunk *spare_chunks; // chunks recycled by reset waiting to be re-used
+};
+
+function M_Pool *M_AllocPool(M_Arena *arena, U64 element_size, U64 alignment, M_PoolFlags flags);
+
+// allocated elements are cleared to zero unless M_ARENA_NO_ZERO is passed
+//
+function void *M_PoolAlloc(M_Pool *pool, M_ArenaFlags flags);
+function void  M_PoolFree(M_Pool *pool, void *ptr);
+
+// returns all elements to the pool at once, the chunks remain allocated from the arena and are
+// re-used for subsequent allocations. this is not thread-safe even with M_POOL_THREAD_SAFE
+//
+function void M_ResetPool(M_Pool *pool);
+
+// growable arrays
+//
+// each array has its own arena which reserves 'limit' bytes of address space up front and
+// commits memory as it grows, so elements are never moved by growth and their addresses remain
+// stable until they are inserted before or removed
+//
+typedef struct M_Array M_Array;
+struct M_Array {
+    M_Arena *arena;
+
+    U8 *data;
+    U64 count;
+
+    U64 element_size;
+};
+
+function M_Array *M_AllocArray(U64 limit, U64 element_size, U64 alignment);
+function void     M_ReleaseArray(M_Array *array);
+
+// pushed and inserted elements are cleared to zero unless M_ARENA_NO_ZERO is passed, these
+// return null if the array has reached its limit
+//
+function void *M_ArrayPushFrom(M_Array *array, U64 count, M_ArenaFlags flags);
+function void *M_ArrayInsertFrom(M_Array *array, U64 index, U64 count, M_ArenaFlags flags);
+
+// removing keeps the order of the remaining elements, remove swap instead moves the last
+// element into the removed slot
+//
+function void M_ArrayRemoveFrom(M_Array *array, U64 index, U64 count);
+function void M_ArrayRemoveSwap(M_Array *array, U64 index);
+function void M_ArrayClear(M_Array *array);
+
+// helper macros for typed arrays, the type must match the element size the array was
+// allocated with
+//
+#define M_AllocArrayT(limit, T) M_AllocArray((limit), sizeof(T), AlignOf(T))
+
+#define M_ArrayPush(...)   M_ArrayPushExpand((__VA_ARGS__, M_ArrayPushTNF, M_ArrayPushTN, M_ArrayPushT))(__VA_ARGS__)
+#define M_ArrayInsert(...) M_ArrayInsertExpand((__VA_ARGS__, M_ArrayInsertTINF, M_ArrayInsertTIN, M_ArrayInsertTI))(__VA_ARGS__)
+#define M_ArrayRemove(...) M_ArrayRemoveExpand((__VA_ARGS__, M_ArrayRemoveIN, M_ArrayRemoveI))(__VA_ARGS__)
+
+#define M_ArrayItems(array, T) ((T *) (array)->data)
+
 // supporting macros for push/pop default argument selection
 //
 // :note these are just implementation details and can be mostly ignored
@@ -727,6 +1360,25 @@ function void   M_ReleaseTemp(M_Temp temp);
 #define M_ArenaPopT(arena, T)     M_ArenaPopSize((arena),       sizeof(T))
 #define M_ArenaPopTN(arena, T, n) M_ArenaPopSize((arena), (n) * sizeof(T))
 
+#define M_ArrayPushExpand(args) M_ArrayPushSelect args
+#define M_ArrayInsertExpand(args) M_ArrayInsertSelect args
+#define M_ArrayRemoveExpand(args) M_ArrayRemoveSelect args
+
+#define M_ArrayPushSelect(a, b, c, d, e, ...) e
+#define M_ArrayInsertSelect(a, b, c, d, e, f, ...) f
+#define M_ArrayRemoveSelect(a, b, c, d, ...) d
+
+#define M_ArrayPushT(array, T)         (T *) M_ArrayPushFrom((array), 1, 0)
+#define M_ArrayPushTN(array, T, n)     (T *) M_ArrayPushFrom((array), (n), 0)
+#define M_ArrayPushTNF(array, T, n, f) (T *) M_ArrayPushFrom((array), (n), f)
+
+#define M_ArrayInsertTI(array, T, i)         (T *) M_ArrayInsertFrom((array), (i), 1, 0)
+#define M_ArrayInsertTIN(array, T, i, n)     (T *) M_ArrayInsertFrom((array), (i), (n), 0)
+#define M_ArrayInsertTINF(array, T, i, n, f) (T *) M_ArrayInsertFrom((array), (i), (n), f)
+
+#define M_ArrayRemoveI(array, i)     M_ArrayRemoveFrom((array), (i), 1)
+#define M_ArrayRemoveIN(array, i, n) M_ArrayRemoveFrom((array), (i), (n))
+
 //
 // --------------------------------------------------------------------------------
 // :strings
@@ -817,6 +1469,45 @@ function B32 Chr_IsPathSeparator(U8 c); // checks for fwd/bkwd on windows, only
 function U8 Chr_ToUppercase(U8 c);
 function U8 Chr_ToLowercase(U8 c);
 
+// string interning
+//
+// each distinct string is copied into the interner once and every equal input returns the same
+// canonical string and id, so interned strings can be compared by their data pointer or id. ids
+// are dense and start at 1, 0 is never a valid id
+//
+// looking up a string that has already been interned doesn't lock and is safe to call from any
+// thread while other threads are interning, only inserting a new string takes the lock
+//
+#if !defined(STR8_INTERN_MAX_COUNT)
+    #define STR8_INTERN_MAX_COUNT (1 << 22)
+#endif
+
+typedef struct Str8_InternTable Str8_InternTable;
+
+typedef struct Str8_Interner Str8_Interner;
+struct Str8_Interner {
+    M_Arena *arena;   // string data and tables
+    M_Array *strings; // canonical strings indexed by id - 1
+
+    Str8_InternTable *volatile table;
+
+    volatile U32 count;
+    volatile U32 lock;
+};
+
+function Str8_Interner *Str8_AllocInterner(U64 limit);
+function void           Str8_ReleaseInterner(Str8_Interner *interner);
+
+// these return an empty string or an id of 0 once STR8_INTERN_MAX_COUNT strings are interned
+//
+function Str8 Str8_Intern(Str8_Interner *interner, Str8 str);
+function U32  Str8_InternId(Str8_Interner *interner, Str8 str);
+
+// never inserts, returns 0 if 'str' hasn't been interned
+//
+function U32  Str8_FindInternId(Str8_Interner *interner, Str8 str);
+function Str8 Str8_FromInternId(Str8_Interner *interner, U32 id);
+
 //
 // --------------------------------------------------------------------------------
 // :logging
@@ -1152,48 +1843,381 @@ function void T_WaitFutex(T_Futex *futex, U32 value);
 function void T_WakeFutex(T_Futex *futex);      // single
 function void T_BroadcastFutex(T_Futex *futex); // all
 
-#if defined(__cplusplus)
-}
+// Queues
+//
+// bounded lock-free queues for passing fixed-size elements between threads, elements are copied
+// in and out. capacity is rounded up to a power of two and both are allocated from the given
+// arena so are released with it
+//
+// the Try variants never block and return false when the queue is full or empty, the blocking
+// variants spin for T_QUEUE_SPIN_COUNT attempts before parking on a futex until the other side
+// makes progress. Try and blocking calls can be mixed freely on the same queue
+//
+#if !defined(T_QUEUE_SPIN_COUNT)
+    #define T_QUEUE_SPIN_COUNT 128
 #endif
 
-#endif  // CORE_H_
+// single-producer single-consumer ring, each side keeps a cached copy of the other side's index
+// so it only has to touch the shared cache line when the cached copy says the ring is full or
+// empty
+//
+typedef struct T_SPSCQueue T_SPSCQueue;
+struct T_SPSCQueue {
+    // producer
+    //
+    volatile U32 write;
+    U32 read_cache;
+    U8  pad0[56];
 
-#endif  // !CORE_IMPL
+    // consumer
+    //
+    volatile U32 read;
+    U32 write_cache;
+    U8  pad1[56];
 
-#if defined(CORE_MODULE) || defined(CORE_IMPL)
+    // parked threads and the futexes they wait on, the signals are only changed when the waiter
+    // count is non-zero
+    //
+    volatile U32 push_waiters;
+    volatile U32 pop_waiters;
 
-#if !defined(CORE_C_)
-#define CORE_C_
+    T_Futex pushed;
+    T_Futex popped;
+    U8 pad2[48];
 
-#if !defined(OS_ARENA_LIMIT)
-    #define OS_ARENA_LIMIT GB(1)
-#endif
+    U32 mask;
+    U64 element_size;
+    U8 *data;
+};
 
-internal void Log_Init(); // this has to be forwared declared so the OS_Init call can use it
+function T_SPSCQueue *T_AllocSPSCQueue(M_Arena *arena, U64 element_size, U32 capacity);
+
+function B32 T_SPSCTryPush(T_SPSCQueue *queue, void *element);
+function B32 T_SPSCTryPop(T_SPSCQueue *queue, void *element);
+
+function void T_SPSCPush(T_SPSCQueue *queue, void *element); // blocks while full
+function void T_SPSCPop(T_SPSCQueue *queue, void *element);  // blocks while empty
+
+// multi-producer multi-consumer queue using per-cell sequence numbers, "Bounded MPMC queue",
+// Dmitry Vyukov. producers and consumers each claim cells with a single compare exchange and
+// only contend with their own side
+//
+typedef struct T_MPMCQueue T_MPMCQueue;
+struct T_MPMCQueue {
+    volatile U32 enqueue;
+    U8 pad0[60];
+
+    volatile U32 dequeue;
+    U8 pad1[60];
+
+    volatile U32 push_waiters;
+    volatile U32 pop_waiters;
+
+    T_Futex pushed;
+    T_Futex popped;
+    U8 pad2[48];
+
+    U32 mask;
+    U64 element_size;
+    U64 stride; // cell size, the sequence number followed by the element
+    U8 *cells;
+};
+
+function T_MPMCQueue *T_AllocMPMCQueue(M_Arena *arena, U64 element_size, U32 capacity);
+
+function B32 T_MPMCTryPush(T_MPMCQueue *queue, void *element);
+function B32 T_MPMCTryPop(T_MPMCQueue *queue, void *element);
+
+function void T_MPMCPush(T_MPMCQueue *queue, void *element); // blocks while full
+function void T_MPMCPop(T_MPMCQueue *queue, void *element);  // blocks while empty
 
 //
 // --------------------------------------------------------------------------------
-// :impl_os_init
+// :jobs
 // --------------------------------------------------------------------------------
 //
-#if OS_WINDOWS
-
+// work-stealing job system built on the threading primitives. each worker owns a Chase-Lev deque
+// which it pushes to and pops from at the bottom, while idle workers steal from the top of other
+// workers' deques. threads which aren't workers submit through a shared queue instead
 //
-// :windows_core
+// the thread which initialises the system becomes worker zero and only runs jobs while it is
+// waiting on a counter, the remaining workers are threads which sleep on a futex when there is
+// nothing to do. jobs can log and use M_AcquireTemp freely as each worker has its own logging
+// context and temp arenas
 //
+#if !defined(J_MAX_WORKERS)
+    #define J_MAX_WORKERS 64
+#endif
 
-typedef U32 Win32_ObjectType;
-enum {
-    WIN32_OBJECT_RELEASED = 0,
-    WIN32_OBJECT_THREAD,
-    WIN32_OBJECT_CRITICAL_SECTION,
-    WIN32_OBJECT_SRWLOCK,
-    WIN32_OBJECT_CONDITION_VAR
-};
+#if !defined(J_DEQUE_CAPACITY)
+    #define J_DEQUE_CAPACITY 4096 // jobs per worker, must be a power of two
+#endif
 
-typedef struct Win32_Object Win32_Object;
-struct Win32_Object {
-    Win32_Object *next;
+#if !defined(J_QUEUE_CAPACITY)
+    #define J_QUEUE_CAPACITY 1024 // shared queue for non-worker threads, must be a power of two
+#endif
+
+#if !defined(J_SPIN_COUNT)
+    #define J_SPIN_COUNT 256 // attempts to find a job before sleeping
+#endif
+
+#define J_WORKER_NONE U32_MAX
+
+#define J_PROC(name) void name(void *param)
+typedef J_PROC(J_Proc);
+
+// the number of incomplete jobs submitted against it, counters must be zero initialised and
+// can be shared between any number of submissions
+//
+typedef T_Futex J_Counter;
+
+typedef struct J_Job J_Job;
+struct J_Job {
+    J_Proc *Proc;
+    void   *param;
+
+    J_Counter *counter; // set on submit
+};
+
+// 'worker_count' includes the calling thread, zero will use one worker per logical core. only the
+// first call has any effect, submitting a job will initialise the system with the default count
+// if this hasn't already been called
+//
+// the calling thread becomes worker zero for the lifetime of the process so this should be called
+// from a long-lived thread, usually the main thread, before any other thread submits jobs. a
+// short-lived thread which happens to submit first would otherwise take the place of worker zero
+// and the system would be left with one less worker once it exits
+//
+function void J_Init(U32 worker_count);
+
+function U32 J_GetWorkerCount();
+function U32 J_GetWorkerIndex(); // J_WORKER_NONE if the calling thread isn't a worker
+
+// 'counter' can be null if the job doesn't need to be waited on. jobs which don't fit in the
+// deque or shared queue are run immediately on the calling thread, as are all jobs when there is
+// only a single worker
+//
+function void J_Submit(J_Proc *Proc, void *param, J_Counter *counter);
+function void J_SubmitJobs(J_Job *jobs, U32 count, J_Counter *counter);
+
+// runs other jobs while waiting for 'counter' to reach zero, sleeps if none are available
+//
+function void J_Wait(J_Counter *counter);
+
+// parallel for
+//
+// calls 'Proc' over [0, count) split into ranges of 'grain' elements, which are run as jobs,
+// the calling thread runs the first range itself and then helps until all have completed. a
+// 'grain' of zero will split the range into a few jobs per worker
+//
+#define J_FOR_PROC(name) void name(void *param, U64 start, U64 end)
+typedef J_FOR_PROC(J_ForProc);
+
+function void ParallelFor(U64 count, U64 grain, J_ForProc *Proc, void *param);
+
+// parallel sorting
+//
+// the array is split into partitions which are sorted concurrently as jobs and then merged in
+// parallel, each merge pass splits every merge evenly across all of the partitions so the jobs
+// stay the same size until the end
+//
+// with PARALLEL_SORT_STABLE partitions are merge sorted and the result is stable, otherwise they
+// are quick sorted. arrays with fewer than PARALLEL_SORT_THRESHOLD elements are sorted on the
+// calling thread instead
+//
+typedef U32 ParallelSortFlags;
+enum {
+    PARALLEL_SORT_STABLE = (1 << 0)
+};
+
+// 'workers' is the number of partitions and is rounded down to a power of two, zero will use one
+// partition per job system worker
+//
+function void _ParallelSort(void *array, S64 count, CompareFunc *Compare, U64 element_size, U32 workers, ParallelSortFlags flags);
+
+#define ParallelSort(array, count, Compare, flags) _ParallelSort((void *) (array), (count), Compare, sizeof(*(array)), 0, (flags))
+
+
+//
+// --------------------------------------------------------------------------------
+// :hash
+// --------------------------------------------------------------------------------
+//
+// 64-bit non-cryptographic hashing in the style of wyhash, hashes are stable across platforms
+// and runs but must not be used where hostile input could be chosen to cause collisions
+//
+#define HASH_DEFAULT_SEED 0
+
+function U64 Hash_Memory(void *data, U64 size);
+function U64 Hash_MemorySeed(void *data, U64 size, U64 seed);
+
+function U64 Hash_Str8(Str8 str);
+function U64 Hash_Str8Seed(Str8 str, U64 seed);
+
+// hashes 'str' as if it had been converted to uppercase, so two strings that compare equal with
+// STR8_EQUAL_FLAG_IGNORE_CASE also hash equal
+//
+function U64 Hash_Str8IgnoreCase(Str8 str);
+
+// mixes the bits of a single integer, this is bijective so distinct keys never collide
+//
+function U64 Hash_U64(U64 x);
+
+// streaming, data can be fed in chunks of any size and the result is identical to hashing all
+// of the data in a single call with the same seed
+//
+//     Hash_State state;
+//     Hash_Begin(&state, HASH_DEFAULT_SEED);
+//     Hash_Update(&state, chunk0, size0);
+//     Hash_Update(&state, chunk1, size1);
+//     U64 hash = Hash_Finish(&state);
+//
+typedef struct Hash_State Hash_State;
+struct Hash_State {
+    U64 seed;
+    U64 see1;
+    U64 see2;
+
+    U64 total;  // number of bytes fed so far
+    U32 count;  // number of bytes waiting in the buffer
+
+    // the tail of a hash reads up to 16 bytes before the final bytes so the end of the last block
+    // is kept in front of the pending data
+    //
+    U8 buffer[16 + 48];
+};
+
+function void Hash_Begin(Hash_State *state, U64 seed);
+function void Hash_Update(Hash_State *state, void *data, U64 size);
+function void Hash_UpdateStr8(Hash_State *state, Str8 str);
+function U64  Hash_Finish(Hash_State *state);
+
+//
+// --------------------------------------------------------------------------------
+// :hash_map
+// --------------------------------------------------------------------------------
+//
+// open addressing hash map in the style of swiss tables, each slot has a control byte holding
+// 7 bits of its hash which are matched 16 at a time with simd so most lookups only compare a
+// single key
+//
+// keys are either integers or strings, values are a fixed size given when the map is allocated
+// and are stored inline with the key, they are aligned to 8 bytes. all memory comes from the
+// supplied arena, growing leaves the old table behind in the arena so use HM_Reserve when the
+// number of entries is known up front
+//
+typedef U32 HM_KeyType;
+enum {
+    HM_KEY_U64 = 0,
+    HM_KEY_STR8
+};
+
+typedef U32 HM_MapFlags;
+enum {
+    // copy string keys into the arena when they are inserted, otherwise the map references the
+    // key data which must remain valid for the lifetime of the entry
+    //
+    HM_MAP_COPY_KEYS = (1 << 0)
+};
+
+typedef struct HM_Map HM_Map;
+struct HM_Map {
+    M_Arena *arena;
+
+    U8 *ctrl;
+    U8 *slots;
+
+    U64 capacity;    // number of slots, always zero or a power of two multiple of the group size
+    U64 count;       // number of entries
+    U64 tombstones;  // number of deleted slots not yet reclaimed
+    U64 growth_left; // entries that can be inserted before the table must be rebuilt
+
+    U32 value_size;
+    U32 slot_size;
+
+    HM_KeyType  key_type;
+    HM_MapFlags flags;
+};
+
+function HM_Map *HM_AllocMap(M_Arena *arena, HM_KeyType key_type, U64 value_size, HM_MapFlags flags);
+
+// make sure 'count' entries can be held without growing
+//
+function void HM_Reserve(HM_Map *map, U64 count);
+function void HM_Clear(HM_Map *map);
+
+// insert returns a pointer to the value for 'key', new values are cleared to zero. find returns
+// null if the key isn't present. remove returns true if the key was found
+//
+function void *HM_InsertU64(HM_Map *map, U64 key);
+function void *HM_FindU64(HM_Map *map, U64 key);
+function B32   HM_RemoveU64(HM_Map *map, U64 key);
+
+function void *HM_InsertStr8(HM_Map *map, Str8 key);
+function void *HM_FindStr8(HM_Map *map, Str8 key);
+function B32   HM_RemoveStr8(HM_Map *map, Str8 key);
+
+// iteration order is unspecified, the map must not be modified while iterating
+//
+//     HM_Iter it = { 0 };
+//     while (HM_Next(map, &it)) { ... it.key_u64 or it.key_str8, it.value ... }
+//
+typedef struct HM_Iter HM_Iter;
+struct HM_Iter {
+    U64 index;
+
+    U64   key_u64;
+    Str8  key_str8;
+    void *value;
+};
+
+function B32 HM_Next(HM_Map *map, HM_Iter *iter);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif  // CORE_H_
+
+#endif  // !CORE_IMPL
+
+#if defined(CORE_MODULE) || defined(CORE_IMPL)
+
+#if !defined(CORE_C_)
+#define CORE_C_
+
+#if !defined(OS_ARENA_LIMIT)
+    #define OS_ARENA_LIMIT GB(1)
+#endif
+
+internal void Log_Init(); // this has to be forwared declared so the OS_Init call can use it
+internal OS_CpuFeatures __OS_GetCpuFeatures(); // implemented with the intrinsics
+
+global_var OS_SystemInfo __os_system_info;
+
+//
+// --------------------------------------------------------------------------------
+// :impl_os_init
+// --------------------------------------------------------------------------------
+//
+#if OS_WINDOWS
+
+//
+// :windows_core
+//
+
+typedef U32 Win32_ObjectType;
+enum {
+    WIN32_OBJECT_RELEASED = 0,
+    WIN32_OBJECT_THREAD,
+    WIN32_OBJECT_CRITICAL_SECTION,
+    WIN32_OBJECT_SRWLOCK,
+    WIN32_OBJECT_CONDITION_VAR
+};
+
+typedef struct Win32_Object Win32_Object;
+struct Win32_Object {
+    Win32_Object *next;
 
     // @todo: we probably want generation numbers
     //
@@ -1279,6 +2303,22 @@ internal void Win32_ReleaseObject(Win32_Object *object) {
     ReleaseSRWLockExclusive(&__windows->object_lock);
 }
 
+U64 OS_GetTicks() {
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+
+    U64 result = cast(U64) counter.QuadPart;
+    return result;
+}
+
+F64 OS_TicksToSeconds(U64 ticks) {
+    LARGE_INTEGER frequency;
+    QueryPerformanceFrequency(&frequency);
+
+    F64 result = cast(F64) ticks / cast(F64) frequency.QuadPart;
+    return result;
+}
+
 //
 // :windows_init
 //
@@ -1296,13 +2336,71 @@ internal void Win32_ReleaseObject(Win32_Object *object) {
     #define __FOLDERID_RoamingAppData &FOLDERID_RoamingAppData
 #endif
 
-void OS_Init() {
-    M_Arena *arena = M_AllocArena(OS_ARENA_LIMIT);
+internal void Win32_InitSystemInfo(OS_SystemInfo *info) {
+    SYSTEM_INFO sys;
+    GetSystemInfo(&sys);
+
+    info->page_size              = sys.dwPageSize;
+    info->huge_page_size         = GetLargePageMinimum();
+    info->allocation_granularity = sys.dwAllocationGranularity;
+
+    info->num_logical_cores  = sys.dwNumberOfProcessors;
+    info->num_physical_cores = 0;
+
+    // query the processor topology for the physical core count and cache sizes
+    //
+    M_Temp temp = M_AcquireTemp(0, 0);
+
+    DWORD length = 0;
+    GetLogicalProcessorInformation(0, &length);
+
+    SYSTEM_LOGICAL_PROCESSOR_INFORMATION *procs = cast(SYSTEM_LOGICAL_PROCESSOR_INFORMATION *) M_ArenaPush(temp.arena, U8, length);
+    if (GetLogicalProcessorInformation(procs, &length)) {
+        DWORD count = length / sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION);
+        for (DWORD it = 0; it < count; ++it) {
+            SYSTEM_LOGICAL_PROCESSOR_INFORMATION *proc = &procs[it];
 
+            if (proc->Relationship == RelationProcessorCore) {
+                info->num_physical_cores += 1;
+            }
+            else if (proc->Relationship == RelationCache) {
+                CACHE_DESCRIPTOR *cache = &proc->Cache;
+                if (cache->Type == CacheData || cache->Type == CacheUnified) {
+                    switch (cache->Level) {
+                        case 1: { info->l1_cache_size = cache->Size; info->cache_line_size = cache->LineSize; } break;
+                        case 2: { info->l2_cache_size = cache->Size; } break;
+                        case 3: { info->l3_cache_size = cache->Size; } break;
+                        default: {} break;
+                    }
+                }
+            }
+        }
+    }
+    else {
+        Log_Error("Failed to get logical processor information (0x%x)", GetLastError());
+    }
+
+    M_ReleaseTemp(temp);
+
+    if (info->num_physical_cores == 0) { info->num_physical_cores = info->num_logical_cores; }
+    if (info->cache_line_size    == 0) { info->cache_line_size    = 64; }
+
+    info->features = __OS_GetCpuFeatures();
+}
+
+void OS_Init() {
     // Initialise logging system
     //
     Log_Init();
 
+    // Query the system information before allocating anything else so the rest of the
+    // library can use the cached values
+    //
+    Win32_InitSystemInfo(&__os_system_info);
+
+    M_Arena *arena = M_AllocArena(OS_ARENA_LIMIT);
+    M_SetArenaName(arena, S("os"));
+
     // Setup context
     //
     __windows        = M_ArenaPush(arena, Win32_Context);
@@ -1434,218 +2532,857 @@ void OS_Init() {
 #elif OS_MACOS
     #error "macOS initalisation is not implemented"
 #elif OS_LINUX
-    #error "Linux initalisation is not implemented"
-#elif OS_SWITCH
-    #error "Switchbrew initalisation is not implemented"
-#endif
 
 //
-// --------------------------------------------------------------------------------
-// :impl_intrinsics
-// --------------------------------------------------------------------------------
+// :linux_core
 //
 
-#if COMPILER_MSVC
+#include <pthread.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include <linux/limits.h>
+#include <limits.h>
 
+typedef U32 Linux_ObjectType;
+enum {
+    LINUX_OBJECT_RELEASED = 0,
+    LINUX_OBJECT_THREAD,
+    LINUX_OBJECT_MUTEX,
+    LINUX_OBJECT_SEMAPHORE,
+    LINUX_OBJECT_RWLOCK,
+    LINUX_OBJECT_CONDITION_VAR
+};
+
+// rw lock state bits, the low bits hold the number of active readers
 //
-// :msvc_intrinsics
-//
+#define LINUX_RWLOCK_WRITER  0x80000000
+#define LINUX_RWLOCK_WAITING 0x40000000
+#define LINUX_RWLOCK_READERS 0x3FFFFFFF
 
-#include <intrin.h>
+typedef struct Linux_Object Linux_Object;
+struct Linux_Object {
+    Linux_Object *next;
 
-U32 CountLeadingZeros_U32(U32 x) {
-    unsigned long index;
+    Linux_ObjectType type;
+    union {
+        // 0 = unlocked, 1 = locked, 2 = locked with (possible) waiters
+        //
+        T_Futex mutex;
 
-    U32 result = _BitScanReverse(&index, x) ? (31 - index) : 32;
-    return result;
-}
+        // see LINUX_RWLOCK_* bits above
+        //
+        T_Futex rwlock;
 
-U64 CountLeadingZeros_U64(U64 x) {
-    unsigned long index;
+        // sequence number, bumped on every wake
+        //
+        T_Futex condition_var;
 
-    U64 result = _BitScanReverse64(&index, x) ? (63 - index) : 64;
-    return result;
-}
+        struct {
+            T_Futex count;
+            U32     max;
 
-U32 CountTrailingZeros_U32(U32 x) {
-    unsigned long index;
+            volatile U32 waiters;
+        } semaphore;
 
-    U32 result = _BitScanForward(&index, x) ? index : 32;
-    return result;
+        struct {
+            pthread_t handle;
+
+            T_ThreadProc *Proc;
+            void *param;
+
+            T_Futex resume;
+            volatile U32 ref;
+
+            B32 joined;
+        } thread;
+    };
+};
+
+typedef struct Linux_Context Linux_Context;
+struct Linux_Context {
+    M_Arena *arena;
+
+    // Object freelists
+    //
+    T_Futex object_lock;
+    Linux_Object *free_objects;
+
+    // Cached paths, these don't change at runtime as of the current implementation
+    // allowing us to turn the "FS_GetPath" call into a simple string copy. the working
+    // directory can be changed with chdir so it is always queried by FS_GetPath instead
+    //
+    Str8 cached_paths[FS_PATH_COUNT];
+};
+
+global_var Linux_Context *__linux_context;
+
+// :note we call the futex syscall directly rather than going through pthreads so the
+// uncontended paths of the locks below are a single atomic operation, the kernel is
+// only entered when a thread actually has to sleep or there is a sleeping thread to wake
+//
+internal void Linux_FutexWait(T_Futex *futex, U32 value) {
+    syscall(SYS_futex, futex, FUTEX_WAIT | FUTEX_PRIVATE_FLAG, value, 0, 0, 0);
 }
 
-U64 CountTrailingZeros_U64(U64 x) {
-    unsigned long index;
+internal void Linux_FutexWake(T_Futex *futex, U32 count) {
+    syscall(SYS_futex, futex, FUTEX_WAKE | FUTEX_PRIVATE_FLAG, count, 0, 0, 0);
+}
 
-    U64 result = _BitScanForward64(&index, x) ? index : 64;
-    return result;
+internal void Linux_LockMutex(T_Futex *mutex) {
+    if (!AtomicCompareExchange_U32(mutex, 1, 0)) {
+        // contended, mark the lock as having waiters and sleep until the holder
+        // releases it
+        //
+        U32 state = AtomicExchange_U32(mutex, 2);
+        while (state != 0) {
+            Linux_FutexWait(mutex, 2);
+            state = AtomicExchange_U32(mutex, 2);
+        }
+    }
 }
 
-#if ARCH_AMD64
+internal void Linux_UnlockMutex(T_Futex *mutex) {
+    U32 state = AtomicExchange_U32(mutex, 0);
+    if (state == 2) { Linux_FutexWake(mutex, 1); }
+}
 
-U32 PopCount_U32(U32 x) {
-    U32 result = __popcnt(x);
+internal Linux_Object *Linux_AllocObject(Linux_ObjectType type) {
+    Linux_Object *result;
+
+    Linux_LockMutex(&__linux_context->object_lock);
+
+    result = __linux_context->free_objects;
+    if (result) {
+        SLL_Pop(__linux_context->free_objects);
+        M_ZeroSize(result, sizeof(Linux_Object));
+    }
+    else {
+        result = M_ArenaPush(__linux_context->arena, Linux_Object);
+    }
+
+    Linux_UnlockMutex(&__linux_context->object_lock);
+
+    Assert(result != 0);
+
+    result->type = type;
     return result;
 }
 
-U64 PopCount_U64(U64 x) {
-    U64 result = __popcnt64(x);
-    return result;
+internal void Linux_ReleaseObject(Linux_Object *object) {
+    object->type = LINUX_OBJECT_RELEASED;
+
+    Linux_LockMutex(&__linux_context->object_lock);
+    SLL_Push(__linux_context->free_objects, object);
+    Linux_UnlockMutex(&__linux_context->object_lock);
 }
 
-#elif ARCH_AARCH64
+#include <time.h>
 
-U32 PopCount_U32(U32 x) {
-    U32 result = _CountOneBits(x);
+// ticks are in nanoseconds
+//
+U64 OS_GetTicks() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    U64 result = (cast(U64) ts.tv_sec * 1000000000ULL) + cast(U64) ts.tv_nsec;
     return result;
 }
 
-U64 PopCount_U64(U64 x) {
-    U64 result = _CountOneBits64(x);
+F64 OS_TicksToSeconds(U64 ticks) {
+    F64 result = cast(F64) ticks / 1000000000.0;
     return result;
 }
 
-#endif
+//
+// :linux_init
+//
 
-// atomics
+#define LINUX_SYS_FILE_SIZE 256
+
+// sysfs and procfs files report a bogus size so we can't use FS_ReadEntireFile, the values
+// we read are tiny so just read up to a fixed size
 //
-U32 AtomicAdd_U32(volatile U32 *ptr, U32 value) {
-    U32 result = _InterlockedExchangeAdd((volatile long *) ptr, value);
-    return result;
-}
+internal Str8 Linux_ReadSysFile(M_Arena *arena, Str8 path) {
+    Str8 result = ZERO(Str8);
 
-U64 AtomicAdd_U64(volatile U64 *value, U64 addend) {
-    U64 result = _InterlockedExchangeAdd64((volatile __int64 *) value, addend);
-    return result;
-}
+    int fd = open((const char *) path.data, O_RDONLY);
+    if (fd >= 0) {
+        U8 *buffer    = M_ArenaPush(arena, U8, LINUX_SYS_FILE_SIZE, M_ARENA_NO_ZERO);
+        ssize_t nread = read(fd, buffer, LINUX_SYS_FILE_SIZE);
 
-U32 AtomicExchange_U32(volatile U32 *value, U32 exchange) {
-    U32 result = _InterlockedExchange((volatile long *) value, exchange);
-    return result;
-}
+        if (nread > 0) {
+            result.count = nread;
+            result.data  = buffer;
+        }
 
-U64 AtomicExchange_U64(volatile U64 *value, U64 exchange) {
-    U64 result = _InterlockedExchange64((volatile __int64 *) value, exchange);
-    return result;
-}
+        close(fd);
+    }
 
-void *AtomicExchange_Ptr(void *volatile *value, void *exchange) {
-    void *result = _InterlockedExchangePointer(value, exchange);
     return result;
 }
 
-B32 AtomicCompareExchange_U32(volatile U32 *value, U32 exchange, U32 comparand) {
-    B32 result = _InterlockedCompareExchange((volatile long *) value, exchange, comparand) == (long) comparand;
+// parses a leading decimal value with an optional K/M/G size suffix
+//
+internal U64 Linux_U64FromSysStr8(Str8 str) {
+    U64 result = 0;
+
+    S64 it = 0;
+    for (; it < str.count && Chr_IsNumber(str.data[it]); ++it) {
+        result = (result * 10) + (str.data[it] - '0');
+    }
+
+    if (it < str.count) {
+        switch (str.data[it]) {
+            case 'K': { result = KB(result); } break;
+            case 'M': { result = MB(result); } break;
+            case 'G': { result = GB(result); } break;
+            default: {} break;
+        }
+    }
+
     return result;
 }
 
-B32 AtomicCompareExchange_U64(volatile U64 *value, U64 exchange, U64 comparand) {
-    B32 result = _InterlockedCompareExchange64((volatile __int64 *) value, exchange, comparand) == (__int64) comparand;
-    return result;
+internal void Linux_InitSystemInfo(OS_SystemInfo *info) {
+    M_Temp temp = M_AcquireTemp(0, 0);
+
+    info->page_size              = sysconf(_SC_PAGESIZE);
+    info->allocation_granularity = info->page_size;
+
+    info->huge_page_size = Linux_U64FromSysStr8(Linux_ReadSysFile(temp.arena, S("/sys/kernel/mm/transparent_hugepage/hpage_pmd_size")));
+
+    // Processor topology, physical cores are the unique (package, core) pairs across all of
+    // the logical processors
+    //
+    S64 num_configured = sysconf(_SC_NPROCESSORS_CONF);
+    S64 num_online     = sysconf(_SC_NPROCESSORS_ONLN);
+
+    info->num_logical_cores  = cast(U32) Max(num_online, 1);
+    info->num_physical_cores = 0;
+
+    if (num_configured > 0) {
+        U64 *cores = M_ArenaPush(temp.arena, U64, num_configured);
+
+        for (S64 cpu = 0; cpu < num_configured; ++cpu) {
+            Str8 core_id = Linux_ReadSysFile(temp.arena, Sf(temp.arena, "/sys/devices/system/cpu/cpu%lld/topology/core_id", cpu));
+            Str8 package = Linux_ReadSysFile(temp.arena, Sf(temp.arena, "/sys/devices/system/cpu/cpu%lld/topology/physical_package_id", cpu));
+
+            if (core_id.count && package.count) {
+                U64 key = Compose_U64(Linux_U64FromSysStr8(package), Linux_U64FromSysStr8(core_id));
+
+                B32 found = false;
+                for (U32 it = 0; it < info->num_physical_cores; ++it) {
+                    if (cores[it] == key) {
+                        found = true;
+                        break;
+                    }
+                }
+
+                if (!found) { cores[info->num_physical_cores++] = key; }
+            }
+        }
+    }
+
+    // Cache hierarchy, we only care about the data and unified caches
+    //
+    for (U32 index = 0;; ++index) {
+        Str8 dir   = Sf(temp.arena, "/sys/devices/system/cpu/cpu0/cache/index%d", index);
+        Str8 level = Linux_ReadSysFile(temp.arena, Sf(temp.arena, "%.*s/level", Sv(dir)));
+
+        if (!level.count) { break; }
+
+        Str8 type = Linux_ReadSysFile(temp.arena, Sf(temp.arena, "%.*s/type", Sv(dir)));
+        if (Str8_Equal(type, S("Instruction"), STR8_EQUAL_FLAG_INEXACT_RHS)) { continue; }
+
+        U64 size = Linux_U64FromSysStr8(Linux_ReadSysFile(temp.arena, Sf(temp.arena, "%.*s/size", Sv(dir))));
+        U64 line = Linux_U64FromSysStr8(Linux_ReadSysFile(temp.arena, Sf(temp.arena, "%.*s/coherency_line_size", Sv(dir))));
+
+        switch (Linux_U64FromSysStr8(level)) {
+            case 1: { info->l1_cache_size = size; info->cache_line_size = cast(U32) line; } break;
+            case 2: { info->l2_cache_size = size; } break;
+            case 3: { info->l3_cache_size = size; } break;
+            default: {} break;
+        }
+    }
+
+    M_ReleaseTemp(temp);
+
+    // fallback to sysconf if sysfs wasn't available, these may also report zero on some
+    // platforms
+    //
+    if (info->l1_cache_size   == 0) { info->l1_cache_size   = Max(sysconf(_SC_LEVEL1_DCACHE_SIZE), 0); }
+    if (info->l2_cache_size   == 0) { info->l2_cache_size   = Max(sysconf(_SC_LEVEL2_CACHE_SIZE),  0); }
+    if (info->l3_cache_size   == 0) { info->l3_cache_size   = Max(sysconf(_SC_LEVEL3_CACHE_SIZE),  0); }
+    if (info->cache_line_size == 0) { info->cache_line_size = cast(U32) Max(sysconf(_SC_LEVEL1_DCACHE_LINESIZE), 0); }
+
+    if (info->num_physical_cores == 0) { info->num_physical_cores = info->num_logical_cores; }
+    if (info->cache_line_size    == 0) { info->cache_line_size    = 64; }
+
+    info->features = __OS_GetCpuFeatures();
 }
 
-B32 AtomicCompareExchange_Ptr(void *volatile *value, void *exchange, void *comparand) {
-    B32 result = _InterlockedCompareExchangePointer(value, exchange, comparand) == comparand;
-    return result;
+void OS_Init() {
+    // Initialise logging system
+    //
+    Log_Init();
+
+    // Query the system information before allocating anything else so the rest of the
+    // library can use the cached values
+    //
+    Linux_InitSystemInfo(&__os_system_info);
+
+    M_Arena *arena = M_AllocArena(OS_ARENA_LIMIT);
+    M_SetArenaName(arena, S("os"));
+
+    // Setup context
+    //
+    __linux_context = M_ArenaPush(arena, Linux_Context);
+    __linux_context->arena = arena;
+
+    // Cache the required runtime paths
+    //
+    M_Temp temp = M_AcquireTemp(0, 0);
+
+    // Executable path
+    //
+    {
+        char *buffer;
+        S64 size = 512;
+
+        ssize_t count;
+        for (;;) {
+            // we have to keep iterating towards the required buffer size
+            // because readlink wont actually tell us
+            //
+            size *= 2;
+            buffer = M_ArenaPush(temp.arena, char, size);
+
+            count = readlink("/proc/self/exe", buffer, size);
+            if (count < size) { break; }
+
+            M_ArenaPopLast(temp.arena);
+        }
+
+        if (count > 0) {
+            while (buffer[count] != '/') { count -= 1; }
+
+            buffer[count] = 0;
+
+            __linux_context->cached_paths[FS_PATH_EXE] = Str8_Copy(arena, Str8_Wrap(count, cast(U8 *) buffer));
+        }
+        else {
+            Log_Error("readlink failed on /proc/self/exe (%d)", errno);
+        }
+    }
+
+    // User path
+    //
+    {
+        // @todo: this can be changed to use our own loaded environment variables
+        // which we can get by reading /proc/self/environ on an init call
+        //
+        if (__environ) {
+            Str8 home_dir = ZERO(Str8);
+            Str8 xdg_dir  = ZERO(Str8);
+
+            for (U32 it = 0; __environ[it] != 0; it += 1) {
+                Str8 env = Sz(__environ[it]);
+                if (Str8_Equal(env, S("XDG_DATA_HOME"), STR8_EQUAL_FLAG_INEXACT_RHS)) {
+                    xdg_dir = Str8_RemoveBeforeFirst(env, '=');
+
+                    // we only really need this, $HOME is a fallback if
+                    // this is unset
+                    //
+                    break;
+                }
+                else if (Str8_Equal(env, S("HOME"), STR8_EQUAL_FLAG_INEXACT_RHS)) {
+                    home_dir = Str8_RemoveBeforeFirst(env, '=');
+                }
+            }
+
+            if (xdg_dir.count || home_dir.count) {
+                if (!xdg_dir.count) {
+                    // this is the defined default as per specifiction
+                    //
+                    __linux_context->cached_paths[FS_PATH_USER] = Sf(arena, "%.*s/.local/share", Sv(home_dir));
+                }
+                else {
+                    __linux_context->cached_paths[FS_PATH_USER] = Str8_Copy(arena, xdg_dir);
+                }
+            }
+            else {
+                Log_Error("Failed to get user home directory");
+            }
+        }
+        else {
+            Log_Error("__environ variable was null");
+        }
+    }
+
+    // Temp path
+    //
+    {
+        Str8 temp_dir = Sl("/tmp");
+
+        if (__environ) {
+            // look for $TEMP or $TMP set by user and use that if it is
+            // set, otherwise we fallback to the globally available /tmp
+            //
+            for (U32 it = 0; __environ[it] != 0; it += 1) {
+                Str8 env = Sz(__environ[it]);
+                if (Str8_Equal(env, S("TEMP"), STR8_EQUAL_FLAG_INEXACT_RHS)) {
+                    temp_dir = Str8_RemoveBeforeFirst(env, '=');
+                    break;
+                }
+                else if (Str8_Equal(env, S("TMP"), STR8_EQUAL_FLAG_INEXACT_RHS)) {
+                    temp_dir = Str8_RemoveBeforeFirst(env, '=');
+                    break;
+                }
+            }
+
+        }
+
+        __linux_context->cached_paths[FS_PATH_TEMP] = Str8_Copy(arena, temp_dir);
+    }
+
+    M_ReleaseTemp(temp);
 }
 
-#elif (COMPILER_CLANG || COMPILER_GCC)
+#elif OS_SWITCH
+    #error "Switchbrew initalisation is not implemented"
+#endif
 
 //
-// :clang_intrinsics
-// :gcc_intrinsics
+// --------------------------------------------------------------------------------
+// :impl_intrinsics
+// --------------------------------------------------------------------------------
 //
 
+#if COMPILER_MSVC
+
+//
+// :msvc_intrinsics
+//
+
+#include <intrin.h>
+
 U32 CountLeadingZeros_U32(U32 x) {
-    U32 result = x ? __builtin_clz(x) : 32;
+    unsigned long index;
+
+    U32 result = _BitScanReverse(&index, x) ? (31 - index) : 32;
     return result;
 }
 
 U64 CountLeadingZeros_U64(U64 x) {
-    U64 result = x ? __builtin_clzll(x) : 64;
+    unsigned long index;
+
+    U64 result = _BitScanReverse64(&index, x) ? (63 - index) : 64;
     return result;
 }
 
 U32 CountTrailingZeros_U32(U32 x) {
-    U32 result = x ? __builtin_ctz(x) : 32;
+    unsigned long index;
+
+    U32 result = _BitScanForward(&index, x) ? index : 32;
     return result;
 }
 
 U64 CountTrailingZeros_U64(U64 x) {
-    U64 result = x ? __builtin_ctzll(x) : 64;
+    unsigned long index;
+
+    U64 result = _BitScanForward64(&index, x) ? index : 64;
     return result;
 }
 
+#if ARCH_AMD64
+
 U32 PopCount_U32(U32 x) {
-    U32 result = __builtin_popcount(x);
+    U32 result = __popcnt(x);
     return result;
 }
 
 U64 PopCount_U64(U64 x) {
-    U64 result = __builtin_popcountll(x);
+    U64 result = __popcnt64(x);
     return result;
 }
 
-// atomics
-//
-// @todo: handle memory ordering semantics more correctly
-//
-U32 AtomicAdd_U32(volatile U32 *ptr, U32 value) {
-    U32 result = __atomic_fetch_add(ptr, value, __ATOMIC_SEQ_CST);
+U64 MulWide_U64(U64 a, U64 b, U64 *hi) {
+    U64 result = _umul128(a, b, hi);
     return result;
 }
 
-U64 AtomicAdd_U64(volatile U64 *ptr, U64 value) {
-    U64 result = __atomic_fetch_add(ptr, value, __ATOMIC_SEQ_CST);
+#elif ARCH_AARCH64
+
+U32 PopCount_U32(U32 x) {
+    U32 result = _CountOneBits(x);
     return result;
 }
 
-U32 AtomicExchange_U32(volatile U32 *value, U32 exchange) {
-    U32 result;
-
-    __atomic_exchange(value, &exchange, &result, __ATOMIC_SEQ_CST);
+U64 PopCount_U64(U64 x) {
+    U64 result = _CountOneBits64(x);
     return result;
 }
 
-U64 AtomicExchange_U64(volatile U64 *value, U64 exchange) {
-    U64 result;
+U64 MulWide_U64(U64 a, U64 b, U64 *hi) {
+    U64 result = a * b;
+    *hi = __umulh(a, b);
 
-    __atomic_exchange(value, &exchange, &result, __ATOMIC_SEQ_CST);
     return result;
 }
 
-void *AtomicExchange_Ptr(void *volatile *value, void *exchange) {
-    void *result;
+#endif
 
-    __atomic_exchange(value, &exchange, &result, __ATOMIC_SEQ_CST);
+// atomics
+//
+U32 AtomicAdd_U32(volatile U32 *ptr, U32 value) {
+    U32 result = _InterlockedExchangeAdd((volatile long *) ptr, value);
     return result;
 }
 
-B32 AtomicCompareExchange_U32(volatile U32 *value, U32 exchange, U32 comparand) {
-    B32 result = __atomic_compare_exchange(value, &comparand, &exchange, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+U64 AtomicAdd_U64(volatile U64 *value, U64 addend) {
+    U64 result = _InterlockedExchangeAdd64((volatile __int64 *) value, addend);
     return result;
 }
 
-B32 AtomicCompareExchange_U64(volatile U64 *value, U64 exchange, U64 comparand) {
-    B32 result = __atomic_compare_exchange(value, &comparand, &exchange, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+// x64 loads and stores already have acquire/release semantics so only the compiler has to be
+// prevented from reordering them
+//
+U32 AtomicLoad_U32(volatile U32 *value) {
+#if ARCH_AMD64
+    U32 result = *value;
+    _ReadWriteBarrier();
+#elif ARCH_AARCH64
+    U32 result = __ldar32((volatile unsigned __int32 *) value);
+#endif
     return result;
 }
 
-B32 AtomicCompareExchange_Ptr(void *volatile *value, void *exchange, void *comparand) {
-    B32 result = __atomic_compare_exchange(value, &comparand, &exchange, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+U64 AtomicLoad_U64(volatile U64 *value) {
+#if ARCH_AMD64
+    U64 result = *value;
+    _ReadWriteBarrier();
+#elif ARCH_AARCH64
+    U64 result = __ldar64((volatile unsigned __int64 *) value);
+#endif
     return result;
 }
 
+void AtomicStore_U32(volatile U32 *value, U32 store) {
+#if ARCH_AMD64
+    _ReadWriteBarrier();
+    *value = store;
+#elif ARCH_AARCH64
+    __stlr32((volatile unsigned __int32 *) value, store);
 #endif
+}
 
-// agnostic across all compilers, msvc has specific intrinsics for this but under
-// optimisations correctly detects these as the right instructions
-//
-U32 RotateLeft_U32(U32 x, U32 count) {
-    count &= 31;
-
-    U32 result = (x << count) | (x >> (32 - count));
-    return result;
+void AtomicStore_U64(volatile U64 *value, U64 store) {
+#if ARCH_AMD64
+    _ReadWriteBarrier();
+    *value = store;
+#elif ARCH_AARCH64
+    __stlr64((volatile unsigned __int64 *) value, store);
+#endif
+}
+
+U32 AtomicExchange_U32(volatile U32 *value, U32 exchange) {
+    U32 result = _InterlockedExchange((volatile long *) value, exchange);
+    return result;
+}
+
+U64 AtomicExchange_U64(volatile U64 *value, U64 exchange) {
+    U64 result = _InterlockedExchange64((volatile __int64 *) value, exchange);
+    return result;
+}
+
+void *AtomicExchange_Ptr(void *volatile *value, void *exchange) {
+    void *result = _InterlockedExchangePointer(value, exchange);
+    return result;
+}
+
+B32 AtomicCompareExchange_U32(volatile U32 *value, U32 exchange, U32 comparand) {
+    B32 result = _InterlockedCompareExchange((volatile long *) value, exchange, comparand) == (long) comparand;
+    return result;
+}
+
+B32 AtomicCompareExchange_U64(volatile U64 *value, U64 exchange, U64 comparand) {
+    B32 result = _InterlockedCompareExchange64((volatile __int64 *) value, exchange, comparand) == (__int64) comparand;
+    return result;
+}
+
+B32 AtomicCompareExchange_Ptr(void *volatile *value, void *exchange, void *comparand) {
+    B32 result = _InterlockedCompareExchangePointer(value, exchange, comparand) == comparand;
+    return result;
+}
+
+void AtomicFence() {
+#if ARCH_AMD64
+    _mm_mfence();
+#elif ARCH_AARCH64
+    __dmb(_ARM64_BARRIER_ISH);
+#endif
+}
+
+void SpinPause() {
+#if ARCH_AMD64
+    _mm_pause();
+#elif ARCH_AARCH64
+    __yield();
+#endif
+}
+
+// cpu features
+//
+#if ARCH_AMD64
+
+internal OS_CpuFeatures __OS_GetCpuFeatures() {
+    OS_CpuFeatures result = 0;
+
+    int regs[4]; // eax, ebx, ecx, edx
+
+    __cpuid(regs, 0);
+    int max_leaf = regs[0];
+
+    __cpuid(regs, 1);
+
+    U32 ecx1 = cast(U32) regs[2];
+    U32 edx1 = cast(U32) regs[3];
+
+    result |= (edx1 & (1 << 26)) ? OS_CPU_FEATURE_SSE2  : 0;
+    result |= (ecx1 & (1 << 20)) ? OS_CPU_FEATURE_SSE42 : 0;
+
+    // the os has to have enabled saving of the extended register state for the wider
+    // registers to be usable, check xcr0 for this
+    //
+    if ((ecx1 & (1 << 27)) && (ecx1 & (1 << 28))) {
+        U64 xcr0 = _xgetbv(0);
+
+        if ((xcr0 & 0x6) == 0x6) {
+            result |= OS_CPU_FEATURE_AVX;
+
+            if (max_leaf >= 7) {
+                __cpuidex(regs, 7, 0);
+
+                U32 ebx7 = cast(U32) regs[1];
+
+                result |= (ebx7 & (1 << 5)) ? OS_CPU_FEATURE_AVX2 : 0;
+
+                if ((xcr0 & 0xE6) == 0xE6 && (ebx7 & (1 << 16)) && (ebx7 & (1 << 30))) {
+                    result |= OS_CPU_FEATURE_AVX512;
+                }
+            }
+        }
+    }
+
+    return result;
+}
+
+#elif ARCH_AARCH64
+
+internal OS_CpuFeatures __OS_GetCpuFeatures() {
+    // advanced simd is mandatory on aarch64
+    //
+    OS_CpuFeatures result = OS_CPU_FEATURE_NEON;
+    return result;
+}
+
+#endif
+
+#elif (COMPILER_CLANG || COMPILER_GCC)
+
+//
+// :clang_intrinsics
+// :gcc_intrinsics
+//
+
+U32 CountLeadingZeros_U32(U32 x) {
+    U32 result = x ? __builtin_clz(x) : 32;
+    return result;
+}
+
+U64 CountLeadingZeros_U64(U64 x) {
+    U64 result = x ? __builtin_clzll(x) : 64;
+    return result;
+}
+
+U32 CountTrailingZeros_U32(U32 x) {
+    U32 result = x ? __builtin_ctz(x) : 32;
+    return result;
+}
+
+U64 CountTrailingZeros_U64(U64 x) {
+    U64 result = x ? __builtin_ctzll(x) : 64;
+    return result;
+}
+
+U32 PopCount_U32(U32 x) {
+    U32 result = __builtin_popcount(x);
+    return result;
+}
+
+U64 PopCount_U64(U64 x) {
+    U64 result = __builtin_popcountll(x);
+    return result;
+}
+
+U64 MulWide_U64(U64 a, U64 b, U64 *hi) {
+    unsigned __int128 product = cast(unsigned __int128) a * b;
+
+    U64 result = cast(U64) product;
+    *hi = cast(U64) (product >> 64);
+
+    return result;
+}
+
+// atomics
+//
+// @todo: handle memory ordering semantics more correctly
+//
+U32 AtomicAdd_U32(volatile U32 *ptr, U32 value) {
+    U32 result = __atomic_fetch_add(ptr, value, __ATOMIC_SEQ_CST);
+    return result;
+}
+
+U64 AtomicAdd_U64(volatile U64 *ptr, U64 value) {
+    U64 result = __atomic_fetch_add(ptr, value, __ATOMIC_SEQ_CST);
+    return result;
+}
+
+U32 AtomicLoad_U32(volatile U32 *value) {
+    U32 result = __atomic_load_n(value, __ATOMIC_ACQUIRE);
+    return result;
+}
+
+U64 AtomicLoad_U64(volatile U64 *value) {
+    U64 result = __atomic_load_n(value, __ATOMIC_ACQUIRE);
+    return result;
+}
+
+void AtomicStore_U32(volatile U32 *value, U32 store) {
+    __atomic_store_n(value, store, __ATOMIC_RELEASE);
+}
+
+void AtomicStore_U64(volatile U64 *value, U64 store) {
+    __atomic_store_n(value, store, __ATOMIC_RELEASE);
+}
+
+U32 AtomicExchange_U32(volatile U32 *value, U32 exchange) {
+    U32 result;
+
+    __atomic_exchange(value, &exchange, &result, __ATOMIC_SEQ_CST);
+    return result;
+}
+
+U64 AtomicExchange_U64(volatile U64 *value, U64 exchange) {
+    U64 result;
+
+    __atomic_exchange(value, &exchange, &result, __ATOMIC_SEQ_CST);
+    return result;
+}
+
+void *AtomicExchange_Ptr(void *volatile *value, void *exchange) {
+    void *result;
+
+    __atomic_exchange(value, &exchange, &result, __ATOMIC_SEQ_CST);
+    return result;
+}
+
+B32 AtomicCompareExchange_U32(volatile U32 *value, U32 exchange, U32 comparand) {
+    B32 result = __atomic_compare_exchange(value, &comparand, &exchange, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+    return result;
+}
+
+B32 AtomicCompareExchange_U64(volatile U64 *value, U64 exchange, U64 comparand) {
+    B32 result = __atomic_compare_exchange(value, &comparand, &exchange, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+    return result;
+}
+
+B32 AtomicCompareExchange_Ptr(void *volatile *value, void *exchange, void *comparand) {
+    B32 result = __atomic_compare_exchange(value, &comparand, &exchange, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+    return result;
+}
+
+void AtomicFence() {
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+void SpinPause() {
+#if ARCH_AMD64
+    __builtin_ia32_pause();
+#elif ARCH_AARCH64
+    __asm__ __volatile__("yield");
+#endif
+}
+
+// cpu features
+//
+#if ARCH_AMD64
+
+#include <cpuid.h>
+
+internal OS_CpuFeatures __OS_GetCpuFeatures() {
+    OS_CpuFeatures result = 0;
+
+    unsigned int eax, ebx, ecx, edx;
+
+    U32 max_leaf = __get_cpuid_max(0, 0);
+
+    if (__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+        result |= (edx & (1 << 26)) ? OS_CPU_FEATURE_SSE2  : 0;
+        result |= (ecx & (1 << 20)) ? OS_CPU_FEATURE_SSE42 : 0;
+
+        // the os has to have enabled saving of the extended register state for the wider
+        // registers to be usable, check xcr0 for this
+        //
+        if ((ecx & (1 << 27)) && (ecx & (1 << 28))) {
+            U32 xcr0_lo, xcr0_hi;
+            __asm__ volatile ("xgetbv" : "=a" (xcr0_lo), "=d" (xcr0_hi) : "c" (0));
+
+            U64 xcr0 = Compose_U64(xcr0_hi, xcr0_lo);
+
+            if ((xcr0 & 0x6) == 0x6) {
+                result |= OS_CPU_FEATURE_AVX;
+
+                if (max_leaf >= 7) {
+                    __cpuid_count(7, 0, eax, ebx, ecx, edx);
+
+                    result |= (ebx & (1 << 5)) ? OS_CPU_FEATURE_AVX2 : 0;
+
+                    if ((xcr0 & 0xE6) == 0xE6 && (ebx & (1 << 16)) && (ebx & (1 << 30))) {
+                        result |= OS_CPU_FEATURE_AVX512;
+                    }
+                }
+            }
+        }
+    }
+
+    return result;
+}
+
+#elif ARCH_AARCH64
+
+internal OS_CpuFeatures __OS_GetCpuFeatures() {
+    // advanced simd is mandatory on aarch64
+    //
+    OS_CpuFeatures result = OS_CPU_FEATURE_NEON;
+    return result;
+}
+
+#endif
+
+#endif
+
+// agnostic across all compilers, msvc has specific intrinsics for this but under
+// optimisations correctly detects these as the right instructions
+//
+U32 RotateLeft_U32(U32 x, U32 count) {
+    count &= 31;
+
+    U32 result = (x << count) | (x >> (32 - count));
+    return result;
 }
 
 U64 RotateLeft_U64(U64 x, U32 count) {
@@ -1669,12 +3406,28 @@ U64 RotateRight_U64(U64 x, U32 count) {
     return result;
 }
 
+// pointers are always 64-bit on the supported architectures
+//
+void *AtomicLoad_Ptr(void *volatile *value) {
+    void *result = cast(void *) AtomicLoad_U64(cast(volatile U64 *) value);
+    return result;
+}
+
+void AtomicStore_Ptr(void *volatile *value, void *store) {
+    AtomicStore_U64(cast(volatile U64 *) value, cast(U64) store);
+}
+
 //
 // --------------------------------------------------------------------------------
 // :impl_utilities
 // --------------------------------------------------------------------------------
 //
 
+OS_SystemInfo *OS_GetSystemInfo() {
+    OS_SystemInfo *result = &__os_system_info;
+    return result;
+}
+
 OS_Handle OS_NilHandle() {
     OS_Handle result = ZERO(OS_Handle);
     return result;
@@ -1901,2738 +3654,7672 @@ U64 ReverseBits_U64(U64 x) {
     return result;
 }
 
-void *M_CopySize(void *dst, void *src, U64 size) {
-    void *result = dst;
+// memory utilities
+//
+// :note the wide kernels below all use the same structure, an unaligned vector is written
+// at the head and the tail of the destination and the body is written with aligned stores
+// in between. the head/tail stores overlap the body so there are no scalar remainder loops,
+// this means they require at least two vectors worth of data and are only used above that
+//
+// the isa is selected with the features cached by OS_Init, this is a well predicted branch
+// rather than an indirect call so small calls don't pay for the dispatch. if OS_Init hasn't
+// been called yet the baseline isa (sse2 / neon) is used
+//
+#if !defined(M_NON_TEMPORAL_THRESHOLD)
+    // copies or fills larger than this will bypass the cache with non-temporal stores as the
+    // destination would evict most of the cache anyway
+    //
+    #define M_NON_TEMPORAL_THRESHOLD MB(4)
+#endif
 
-    U8 *dst8 = cast(U8 *) dst;
-    U8 *src8 = cast(U8 *) src;
+#if ARCH_AMD64
 
-    while (size--) {
-        *dst8++ = *src8++;
-    }
+#include <immintrin.h>
 
-    return result;
-}
+#if COMPILER_MSVC
+    #define __M_TARGET_AVX2
+#else
+    #define __M_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
 
-void *M_FillSize(void *dst, U8 value, U64 size) {
-    void *result = dst;
+#define __M_HAS_AVX2() ((__os_system_info.features & OS_CPU_FEATURE_AVX2) != 0)
 
-    U8 *dst8 = cast(U8 *) dst;
+internal void __M_CopyWide_SSE2(U8 *dst, U8 *src, U64 size) {
+    Assert(size >= 32);
 
-    while (size--) {
-        *dst8++ = value;
-    }
+    __m128i head = _mm_loadu_si128(cast(__m128i *) src);
+    __m128i tail = _mm_loadu_si128(cast(__m128i *) (src + size - 16));
 
-    return result;
-}
+    U64 skew = 16 - (cast(U64) dst & 15);
 
-void *M_ZeroSize(void *dst, U64 size) {
-    void *result = dst;
+    U8 *d = dst + skew;
+    U8 *s = src + skew;
+    U64 remaining = size - skew;
 
-    U8 *dst8 = cast(U8 *) dst;
+    if (size >= M_NON_TEMPORAL_THRESHOLD) {
+        for (; remaining > 64; remaining -= 64, d += 64, s += 64) {
+            _mm_stream_si128(cast(__m128i *) (d +  0), _mm_loadu_si128(cast(__m128i *) (s +  0)));
+            _mm_stream_si128(cast(__m128i *) (d + 16), _mm_loadu_si128(cast(__m128i *) (s + 16)));
+            _mm_stream_si128(cast(__m128i *) (d + 32), _mm_loadu_si128(cast(__m128i *) (s + 32)));
+            _mm_stream_si128(cast(__m128i *) (d + 48), _mm_loadu_si128(cast(__m128i *) (s + 48)));
+        }
 
-    while (size--) {
-        *dst8++ = 0;
+        _mm_sfence();
     }
-
-    return result;
-}
-
-B32 M_CompareSize(void *a, void *b, U64 size) {
-    B32 result = true;
-
-    U8 *a8 = cast(U8 *) a;
-    U8 *b8 = cast(U8 *) b;
-
-    while (size--) {
-        if (*a8++ != *b8++) {
-            result = false;
-            break;
+    else {
+        for (; remaining > 64; remaining -= 64, d += 64, s += 64) {
+            _mm_store_si128(cast(__m128i *) (d +  0), _mm_loadu_si128(cast(__m128i *) (s +  0)));
+            _mm_store_si128(cast(__m128i *) (d + 16), _mm_loadu_si128(cast(__m128i *) (s + 16)));
+            _mm_store_si128(cast(__m128i *) (d + 32), _mm_loadu_si128(cast(__m128i *) (s + 32)));
+            _mm_store_si128(cast(__m128i *) (d + 48), _mm_loadu_si128(cast(__m128i *) (s + 48)));
         }
     }
 
-    return result;
-}
-
-// merge sort implementation
-//
-internal void _MergeSortMerge(U8 *array, CompareFunc *Compare, U64 element_size, S64 start, S64 middle, S64 end) {
-    S64 lcount = middle - start + 1;
-    S64 rcount = end - middle;
+    for (; remaining > 16; remaining -= 16, d += 16, s += 16) {
+        _mm_store_si128(cast(__m128i *) d, _mm_loadu_si128(cast(__m128i *) s));
+    }
 
-    M_Temp temp = M_AcquireTemp(0, 0);
+    _mm_storeu_si128(cast(__m128i *) dst, head);
+    _mm_storeu_si128(cast(__m128i *) (dst + size - 16), tail);
+}
 
-    U8 *lstart = array + ((start)      * element_size);
-    U8 *rstart = array + ((middle + 1) * element_size);
+internal __M_TARGET_AVX2 void __M_CopyWide_AVX2(U8 *dst, U8 *src, U64 size) {
+    Assert(size >= 64);
 
-    U8 *l = M_ArenaPushCopy(temp.arena, lstart, U8, lcount * element_size);
-    U8 *r = M_ArenaPushCopy(temp.arena, rstart, U8, rcount * element_size);
+    __m256i head = _mm256_loadu_si256(cast(__m256i *) src);
+    __m256i tail = _mm256_loadu_si256(cast(__m256i *) (src + size - 32));
 
-    U8 *lend = l + (lcount * element_size);
-    U8 *rend = r + (rcount * element_size);
+    U64 skew = 32 - (cast(U64) dst & 31);
 
-    U8 *element = array + (start * element_size);
+    U8 *d = dst + skew;
+    U8 *s = src + skew;
+    U64 remaining = size - skew;
 
-    while (l < lend && r < rend) {
-        if (Compare(l, r) <= 0) {
-            M_CopySize(element, l, element_size);
-            l += element_size;
-        }
-        else {
-            M_CopySize(element, r, element_size);
-            r += element_size;
+    if (size >= M_NON_TEMPORAL_THRESHOLD) {
+        for (; remaining > 128; remaining -= 128, d += 128, s += 128) {
+            _mm256_stream_si256(cast(__m256i *) (d +  0), _mm256_loadu_si256(cast(__m256i *) (s +  0)));
+            _mm256_stream_si256(cast(__m256i *) (d + 32), _mm256_loadu_si256(cast(__m256i *) (s + 32)));
+            _mm256_stream_si256(cast(__m256i *) (d + 64), _mm256_loadu_si256(cast(__m256i *) (s + 64)));
+            _mm256_stream_si256(cast(__m256i *) (d + 96), _mm256_loadu_si256(cast(__m256i *) (s + 96)));
         }
 
-        element += element_size;
+        _mm_sfence();
+    }
+    else {
+        for (; remaining > 128; remaining -= 128, d += 128, s += 128) {
+            _mm256_store_si256(cast(__m256i *) (d +  0), _mm256_loadu_si256(cast(__m256i *) (s +  0)));
+            _mm256_store_si256(cast(__m256i *) (d + 32), _mm256_loadu_si256(cast(__m256i *) (s + 32)));
+            _mm256_store_si256(cast(__m256i *) (d + 64), _mm256_loadu_si256(cast(__m256i *) (s + 64)));
+            _mm256_store_si256(cast(__m256i *) (d + 96), _mm256_loadu_si256(cast(__m256i *) (s + 96)));
+        }
     }
 
-    U64 l_remainder = cast(U64) (lend - l);
-    U64 r_remainder = cast(U64) (rend - r);
-
-    if (l_remainder) {
-        M_CopySize(element, l, l_remainder);
-        element += l_remainder;
+    for (; remaining > 32; remaining -= 32, d += 32, s += 32) {
+        _mm256_store_si256(cast(__m256i *) d, _mm256_loadu_si256(cast(__m256i *) s));
     }
 
-    if (r_remainder) { M_CopySize(element, r, r_remainder); }
+    _mm256_storeu_si256(cast(__m256i *) dst, head);
+    _mm256_storeu_si256(cast(__m256i *) (dst + size - 32), tail);
 
-    M_ReleaseTemp(temp);
+    _mm256_zeroupper();
 }
 
-internal void _MergeSortSplit(U8 *array, CompareFunc *Compare, U64 element_size, S64 start, S64 end) {
-    if (start < end) {
-        S64 middle = start + ((end - start) >> 1);
+internal void __M_FillWide_SSE2(U8 *dst, U8 value, U64 size) {
+    Assert(size >= 32);
+
+    __m128i v = _mm_set1_epi8(cast(char) value);
+
+    U64 skew = 16 - (cast(U64) dst & 15);
 
-        _MergeSortSplit(array, Compare, element_size, start,      middle);
-        _MergeSortSplit(array, Compare, element_size, middle + 1, end);
+    U8 *d = dst + skew;
+    U64 remaining = size - skew;
 
-        _MergeSortMerge(array, Compare, element_size, start, middle, end);
+    if (size >= M_NON_TEMPORAL_THRESHOLD) {
+        for (; remaining > 64; remaining -= 64, d += 64) {
+            _mm_stream_si128(cast(__m128i *) (d +  0), v);
+            _mm_stream_si128(cast(__m128i *) (d + 16), v);
+            _mm_stream_si128(cast(__m128i *) (d + 32), v);
+            _mm_stream_si128(cast(__m128i *) (d + 48), v);
+        }
+
+        _mm_sfence();
+    }
+    else {
+        for (; remaining > 64; remaining -= 64, d += 64) {
+            _mm_store_si128(cast(__m128i *) (d +  0), v);
+            _mm_store_si128(cast(__m128i *) (d + 16), v);
+            _mm_store_si128(cast(__m128i *) (d + 32), v);
+            _mm_store_si128(cast(__m128i *) (d + 48), v);
+        }
     }
-}
 
-void _MergeSort(void *array, S64 count, CompareFunc *Compare, U64 element_size) {
-    _MergeSortSplit((U8 *) array, Compare, element_size, 0, count - 1);
-}
+    for (; remaining > 16; remaining -= 16, d += 16) {
+        _mm_store_si128(cast(__m128i *) d, v);
+    }
 
-// quick sort implementation
-//
-internal S64 _QuickSortPartition(U8 *array, CompareFunc *Compare, U64 element_size, S64 lo, S64 hi) {
-    S64 result = lo;
+    _mm_storeu_si128(cast(__m128i *) dst, v);
+    _mm_storeu_si128(cast(__m128i *) (dst + size - 16), v);
+}
 
-    M_Temp temp = M_AcquireTemp(0, 0);
+internal __M_TARGET_AVX2 void __M_FillWide_AVX2(U8 *dst, U8 value, U64 size) {
+    Assert(size >= 64);
 
-    U8 *pivot = array + (hi * element_size);
+    __m256i v = _mm256_set1_epi8(cast(char) value);
 
-    U8 *i = array + (lo * element_size);
-    U8 *j = array + (lo * element_size);
-    U8 *t = M_ArenaPush(temp.arena, U8, element_size); // for swapping
+    U64 skew = 32 - (cast(U64) dst & 31);
 
-    for (S64 it = lo; it < hi; ++it) {
-        if (Compare(j, pivot) <= 0) {
-            // swap i and j
-            //
-            M_CopySize(t, i, element_size);
-            M_CopySize(i, j, element_size);
-            M_CopySize(j, t, element_size);
+    U8 *d = dst + skew;
+    U64 remaining = size - skew;
 
-            i      += element_size;
-            result += 1;
+    if (size >= M_NON_TEMPORAL_THRESHOLD) {
+        for (; remaining > 128; remaining -= 128, d += 128) {
+            _mm256_stream_si256(cast(__m256i *) (d +  0), v);
+            _mm256_stream_si256(cast(__m256i *) (d + 32), v);
+            _mm256_stream_si256(cast(__m256i *) (d + 64), v);
+            _mm256_stream_si256(cast(__m256i *) (d + 96), v);
         }
 
-        j += element_size;
+        _mm_sfence();
+    }
+    else {
+        for (; remaining > 128; remaining -= 128, d += 128) {
+            _mm256_store_si256(cast(__m256i *) (d +  0), v);
+            _mm256_store_si256(cast(__m256i *) (d + 32), v);
+            _mm256_store_si256(cast(__m256i *) (d + 64), v);
+            _mm256_store_si256(cast(__m256i *) (d + 96), v);
+        }
     }
 
-    // swap i with pivot
-    //
-    M_CopySize(t,     i,     element_size);
-    M_CopySize(i,     pivot, element_size);
-    M_CopySize(pivot, t,     element_size);
+    for (; remaining > 32; remaining -= 32, d += 32) {
+        _mm256_store_si256(cast(__m256i *) d, v);
+    }
 
-    M_ReleaseTemp(temp);
+    _mm256_storeu_si256(cast(__m256i *) dst, v);
+    _mm256_storeu_si256(cast(__m256i *) (dst + size - 32), v);
 
-    return result;
+    _mm256_zeroupper();
 }
 
-internal void _QuickSortRange(U8 *array, CompareFunc *Compare, U64 element_size, S64 lo, S64 hi) {
-    if (lo < hi) {
-        S64 pivot = _QuickSortPartition(array, Compare, element_size, lo, hi);
+internal B32 __M_CompareWide_SSE2(U8 *a, U8 *b, U64 size) {
+    Assert(size >= 16);
 
-        _QuickSortRange(array, Compare, element_size, lo, pivot - 1);
-        _QuickSortRange(array, Compare, element_size, pivot + 1, hi);
-    }
-}
+    B32 result = true;
 
-void _QuickSort(void *array, S64 count, CompareFunc *Compare, U64 element_size) {
-    _QuickSortRange((U8 *) array, Compare, element_size, 0, count - 1);
-}
+    U64 it = 0;
+    for (; it + 16 <= size; it += 16) {
+        __m128i va = _mm_loadu_si128(cast(__m128i *) (a + it));
+        __m128i vb = _mm_loadu_si128(cast(__m128i *) (b + it));
 
-//
-// --------------------------------------------------------------------------------
-// :impl_arena
-// --------------------------------------------------------------------------------
-//
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(va, vb)) != 0xFFFF) {
+            result = false;
+            break;
+        }
+    }
 
-#if OS_WINDOWS
+    if (result && it != size) {
+        // overlapping compare of the final vector
+        //
+        __m128i va = _mm_loadu_si128(cast(__m128i *) (a + size - 16));
+        __m128i vb = _mm_loadu_si128(cast(__m128i *) (b + size - 16));
 
-//
-// :windows_arena
-//
+        result = (_mm_movemask_epi8(_mm_cmpeq_epi8(va, vb)) == 0xFFFF);
+    }
 
-void *M_Reserve(U64 size) {
-    void *result = VirtualAlloc(0, size, MEM_RESERVE, PAGE_NOACCESS);
     return result;
 }
 
-B32 M_Commit(void *base, U64 size) {
-    B32 result = VirtualAlloc(base, size, MEM_COMMIT, PAGE_READWRITE) != 0;
-    return result;
-}
+internal __M_TARGET_AVX2 B32 __M_CompareWide_AVX2(U8 *a, U8 *b, U64 size) {
+    Assert(size >= 32);
 
-void M_Decommit(void *base, U64 size) {
-    VirtualFree(base, size, MEM_DECOMMIT);
-}
+    B32 result = true;
 
-void M_Release(void *base, U64 size) {
-    (void) size;
-    VirtualFree(base, 0, MEM_RELEASE);
-}
+    U64 it = 0;
+    for (; it + 32 <= size; it += 32) {
+        __m256i va = _mm256_loadu_si256(cast(__m256i *) (a + it));
+        __m256i vb = _mm256_loadu_si256(cast(__m256i *) (b + it));
 
-U64 M_GetPageSize() {
-    SYSTEM_INFO info;
-    GetSystemInfo(&info);
+        if (cast(U32) _mm256_movemask_epi8(_mm256_cmpeq_epi8(va, vb)) != U32_MAX) {
+            result = false;
+            break;
+        }
+    }
 
-    U64 result = info.dwPageSize;
-    return result;
-}
+    if (result && it != size) {
+        __m256i va = _mm256_loadu_si256(cast(__m256i *) (a + size - 32));
+        __m256i vb = _mm256_loadu_si256(cast(__m256i *) (b + size - 32));
 
-U64 M_GetAllocationGranularity() {
-    SYSTEM_INFO info;
-    GetSystemInfo(&info);
+        result = (cast(U32) _mm256_movemask_epi8(_mm256_cmpeq_epi8(va, vb)) == U32_MAX);
+    }
+
+    _mm256_zeroupper();
 
-    U64 result = info.dwAllocationGranularity;
     return result;
 }
 
-#elif OS_MACOS
-    #error "macOS memory subsystem not implemented"
-#elif OS_LINUX
+#elif ARCH_AARCH64
 
+#include <arm_neon.h>
+
+// :note neon doesn't expose non-temporal stores as intrinsics so the large copies just use
+// the regular stores, the hardware write streaming detection on most cores handles this
 //
-// :linux_arena
-//
+internal void __M_CopyWide_NEON(U8 *dst, U8 *src, U64 size) {
+    Assert(size >= 32);
 
-#include <sys/mman.h>
-#include <unistd.h>
+    uint8x16_t head = vld1q_u8(src);
+    uint8x16_t tail = vld1q_u8(src + size - 16);
 
-#if !defined(MAP_ANON)
-    #define MAP_ANON MAP_ANONYMOUS
-#endif
+    U64 skew = 16 - (cast(U64) dst & 15);
 
-void *M_Reserve(U64 size) {
-    void *ptr = mmap(0, size, PROT_NONE, MAP_PRIVATE | MAP_ANON, -1, 0);
+    U8 *d = dst + skew;
+    U8 *s = src + skew;
+    U64 remaining = size - skew;
 
-    void *result = (ptr == MAP_FAILED) ? 0 : ptr;
-    return result;
-}
+    for (; remaining > 64; remaining -= 64, d += 64, s += 64) {
+        vst1q_u8(d +  0, vld1q_u8(s +  0));
+        vst1q_u8(d + 16, vld1q_u8(s + 16));
+        vst1q_u8(d + 32, vld1q_u8(s + 32));
+        vst1q_u8(d + 48, vld1q_u8(s + 48));
+    }
 
-B32 M_Commit(void *base, U64 size) {
-    B32 result = mprotect(base, size, PROT_READ | PROT_WRITE) == 0;
-    return result;
-}
+    for (; remaining > 16; remaining -= 16, d += 16, s += 16) {
+        vst1q_u8(d, vld1q_u8(s));
+    }
 
-void M_Decommit(void *base, U64 size) {
-    madvise(base, size, MADV_DONTNEED);
-    mprotect(base, size, PROT_NONE);
+    vst1q_u8(dst, head);
+    vst1q_u8(dst + size - 16, tail);
 }
 
-void M_Release(void *base, U64 size) {
-    munmap(base, size);
-}
+internal void __M_FillWide_NEON(U8 *dst, U8 value, U64 size) {
+    Assert(size >= 32);
 
-U64 M_GetPageSize() {
-    U64 result = sysconf(_SC_PAGESIZE);
-    return result;
-}
+    uint8x16_t v = vdupq_n_u8(value);
 
-U64 M_GetAllocationGranularity() {
-    U64 result = sysconf(_SC_PAGESIZE);
-    return result;
-}
+    U64 skew = 16 - (cast(U64) dst & 15);
 
-#elif OS_SWITCH
+    U8 *d = dst + skew;
+    U64 remaining = size - skew;
 
-//
-// :switch_arena
-//
-// we unfortunately don't have any other options to allocate memory with switchbrew,
-// malloc/free are the only userspace general address space allocators available to
-// us
-//
-#include <stdlib.h>
+    for (; remaining > 64; remaining -= 64, d += 64) {
+        vst1q_u8(d +  0, v);
+        vst1q_u8(d + 16, v);
+        vst1q_u8(d + 32, v);
+        vst1q_u8(d + 48, v);
+    }
 
-void *M_Reserve(U64 size) {
-    void *result = malloc(size);
-    return result;
+    for (; remaining > 16; remaining -= 16, d += 16) {
+        vst1q_u8(d, v);
+    }
+
+    vst1q_u8(dst, v);
+    vst1q_u8(dst + size - 16, v);
 }
 
-B32 M_Commit(void *base, U64 size) {
-    (void) base;
-    (void) size;
+internal B32 __M_CompareWide_NEON(U8 *a, U8 *b, U64 size) {
+    Assert(size >= 16);
 
-    // already committed the entire region with malloc so nothing to do
-    //
     B32 result = true;
-    return result;
-}
 
-void M_Decommit(void *base, U64 size) {
-    (void) base;
-    (void) size;
+    U64 it = 0;
+    for (; it + 16 <= size; it += 16) {
+        if (vminvq_u8(vceqq_u8(vld1q_u8(a + it), vld1q_u8(b + it))) != 0xFF) {
+            result = false;
+            break;
+        }
+    }
 
-    // no decommit available because malloc/free so nothing to do
-    //
+    if (result && it != size) {
+        result = (vminvq_u8(vceqq_u8(vld1q_u8(a + size - 16), vld1q_u8(b + size - 16))) == 0xFF);
+    }
+
+    return result;
 }
 
-void M_Release(void *base, U64 size) {
-    (void) size;
+#endif
 
-    free(base);
-}
+void *M_CopySize(void *dst, void *src, U64 size) {
+    void *result = dst;
 
-U64 M_GetPageSize() {
-    U64 result = 4096;
-    return result;
-}
+    U8 *dst8 = cast(U8 *) dst;
+    U8 *src8 = cast(U8 *) src;
+
+    if (size < 32) {
+        while (size--) {
+            *dst8++ = *src8++;
+        }
+    }
+    else {
+#if ARCH_AMD64
+        if (size >= 64 && __M_HAS_AVX2()) {
+            __M_CopyWide_AVX2(dst8, src8, size);
+        }
+        else {
+            __M_CopyWide_SSE2(dst8, src8, size);
+        }
+#elif ARCH_AARCH64
+        __M_CopyWide_NEON(dst8, src8, size);
+#endif
+    }
 
-U64 M_GetAllocationGranularity() {
-    U64 result = 4096;
     return result;
 }
 
-#endif
-
-#define M_ARENA_MIN_OFFSET sizeof(M_Arena)
+void *M_CopySizeForward(void *dst, void *src, U64 size) {
+    void *result = dst;
 
-#if !defined(M_ARENA_COMMIT_SIZE)
-    #define M_ARENA_COMMIT_SIZE KB(64)
-#endif
+    U8 *dst8 = cast(U8 *) dst;
+    U8 *src8 = cast(U8 *) src;
 
-#if !defined(M_ARENA_MAX_RESERVE_SWITCH)
-    #define M_ARENA_MAX_RESERVE_SWITCH MB(8)
-#endif
+    U64 distance = cast(U64) (dst8 - src8);
 
-#if !defined(M_ARENA_GROW_RESERVE_SIZE)
-    #define M_ARENA_GROW_RESERVE_SIZE MB(1)
+    if (dst8 <= src8 || distance >= 16) {
+        // no bytes written can be read again within a single vector so we can copy
+        // 16 bytes at a time, anything closer has to replicate the pattern byte by byte
+        //
+        for (; size >= 16; size -= 16, dst8 += 16, src8 += 16) {
+#if ARCH_AMD64
+            _mm_storeu_si128(cast(__m128i *) dst8, _mm_loadu_si128(cast(__m128i *) src8));
+#elif ARCH_AARCH64
+            vst1q_u8(dst8, vld1q_u8(src8));
 #endif
+        }
+    }
 
-internal M_Arena *__M_AllocSizedArena(U64 limit, U64 initial_commit, M_ArenaFlags flags) {
-    M_Arena *result = 0;
+    while (size--) {
+        *dst8++ = *src8++;
+    }
 
-    U64 page_size   = M_GetPageSize();
-    U64 granularity = M_GetAllocationGranularity();
+    return result;
+}
 
-    // have at least the allocation granularity to reserve and at least the page size to commit
-    //
-    U64 to_reserve = Max(AlignUp(limit, granularity), granularity);
-    U64 to_commit  = Clamp(page_size, AlignUp(initial_commit, page_size), to_reserve);
+void *M_MoveSize(void *dst, void *src, U64 size) {
+    void *result = dst;
 
-    void *base = M_Reserve(to_reserve);
-    if (base != 0) {
-        if (M_Commit(base, to_commit)) {
-            result = cast(M_Arena *) base;
+    U8 *dst8 = cast(U8 *) dst;
+    U8 *src8 = cast(U8 *) src;
 
-            result->current = result;
-            result->prev    = 0;
+    if (dst8 <= src8 || dst8 >= src8 + size) {
+        M_CopySizeForward(dst, src, size);
+    }
+    else {
+        // 'dst' overlaps the end of 'src' so copy back to front, each vector is loaded before
+        // anything that overlaps it is stored
+        //
+        dst8 += size;
+        src8 += size;
 
-            result->base        = 0;
-            result->limit       = to_reserve;
-            result->offset      = M_ARENA_MIN_OFFSET;
-            result->last_offset = M_ARENA_MIN_OFFSET;
+        for (; size >= 16; size -= 16) {
+            dst8 -= 16;
+            src8 -= 16;
 
-            result->committed = to_commit;
+#if ARCH_AMD64
+            _mm_storeu_si128(cast(__m128i *) dst8, _mm_loadu_si128(cast(__m128i *) src8));
+#elif ARCH_AARCH64
+            vst1q_u8(dst8, vld1q_u8(src8));
+#endif
+        }
 
-            result->flags = flags;
+        while (size--) {
+            *--dst8 = *--src8;
         }
     }
 
-    Assert(result != 0);
-
     return result;
 }
 
-M_Arena *M_AllocArenaArgs(U64 limit, U64 initial_commit, M_ArenaFlags flags) {
-#if OS_SWITCH
-    // :note ~switch
-    //
-    // swtichbrew doesn't support virtual memory semantics, this means we can't just
-    // ask for 64GiB of virtual address space to commit later and get away with it
-    // like on other operating systems.
-    //
-    // to work around this we force growable arenas on and clamp the initial arena
-    // size to a more reasonable size
-    //
-    flags &= ~M_ARENA_DONT_GROW;
-    limit  = Min(limit, M_ARENA_MAX_RESERVE_SWITCH);
+void *M_FillSize(void *dst, U8 value, U64 size) {
+    void *result = dst;
+
+    U8 *dst8 = cast(U8 *) dst;
+
+    if (size < 32) {
+        while (size--) {
+            *dst8++ = value;
+        }
+    }
+    else {
+#if ARCH_AMD64
+        if (size >= 64 && __M_HAS_AVX2()) {
+            __M_FillWide_AVX2(dst8, value, size);
+        }
+        else {
+            __M_FillWide_SSE2(dst8, value, size);
+        }
+#elif ARCH_AARCH64
+        __M_FillWide_NEON(dst8, value, size);
 #endif
+    }
 
-    M_Arena *result = __M_AllocSizedArena(limit, initial_commit, flags);
     return result;
 }
 
-M_Arena *M_AllocArena(U64 limit) {
-    M_Arena *result = M_AllocArenaArgs(limit, M_ARENA_COMMIT_SIZE, 0);
+void *M_ZeroSize(void *dst, U64 size) {
+    void *result = M_FillSize(dst, 0, size);
     return result;
 }
 
-void M_ResetArena(M_Arena *arena) {
-    M_Arena *current = arena->current;
-    while (current->prev != 0) {
-        void *base = cast(void *) current;
-        U64   size = current->limit;
+B32 M_CompareSize(void *a, void *b, U64 size) {
+    B32 result = true;
 
-        current = current->prev;
+    U8 *a8 = cast(U8 *) a;
+    U8 *b8 = cast(U8 *) b;
 
-        M_Release(base, size);
+    if (size < 16) {
+        while (size--) {
+            if (*a8++ != *b8++) {
+                result = false;
+                break;
+            }
+        }
+    }
+    else {
+#if ARCH_AMD64
+        if (size >= 32 && __M_HAS_AVX2()) {
+            result = __M_CompareWide_AVX2(a8, b8, size);
+        }
+        else {
+            result = __M_CompareWide_SSE2(a8, b8, size);
+        }
+#elif ARCH_AARCH64
+        result = __M_CompareWide_NEON(a8, b8, size);
+#endif
     }
 
-    Assert(current == arena);
-    Assert(current->committed >= M_ARENA_COMMIT_SIZE);
-
-    void *decommit_base = cast(U8 *) current + M_ARENA_COMMIT_SIZE;
-    U64   decommit_size = current->committed - M_ARENA_COMMIT_SIZE;
+    return result;
+}
 
-    if (decommit_size != 0) { M_Decommit(decommit_base, decommit_size); }
+// sorting helpers
+//
+// elements are swapped in place rather than through a temporary so nothing needs to be
+// allocated, the common sizes are moved as whole words and larger elements 8 bytes at a time.
+// the elements are arbitrary user storage so the words are moved with M_CopyFixed
+//
+internal void _SortSwap(U8 *a, U8 *b, U64 element_size) {
+    switch (element_size) {
+        case 4: {
+            U32 t;
+            M_CopyFixed(&t, a, sizeof(U32));
+            M_CopyFixed(a,  b, sizeof(U32));
+            M_CopyFixed(b, &t, sizeof(U32));
+        }
+        break;
+        case 8: {
+            U64 t;
+            M_CopyFixed(&t, a, sizeof(U64));
+            M_CopyFixed(a,  b, sizeof(U64));
+            M_CopyFixed(b, &t, sizeof(U64));
+        }
+        break;
+        case 16: {
+            U64 t[2];
+            M_CopyFixed(t, a, sizeof(t));
+            M_CopyFixed(a, b, sizeof(t));
+            M_CopyFixed(b, t, sizeof(t));
+        }
+        break;
+        default: {
+            U64 it = 0;
+            for (; it + 8 <= element_size; it += 8) {
+                U64 t;
+                M_CopyFixed(&t,     a + it, sizeof(U64));
+                M_CopyFixed(a + it, b + it, sizeof(U64));
+                M_CopyFixed(b + it, &t,     sizeof(U64));
+            }
 
-    current->offset      = M_ARENA_MIN_OFFSET;
-    current->last_offset = M_ARENA_MIN_OFFSET;
-    current->committed   = M_ARENA_COMMIT_SIZE;
+            for (; it < element_size; ++it) {
+                U8 t  = a[it];
+                a[it] = b[it];
+                b[it] = t;
+            }
+        }
+        break;
+    }
+}
 
-    arena->current = current;
+internal void _SortCopy(U8 *dst, U8 *src, U64 element_size) {
+    switch (element_size) {
+        case 4:  { M_CopyFixed(dst, src, sizeof(U32));     } break;
+        case 8:  { M_CopyFixed(dst, src, sizeof(U64));     } break;
+        case 16: { M_CopyFixed(dst, src, 2 * sizeof(U64)); } break;
+        default: {
+            U64 it = 0;
+            for (; it + 8 <= element_size; it += 8) { M_CopyFixed(dst + it, src + it, sizeof(U64)); }
+            for (; it < element_size; ++it) { dst[it] = src[it]; }
+        }
+        break;
+    }
 }
 
-void M_ReleaseArena(M_Arena *arena) {
-    M_Arena *current = arena->current;
-    while (current != 0) {
-        void *base = cast(void *) current;
-        U64   size = current->limit;
+// scratch buffers hold elements which are passed to the comparison function so they must be
+// aligned for any element type, including vector types, regardless of what was pushed to the temp
+// arena before them
+//
+#define _SORT_SCRATCH_ALIGNMENT 64
 
-        current = current->prev;
+// all of the sort internals work on element pointers, 'end' is one past the last element
+//
+typedef struct _SortContext _SortContext;
+struct _SortContext {
+    CompareFunc *Compare;
+    U64 element_size;
+};
+
+#define _SortLess(ctx, a, b) ((ctx)->Compare((a), (b)) < 0)
+
+// only moves an element past strictly greater ones so is stable
+//
+internal void _SortInsertion(_SortContext *ctx, U8 *begin, U8 *end) {
+    U64 size = ctx->element_size;
 
-        M_Release(base, size);
+    for (U8 *it = begin + size; it < end; it += size) {
+        for (U8 *j = it; j > begin && _SortLess(ctx, j, j - size); j -= size) {
+            _SortSwap(j, j - size, size);
+        }
     }
 }
 
-void *M_ArenaPushFrom(M_Arena *arena, U64 size, M_ArenaFlags flags, U64 alignment) {
-    void *result = 0;
-
-    M_Arena *current = arena->current;
+// merge sort implementation
+//
+// bottom-up merge sort, fixed size runs are insertion sorted in place then merged in passes of
+// doubling width. a single scratch buffer the size of the input is taken once and each pass
+// merges from one buffer into the other, so every pass moves each element exactly once. pairs of
+// runs that are already in order are copied without comparing, and input that is entirely sorted
+// is detected up front and left untouched
+//
+#define MERGE_SORT_RUN_COUNT 32
 
-    alignment  = Clamp(1, alignment, 4096);
-    U64 offset = AlignUp(current->offset, alignment);
-    U64 end    = offset + size;
+internal void _MergeSortMerge(_SortContext *ctx, U8 *dst, U8 *l, U8 *lend, U8 *r, U8 *rend) {
+    U64 size = ctx->element_size;
 
-    if (end > current->limit) {
-        // not enough space in current arena so allocate a new one if growing is
-        // permitted
+    if (r < rend && _SortLess(ctx, r, lend - size)) {
+        // taking from the left when equal keeps the sort stable
         //
-        if ((arena->flags & M_ARENA_DONT_GROW) == 0) {
-            U64 reserve   = Max(size + M_ARENA_MIN_OFFSET, M_ARENA_GROW_RESERVE_SIZE);
-            M_Arena *next = __M_AllocSizedArena(reserve, M_ARENA_COMMIT_SIZE, 0);
-
-            next->base = current->base + current->limit;
-
-            SLL_PushN(arena->current, next, prev);
+        while (l < lend && r < rend) {
+            if (_SortLess(ctx, r, l)) {
+                _SortCopy(dst, r, size);
+                r += size;
+            }
+            else {
+                _SortCopy(dst, l, size);
+                l += size;
+            }
 
-            current = next;
-            offset  = AlignUp(current->offset, alignment);
-            end     = offset + size;
+            dst += size;
         }
     }
 
-    if (end > current->committed) {
-        void *commit_base = cast(U8 *) current + current->committed;
-        U64 commit_offset = AlignUp(end, M_ARENA_COMMIT_SIZE);
-        U64 commit_limit  = Min(commit_offset, current->limit);
-        U64 commit_size   = commit_limit - current->committed;
+    U64 l_remainder = cast(U64) (lend - l);
+    U64 r_remainder = cast(U64) (rend - r);
 
-        if (M_Commit(commit_base, commit_size)) { current->committed = commit_limit; }
+    if (l_remainder) {
+        M_CopySize(dst, l, l_remainder);
+        dst += l_remainder;
     }
 
-    if (current->committed >= end) {
-        // we have managed to commit enough space for the allocation
-        //
-        result = cast(U8 *) current + offset;
+    if (r_remainder) { M_CopySize(dst, r, r_remainder); }
+}
 
-        current->last_offset = current->offset;
-        current->offset      = end;
+void _MergeSort(void *array, S64 count, CompareFunc *Compare, U64 element_size) {
+    _SortContext ctx;
+    ctx.Compare      = Compare;
+    ctx.element_size = element_size;
+
+    U8 *begin = cast(U8 *) array;
+    U8 *end   = begin + (count * element_size);
 
-        if ((flags & M_ARENA_NO_ZERO) == 0) { M_ZeroSize(result, size); }
+    B32 sorted = true;
+    for (U8 *it = begin + element_size; sorted && it < end; it += element_size) {
+        sorted = !_SortLess(&ctx, it, it - element_size);
     }
 
-    Assert(result != 0);
-    Assert(((U64) result & (alignment - 1)) == 0);
+    if (!sorted) {
+        U64 run = MERGE_SORT_RUN_COUNT * element_size;
+        U64 total = cast(U64) (end - begin);
 
-    return result;
-}
+        for (U8 *it = begin; it < end; it += run) {
+            _SortInsertion(&ctx, it, (cast(U64) (end - it) > run) ? (it + run) : end);
+        }
 
-void *M_ArenaPushCopyFrom(M_Arena *arena, void *src, U64 size, M_ArenaFlags flags, U64 alignment) {
-    void *result = M_CopySize(M_ArenaPushFrom(arena, size, flags, alignment), src, size);
-    return result;
-}
+        if (total > run) {
+            M_Temp temp = M_AcquireTemp(0, 0);
 
-U64 M_GetArenaOffset(M_Arena *arena) {
-    M_Arena *current = arena->current;
+            U8 *src = begin;
+            U8 *dst = M_ArenaPush(temp.arena, U8, total, M_ARENA_NO_ZERO, _SORT_SCRATCH_ALIGNMENT);
 
-    U64 result = (current->base + current->offset);
-    return result;
-}
+            for (U64 width = run; width < total; width <<= 1) {
+                for (U64 offset = 0; offset < total; offset += (width << 1)) {
+                    U64 middle = Min(offset + width,        total);
+                    U64 last   = Min(offset + (width << 1), total);
 
-void M_ArenaPopTo(M_Arena *arena, U64 offset) {
-    M_Arena *current = arena->current;
+                    _MergeSortMerge(&ctx, dst + offset, src + offset, src + middle, src + middle, src + last);
+                }
 
-    while (current->base > offset) {
-        void *base = cast(void *) current;
-        U64   size = current->limit;
+                U8 *swap = src;
+                src = dst;
+                dst = swap;
+            }
 
-        current = current->prev;
+            if (src != begin) { M_CopySize(begin, src, total); }
 
-        M_Release(base, size);
+            M_ReleaseTemp(temp);
+        }
     }
+}
 
-    U64 local_offset = Max(offset - current->base, M_ARENA_MIN_OFFSET);
+// quick sort implementation
+//
+// pattern-defeating quicksort, an introsort that detects and adapts to common input patterns.
+// pivots are the median of 3, or the median of 3 medians for larger ranges, and are left at the
+// start of the range while partitioning so no copy of them is needed. small ranges use insertion
+// sort, and once too many unbalanced partitions have been seen the range is heap sorted instead
+// so the worst case is O(n log n). only the smaller side of each partition is recursed into so
+// the stack depth is O(log n)
+//
+// gives up and returns false once more than QUICK_SORT_PARTIAL_LIMIT elements have been moved,
+// used to cheaply finish ranges that are already nearly sorted
+//
+internal B32 _QuickSortPartialInsertion(_SortContext *ctx, U8 *begin, U8 *end) {
+    B32 result = true;
 
-    if (local_offset <= current->offset) {
-        // as we have popped back explicitly the 'last_offset' is no longer valid so
-        // set that to this offset thus calling 'pop last' after manually setting the
-        // offset doesn't do anything
-        //
-        current->offset      = local_offset;
-        current->last_offset = local_offset;
+    U64 size  = ctx->element_size;
+    U64 moves = 0;
+
+    for (U8 *it = begin + size; result && it < end; it += size) {
+        U8 *j = it;
+        for (; j > begin && _SortLess(ctx, j, j - size); j -= size) {
+            _SortSwap(j, j - size, size);
+        }
+
+        moves += cast(U64) (it - j) / size;
+        result = (moves <= QUICK_SORT_PARTIAL_LIMIT);
     }
 
-    arena->current = current;
+    return result;
 }
 
-void M_ArenaPopSize(M_Arena *arena, U64 size) {
-    U64 offset = M_GetArenaOffset(arena);
+internal void _QuickSortSort2(_SortContext *ctx, U8 *a, U8 *b) {
+    if (_SortLess(ctx, b, a)) { _SortSwap(a, b, ctx->element_size); }
+}
 
-    // explicitly greater than because the arena takes some space for its header
-    // information
-    //
-    if (offset > size) {
-        M_ArenaPopTo(arena, offset - size);
-    }
+internal void _QuickSortSort3(_SortContext *ctx, U8 *a, U8 *b, U8 *c) {
+    _QuickSortSort2(ctx, a, b);
+    _QuickSortSort2(ctx, b, c);
+    _QuickSortSort2(ctx, a, b);
 }
 
-void M_ArenaPopLast(M_Arena *arena) {
-    M_Arena *current = arena->current;
+internal void _QuickSortSiftDown(_SortContext *ctx, U8 *array, S64 root, S64 count) {
+    U64 size = ctx->element_size;
 
-    // We know the last offset cannot span multiple arenas even with chained growth
-    // because single push allocations must be contiguous and thus be contained in a
-    // single arena
-    //
-    // this means popping the last allocation is a simple move of the offset
-    //
-    current->offset = current->last_offset;
+    for (S64 child = (2 * root) + 1; child < count; child = (2 * root) + 1) {
+        if ((child + 1) < count && _SortLess(ctx, array + (child * size), array + ((child + 1) * size))) {
+            child += 1;
+        }
+
+        if (!_SortLess(ctx, array + (root * size), array + (child * size))) { break; }
+
+        _SortSwap(array + (root * size), array + (child * size), size);
+        root = child;
+    }
 }
 
-// thread-local temporary arenas
-//
-#if !defined(M_TEMP_ARENA_COUNT)
-    #define M_TEMP_ARENA_COUNT 2
-#endif
+internal void _QuickSortHeap(_SortContext *ctx, U8 *begin, U8 *end) {
+    U64 size  = ctx->element_size;
+    S64 count = cast(S64) ((end - begin) / size);
 
-#if !defined(M_TEMP_ARENA_RESERVE_SIZE)
-    #define M_TEMP_ARENA_RESERVE_SIZE GB(4)
-#endif
+    for (S64 it = (count >> 1) - 1; it >= 0; --it) { _QuickSortSiftDown(ctx, begin, it, count); }
 
-thread_static M_Arena *__tls_temp[M_TEMP_ARENA_COUNT];
+    for (S64 it = count - 1; it > 0; --it) {
+        _SortSwap(begin, begin + (it * size), size);
+        _QuickSortSiftDown(ctx, begin, 0, it);
+    }
+}
 
-M_Temp M_AcquireTemp(U32 count, M_Arena **conflicts) {
-    M_Temp result;
+// partitions around the pivot at 'begin', elements equal to the pivot go to the right. returns
+// the final position of the pivot and whether the range was already partitioned
+//
+internal U8 *_QuickSortPartitionRight(_SortContext *ctx, U8 *begin, U8 *end, B32 *partitioned) {
+    U64 size  = ctx->element_size;
+    U8 *pivot = begin;
 
-    result.arena  = 0;
-    result.offset = 0;
+    U8 *first = begin;
+    U8 *last  = end;
 
-    for (U32 t = 0; t < M_TEMP_ARENA_COUNT; ++t) {
-        if (!__tls_temp[t]) { __tls_temp[t] = M_AllocArena(M_TEMP_ARENA_RESERVE_SIZE); }
+    do { first += size; } while (_SortLess(ctx, first, pivot));
 
-        M_Arena *arena = __tls_temp[t];
-        for (U32 c = 0; c < count; ++c) {
-            if (conflicts[c] == arena) {
-                arena = 0;
-                break;
-            }
+    // if the first element was already out of place nothing guards the backwards search so it
+    // has to be bounded, otherwise the element before 'first' stops it
+    //
+    if ((first - size) == begin) {
+        while (first < last) {
+            last -= size;
+            if (_SortLess(ctx, last, pivot)) { break; }
         }
+    }
+    else {
+        do { last -= size; } while (!_SortLess(ctx, last, pivot));
+    }
 
-        if (arena) {
-            result.arena  = arena;
-            result.offset = M_GetArenaOffset(arena);
+    *partitioned = (first >= last);
 
-            break;
-        }
+    while (first < last) {
+        _SortSwap(first, last, size);
+
+        do { first += size; } while (_SortLess(ctx, first, pivot));
+        do { last  -= size; } while (!_SortLess(ctx, last, pivot));
     }
 
-    Assert(result.arena != 0);
+    U8 *result = first - size;
+    if (result != begin) { _SortSwap(begin, result, size); }
 
     return result;
 }
 
-void M_ReleaseTemp(M_Temp temp) {
-    M_ArenaPopTo(temp.arena, temp.offset);
-}
-
-//
-// --------------------------------------------------------------------------------
-// :impl_strings
-// --------------------------------------------------------------------------------
+// used when the pivot is equal to the element before the range, which must be less than or equal
+// to everything in it. elements equal to the pivot go to the left so runs of duplicates are
+// skipped entirely rather than being partitioned again
 //
+internal U8 *_QuickSortPartitionLeft(_SortContext *ctx, U8 *begin, U8 *end) {
+    U64 size  = ctx->element_size;
+    U8 *pivot = begin;
 
-Str8 Str8_Wrap(S64 count, U8 *data) {
-    Str8 result;
-    result.count = count;
-    result.data  = data;
-
-    return result;
-}
+    U8 *first = begin;
+    U8 *last  = end;
 
-internal S64 CountLengthZ(U8 *zstr) {
-    S64 result = 0;
+    do { last -= size; } while (_SortLess(ctx, pivot, last));
 
-    while (zstr[result]) {
-        result += 1;
+    if ((last + size) == end) {
+        while (first < last) {
+            first += size;
+            if (_SortLess(ctx, pivot, first)) { break; }
+        }
+    }
+    else {
+        do { first += size; } while (!_SortLess(ctx, pivot, first));
     }
 
-    return result;
-}
+    while (first < last) {
+        _SortSwap(first, last, size);
 
-Str8 Str8_WrapZ(U8 *zstr) {
-    Str8 result;
-    result.count = CountLengthZ(zstr);
-    result.data  = zstr;
+        do { last  -= size; } while (_SortLess(ctx, pivot, last));
+        do { first += size; } while (!_SortLess(ctx, pivot, first));
+    }
+
+    U8 *result = last;
+    if (result != begin) { _SortSwap(begin, result, size); }
 
     return result;
 }
 
-Str8 Str8_WrapRange(U8 *start, U8 *end) {
-    Str8 result;
+internal void _QuickSortRange(_SortContext *ctx, U8 *begin, U8 *end, S32 bad_allowed, B32 leftmost) {
+    U64 size = ctx->element_size;
 
-    Assert(start <= end);
+    for (;;) {
+        S64 count = cast(S64) ((end - begin) / size);
 
-    result.count = cast(S64) (end - start);
-    result.data  = start;
+        if (count < QUICK_SORT_INSERTION_THRESHOLD) {
+            _SortInsertion(ctx, begin, end);
+            break;
+        }
 
-    return result;
-}
+        // select the pivot and move it to the start of the range
+        //
+        S64 half = count >> 1;
+        U8 *mid  = begin + (half * size);
 
-// will be null-terminated
-//
-Str8 Str8_Copy(M_Arena *arena, Str8 str) {
-    Str8 result;
-    result.count = str.count;
-    result.data  = cast(U8 *) M_CopySize(M_ArenaPush(arena, U8, str.count + 1), str.data, str.count);
+        if (count > QUICK_SORT_NINTHER_THRESHOLD) {
+            _QuickSortSort3(ctx, begin,              mid,          end - size);
+            _QuickSortSort3(ctx, begin + size,       mid - size,   end - (2 * size));
+            _QuickSortSort3(ctx, begin + (2 * size), mid + size,   end - (3 * size));
+            _QuickSortSort3(ctx, mid - size,         mid,          mid + size);
 
-    return result;
-}
+            _SortSwap(begin, mid, size);
+        }
+        else {
+            _QuickSortSort3(ctx, mid, begin, end - size);
+        }
 
-Str8 Str8_Concat(M_Arena *arena, Str8 a, Str8 b) {
-    Str8 result;
-    result.count = (a.count + b.count);
-    result.data  = M_ArenaPush(arena, U8, result.count + 1);
-
-    M_CopySize(result.data          , a.data, a.count);
-    M_CopySize(result.data + a.count, b.data, b.count);
+        // if the pivot is equal to the element before this range, which was the pivot of an
+        // earlier partition, everything equal to it can be placed and skipped at once
+        //
+        if (!leftmost && !_SortLess(ctx, begin - size, begin)) {
+            begin = _QuickSortPartitionLeft(ctx, begin, end) + size;
+            continue;
+        }
 
-    return result;
-}
+        B32 partitioned;
+        U8 *pivot = _QuickSortPartitionRight(ctx, begin, end, &partitioned);
 
-// string equality
-//
-B32 Str8_Equal(Str8 a, Str8 b, Str8_EqualFlags flags) {
-    B32 result;
+        S64 lcount = cast(S64) ((pivot - begin) / size);
+        S64 rcount = cast(S64) ((end - (pivot + size)) / size);
 
-    B32 ignore_case = (flags & STR8_EQUAL_FLAG_IGNORE_CASE) != 0;
-    B32 inexact_rhs = (flags & STR8_EQUAL_FLAG_INEXACT_RHS) != 0;
+        if (lcount < (count >> 3) || rcount < (count >> 3)) {
+            // a bad partition, after enough of these fall back to heap sort. otherwise shuffle
+            // some elements around to break up whatever pattern caused it
+            //
+            bad_allowed -= 1;
+            if (bad_allowed <= 0) {
+                _QuickSortHeap(ctx, begin, end);
+                break;
+            }
 
-    result = (a.count == b.count) || inexact_rhs;
+            if (lcount >= QUICK_SORT_INSERTION_THRESHOLD) {
+                S64 q = lcount >> 2;
 
-    if (result) {
-        S64 count = Min(a.count, b.count);
+                _SortSwap(begin,        begin + (q * size), size);
+                _SortSwap(pivot - size, pivot - (q * size), size);
 
-        for (S64 it = 0; it < count; ++it) {
-            U8 ca, cb;
-            if (ignore_case) {
-                ca = Chr_ToUppercase(a.data[it]);
-                cb = Chr_ToUppercase(b.data[it]);
-            }
-            else {
-                ca = a.data[it];
-                cb = b.data[it];
+                if (lcount > QUICK_SORT_NINTHER_THRESHOLD) {
+                    _SortSwap(begin + size,       begin + ((q + 1) * size), size);
+                    _SortSwap(begin + (2 * size), begin + ((q + 2) * size), size);
+                    _SortSwap(pivot - (2 * size), pivot - ((q + 1) * size), size);
+                    _SortSwap(pivot - (3 * size), pivot - ((q + 2) * size), size);
+                }
             }
 
-            if (ca != cb) {
-                result = false;
+            if (rcount >= QUICK_SORT_INSERTION_THRESHOLD) {
+                S64 q = rcount >> 2;
+
+                _SortSwap(pivot + size, pivot + ((q + 1) * size), size);
+                _SortSwap(end - size,   end - (q * size),         size);
+
+                if (rcount > QUICK_SORT_NINTHER_THRESHOLD) {
+                    _SortSwap(pivot + (2 * size), pivot + ((q + 2) * size), size);
+                    _SortSwap(pivot + (3 * size), pivot + ((q + 3) * size), size);
+                    _SortSwap(end - (2 * size),   end - ((q + 1) * size),   size);
+                    _SortSwap(end - (3 * size),   end - ((q + 2) * size),   size);
+                }
+            }
+        }
+        else if (partitioned) {
+            // no elements were moved so the input may already be sorted, try to finish both
+            // sides with a bounded insertion sort
+            //
+            if (_QuickSortPartialInsertion(ctx, begin, pivot) && _QuickSortPartialInsertion(ctx, pivot + size, end)) {
                 break;
             }
         }
-    }
 
-    return result;
+        // recurse into the smaller side and loop on the larger, the right side is never the
+        // leftmost range
+        //
+        if (lcount < rcount) {
+            _QuickSortRange(ctx, begin, pivot, bad_allowed, leftmost);
+
+            begin    = pivot + size;
+            leftmost = false;
+        }
+        else {
+            _QuickSortRange(ctx, pivot + size, end, bad_allowed, false);
+            end = pivot;
+        }
+    }
 }
 
-// @todo: probably want to move away from vsnprintf to allow us to have custom type
-// printing etc.
-//
-#include <stdio.h> // vsnprintf
+void _QuickSort(void *array, S64 count, CompareFunc *Compare, U64 element_size) {
+    if (count > 1) {
+        _SortContext ctx;
+        ctx.Compare      = Compare;
+        ctx.element_size = element_size;
 
-#if !defined(STR8_INITIAL_FORMAT_GUESS_SIZE)
-    #define STR8_INITIAL_FORMAT_GUESS_SIZE 1024
-#endif
+        U8 *begin = cast(U8 *) array;
+        U8 *end   = begin + (count * element_size);
 
-internal S64 Str8_ProcessFormat(U8 *buffer, S64 count, const char *format, va_list args) {
-    S64 result = vsnprintf((char *) buffer, count, format, args);
-    return result;
+        S32 bad_allowed = cast(S32) (63 - CountLeadingZeros_U64(cast(U64) count));
+        _QuickSortRange(&ctx, begin, end, bad_allowed, true);
+    }
 }
 
-Str8 Str8_FormatArgs(M_Arena *arena, const char *format, va_list args) {
-    Str8 result;
-
-    va_list copy;
-    va_copy(copy, args);
-
-    S64 buffer_size = STR8_INITIAL_FORMAT_GUESS_SIZE;
-    U8 *buffer      = M_ArenaPush(arena, U8, buffer_size);
+// radix sort implementation
+//
+// keys are first converted in place to unsigned values with the same ordering, which is
+// combined with building the histograms for every digit so the input is only read once before
+// the scatter passes. each pass scatters from one buffer into the other and passes where every
+// key has the same digit are skipped entirely, which is common for small values or keys that
+// share their high bits. keys are converted back after the final pass
+//
+#if !defined(RADIX_SORT_DIGIT_BITS)
+    #define RADIX_SORT_DIGIT_BITS 11
+#endif
 
-    S64 count = Str8_ProcessFormat(buffer, buffer_size, format, args);
-    if (count >= buffer_size) {
-        // not enough space in the initial guess so pop the entire buffer, push the
-        // correct size and process format again
-        //
-        M_ArenaPopLast(arena);
+#define RADIX_SORT_BUCKETS (1 << RADIX_SORT_DIGIT_BITS)
+#define RADIX_SORT_MASK    (RADIX_SORT_BUCKETS - 1)
 
-        result.count = count;
-        result.data  = M_ArenaPush(arena, U8, result.count + 1);
+#define RADIX_SORT_PASSES_32 ((32 + RADIX_SORT_DIGIT_BITS - 1) / RADIX_SORT_DIGIT_BITS)
+#define RADIX_SORT_PASSES_64 ((64 + RADIX_SORT_DIGIT_BITS - 1) / RADIX_SORT_DIGIT_BITS)
 
-        Str8_ProcessFormat(result.data, result.count + 1, format, copy);
-    }
-    else if (count < 0) {
-        // error occurred
-        //
-        M_ArenaPopLast(arena);
+typedef U32 _RadixKey;
+enum {
+    _RADIX_KEY_UNSIGNED = 0,
+    _RADIX_KEY_SIGNED,
+    _RADIX_KEY_FLOAT
+};
 
-        result.count = 0;
-        result.data  = 0;
-    }
-    else {
-        // initial size was enough, pop any unused portion of the initial buffer
-        //
-        result.count = count;
-        result.data  = buffer;
+// signed keys flip the sign bit, negative floats flip every bit so larger magnitudes order first
+// and positive floats flip just the sign bit
+//
+internal U32 _RadixToSortable_U32(U32 key, _RadixKey type) {
+    U32 result = key;
 
-        // we keep the null-terminating byte
-        //
-        M_ArenaPopSize(arena, buffer_size - count - 1);
-    }
+    if (type == _RADIX_KEY_SIGNED)     { result ^= 0x80000000; }
+    else if (type == _RADIX_KEY_FLOAT) { result ^= (cast(U32) (cast(S32) key >> 31) | 0x80000000); }
 
     return result;
 }
 
-Str8 Str8_Format(M_Arena *arena, const char *format, ...) {
-    Str8 result;
-
-    va_list args;
-    va_start(args, format);
-
-    result = Str8_FormatArgs(arena, format, args);
+internal U32 _RadixFromSortable_U32(U32 key, _RadixKey type) {
+    U32 result = key;
 
-    va_end(args);
+    if (type == _RADIX_KEY_SIGNED)     { result ^= 0x80000000; }
+    else if (type == _RADIX_KEY_FLOAT) { result ^= (((key >> 31) - 1) | 0x80000000); }
 
     return result;
 }
 
-// string slicing, all counts are in bytes
-//
-Str8 Str8_Prefix(Str8 str, S64 count) {
-    Str8 result;
-    result.count = Min(str.count, count);
-    result.data  = str.data;
+internal U64 _RadixToSortable_U64(U64 key, _RadixKey type) {
+    U64 result = key;
+
+    if (type == _RADIX_KEY_SIGNED) { result ^= 0x8000000000000000ULL; }
 
     return result;
 }
 
-Str8 Str8_Suffix(Str8 str, S64 count) {
-    Str8 result;
-    result.count = Min(str.count, count);
-    result.data  = str.data + (str.count - result.count);
+internal U64 _RadixFromSortable_U64(U64 key, _RadixKey type) {
+    U64 result = key;
+
+    if (type == _RADIX_KEY_SIGNED) { result ^= 0x8000000000000000ULL; }
 
     return result;
 }
 
-Str8 Str8_Advance(Str8 str, S64 count) {
-    Str8 result;
-    result.count = str.count - Min(str.count, count);
-    result.data  = str.data  + Min(str.count, count);
+internal void _RadixSort32(M_Arena *arena, U32 *keys, U32 *values, S64 count, _RadixKey type) {
+    if (count > 1) {
+        U64 offset = M_GetArenaOffset(arena);
 
-    return result;
-}
+        U64 *histograms = M_ArenaPush(arena, U64, RADIX_SORT_PASSES_32 * RADIX_SORT_BUCKETS);
 
-Str8 Str8_Remove(Str8 str, S64 count) {
-    Str8 result;
-    result.count = str.count - Min(str.count, count);
-    result.data  = str.data;
+        U32 *src_keys   = keys;
+        U32 *src_values = values;
 
-    return result;
-}
+        U32 *dst_keys   = M_ArenaPush(arena, U32, count, M_ARENA_NO_ZERO);
+        U32 *dst_values = values ? M_ArenaPush(arena, U32, count, M_ARENA_NO_ZERO) : 0;
 
-Str8 Str8_Slice(Str8 str, S64 start, S64 end) {
-    Str8 result;
+        for (S64 it = 0; it < count; ++it) {
+            U32 key = _RadixToSortable_U32(keys[it], type);
+            keys[it] = key;
 
-    Assert(start <= end);
+            for (U32 pass = 0; pass < RADIX_SORT_PASSES_32; ++pass) {
+                histograms[(pass * RADIX_SORT_BUCKETS) + ((key >> (pass * RADIX_SORT_DIGIT_BITS)) & RADIX_SORT_MASK)] += 1;
+            }
+        }
 
-    result.count = Min(str.count, end - start);
-    result.data  = str.data + Min(str.count, start);
+        for (U32 pass = 0; pass < RADIX_SORT_PASSES_32; ++pass) {
+            U32  shift     = pass * RADIX_SORT_DIGIT_BITS;
+            U64 *histogram = histograms + (pass * RADIX_SORT_BUCKETS);
 
-    return result;
-}
+            if (histogram[(src_keys[0] >> shift) & RADIX_SORT_MASK] == cast(U64) count) { continue; }
 
-// these are ascii only and are meant to be used with char literals
-//
-// including the found character
-//
-Str8 Str8_RemoveAfterFirst(Str8 str, U8 chr) {
-    Str8 result = str;
+            U64 total = 0;
+            for (U32 it = 0; it < RADIX_SORT_BUCKETS; ++it) {
+                U64 bucket = histogram[it];
 
-    for (S64 it = 0; it < str.count; ++it) {
-        if (str.data[it] == chr) {
-            result = Str8_Prefix(str, it);
-            break;
-        }
-    }
+                histogram[it] = total;
+                total += bucket;
+            }
 
-    return result;
-}
+            if (values) {
+                for (S64 it = 0; it < count; ++it) {
+                    U32 key   = src_keys[it];
+                    U64 index = histogram[(key >> shift) & RADIX_SORT_MASK]++;
 
-Str8 Str8_RemoveAfterLast(Str8 str, U8 chr) {
-    Str8 result = str;
+                    dst_keys[index]   = key;
+                    dst_values[index] = src_values[it];
+                }
+            }
+            else {
+                for (S64 it = 0; it < count; ++it) {
+                    U32 key = src_keys[it];
+                    dst_keys[histogram[(key >> shift) & RADIX_SORT_MASK]++] = key;
+                }
+            }
 
-    for (S64 it = str.count - 1; it >= 0; --it) {
-        if (str.data[it] == chr) {
-            result = Str8_Prefix(str, it);
-            break;
-        }
-    }
+            U32 *swap_keys   = src_keys;
+            U32 *swap_values = src_values;
 
-    return result;
-}
+            src_keys   = dst_keys;
+            src_values = dst_values;
+            dst_keys   = swap_keys;
+            dst_values = swap_values;
+        }
 
-Str8 Str8_RemoveBeforeFirst(Str8 str, U8 chr) {
-    Str8 result = str;
+        if (src_keys != keys) {
+            M_CopySize(keys, src_keys, count * sizeof(U32));
+            if (values) { M_CopySize(values, src_values, count * sizeof(U32)); }
+        }
 
-    for (S64 it = 0; it < str.count; ++it) {
-        if (str.data[it] == chr) {
-            result = Str8_Suffix(str, str.count - it - 1);
-            break;
+        if (type != _RADIX_KEY_UNSIGNED) {
+            for (S64 it = 0; it < count; ++it) { keys[it] = _RadixFromSortable_U32(keys[it], type); }
         }
-    }
 
-    return result;
+        M_ArenaPopTo(arena, offset);
+    }
 }
 
-Str8 Str8_RemoveBeforeLast(Str8 str, U8 chr) {
-    Str8 result = str;
+internal void _RadixSort64(M_Arena *arena, U64 *keys, U64 *values, S64 count, _RadixKey type) {
+    if (count > 1) {
+        U64 offset = M_GetArenaOffset(arena);
 
-    for (S64 it = str.count - 1; it >= 0; --it) {
-        if (str.data[it] == chr) {
-            result = Str8_Suffix(str, str.count - it - 1);
-            break;
-        }
-    }
+        U64 *histograms = M_ArenaPush(arena, U64, RADIX_SORT_PASSES_64 * RADIX_SORT_BUCKETS);
 
-    return result;
-}
+        U64 *src_keys   = keys;
+        U64 *src_values = values;
 
-Str8 Str8_GetBasename(Str8 path) {
-    Str8 result = path;
+        U64 *dst_keys   = M_ArenaPush(arena, U64, count, M_ARENA_NO_ZERO);
+        U64 *dst_values = values ? M_ArenaPush(arena, U64, count, M_ARENA_NO_ZERO) : 0;
 
-    for (S64 it = path.count - 1; it >= 0; --it) {
-        if (Chr_IsPathSeparator(path.data[it])) {
-            result = Str8_Suffix(path, path.count - it - 1);
-            break;
+        for (S64 it = 0; it < count; ++it) {
+            U64 key = _RadixToSortable_U64(keys[it], type);
+            keys[it] = key;
+
+            for (U32 pass = 0; pass < RADIX_SORT_PASSES_64; ++pass) {
+                histograms[(pass * RADIX_SORT_BUCKETS) + ((key >> (pass * RADIX_SORT_DIGIT_BITS)) & RADIX_SORT_MASK)] += 1;
+            }
         }
-    }
 
-    return result;
-}
+        for (U32 pass = 0; pass < RADIX_SORT_PASSES_64; ++pass) {
+            U32  shift     = pass * RADIX_SORT_DIGIT_BITS;
+            U64 *histogram = histograms + (pass * RADIX_SORT_BUCKETS);
 
-Str8 Str8_GetDirname(Str8 path) {
-    // if a path separator isn't found, use 'current working directory'
-    //
-    Str8 result = Sl(".");
+            if (histogram[(src_keys[0] >> shift) & RADIX_SORT_MASK] == cast(U64) count) { continue; }
 
-    for (S64 it = path.count - 1; it >= 0; --it) {
-        if (Chr_IsPathSeparator(path.data[it])) {
-            result = Str8_Prefix(path, it);
-            break;
-        }
-    }
+            U64 total = 0;
+            for (U32 it = 0; it < RADIX_SORT_BUCKETS; ++it) {
+                U64 bucket = histogram[it];
 
-    return result;
-}
+                histogram[it] = total;
+                total += bucket;
+            }
 
-Str8 Str8_GetExtension(Str8 path) {
-    Str8 result = Sl(""); // if '.' is not found, no extension
+            if (values) {
+                for (S64 it = 0; it < count; ++it) {
+                    U64 key   = src_keys[it];
+                    U64 index = histogram[(key >> shift) & RADIX_SORT_MASK]++;
 
-    for (S64 it = path.count - 1; it >= 0; --it) {
-        if (path.data[it] == '.') {
-            result = Str8_Suffix(path, path.count - it - 1);
-            break;
-        }
-    }
+                    dst_keys[index]   = key;
+                    dst_values[index] = src_values[it];
+                }
+            }
+            else {
+                for (S64 it = 0; it < count; ++it) {
+                    U64 key = src_keys[it];
+                    dst_keys[histogram[(key >> shift) & RADIX_SORT_MASK]++] = key;
+                }
+            }
 
-    return result;
-}
+            U64 *swap_keys   = src_keys;
+            U64 *swap_values = src_values;
 
-Str8 Str8_StripExtension(Str8 path) {
-    Str8 result = path;
+            src_keys   = dst_keys;
+            src_values = dst_values;
+            dst_keys   = swap_keys;
+            dst_values = swap_values;
+        }
 
-    for (S64 it = path.count - 1; it >= 0; --it) {
-        if (path.data[it] == '.') {
-            result = Str8_Prefix(path, it);
-            break;
+        if (src_keys != keys) {
+            M_CopySize(keys, src_keys, count * sizeof(U64));
+            if (values) { M_CopySize(values, src_values, count * sizeof(U64)); }
         }
+
+        if (type != _RADIX_KEY_UNSIGNED) {
+            for (S64 it = 0; it < count; ++it) { keys[it] = _RadixFromSortable_U64(keys[it], type); }
+        }
+
+        M_ArenaPopTo(arena, offset);
     }
+}
 
-    return result;
+void RadixSort_U32(M_Arena *arena, U32 *keys, S64 count) {
+    _RadixSort32(arena, keys, 0, count, _RADIX_KEY_UNSIGNED);
 }
 
-Codepoint UTF8_Decode(Str8 str) {
-    Codepoint result;
+void RadixSort_U64(M_Arena *arena, U64 *keys, S64 count) {
+    _RadixSort64(arena, keys, 0, count, _RADIX_KEY_UNSIGNED);
+}
 
-    local_persist const U8 lengths[] = {
-        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
-        0, 0, 0, 0, 0, 0, 0, 0, 2, 2, 2, 2, 3, 3, 4, 0
-    };
+void RadixSort_S32(M_Arena *arena, S32 *keys, S64 count) {
+    _RadixSort32(arena, cast(U32 *) keys, 0, count, _RADIX_KEY_SIGNED);
+}
 
-    local_persist const U32 masks[] = { 0x00, 0x7F, 0x1F, 0x0F, 0x07 };
+void RadixSort_S64(M_Arena *arena, S64 *keys, S64 count) {
+    _RadixSort64(arena, cast(U64 *) keys, 0, count, _RADIX_KEY_SIGNED);
+}
 
-    if (str.count > 0) {
-        U8 *data = str.data;
-
-        U32 len   = lengths[data[0] >> 3];
-        U32 avail = cast(U32) Min(len, str.count);
-
-        U32 codepoint = data[0] & masks[len];
+void RadixSort_F32(M_Arena *arena, F32 *keys, S64 count) {
+    _RadixSort32(arena, cast(U32 *) keys, 0, count, _RADIX_KEY_FLOAT);
+}
 
-        for (U32 it = 1; it < avail; ++it) {
-            codepoint <<= 6;
-            codepoint  |= (data[it] & 0x3F);
-        }
+void RadixSortPairs_U32(M_Arena *arena, U32 *keys, U32 *values, S64 count) {
+    _RadixSort32(arena, keys, values, count, _RADIX_KEY_UNSIGNED);
+}
 
-        // don't go past the end of the string, may produce invalid codepoints
-        //
-        result.count = avail;
-        result.value = codepoint;
-    }
-    else {
-        result.value = '?';
-        result.count =  1 ;
-    }
+void RadixSortPairs_U64(M_Arena *arena, U64 *keys, U64 *values, S64 count) {
+    _RadixSort64(arena, keys, values, count, _RADIX_KEY_UNSIGNED);
+}
 
-    return result;
+void RadixSortPairs_F32(M_Arena *arena, F32 *keys, U32 *values, S64 count) {
+    _RadixSort32(arena, cast(U32 *) keys, values, count, _RADIX_KEY_FLOAT);
 }
 
-U32 UTF8_Encode(U8 *output, U32 codepoint) {
-    U32 result;
+//
+// --------------------------------------------------------------------------------
+// :impl_arena
+// --------------------------------------------------------------------------------
+//
 
-    if (codepoint <= 0x7F) {
-        output[0] = cast(U8) codepoint;
-        result    = 1;
-    }
-    else if (codepoint <= 0x7FF) {
-        output[0] = ((codepoint >> 6) & 0x1F) | 0xC0;
-        output[1] = ((codepoint >> 0) & 0x3F) | 0x80;
-        result    = 2;
-    }
-    else if (codepoint <= 0xFFFF) {
-        output[0] = ((codepoint >> 12) & 0x0F) | 0xE0;
-        output[1] = ((codepoint >>  6) & 0x3F) | 0x80;
-        output[2] = ((codepoint >>  0) & 0x3F) | 0x80;
-        result    = 3;
-    }
-    else if (codepoint <= 0x10FFFF) {
-        output[0] = ((codepoint >> 18) & 0x07) | 0xF0;
-        output[1] = ((codepoint >> 12) & 0x3F) | 0x80;
-        output[2] = ((codepoint >>  6) & 0x3F) | 0x80;
-        output[3] = ((codepoint >>  0) & 0x3F) | 0x80;
-        result    = 4;
-    }
-    else {
-        output[0] = '?';
-        result    =  1 ;
-    }
+internal U64 __M_GetHugePageSize() {
+    U64 result = __os_system_info.huge_page_size;
+    if (result == 0) { result = MB(2); }
 
     return result;
 }
 
-// character utilities
+#if OS_WINDOWS
+
 //
-B32 Chr_IsWhitespace(U8 c) {
-    B32 result = (c == ' ') || (c == '\n') || (c == '\r') || (c == '\t') || (c == '\f') || (c == '\v');
+// :windows_arena
+//
+
+void *M_Reserve(U64 size) {
+    void *result = VirtualAlloc(0, size, MEM_RESERVE, PAGE_NOACCESS);
     return result;
 }
 
-B32 Chr_IsAlpha(U8 c) {
-    B32 result = Chr_IsUppercase(c) || Chr_IsLowercase(c);
+B32 M_Commit(void *base, U64 size) {
+    B32 result = VirtualAlloc(base, size, MEM_COMMIT, PAGE_READWRITE) != 0;
     return result;
 }
 
-B32 Chr_IsUppercase(U8 c) {
-    B32 result = (c >= 'A' && c <= 'Z');
-    return result;
+void M_Decommit(void *base, U64 size) {
+    VirtualFree(base, size, MEM_DECOMMIT);
 }
 
-B32 Chr_IsLowercase(U8 c) {
-    B32 result = (c >= 'a' && c <= 'z');
-    return result;
+void M_Release(void *base, U64 size) {
+    (void) size;
+    VirtualFree(base, 0, MEM_RELEASE);
 }
 
-B32 Chr_IsNumber(U8 c) {
-    B32 result = (c >= '0' && c <= '9');
+// :note large pages on windows must be committed in their entirety when they are reserved and
+// require the lock memory privilege, this doesn't fit the reserve/commit model of the arena so
+// the huge page flags are ignored
+//
+internal void *__M_ReserveArena(U64 size, M_ArenaFlags *flags) {
+    *flags &= ~(M_ARENA_HUGE_PAGES | M_ARENA_HUGE_TLB);
+
+    void *result = M_Reserve(size);
     return result;
 }
 
-B32 Chr_IsHex(U8 c) {
-    B32 result = Chr_IsNumber(c) || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
-    return result;
+internal void __M_Prefault(void *base, U64 size) {
+    U64 page_size = M_GetPageSize();
+
+    for (U64 it = 0; it < size; it += page_size) {
+        volatile U8 *page = cast(volatile U8 *) base + it;
+        *page = *page;
+    }
 }
 
-B32 Chr_IsSlash(U8 c) {
-    B32 result = (c == '/') || (c == '\\');
+internal B32 __M_MapFile(void *base, U64 size, OS_Handle file, U64 offset) {
+    (void) base;
+    (void) size;
+    (void) file;
+    (void) offset;
+
+    // file views can't be placed inside an existing VirtualAlloc reservation without the
+    // placeholder api, which isn't available on all supported versions, so fallback to reading
+    //
+    B32 result = false;
     return result;
 }
 
-B32 Chr_IsPathSeparator(U8 c) {
-#if OS_WINDOWS
-    B32 result = (c == '/') || (c == '\\');
-#else
-    B32 result = (c == '/');
-#endif
+internal U64 __M_ArenaHugePageBytes(M_Arena *arena) {
+    (void) arena;
 
+    U64 result = 0;
     return result;
 }
 
-U8 Chr_ToUppercase(U8 c) {
-    U8 result = Chr_IsLowercase(c) ? (c - ('a' - 'A')) : c;
+// these are cached by OS_Init, we only fall back to asking the system if they are used
+// before initialisation
+//
+U64 M_GetPageSize() {
+    U64 result = __os_system_info.page_size;
+    if (result == 0) {
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+
+        result = info.dwPageSize;
+    }
+
     return result;
 }
 
-U8 Chr_ToLowercase(U8 c) {
-    U8 result = Chr_IsUppercase(c) ? (c + ('a' - 'A')) : c;
+U64 M_GetAllocationGranularity() {
+    U64 result = __os_system_info.allocation_granularity;
+    if (result == 0) {
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+
+        result = info.dwAllocationGranularity;
+    }
+
     return result;
 }
 
+#elif OS_MACOS
+    #error "macOS memory subsystem not implemented"
+#elif OS_LINUX
+
 //
-// --------------------------------------------------------------------------------
-// :impl_stream
-// --------------------------------------------------------------------------------
+// :linux_arena
 //
 
-internal STREAM_REFILL(Stream_RefillZeros) {
-    Stream_Error result = stream->error;
+#include <sys/mman.h>
+#include <unistd.h>
 
-    local_persist U8 zeros[64];
+#if !defined(MAP_ANON)
+    #define MAP_ANON MAP_ANONYMOUS
+#endif
 
-    stream->start = zeros;
-    stream->end   = zeros + sizeof(zeros);
-    stream->pos   = zeros;
+void *M_Reserve(U64 size) {
+    void *ptr = mmap(0, size, PROT_NONE, MAP_PRIVATE | MAP_ANON, -1, 0);
 
+    void *result = (ptr == MAP_FAILED) ? 0 : ptr;
     return result;
 }
 
-internal STREAM_REFILL(Stream_RefillMemory) {
-    Stream_Error result = Stream_Fail(stream, STREAM_ERROR_READ_PAST_END);
+B32 M_Commit(void *base, U64 size) {
+    B32 result = mprotect(base, size, PROT_READ | PROT_WRITE) == 0;
     return result;
 }
 
-void Stream_Zero(Stream_Context *stream) {
-    stream->bit_buffer = 0;
-    stream->bit_count  = 0;
-
-    stream->error = STREAM_ERROR_NONE;
+void M_Decommit(void *base, U64 size) {
+    madvise(base, size, MADV_DONTNEED);
+    mprotect(base, size, PROT_NONE);
+}
 
-    stream->RefillFunc = Stream_RefillZeros;
-    stream->RefillFunc(stream);
+void M_Release(void *base, U64 size) {
+    munmap(base, size);
 }
 
-void Stream_FromMemory(Stream_Context *stream, Str8 memory) {
-    stream->bit_buffer = 0;
-    stream->bit_count  = 0;
+internal void *__M_ReserveArena(U64 size, M_ArenaFlags *flags) {
+    void *result = 0;
 
-    stream->error = STREAM_ERROR_NONE;
+    if (*flags & M_ARENA_HUGE_TLB) {
+#if defined(MAP_HUGETLB)
+        // private hugetlb mappings reserve pages from the pool up front, so if this succeeds
+        // later faults are guaranteed to be satisfied
+        //
+        void *ptr = mmap(0, size, PROT_NONE, MAP_PRIVATE | MAP_ANON | MAP_HUGETLB, -1, 0);
+        if (ptr != MAP_FAILED) { result = ptr; }
+#endif
 
-    stream->start = memory.data;
-    stream->end   = memory.data + memory.count;
-    stream->pos   = memory.data;
+        if (!result) {
+            *flags &= ~M_ARENA_HUGE_TLB;
+            *flags |=  M_ARENA_HUGE_PAGES;
+        }
+    }
 
-    stream->RefillFunc = Stream_RefillMemory;
-}
+    if (!result && (*flags & M_ARENA_HUGE_PAGES)) {
+        // over-reserve and trim the ends so the base is huge page aligned, otherwise the first
+        // and last partial huge pages are never eligible to be collapsed
+        //
+        U64 alignment = __M_GetHugePageSize();
 
-Stream_Error Stream_Fail(Stream_Context *stream, Stream_Error err) {
-    Stream_Error result;
+        void *ptr = mmap(0, size + alignment, PROT_NONE, MAP_PRIVATE | MAP_ANON, -1, 0);
+        if (ptr != MAP_FAILED) {
+            U64 start   = cast(U64) ptr;
+            U64 aligned = AlignUp(start, alignment);
 
-    stream->error      = err;
-    stream->RefillFunc = Stream_RefillZeros;
+            U64 head = aligned - start;
+            U64 tail = alignment - head;
 
-    result = stream->RefillFunc(stream);
-    return result;
-}
+            if (head != 0) { munmap(ptr, head); }
+            if (tail != 0) { munmap(cast(void *) (aligned + size), tail); }
 
-// Bit functions
-//
-void Stream_RefillBits(Stream_Context *stream) {
-    // @todo: think about how to handle this if we need more than 32-bits
-    // in our bit buffer.
-    //
-    // If we have a larger amount it may cause over-reads where the codec
-    // has specifically put mechanisms in place to prevent them. This could
-    // potentially cause a refill call when it was unexpected by client code
-    // and will desync the entire bitstream
-    //
-    // for example in PNG during the DEFLATE stage a BTYPE of 0 will first
-    // align the bitstream to a byte boundary and then read two 16 bit
-    // values, as 32-bits is the maximum it will read this guarantees the
-    // bit buffer/count will be zero after. Thus when copying literals directly
-    // (which updates the streams 'pos') there is no worry about having to
-    // flush the bit buffer or over-reading.
-    //
-    // One option could be to fill the bit buffer without actually consuming bytes
-    // and only update the "pos" pointer when consuming bits instead. However,
-    // this has the issue of having to do a "dummy" refill to lookahead if
-    // we reach the end of the stream section
-    //
-    // We could just require the max number of bits to be provided to the
-    // this refill bits call
-    //
+            result = cast(void *) aligned;
 
-    for (; stream->bit_count <= 24; stream->bit_count += 8) {
-        if (stream->pos == stream->end) {
-            // We have run out of bytes to put into the bit buffer so
-            // attempt to refill, if on failure it will produce the virtual
-            // zero stream and pad the extra bytes to zero
-            //
-            stream->RefillFunc(stream);
+#if defined(MADV_HUGEPAGE)
+            if (madvise(result, size, MADV_HUGEPAGE) != 0) { *flags &= ~M_ARENA_HUGE_PAGES; }
+#else
+            *flags &= ~M_ARENA_HUGE_PAGES;
+#endif
         }
-
-        stream->bit_buffer |= (*stream->pos++ << stream->bit_count);
     }
-}
 
-void Stream_ConsumeBits(Stream_Context *stream, U32 count) {
-    Assert(stream->bit_count >= count);
+    if (!result && (*flags & (M_ARENA_HUGE_PAGES | M_ARENA_HUGE_TLB)) == 0) {
+        result = M_Reserve(size);
+    }
 
-    stream->bit_buffer >>= count;
-    stream->bit_count   -= count;
+    return result;
 }
 
-U32 Stream_PeekBits(Stream_Context *stream, U32 count) {
-    Assert(count < 32);
+internal void __M_Prefault(void *base, U64 size) {
+    B32 populated = false;
 
-    if (stream->bit_count < count) {
-        // Not enough bit, refill!
+#if defined(MADV_POPULATE_WRITE)
+    populated = madvise(base, size, MADV_POPULATE_WRITE) == 0;
+#endif
+
+    if (!populated) {
+        // older kernels don't support populating with madvise, so touch each page manually
+        // instead. this doesn't modify the contents so the memory remains known to be zero
         //
-        Stream_RefillBits(stream);
-    }
+        U64 page_size = M_GetPageSize();
 
-    // this works with zero count
-    //
-    U32 result = stream->bit_buffer & ((1ULL << count) - 1);
-    return result;
+        for (U64 it = 0; it < size; it += page_size) {
+            volatile U8 *page = cast(volatile U8 *) base + it;
+            *page = *page;
+        }
+    }
 }
 
-// This will peek and then consume 'count' bits in one go
+// maps the file copy-on-write over the start of a reserved region, writes are private to this
+// process and never modify the file
 //
-U32 Stream_ReadBits(Stream_Context *stream, U32 count) {
-    U32 result = Stream_PeekBits(stream, count);
+internal B32 __M_MapFile(void *base, U64 size, OS_Handle file, U64 offset) {
+    int fd = cast(int) file.v[0];
 
-    Stream_ConsumeBits(stream, count);
+    void *ptr = mmap(base, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fd, offset);
+
+    B32 result = (ptr == base);
     return result;
 }
 
+// the only reliable way to find out whether huge pages were actually used to back a mapping is
+// to ask the kernel via smaps, this is slow so it is only done when stats are requested
 //
-// --------------------------------------------------------------------------------
-// :impl_logging
-// --------------------------------------------------------------------------------
-//
+internal U64 __M_ArenaHugePageBytes(M_Arena *arena) {
+    U64 result = 0;
 
-#if !defined(LOG_CONTEXT_ARENA_SIZE)
-    #define LOG_CONTEXT_ARENA_SIZE MB(64)
-#endif
+    int fd = open("/proc/self/smaps", O_RDONLY);
+    if (fd >= 0) {
+        U8  buffer[4096];
+        U64 count = 0;
 
-thread_static Log_Context *__thread_logger;
+        B32 in_arena = false;
+        B32 eof      = false;
 
-Str8 Log_StrFromLevel(S32 level) {
-    Str8 result = S("Custom");
+        while (!eof) {
+            ssize_t nread = read(fd, buffer + count, sizeof(buffer) - count);
+            if (nread <= 0) { eof = true; }
+            else { count += nread; }
 
-    switch (level) {
-        case LOG_DEBUG: { result = S("Debug");   } break;
-        case LOG_INFO:  { result = S("Info");    } break;
-        case LOG_WARN:  { result = S("Warning"); } break;
-        case LOG_ERROR: { result = S("Error");   } break;
-        default: {} break;
+            U64 start = 0;
+            for (U64 it = 0; it < count; ++it) {
+                if (buffer[it] != '\n') { continue; }
+
+                Str8 line = Str8_Wrap(it - start, buffer + start);
+                start     = it + 1;
+
+                if (line.count == 0) { continue; }
+
+                if (Chr_IsHex(line.data[0]) && !Chr_IsUppercase(line.data[0])) {
+                    // mapping header in the form 'start-end perms ...'
+                    //
+                    U64 range[2] = { 0, 0 };
+
+                    S64 c = 0;
+                    for (U32 r = 0; r < 2; ++r, ++c) {
+                        for (; c < line.count && Chr_IsHex(line.data[c]); ++c) {
+                            U8 chr = Chr_ToLowercase(line.data[c]);
+                            range[r] = (range[r] << 4) | (Chr_IsNumber(chr) ? (chr - '0') : (chr - 'a' + 10));
+                        }
+                    }
+
+                    in_arena = false;
+
+                    M_Arena *chains[] = { arena->current, arena->large };
+                    for (U32 chain = 0; !in_arena && chain < ArraySize(chains); ++chain) {
+                        for (M_Arena *block = chains[chain]; block != 0; block = block->prev) {
+                            U64 block_start = cast(U64) block;
+                            U64 block_end   = block_start + block->limit;
+
+                            if (range[0] >= block_start && range[1] <= block_end) {
+                                in_arena = true;
+                                break;
+                            }
+                        }
+                    }
+                }
+                else if (in_arena) {
+                    Str8 key   = Str8_RemoveAfterFirst(line, ':');
+                    Str8 value = Str8_RemoveBeforeFirst(line, ':');
+
+                    if (Str8_Equal(key, S("AnonHugePages"), 0) || Str8_Equal(key, S("Private_Hugetlb"), 0)) {
+                        while (value.count && (value.data[0] == ':' || Chr_IsWhitespace(value.data[0]))) {
+                            value = Str8_Advance(value, 1);
+                        }
+
+                        result += KB(Linux_U64FromSysStr8(value));
+                    }
+                }
+            }
+
+            if (start == 0 && count == sizeof(buffer)) {
+                // line too long to fit in the buffer, none of the lines we care about are this
+                // long so just skip it
+                //
+                count = 0;
+            }
+            else {
+                M_CopySizeForward(buffer, buffer + start, count - start);
+                count -= start;
+            }
+        }
+
+        close(fd);
     }
 
     return result;
 }
 
-void Log_Init() {
-    if (__thread_logger == 0) {
-        M_Arena *arena  = M_AllocArena(LOG_CONTEXT_ARENA_SIZE);
+// these are cached by OS_Init, we only fall back to asking the system if they are used
+// before initialisation
+//
+U64 M_GetPageSize() {
+    U64 result = __os_system_info.page_size;
+    if (result == 0) { result = sysconf(_SC_PAGESIZE); }
 
-        __thread_logger = M_ArenaPush(arena, Log_Context);
-        __thread_logger->arena = arena;
+    return result;
+}
 
-        // Push a default scope for logging messages to
-        //
-        Log_PushScope();
-    }
+U64 M_GetAllocationGranularity() {
+    U64 result = __os_system_info.allocation_granularity;
+    if (result == 0) { result = sysconf(_SC_PAGESIZE); }
+
+    return result;
 }
 
-void Log_PushScope() {
-    U64 offset = M_GetArenaOffset(__thread_logger->arena);
+#elif OS_SWITCH
 
-    Log_Scope *scope = M_ArenaPush(__thread_logger->arena, Log_Scope);
-    scope->offset    = offset;
+//
+// :switch_arena
+//
+// we unfortunately don't have any other options to allocate memory with switchbrew,
+// malloc/free are the only userspace general address space allocators available to
+// us
+//
+#include <stdlib.h>
 
-    SLL_Push(__thread_logger->scopes, scope);
+void *M_Reserve(U64 size) {
+    void *result = malloc(size);
+    return result;
 }
 
-Log_MessageArray Log_PopScope(M_Arena *arena) {
-    Log_MessageArray result = ZERO(Log_MessageArray);
+B32 M_Commit(void *base, U64 size) {
+    (void) base;
+    (void) size;
 
-    Log_Scope *scope = __thread_logger->scopes;
-    Log_MessageList *messages = &scope->messages;
+    // already committed the entire region with malloc so nothing to do
+    //
+    B32 result = true;
+    return result;
+}
 
-    // Copy all of the messages into the result array, then
-    // remove pop the logger arena position back to the offset
+void M_Decommit(void *base, U64 size) {
+    (void) base;
+    (void) size;
+
+    // no decommit available because malloc/free so nothing to do
     //
-    if (messages->num_messages != 0) {
-        result.count = messages->num_messages;
-        result.items = M_ArenaPush(arena, Log_Message, result.count);
+}
 
-        Log_Message *src = messages->first;
-        for (U32 it = 0; it < result.count; ++it) {
-            Log_Message *dst = &result.items[it];
+void M_Release(void *base, U64 size) {
+    (void) size;
 
-            dst->next = dst + 1;
+    free(base);
+}
 
-            dst->code = src->code;
+internal void *__M_ReserveArena(U64 size, M_ArenaFlags *flags) {
+    *flags &= ~(M_ARENA_HUGE_PAGES | M_ARENA_HUGE_TLB);
 
-            dst->file = Str8_Copy(arena, src->file);
-            dst->func = Str8_Copy(arena, src->func);
-            dst->line = src->line;
+    void *result = M_Reserve(size);
+    return result;
+}
 
-            dst->message = Str8_Copy(arena, src->message);
+internal void __M_Prefault(void *base, U64 size) {
+    (void) base;
+    (void) size;
 
-            src = src->next;
-        }
+    // malloc has already given us the memory, nothing to do
+    //
+}
 
-        result.items[result.count - 1].next = 0;
-    }
+internal B32 __M_MapFile(void *base, U64 size, OS_Handle file, U64 offset) {
+    (void) base;
+    (void) size;
+    (void) file;
+    (void) offset;
 
-    __thread_logger->scopes = scope->next;
-    M_ArenaPopTo(__thread_logger->arena, scope->offset);
+    // no file mapping available, the caller will read the file instead
+    //
+    B32 result = false;
+    return result;
+}
 
-    if (__thread_logger->scopes == 0) {
-        // If all scopes have been popped, push a default scope
-        // so there is always one valid
-        //
-        Log_PushScope();
-    }
+internal U64 __M_ArenaHugePageBytes(M_Arena *arena) {
+    (void) arena;
 
+    U64 result = 0;
     return result;
 }
 
-void Log_PushMessageArgs(S32 code, Str8 file, U32 line, Str8 func, const char *format, va_list args) {
-    Assert(__thread_logger != 0);
+U64 M_GetPageSize() {
+    U64 result = 4096;
+    return result;
+}
 
-    Log_Message *node = M_ArenaPush(__thread_logger->arena, Log_Message);
+U64 M_GetAllocationGranularity() {
+    U64 result = 4096;
+    return result;
+}
 
-    // @todo: we probably don't have to copy the file/func each time
-    // because they are likely coming from the statically defined macro
-    // varaibles
-    //
-    node->code = code;
+#endif
 
-    node->file = Str8_Copy(__thread_logger->arena, file);
-    node->func = Str8_Copy(__thread_logger->arena, func);
-    node->line = line;
+#define M_ARENA_MIN_OFFSET sizeof(M_Arena)
 
-    node->message = Str8_FormatArgs(__thread_logger->arena, format, args);
+#if !defined(M_ARENA_COMMIT_SIZE)
+    #define M_ARENA_COMMIT_SIZE KB(64)
+#endif
 
-    // Pull the top scope and push the message onto its list
-    //
-    Log_MessageList *messages = &__thread_logger->scopes->messages;
+#if !defined(M_ARENA_MAX_RESERVE_SWITCH)
+    #define M_ARENA_MAX_RESERVE_SWITCH MB(8)
+#endif
 
-    SLL_Enqueue(messages->first, messages->last, node);
-    messages->num_messages += 1;
+#if !defined(M_ARENA_GROW_RESERVE_SIZE)
+    #define M_ARENA_GROW_RESERVE_SIZE MB(1)
+#endif
+
+// default maximum for the geometric commit step, see M_SetArenaCommitPolicy
+//
+#if !defined(M_ARENA_COMMIT_MAX_SIZE)
+    #define M_ARENA_COMMIT_MAX_SIZE MB(8)
+#endif
+
+// the number of resets or outermost temp releases per decay step of the decommit hysteresis,
+// must be between 1 and 16
+//
+#if !defined(M_ARENA_RETAIN_WINDOW)
+    #define M_ARENA_RETAIN_WINDOW 8
+#endif
+
+// whether memory returned from M_Commit after a reserve or M_Decommit is guaranteed to be
+// zero by the operating system, this allows the arena to skip clearing memory which has
+// never been handed out
+//
+#if OS_SWITCH
+    #define M_ARENA_COMMIT_IS_ZERO 0
+#else
+    #define M_ARENA_COMMIT_IS_ZERO 1
+#endif
+
+#define M_ARENA_HUGE_FLAGS (M_ARENA_HUGE_PAGES | M_ARENA_HUGE_TLB)
+
+// flags that are passed down from an arena to the blocks it chains when growing
+//
+#define M_ARENA_INHERIT_FLAGS (M_ARENA_HUGE_FLAGS | M_ARENA_PREFAULT)
+
+// the size commits are rounded to for a block, huge page backed blocks must commit in whole
+// huge pages otherwise the kernel can't use a huge page for the partially committed region
+//
+internal U64 __M_ArenaCommitGranularity(M_Arena *block) {
+    U64 result = M_ARENA_COMMIT_SIZE;
+    if (block->flags & M_ARENA_HUGE_FLAGS) { result = Max(result, __M_GetHugePageSize()); }
+
+    return result;
 }
 
-void Log_PushMessage(S32 code, Str8 file, U32 line, Str8 func, const char *format, ...) {
-    va_list args;
-    va_start(args, format);
+// arena instrumentation
+//
+#if !defined(M_ARENA_INFO_NAME_SIZE)
+    #define M_ARENA_INFO_NAME_SIZE 32
+#endif
 
-    Log_PushMessageArgs(code, file, line, func, format, args);
+struct M_ArenaInfo {
+    M_ArenaInfo *next;
+    M_ArenaInfo *prev;
 
-    va_end(args);
+    M_Arena *arena;
+
+    U32 name_count;
+    U8  name[M_ARENA_INFO_NAME_SIZE];
+
+    // a summary of the block chain published by the thread that owns the arena whenever it
+    // changes, M_DumpArenaStats only reads these as it can't safely walk the chain of an arena
+    // that another thread may be freeing blocks from
+    //
+    U64 reserved;
+    U64 committed;
+    U64 offset;
+    U64 chain_length;
+    U64 large_blocks;
+
+    U64 high_water;
+    U64 pushes;
+    U64 pops;
+    U64 resets;
+    U64 commits;
+    U64 decommits;
+    U64 bytes_zeroed;
+};
+
+#if M_ARENA_INSTRUMENT
+    // concurrent arenas have to update the counters atomically, everything else is only accessed
+    // by a single thread so it can be a plain add
+    //
+    #define __M_ArenaCount(arena, field, value) do { \
+        M_ArenaInfo *__info = (arena)->info; \
+        if (__info) { \
+            if ((arena)->flags & M_ARENA_CONCURRENT) { AtomicAdd_U64(&__info->field, (value)); } \
+            else { __info->field += (value); } \
+        } \
+    } while (0)
+
+    #define __M_ArenaStore(arena, field, value) do { \
+        M_ArenaInfo *__info = (arena)->info; \
+        if (__info) { \
+            if ((arena)->flags & M_ARENA_CONCURRENT) { AtomicExchange_U64(&__info->field, (value)); } \
+            else { __info->field = (value); } \
+        } \
+    } while (0)
+
+    #define __M_ArenaHighWater(arena, offset) do { \
+        M_ArenaInfo *__info = (arena)->info; \
+        if (__info) { \
+            if ((arena)->flags & M_ARENA_CONCURRENT) { \
+                for (U64 __hw = __info->high_water; (offset) > __hw; __hw = __info->high_water) { \
+                    if (AtomicCompareExchange_U64(&__info->high_water, (offset), __hw)) { break; } \
+                } \
+            } \
+            else if ((offset) > __info->high_water) { __info->high_water = (offset); } \
+        } \
+    } while (0)
+
+    // walks the block chain and publishes the summary to the arena info, this must only be called
+    // by the thread that owns the arena, or while holding the lock of a concurrent arena
+    //
+    internal void __M_ArenaPublish(M_Arena *arena) {
+        if (arena->info) {
+            U64 reserved     = 0;
+            U64 committed    = 0;
+            U64 chain_length = 0;
+            U64 large_blocks = 0;
+
+            for (M_Arena *block = arena->current; block != 0; block = block->prev) {
+                reserved  += block->limit;
+                committed += block->committed;
+
+                chain_length += 1;
+            }
+
+            for (M_Arena *block = arena->large; block != 0; block = block->prev) {
+                reserved  += block->limit;
+                committed += block->committed;
+
+                large_blocks += 1;
+            }
+
+            __M_ArenaStore(arena, reserved,     reserved);
+            __M_ArenaStore(arena, committed,    committed);
+            __M_ArenaStore(arena, chain_length, chain_length);
+            __M_ArenaStore(arena, large_blocks, large_blocks);
+            __M_ArenaStore(arena, offset,       M_GetArenaOffset(arena));
+        }
+    }
+#else
+    #define __M_ArenaCount(arena, field, value)
+    #define __M_ArenaStore(arena, field, value)
+    #define __M_ArenaHighWater(arena, offset)
+    #define __M_ArenaPublish(arena)
+#endif
+
+typedef struct M_ArenaRegistry M_ArenaRegistry;
+struct M_ArenaRegistry {
+    volatile U32 lock;
+
+    M_Arena *arena;
+    M_Pool  *pool;
+
+    M_ArenaInfo *first;
+    M_ArenaInfo *last;
+};
+
+global_var M_ArenaRegistry __m_arena_registry;
+
+internal void __M_LockArenaRegistry() {
+    while (!AtomicCompareExchange_U32(&__m_arena_registry.lock, 1, 0)) { SpinPause(); }
+}
+
+internal void __M_UnlockArenaRegistry() {
+    AtomicExchange_U32(&__m_arena_registry.lock, 0);
 }
 
+// block cache
 //
-// --------------------------------------------------------------------------------
-// :impl_filesystem
-// --------------------------------------------------------------------------------
+#if !defined(M_BLOCK_CACHE_BUDGET)
+    #define M_BLOCK_CACHE_BUDGET MB(64)
+#endif
+
+typedef struct M_BlockCache M_BlockCache;
+struct M_BlockCache {
+    volatile U32 lock;
+
+    M_Arena *blocks; // linked through 'prev'
+
+    U64 budget;
+    U64 cached_bytes;
+    U32 cached_blocks;
+
+    U64 hits;
+    U64 misses;
+};
+
+global_var M_BlockCache __m_block_cache = { 0, 0, M_BLOCK_CACHE_BUDGET };
+
+internal void __M_LockBlockCache() {
+    while (!AtomicCompareExchange_U32(&__m_block_cache.lock, 1, 0)) { SpinPause(); }
+}
+
+internal void __M_UnlockBlockCache() {
+    AtomicExchange_U32(&__m_block_cache.lock, 0);
+}
+
+// find a cached block that has at least 'limit' reserved and isn't excessively large for the
+// request, the huge page flags must match as they change how the block was reserved
 //
+internal M_Arena *__M_TakeCachedBlock(U64 limit, M_ArenaFlags flags) {
+    M_Arena *result = 0;
 
-#if OS_WINDOWS
+    M_BlockCache *cache = &__m_block_cache;
+
+    __M_LockBlockCache();
+
+    for (M_Arena **block = &cache->blocks; *block != 0; block = &(*block)->prev) {
+        M_Arena *it = *block;
+
+        B32 size_ok  = (it->limit >= limit) && (it->limit <= (limit << 1));
+        B32 flags_ok = (it->flags & M_ARENA_HUGE_FLAGS) == (flags & M_ARENA_HUGE_FLAGS);
+
+        if (size_ok && flags_ok) {
+            *block = it->prev;
+
+            cache->cached_bytes  -= it->limit;
+            cache->cached_blocks -= 1;
+
+            result = it;
+            break;
+        }
+    }
+
+    if (result) { cache->hits   += 1; }
+    else        { cache->misses += 1; }
+
+    __M_UnlockBlockCache();
+
+    return result;
+}
 
+// concurrent pushes don't maintain the known-zero and peak offsets as they can't be updated
+// atomically with the offset, however the offset only ever increases while pushing so we can
+// bring them up to date when the arena is next popped or reset
 //
-// :windows_filesystem
+internal void __M_ArenaSyncOffsets(M_Arena *block) {
+    U64 offset = Min(block->offset, block->committed);
+
+    block->zero_offset = Max(block->zero_offset, offset);
+    block->peak_offset = Max(block->peak_offset, offset);
+}
+
+// shared arenas are preceded by a header which other processes read the published offset
+// from, see M_AllocSharedArena
 //
+#define M_SHARED_ARENA_HEADER_SIZE KB(64)
 
-internal void Win32_ListPathRecurse(M_Arena *arena, FS_List *list, Str8 path, FS_ListFlags flags) {
-    M_Temp temp  = M_AcquireTemp(1, &arena);
+internal void __M_ReleaseBlock(M_Arena *block) {
+    M_BlockCache *cache = &__m_block_cache;
 
-    // we have to append the wildcard to search
+    __M_ArenaSyncOffsets(block);
+
+    B32 cached = false;
+
+    __M_LockBlockCache();
+
+    // blocks mapped from a snapshot are never cached as their contents can't be decommitted
     //
-    Str8 search_path = Sf(temp.arena, "%.*s\\*", Sv(path));
-    WCHAR *wpath     = Win32_WideFromStr8(temp.arena, search_path);
+    if (block->mapped_size == 0 && cache->cached_bytes + block->limit <= cache->budget) {
+        block->prev = cache->blocks;
+        cache->blocks = block;
 
-    B32 recurse        = (flags & FS_LIST_RECURSIVE)      != 0;
-    B32 include_hidden = (flags & FS_LIST_INCLUDE_HIDDEN) != 0;
+        cache->cached_bytes  += block->limit;
+        cache->cached_blocks += 1;
 
-    WIN32_FIND_DATAW find_data;
-    HANDLE find = FindFirstFileW(wpath, &find_data);
+        cached = true;
+    }
 
-    while (find != INVALID_HANDLE_VALUE) {
-        Str8 basename = Win32_Str8FromWide(temp.arena, find_data.cFileName);
+    __M_UnlockBlockCache();
+
+    if (!cached) {
+        if (block->flags & M_ARENA_SHARED) {
+            M_Release(cast(U8 *) block - M_SHARED_ARENA_HEADER_SIZE, block->limit + M_SHARED_ARENA_HEADER_SIZE);
+        }
+        else {
+            M_Release(cast(void *) block, block->limit);
+        }
+    }
+}
+
+// initialises the header of a block which has had 'committed' bytes committed, 'zero_offset' is
+// left as-is because it depends on where the memory came from
+//
+internal void __M_InitArenaBlock(M_Arena *block, U64 limit, U64 committed, M_ArenaFlags flags) {
+    block->current = block;
+    block->prev    = 0;
+
+    block->base        = 0;
+    block->limit       = limit;
+    block->offset      = M_ARENA_MIN_OFFSET;
+    block->last_offset = M_ARENA_MIN_OFFSET;
+
+    block->committed = committed;
+
+    block->flags = flags;
+    block->lock  = 0;
+
+    block->commit_step     = M_ARENA_COMMIT_SIZE;
+    block->commit_max_step = M_ARENA_COMMIT_MAX_SIZE;
+
+    block->peak_offset = M_ARENA_MIN_OFFSET;
+    block->retain_size = 0;
+
+    block->large = 0;
+    block->info  = 0;
+
+    block->mapped_size = 0;
+}
+
+internal M_Arena *__M_AllocSizedArena(U64 limit, U64 initial_commit, M_ArenaFlags flags) {
+    M_Arena *result = 0;
+
+    U64 page_size   = M_GetPageSize();
+    U64 granularity = M_GetAllocationGranularity();
+
+    if (flags & M_ARENA_HUGE_FLAGS) {
+        // blocks smaller than a huge page can never be backed by one, so don't bother
+        //
+        U64 huge_page_size = __M_GetHugePageSize();
+
+        if (limit >= huge_page_size) {
+            page_size   = huge_page_size;
+            granularity = huge_page_size;
+        }
+        else {
+            flags &= ~M_ARENA_HUGE_FLAGS;
+        }
+    }
+
+    // have at least the allocation granularity to reserve and at least the page size to commit
+    //
+    U64 to_reserve = Max(AlignUp(limit, granularity), granularity);
+    U64 to_commit  = Clamp(page_size, AlignUp(initial_commit, page_size), to_reserve);
+
+    M_Arena *cached = __M_TakeCachedBlock(to_reserve, flags);
+    if (cached != 0) {
+        // cached blocks retain their committed memory and their known-zero offset, we only need
+        // to commit more if the initial commit requested is larger than what the block has
+        //
+        if (cached->committed < to_commit) {
+            void *commit_base = cast(U8 *) cached + cached->committed;
+            U64   commit_size = Min(to_commit, cached->limit) - cached->committed;
+
+            if (M_Commit(commit_base, commit_size)) {
+                if (cached->flags & M_ARENA_PREFAULT) { __M_Prefault(commit_base, commit_size); }
+                cached->committed += commit_size;
+            }
+        }
+
+        to_reserve = cached->limit;
+        to_commit  = cached->committed;
+
+        flags = (flags & ~M_ARENA_HUGE_FLAGS) | (cached->flags & M_ARENA_HUGE_FLAGS);
+
+        result = cached;
+    }
+    else {
+        void *base = __M_ReserveArena(to_reserve, &flags);
+        if (base != 0) {
+            if (M_Commit(base, to_commit)) {
+                if (flags & M_ARENA_PREFAULT) { __M_Prefault(base, to_commit); }
+
+                result = cast(M_Arena *) base;
+                result->zero_offset = M_ARENA_COMMIT_IS_ZERO ? M_ARENA_MIN_OFFSET : to_reserve;
+            }
+        }
+    }
+
+    if (result != 0) { __M_InitArenaBlock(result, to_reserve, to_commit, flags); }
+
+    Assert(result != 0);
+
+    return result;
+}
+
+internal void __M_RegisterArena(M_Arena *arena) {
+#if M_ARENA_INSTRUMENT
+    M_ArenaRegistry *registry = &__m_arena_registry;
+
+    __M_LockArenaRegistry();
+
+    if (!registry->arena) {
+        // the registry arena isn't registered itself otherwise we would recurse
+        //
+        registry->arena = __M_AllocSizedArena(MB(1), M_ARENA_COMMIT_SIZE, 0);
+        registry->pool  = M_AllocPool(registry->arena, sizeof(M_ArenaInfo), AlignOf(M_ArenaInfo), 0);
+    }
+
+    M_ArenaInfo *info = cast(M_ArenaInfo *) M_PoolAlloc(registry->pool, 0);
+    info->arena = arena;
+
+    DLL_InsertBack(registry->first, registry->last, info);
+
+    __M_UnlockArenaRegistry();
+
+    arena->info = info;
+
+    __M_ArenaPublish(arena);
+#else
+    (void) arena;
+#endif
+}
+
+M_Arena *M_AllocArenaArgs(U64 limit, U64 initial_commit, M_ArenaFlags flags) {
+#if OS_SWITCH
+    // :note ~switch
+    //
+    // swtichbrew doesn't support virtual memory semantics, this means we can't just
+    // ask for 64GiB of virtual address space to commit later and get away with it
+    // like on other operating systems.
+    //
+    // to work around this we force growable arenas on and clamp the initial arena
+    // size to a more reasonable size
+    //
+    flags &= ~M_ARENA_DONT_GROW;
+    limit  = Min(limit, M_ARENA_MAX_RESERVE_SWITCH);
+#endif
+
+    M_Arena *result = __M_AllocSizedArena(limit, initial_commit, flags);
+    __M_RegisterArena(result);
+
+    return result;
+}
+
+M_Arena *M_AllocArena(U64 limit) {
+    M_Arena *result = M_AllocArenaArgs(limit, M_ARENA_COMMIT_SIZE, 0);
+    return result;
+}
+
+// decommits everything in the block beyond 'target', anything in use is always kept
+//
+internal void __M_ArenaDecommitTo(M_Arena *arena, M_Arena *block, U64 target) {
+    U64 granularity = __M_ArenaCommitGranularity(block);
+
+    target = AlignUp(Max(Max(target, block->offset), block->mapped_size), granularity);
+    target = Clamp(granularity, target, block->committed);
+
+    if (block->committed > target) {
+        M_Decommit(cast(U8 *) block + target, block->committed - target);
+        __M_ArenaCount(arena, decommits, 1);
+
+        // the retained commit region may have been written to, but everything that was
+        // decommitted will come back as zero
+        //
+        if (M_ARENA_COMMIT_IS_ZERO) { block->zero_offset = Min(block->zero_offset, target); }
+
+        block->committed = target;
+
+        __M_ArenaPublish(arena);
+    }
+
+    (void) arena;
+}
+
+// decommits the tail of a block after it has been reset or its outermost temp released. to
+// avoid thrashing when an arena is repeatedly grown and emptied the retained size only decays,
+// by half, after a whole window of M_ARENA_RETAIN_WINDOW releases in which none of them used
+// at least half of it. only memory beyond twice the retained size, or 'retain_min', is
+// decommitted
+//
+// this isn't done on every pop, a few small pops in a row would otherwise decay the retained
+// size enough to decommit a large region that is about to be used again
+//
+// there is no room left in the arena header so the low bits of 'retain_size' hold the window
+// state, the number of releases so far and whether any of them used the retained size
+//
+#define __M_ARENA_RETAIN_COUNT_MASK 0x0FULL
+#define __M_ARENA_RETAIN_USED       0x10ULL
+#define __M_ARENA_RETAIN_SIZE_MASK  (~0x1FULL)
+
+internal void __M_ArenaDecommitExcess(M_Arena *arena, M_Arena *block, U64 retain_min) {
+    U64 state  = block->retain_size;
+    U64 retain = state & __M_ARENA_RETAIN_SIZE_MASK;
+    U64 count  = (state & __M_ARENA_RETAIN_COUNT_MASK) + 1;
+    U64 peak   = AlignUp(block->peak_offset, 32);
+
+    B32 used = (state & __M_ARENA_RETAIN_USED) || (peak >= (retain >> 1));
+
+    if (count >= M_ARENA_RETAIN_WINDOW) {
+        if (!used) { retain = (retain >> 1) & __M_ARENA_RETAIN_SIZE_MASK; }
+
+        count = 0;
+        used  = false;
+    }
+
+    retain = Max(retain, peak);
+
+    block->retain_size = retain | count | (used ? __M_ARENA_RETAIN_USED : 0);
+    block->peak_offset = block->offset;
+
+    __M_ArenaDecommitTo(arena, block, Max(retain << 1, retain_min));
+}
+
+// unlike the hysteresis above this immediately decommits everything beyond 'retain' and
+// forgets the previous peak usage
+//
+internal void __M_ArenaTrim(M_Arena *arena, U64 retain) {
+    M_Arena *block = arena->current;
+
+    block->retain_size = Min(block->retain_size & __M_ARENA_RETAIN_SIZE_MASK, retain & __M_ARENA_RETAIN_SIZE_MASK);
+    block->peak_offset = block->offset;
+
+    __M_ArenaDecommitTo(arena, block, retain);
+}
+
+void M_SetArenaCommitPolicy(M_Arena *arena, U64 step, U64 max_step) {
+    arena->commit_step     = Max(step, M_ARENA_COMMIT_SIZE);
+    arena->commit_max_step = Max(max_step, arena->commit_step);
+}
+
+// releases all large blocks that were allocated after 'offset'
+//
+internal void __M_ArenaReleaseLarge(M_Arena *arena, U64 offset) {
+    while (arena->large != 0 && arena->large->base > offset) {
+        M_Arena *block = arena->large;
+        arena->large   = block->prev;
+
+        __M_ReleaseBlock(block);
+    }
+}
+
+void M_ResetArena(M_Arena *arena) {
+    __M_ArenaCount(arena, resets, 1);
+    __M_ArenaReleaseLarge(arena, 0);
+
+    M_Arena *current = arena->current;
+    while (current->prev != 0) {
+        M_Arena *block = current;
+        current = current->prev;
+
+        __M_ReleaseBlock(block);
+    }
+
+    Assert(current == arena);
+
+    __M_ArenaSyncOffsets(current);
+
+    current->offset      = M_ARENA_MIN_OFFSET;
+    current->last_offset = M_ARENA_MIN_OFFSET;
+
+    __M_ArenaDecommitExcess(arena, current, 0);
+
+    arena->current = current;
+
+    __M_ArenaPublish(arena);
+}
+
+void M_ReleaseArena(M_Arena *arena) {
+#if M_ARENA_INSTRUMENT
+    if (arena->info) {
+        M_ArenaRegistry *registry = &__m_arena_registry;
+
+        __M_LockArenaRegistry();
+
+        DLL_Remove(registry->first, registry->last, arena->info);
+        M_PoolFree(registry->pool, arena->info);
+
+        __M_UnlockArenaRegistry();
+
+        arena->info = 0;
+    }
+#endif
+
+    __M_ArenaReleaseLarge(arena, 0);
+
+    M_Arena *current = arena->current;
+    while (current != 0) {
+        M_Arena *block = current;
+        current = current->prev;
+
+        __M_ReleaseBlock(block);
+    }
+}
+
+// clears the range of a block being allocated taking into account how much of it is already
+// known to be zero
+//
+internal void __M_ArenaClearRange(M_Arena *arena, M_Arena *block, U64 offset, U64 end, M_ArenaFlags flags) {
+    U8 *base = cast(U8 *) block + offset;
+
+    if (end > block->zero_offset) {
+        // only the part of the allocation below the zero offset can be dirty, anything
+        // past it hasn't been touched since it was committed
+        //
+        if ((flags & M_ARENA_NO_ZERO) == 0 && offset < block->zero_offset) {
+            M_ZeroSize(base, block->zero_offset - offset);
+            __M_ArenaCount(arena, bytes_zeroed, block->zero_offset - offset);
+        }
+
+        block->zero_offset = end;
+    }
+    else if ((flags & M_ARENA_NO_ZERO) == 0) {
+        M_ZeroSize(base, end - offset);
+        __M_ArenaCount(arena, bytes_zeroed, end - offset);
+    }
+
+    (void) arena;
+}
+
+// allocations that won't fit in a regular growth block are given their own dedicated block
+// on a side-chain, this leaves the current block in place for subsequent small allocations
+// rather than wasting its tail
+//
+// a pointer to the large block is pushed to the main chain, this gives the allocation a
+// unique position within the arena offsets so pops release it in the correct order
+//
+internal void *__M_ArenaPushLarge(M_Arena *arena, U64 size, M_ArenaFlags flags, U64 alignment) {
+    void *result = 0;
+
+    U64 offset = AlignUp(M_ARENA_MIN_OFFSET, alignment);
+    U64 end    = offset + size;
+
+    // the block is checked before the token is pushed so a failed allocation doesn't leave
+    // anything behind in the arena
+    //
+    M_Arena *block = __M_AllocSizedArena(end, end, arena->flags & M_ARENA_INHERIT_FLAGS);
+    if (block && block->committed < end) {
+        __M_ReleaseBlock(block);
+        block = 0;
+    }
+
+    M_Arena **token = block ? M_ArenaPush(arena, M_Arena *, 1, M_ARENA_NO_ZERO) : 0;
+
+    if (token) {
+        block->base        = M_GetArenaOffset(arena);
+        block->last_offset = offset;
+        block->offset      = end;
+
+        __M_ArenaClearRange(arena, block, offset, end, flags);
+
+        SLL_PushN(arena->large, block, prev);
+
+        __M_ArenaPublish(arena);
+
+        *token = block;
+        result = cast(U8 *) block + offset;
+    }
+    else if (block) {
+        __M_ReleaseBlock(block);
+    }
+
+    return result;
+}
+
+// concurrent arenas
+//
+internal void __M_LockArena(M_Arena *arena) {
+    while (!AtomicCompareExchange_U32(&arena->lock, 1, 0)) { SpinPause(); }
+}
+
+internal void __M_UnlockArena(M_Arena *arena) {
+    AtomicExchange_U32(&arena->lock, 0);
+}
+
+// reserves space in the current block with an atomic add, if the reservation isn't committed
+// the arena is locked and more is committed. if the reservation overflowed the block the arena
+// is locked and grown, unless another thread has already done so, and the reservation is retried
+// on the new block
+//
+// returns the block the reservation was made in and its offset within that block
+//
+internal M_Arena *__M_ArenaReserveConcurrent(M_Arena *arena, U64 size, U64 alignment, U64 *offset) {
+    M_Arena *result = 0;
+
+    // reserve the worst case alignment padding up front so we only need a single atomic add
+    //
+    U64 reserve = size + (alignment - 1);
+
+    B32 failed = false;
+    while (!result && !failed) {
+        M_Arena *current = *cast(M_Arena *volatile *) &arena->current;
+
+        U64 start = AtomicAdd_U64(&current->offset, reserve);
+        U64 end   = AlignUp(start, alignment) + size;
+
+        if (end <= current->limit) {
+            volatile U64 *committed = &current->committed;
+
+            if (end > *committed) {
+                __M_LockArena(arena);
+
+                if (end > *committed) {
+                    void *commit_base = cast(U8 *) current + *committed;
+                    U64 commit_end    = Max(end, *committed + arena->commit_step);
+                    U64 commit_offset = AlignUp(commit_end, __M_ArenaCommitGranularity(current));
+                    U64 commit_limit  = Min(commit_offset, current->limit);
+                    U64 commit_size   = commit_limit - *committed;
+
+                    if (M_Commit(commit_base, commit_size)) {
+                        if (current->flags & M_ARENA_PREFAULT) { __M_Prefault(commit_base, commit_size); }
+
+                        AtomicExchange_U64(committed, commit_limit);
+                        arena->commit_step = Min(arena->commit_step << 1, arena->commit_max_step);
+
+                        __M_ArenaCount(arena, commits, 1);
+                        __M_ArenaPublish(arena);
+                    }
+                }
+
+                __M_UnlockArena(arena);
+            }
+
+            if (end <= *committed) {
+                result  = current;
+                *offset = end - size;
+            }
+            else {
+                // failed to commit, nothing else we can do
+                //
+                failed = true;
+            }
+        }
+        else if ((arena->flags & M_ARENA_DONT_GROW) == 0) {
+            __M_LockArena(arena);
+
+            // only the first thread to overflow the block grows it, everyone else will retry on
+            // the new block once it has been published
+            //
+            if (arena->current == current) {
+                // a push too large for a normal growth block can end up here if it was expected to
+                // fit in the current block but lost the race for the space, so the new block is
+                // sized to always fit the reservation otherwise it would overflow on every retry
+                //
+                U64 grow = Max(M_ARENA_GROW_RESERVE_SIZE, M_ARENA_MIN_OFFSET + reserve);
+
+                M_Arena *next = __M_AllocSizedArena(grow, M_ARENA_COMMIT_SIZE, arena->flags & M_ARENA_INHERIT_FLAGS);
+                if (next) {
+                    next->base = current->base + current->limit;
+                    next->prev = current;
+
+                    AtomicExchange_Ptr(cast(void *volatile *) &arena->current, next);
+
+                    __M_ArenaPublish(arena);
+                }
+                else {
+                    failed = true;
+                }
+            }
+
+            __M_UnlockArena(arena);
+        }
+        else {
+            failed = true;
+        }
+    }
+
+    return result;
+}
+
+internal void *__M_ArenaPushConcurrent(M_Arena *arena, U64 size, M_ArenaFlags flags, U64 alignment) {
+    void *result = 0;
+
+    M_Arena *block  = 0;
+    U64      offset = 0;
+
+    M_Arena *current = *cast(M_Arena *volatile *) &arena->current;
+
+    U64 used      = *cast(volatile U64 *) &current->offset;
+    U64 remaining = current->limit - Min(used, current->limit);
+
+    B32 large = (AlignUp(M_ARENA_MIN_OFFSET, alignment) + size) > M_ARENA_GROW_RESERVE_SIZE;
+
+    B32 large_block = large && (size + alignment) > remaining && (arena->flags & M_ARENA_DONT_GROW) == 0;
+
+    if (large_block) {
+        // same as the serial large allocation, the block can be allocated without holding the
+        // lock but must be inserted into the side-chain in position order
+        //
+        offset = AlignUp(M_ARENA_MIN_OFFSET, alignment);
+
+        U64 end = offset + size;
+
+        block = __M_AllocSizedArena(end, end, arena->flags & M_ARENA_INHERIT_FLAGS);
+        if (block && block->committed < end) {
+            __M_ReleaseBlock(block);
+            block = 0;
+        }
+
+        if (block) {
+            U64 token_offset = 0;
+            M_Arena *token   = __M_ArenaReserveConcurrent(arena, sizeof(M_Arena *), AlignOf(M_Arena *), &token_offset);
+
+            if (!token) {
+                __M_ReleaseBlock(block);
+                block = 0;
+            }
+            else {
+                *cast(M_Arena **) (cast(U8 *) token + token_offset) = block;
+
+                block->base        = token->base + token_offset + sizeof(M_Arena *);
+                block->last_offset = offset;
+                block->offset      = end;
+
+                __M_LockArena(arena);
+
+                M_Arena **insert = &arena->large;
+                while (*insert != 0 && (*insert)->base > block->base) { insert = &(*insert)->prev; }
+
+                block->prev = *insert;
+                *insert     = block;
+
+                __M_ArenaPublish(arena);
+
+                __M_UnlockArena(arena);
+
+                result = cast(U8 *) block + offset;
+            }
+        }
+    }
+    else {
+        block = __M_ArenaReserveConcurrent(arena, size, alignment, &offset);
+        if (block) { result = cast(U8 *) block + offset; }
+    }
+
+    if (result && (flags & M_ARENA_NO_ZERO) == 0) {
+        // the known-zero offset is only updated when the arena isn't being pushed to
+        // concurrently so it is stable here, see __M_ArenaSyncOffsets
+        //
+        U64 zero_offset = block->zero_offset;
+        if (offset < zero_offset) {
+            M_ZeroSize(result, Min(size, zero_offset - offset));
+            __M_ArenaCount(arena, bytes_zeroed, Min(size, zero_offset - offset));
+        }
+    }
+
+    if (result && !large_block) { __M_ArenaHighWater(arena, block->base + offset + size); }
+
+    return result;
+}
+
+internal void *__M_ArenaPushSerial(M_Arena *arena, U64 size, M_ArenaFlags flags, U64 alignment) {
+    void *result = 0;
+
+    M_Arena *current = arena->current;
+
+    U64 offset = AlignUp(current->offset, alignment);
+    U64 end    = offset + size;
+
+    if (end > current->limit && (arena->flags & M_ARENA_DONT_GROW) == 0) {
+        // not enough space in current arena so allocate a new one if growing is
+        // permitted
+        //
+        if ((AlignUp(M_ARENA_MIN_OFFSET, alignment) + size) > M_ARENA_GROW_RESERVE_SIZE) {
+            result = __M_ArenaPushLarge(arena, size, flags, alignment);
+        }
+        else {
+            M_Arena *next = __M_AllocSizedArena(M_ARENA_GROW_RESERVE_SIZE, M_ARENA_COMMIT_SIZE, arena->flags & M_ARENA_INHERIT_FLAGS);
+
+            next->base = current->base + current->limit;
+
+            SLL_PushN(arena->current, next, prev);
+
+            __M_ArenaPublish(arena);
+
+            current = next;
+            offset  = AlignUp(current->offset, alignment);
+            end     = offset + size;
+        }
+    }
+
+    if (result == 0 && end > current->committed) {
+        void *commit_base = cast(U8 *) current + current->committed;
+        U64 commit_end    = Max(end, current->committed + arena->commit_step);
+        U64 commit_offset = AlignUp(commit_end, __M_ArenaCommitGranularity(current));
+        U64 commit_limit  = Min(commit_offset, current->limit);
+        U64 commit_size   = commit_limit - current->committed;
+
+        if (M_Commit(commit_base, commit_size)) {
+            if (current->flags & M_ARENA_PREFAULT) { __M_Prefault(commit_base, commit_size); }
+
+            current->committed = commit_limit;
+            arena->commit_step = Min(arena->commit_step << 1, arena->commit_max_step);
+
+            __M_ArenaCount(arena, commits, 1);
+            __M_ArenaPublish(arena);
+        }
+    }
+
+    if (result == 0 && current->committed >= end) {
+        // we have managed to commit enough space for the allocation
+        //
+        result = cast(U8 *) current + offset;
+
+        current->last_offset = current->offset;
+        current->offset      = end;
+
+        if (end > current->peak_offset) { current->peak_offset = end; }
+
+        __M_ArenaHighWater(arena, current->base + end);
+
+        __M_ArenaClearRange(arena, current, offset, end, flags);
+    }
+
+    return result;
+}
+
+void *M_ArenaPushFrom(M_Arena *arena, U64 size, M_ArenaFlags flags, U64 alignment) {
+    void *result = 0;
+
+    alignment = Clamp(1, alignment, 4096);
+
+    if (arena->flags & M_ARENA_CONCURRENT) {
+        result = __M_ArenaPushConcurrent(arena, size, flags, alignment);
+    }
+    else {
+        result = __M_ArenaPushSerial(arena, size, flags, alignment);
+    }
+
+    Assert(result != 0);
+    Assert(((U64) result & (alignment - 1)) == 0);
+
+    __M_ArenaCount(arena, pushes, 1);
+    __M_ArenaStore(arena, offset, M_GetArenaOffset(arena));
+
+    return result;
+}
+
+void *M_ArenaPushCopyFrom(M_Arena *arena, void *src, U64 size, M_ArenaFlags flags, U64 alignment) {
+    void *result = M_CopySize(M_ArenaPushFrom(arena, size, flags, alignment), src, size);
+    return result;
+}
+
+U64 M_GetArenaOffset(M_Arena *arena) {
+    M_Arena *current = arena->current;
+
+    U64 result = (current->base + current->offset);
+    return result;
+}
+
+// the parts of the stats that are read from the arena info, this is all M_DumpArenaStats can
+// use as the chain itself may be being modified by the arena's owning thread
+//
+internal M_ArenaStats __M_ArenaInfoStats(M_ArenaInfo *info) {
+    M_ArenaStats result = { 0 };
+
+    result.reserved  = info->reserved;
+    result.committed = info->committed;
+    result.offset    = info->offset;
+
+    result.chain_length = cast(U32) info->chain_length;
+    result.large_blocks = cast(U32) info->large_blocks;
+
+    result.name = Str8_Wrap(info->name_count, info->name);
+
+    result.high_water   = info->high_water;
+    result.pushes       = info->pushes;
+    result.pops         = info->pops;
+    result.resets       = info->resets;
+    result.commits      = info->commits;
+    result.decommits    = info->decommits;
+    result.bytes_zeroed = info->bytes_zeroed;
+
+    return result;
+}
+
+M_ArenaStats M_GetArenaStats(M_Arena *arena) {
+    M_ArenaStats result = { 0 };
+
+    M_ArenaInfo *info = arena->info;
+    if (info) { result = __M_ArenaInfoStats(info); }
+
+    // the chain is walked directly rather than using the published summary as this is called by
+    // the thread that owns the arena so it is always up to date
+    //
+    result.reserved     = 0;
+    result.committed    = 0;
+    result.chain_length = 0;
+    result.large_blocks = 0;
+
+    for (M_Arena *block = arena->current; block != 0; block = block->prev) {
+        result.reserved  += block->limit;
+        result.committed += block->committed;
+
+        result.chain_length += 1;
+    }
+
+    for (M_Arena *block = arena->large; block != 0; block = block->prev) {
+        result.reserved  += block->limit;
+        result.committed += block->committed;
+
+        result.large_blocks += 1;
+    }
+
+    result.offset          = M_GetArenaOffset(arena);
+    result.huge_page_bytes = __M_ArenaHugePageBytes(arena);
+
+    return result;
+}
+
+void M_SetArenaName(M_Arena *arena, Str8 name) {
+    M_ArenaInfo *info = arena->info;
+    if (info) {
+        info->name_count = cast(U32) Min(name.count, M_ARENA_INFO_NAME_SIZE);
+        M_CopySize(info->name, name.data, info->name_count);
+    }
+}
+
+Str8 M_DumpArenaStats(M_Arena *arena) {
+    Str8 result = S("");
+
+    // acquire the temp arena before locking the registry as it may need to allocate the temp
+    // arena, which would register it
+    //
+    M_Temp temp = M_AcquireTemp(1, &arena);
+
+    typedef struct M_DumpLine M_DumpLine;
+    struct M_DumpLine {
+        M_DumpLine *next;
+        Str8 line;
+    };
+
+    M_DumpLine *first = 0;
+    M_DumpLine *last  = 0;
+
+    S64 total = 0;
+
+    M_ArenaRegistry *registry = &__m_arena_registry;
+
+    __M_LockArenaRegistry();
+
+    for (M_ArenaInfo *info = registry->first; info != 0; info = info->next) {
+        // only the summary published by the owning thread is read, other threads may be
+        // releasing blocks from their arenas while this is running. huge page usage requires
+        // reading smaps which is too slow to do while holding the registry lock, use
+        // M_GetArenaStats directly if needed
+        //
+        M_ArenaStats stats = __M_ArenaInfoStats(info);
+
+        M_DumpLine *line = M_ArenaPush(temp.arena, M_DumpLine);
+
+        line->line = Sf(temp.arena, "%-*.*s : reserved %llu, committed %llu, offset %llu, high water %llu, blocks %u, large %u, "
+                "pushes %llu, pops %llu, resets %llu, commits %llu, decommits %llu, zeroed %llu\n",
+                M_ARENA_INFO_NAME_SIZE, Sv(stats.name.count ? stats.name : S("(unnamed)")),
+                stats.reserved, stats.committed, stats.offset, stats.high_water, stats.chain_length, stats.large_blocks,
+                stats.pushes, stats.pops, stats.resets, stats.commits, stats.decommits, stats.bytes_zeroed);
+
+        SLL_Enqueue(first, last, line);
+        total += line->line.count;
+    }
+
+    __M_UnlockArenaRegistry();
+
+    if (total != 0) {
+        result.count = total;
+        result.data  = M_ArenaPush(arena, U8, total + 1, M_ARENA_NO_ZERO);
+
+        S64 offset = 0;
+        for (M_DumpLine *line = first; line != 0; line = line->next) {
+            M_CopySize(result.data + offset, line->line.data, line->line.count);
+            offset += line->line.count;
+        }
+
+        result.data[total] = 0;
+    }
+
+    M_ReleaseTemp(temp);
+
+    return result;
+}
+
+// releases cached blocks until the cache is within 'budget' bytes
+//
+internal void __M_TrimBlockCache(U64 budget) {
+    M_BlockCache *cache = &__m_block_cache;
+
+    M_Arena *release = 0;
+
+    __M_LockBlockCache();
+
+    while (cache->blocks != 0 && cache->cached_bytes > budget) {
+        M_Arena *block = cache->blocks;
+        cache->blocks  = block->prev;
+
+        cache->cached_bytes  -= block->limit;
+        cache->cached_blocks -= 1;
+
+        block->prev = release;
+        release     = block;
+    }
+
+    __M_UnlockBlockCache();
+
+    // release outside of the lock so other threads aren't blocked on the system calls
+    //
+    while (release != 0) {
+        M_Arena *block = release;
+        release = release->prev;
+
+        M_Release(cast(void *) block, block->limit);
+    }
+}
+
+void M_SetBlockCacheBudget(U64 budget) {
+    __m_block_cache.budget = budget;
+    __M_TrimBlockCache(budget);
+}
+
+void M_FlushBlockCache() {
+    __M_TrimBlockCache(0);
+}
+
+M_BlockCacheStats M_GetBlockCacheStats() {
+    M_BlockCacheStats result;
+
+    M_BlockCache *cache = &__m_block_cache;
+
+    __M_LockBlockCache();
+
+    result.hits   = cache->hits;
+    result.misses = cache->misses;
+
+    result.budget        = cache->budget;
+    result.cached_bytes  = cache->cached_bytes;
+    result.cached_blocks = cache->cached_blocks;
+
+    __M_UnlockBlockCache();
+
+    return result;
+}
+
+void M_ArenaPopTo(M_Arena *arena, U64 offset) {
+    M_Arena *large = arena->large;
+
+    __M_ArenaCount(arena, pops, 1);
+    __M_ArenaReleaseLarge(arena, offset);
+
+    M_Arena *current = arena->current;
+
+    while (current->base > offset) {
+        M_Arena *block = current;
+        current = current->prev;
+
+        __M_ReleaseBlock(block);
+    }
+
+    U64 local_offset = Max(offset - current->base, M_ARENA_MIN_OFFSET);
+
+    if (local_offset <= current->offset) {
+        __M_ArenaSyncOffsets(current);
+
+        // as we have popped back explicitly the 'last_offset' is no longer valid so
+        // set that to this offset thus calling 'pop last' after manually setting the
+        // offset doesn't do anything
+        //
+        current->offset      = local_offset;
+        current->last_offset = local_offset;
+    }
+
+    // only walk the chain again if blocks were actually released
+    //
+    if (arena->current != current || arena->large != large) {
+        arena->current = current;
+        __M_ArenaPublish(arena);
+    }
+    else {
+        __M_ArenaStore(arena, offset, M_GetArenaOffset(arena));
+    }
+}
+
+void M_ArenaPopSize(M_Arena *arena, U64 size) {
+    U64 offset = M_GetArenaOffset(arena);
+
+    // explicitly greater than because the arena takes some space for its header
+    // information
+    //
+    if (offset > size) {
+        M_ArenaPopTo(arena, offset - size);
+    }
+}
+
+void M_ArenaPopLast(M_Arena *arena) {
+    M_Arena *current = arena->current;
+
+    if ((arena->flags & M_ARENA_CONCURRENT) == 0) {
+        __M_ArenaCount(arena, pops, 1);
+
+        // We know the last offset cannot span multiple arenas even with chained growth
+        // because single push allocations must be contiguous and thus be contained in a
+        // single arena
+        //
+        // this means popping the last allocation is a simple move of the offset
+        //
+        current->offset = current->last_offset;
+
+        // if the last allocation was a large allocation this will have popped its token, so
+        // the large block must also be released
+        //
+        M_Arena *large = arena->large;
+
+        __M_ArenaReleaseLarge(arena, current->base + current->offset);
+
+        if (arena->large != large) { __M_ArenaPublish(arena); }
+        else { __M_ArenaStore(arena, offset, M_GetArenaOffset(arena)); }
+    }
+}
+
+// thread-local temporary arenas
+//
+#if !defined(M_TEMP_ARENA_COUNT)
+    #define M_TEMP_ARENA_COUNT 2
+#endif
+
+#if !defined(M_TEMP_ARENA_MAX_COUNT)
+    #define M_TEMP_ARENA_MAX_COUNT 8
+#endif
+
+#if !defined(M_TEMP_ARENA_RESERVE_SIZE)
+    #define M_TEMP_ARENA_RESERVE_SIZE GB(4)
+#endif
+
+#if !defined(M_TEMP_ARENA_RETAIN_SIZE)
+    #define M_TEMP_ARENA_RETAIN_SIZE MB(1)
+#endif
+
+StaticAssert(M_TEMP_ARENA_COUNT <= M_TEMP_ARENA_MAX_COUNT, "too many default temp arenas");
+
+thread_static M_Arena *__tls_temp[M_TEMP_ARENA_MAX_COUNT];
+thread_static U32      __tls_temp_count;
+
+M_Temp M_AcquireTemp(U32 count, M_Arena **conflicts) {
+    M_Temp result;
+
+    result.arena  = 0;
+    result.offset = 0;
+
+    U32 temp_count = __tls_temp_count ? __tls_temp_count : M_TEMP_ARENA_COUNT;
+
+    for (U32 t = 0; t < temp_count; ++t) {
+        if (!__tls_temp[t]) {
+            __tls_temp[t] = M_AllocArena(M_TEMP_ARENA_RESERVE_SIZE);
+            M_SetArenaName(__tls_temp[t], S("temp"));
+        }
+
+        M_Arena *arena = __tls_temp[t];
+        for (U32 c = 0; c < count; ++c) {
+            if (conflicts[c] == arena) {
+                arena = 0;
+                break;
+            }
+        }
+
+        if (arena) {
+            result.arena  = arena;
+            result.offset = M_GetArenaOffset(arena);
+
+            break;
+        }
+    }
+
+    Assert(result.arena != 0);
+
+    return result;
+}
+
+void M_ReleaseTemp(M_Temp temp) {
+    M_ArenaPopTo(temp.arena, temp.offset);
+
+    // temps are strictly nested so only the outermost temp will be released back to the
+    // start of the arena
+    //
+    if (temp.offset <= M_ARENA_MIN_OFFSET) {
+        __M_ArenaDecommitExcess(temp.arena, temp.arena->current, M_TEMP_ARENA_RETAIN_SIZE);
+    }
+}
+
+void M_SetTempArenaCount(U32 count) {
+    __tls_temp_count = Clamp(1, count, M_TEMP_ARENA_MAX_COUNT);
+}
+
+void M_TrimTempArenas() {
+    for (U32 t = 0; t < M_TEMP_ARENA_MAX_COUNT; ++t) {
+        M_Arena *arena = __tls_temp[t];
+        if (arena) { __M_ArenaTrim(arena, M_TEMP_ARENA_RETAIN_SIZE); }
+    }
+}
+
+// persistent arenas
+//
+#define M_ARENA_SNAPSHOT_MAGIC   0x50414E53 // 'SNAP'
+#define M_ARENA_SNAPSHOT_VERSION 2
+
+// the arena data is placed at a fixed offset in the file so it can be mapped directly, this is
+// larger than the page size on all supported platforms
+//
+#define M_ARENA_SNAPSHOT_DATA_OFFSET KB(64)
+
+typedef struct M_ArenaSnapshot M_ArenaSnapshot;
+struct M_ArenaSnapshot {
+    U32 magic;
+    U32 version;
+    U32 user_version;
+
+    M_ArenaFlags flags;
+
+    U64 limit;
+    U64 size;
+    U64 checksum;
+
+    // checksum of the fields above, this is always verified on load
+    //
+    U64 header_checksum;
+};
+
+// the arena header itself isn't saved, it contains pointers and is re-initialised on load, so
+// only the data after it is checksummed
+//
+internal U64 __M_ArenaChecksum(U8 *data, U64 count) {
+    const U64 prime1 = 0x9E3779B185EBCA87ULL;
+    const U64 prime2 = 0xC2B2AE3D27D4EB4FULL;
+
+    U64 acc[4] = { count, count + prime1, count + prime2, count ^ prime1 };
+
+    U64 it = 0;
+    for (; it + 32 <= count; it += 32) {
+        U64 *words = cast(U64 *) (data + it);
+
+        acc[0] = RotateLeft_U64(acc[0] + (words[0] * prime2), 31) * prime1;
+        acc[1] = RotateLeft_U64(acc[1] + (words[1] * prime2), 31) * prime1;
+        acc[2] = RotateLeft_U64(acc[2] + (words[2] * prime2), 31) * prime1;
+        acc[3] = RotateLeft_U64(acc[3] + (words[3] * prime2), 31) * prime1;
+    }
+
+    U64 result = RotateLeft_U64(acc[0], 1) + RotateLeft_U64(acc[1], 7) + RotateLeft_U64(acc[2], 12) + RotateLeft_U64(acc[3], 18);
+
+    for (; it < count; ++it) {
+        result = (result ^ data[it]) * prime1;
+    }
+
+    result ^= (result >> 33);
+    result *= prime2;
+    result ^= (result >> 29);
+
+    return result;
+}
+
+internal U64 __M_ArenaHeaderChecksum(M_ArenaSnapshot snapshot) {
+    snapshot.header_checksum = 0;
+
+    U64 result = __M_ArenaChecksum(cast(U8 *) &snapshot, sizeof(M_ArenaSnapshot));
+    return result;
+}
+
+B32 M_ArenaSave(M_Arena *arena, Str8 path, U32 version) {
+    B32 result = false;
+
+    if (arena->current == arena && arena->large == 0) {
+        U64 size = arena->offset;
+        U8 *data = cast(U8 *) arena + M_ARENA_MIN_OFFSET;
+
+        M_ArenaSnapshot snapshot = ZERO(M_ArenaSnapshot);
+
+        snapshot.magic        = M_ARENA_SNAPSHOT_MAGIC;
+        snapshot.version      = M_ARENA_SNAPSHOT_VERSION;
+        snapshot.user_version = version;
+
+        // huge pages can't be used for file mappings and there is no point prefaulting memory
+        // that is going to be demand paged from the file
+        //
+        snapshot.flags = arena->flags & ~(M_ARENA_HUGE_FLAGS | M_ARENA_PREFAULT | M_ARENA_SHARED);
+
+        snapshot.limit    = arena->limit;
+        snapshot.size     = size;
+        snapshot.checksum = __M_ArenaChecksum(data, size - M_ARENA_MIN_OFFSET);
+
+        snapshot.header_checksum = __M_ArenaHeaderChecksum(snapshot);
+
+        OS_Handle file = FS_OpenFile(path, FS_ACCESS_WRITE);
+        if (OS_HandleValid(file)) {
+            Str8 header   = Str8_Wrap(sizeof(M_ArenaSnapshot), cast(U8 *) &snapshot);
+            Str8 contents = Str8_Wrap(size - M_ARENA_MIN_OFFSET, data);
+
+            U64 offset = M_ARENA_SNAPSHOT_DATA_OFFSET + M_ARENA_MIN_OFFSET;
+
+            result = (FS_WriteFile(file, contents, offset) == contents.count) &&
+                     (FS_WriteFile(file, header, 0)        == header.count);
+
+            FS_CloseFile(file);
+        }
+    }
+    else {
+        Log_Error("Only arenas with a single block can be saved");
+    }
+
+    return result;
+}
+
+M_Arena *M_ArenaLoad(Str8 path, U32 version) {
+    M_Arena *result = 0;
+
+    OS_Handle file = FS_OpenFile(path, FS_ACCESS_READ);
+    if (OS_HandleValid(file)) {
+        M_ArenaSnapshot snapshot = ZERO(M_ArenaSnapshot);
+        Str8 header = Str8_Wrap(sizeof(M_ArenaSnapshot), cast(U8 *) &snapshot);
+
+        U64 file_size = FS_SizeFromHandle(file);
+        B32 valid     = FS_ReadFile(file, header, 0) == header.count;
+
+        valid = valid && (snapshot.magic == M_ARENA_SNAPSHOT_MAGIC) && (snapshot.version == M_ARENA_SNAPSHOT_VERSION);
+        valid = valid && (snapshot.header_checksum == __M_ArenaHeaderChecksum(snapshot));
+        valid = valid && (snapshot.user_version == version);
+        valid = valid && (snapshot.size >= M_ARENA_MIN_OFFSET) && (snapshot.size <= snapshot.limit);
+        valid = valid && (file_size >= M_ARENA_SNAPSHOT_DATA_OFFSET + snapshot.size);
+
+        if (valid) {
+            M_ArenaFlags flags = snapshot.flags;
+
+            U64 to_reserve = AlignUp(snapshot.limit, M_GetAllocationGranularity());
+            U64 to_commit  = AlignUp(snapshot.size,  M_GetPageSize());
+
+            U8 *base = cast(U8 *) __M_ReserveArena(to_reserve, &flags);
+            if (base != 0) {
+                U64 mapped_size = 0;
+                B32 loaded      = false;
+
+                if (__M_MapFile(base, to_commit, file, M_ARENA_SNAPSHOT_DATA_OFFSET)) {
+                    mapped_size = to_commit;
+                    loaded      = true;
+                }
+                else if (M_Commit(base, to_commit)) {
+                    Str8 contents = Str8_Wrap(snapshot.size - M_ARENA_MIN_OFFSET, base + M_ARENA_MIN_OFFSET);
+                    loaded = FS_ReadFile(file, contents, M_ARENA_SNAPSHOT_DATA_OFFSET + M_ARENA_MIN_OFFSET) == contents.count;
+                }
+
+                // only verify the data if it has already been read in, otherwise checksumming it
+                // would fault in every page of the mapping
+                //
+                if (loaded && (M_ARENA_LOAD_VERIFY || mapped_size == 0)) {
+                    U8 *data = base + M_ARENA_MIN_OFFSET;
+                    loaded   = __M_ArenaChecksum(data, snapshot.size - M_ARENA_MIN_OFFSET) == snapshot.checksum;
+                }
+
+                if (loaded) {
+                    result = cast(M_Arena *) base;
+
+                    __M_InitArenaBlock(result, to_reserve, to_commit, flags);
+
+                    result->offset      = snapshot.size;
+                    result->last_offset = snapshot.size;
+                    result->peak_offset = snapshot.size;
+                    result->mapped_size = mapped_size;
+
+                    // the tail of the last mapped page may contain stale data from the file,
+                    // so only memory committed after loading is known to be zero
+                    //
+                    result->zero_offset = M_ARENA_COMMIT_IS_ZERO ? to_commit : to_reserve;
+
+                    __M_RegisterArena(result);
+                }
+                else {
+                    Log_Error("Arena snapshot '%.*s' failed to load or is corrupt", Sv(path));
+                    M_Release(base, to_reserve);
+                }
+            }
+        }
+        else {
+            Log_Error("Arena snapshot '%.*s' is invalid or has the wrong version", Sv(path));
+        }
+
+        FS_CloseFile(file);
+    }
+
+    return result;
+}
+
+U64 M_ArenaOffsetFromPointer(M_Arena *arena, void *ptr) {
+    U64 result = 0;
+
+    U8 *addr = cast(U8 *) ptr;
+    for (M_Arena *block = arena->current; block != 0; block = block->prev) {
+        U8 *start = cast(U8 *) block;
+        if (addr >= start + M_ARENA_MIN_OFFSET && addr <= start + block->offset) {
+            result = block->base + cast(U64) (addr - start);
+            break;
+        }
+    }
+
+    return result;
+}
+
+void *M_ArenaPointerFromOffset(M_Arena *arena, U64 offset) {
+    void *result = 0;
+
+    if (offset != 0) {
+        for (M_Arena *block = arena->current; block != 0; block = block->prev) {
+            if (offset >= block->base + M_ARENA_MIN_OFFSET) {
+                result = cast(U8 *) block + (offset - block->base);
+                break;
+            }
+        }
+    }
+
+    return result;
+}
+
+// shared arenas
+//
+#define M_SHARED_ARENA_MAGIC   0x44524853 // 'SHRD'
+#define M_SHARED_ARENA_VERSION 1
+
+// this is placed in its own page directly before the arena, it is read by other processes
+// so must not contain any pointers
+//
+typedef struct M_SharedArenaHeader M_SharedArenaHeader;
+struct M_SharedArenaHeader {
+    U32 magic;
+    U32 version;
+
+    U64 limit;
+
+    volatile U64 committed;
+    volatile U64 offset;
+};
+
+internal M_SharedArenaHeader *__M_SharedArenaHeader(U8 *base) {
+    M_SharedArenaHeader *result = cast(M_SharedArenaHeader *) (base - M_SHARED_ARENA_HEADER_SIZE);
+    return result;
+}
+
+void M_PublishSharedArena(M_Arena *arena) {
+    Assert(arena->flags & M_ARENA_SHARED);
+
+    M_SharedArenaHeader *header = __M_SharedArenaHeader(cast(U8 *) arena);
+
+    // release stores, so all writes to the arena before publishing are visible to any process
+    // that observes the new offset
+    //
+    AtomicStore_U64(&header->committed, arena->committed);
+    AtomicStore_U64(&header->offset,    arena->offset);
+}
+
+U64 M_SharedViewOffset(M_SharedView view) {
+    M_SharedArenaHeader *header = __M_SharedArenaHeader(view.base);
+
+    U64 result = AtomicLoad_U64(&header->offset);
+    return result;
+}
+
+U64 M_SharedViewCommitted(M_SharedView view) {
+    M_SharedArenaHeader *header = __M_SharedArenaHeader(view.base);
+
+    U64 result = AtomicLoad_U64(&header->committed);
+    return result;
+}
+
+void *M_SharedViewPointer(M_SharedView view, U64 offset) {
+    void *result = (offset < view.limit) ? view.base + offset : 0;
+    return result;
+}
+
+#if OS_LINUX
+
+M_Arena *M_AllocSharedArena(U64 limit, Str8 path, OS_Handle *handle) {
+    M_Arena *result = 0;
+
+    U64 granularity = M_GetAllocationGranularity();
+
+    U64 to_reserve = Max(AlignUp(limit, granularity), granularity);
+    U64 to_commit  = Min(M_ARENA_COMMIT_SIZE, to_reserve);
+
+    int fd = -1;
+    if (path.count != 0) {
+        M_Temp temp = M_AcquireTemp(0, 0);
+        Str8 zpath  = Str8_Copy(temp.arena, path);
+
+        fd = open((const char *) zpath.data, O_RDWR | O_CREAT | O_TRUNC, 0600);
+
+        M_ReleaseTemp(temp);
+    }
+    else {
+        fd = cast(int) syscall(SYS_memfd_create, "M_SharedArena", 0);
+    }
+
+    if (fd >= 0) {
+        // the file is sized to the full limit up front, this doesn't use any memory until pages
+        // are touched but means consumers can map the whole thing once
+        //
+        U64 total = M_SHARED_ARENA_HEADER_SIZE + to_reserve;
+
+        if (ftruncate(fd, total) == 0) {
+            U8 *base = cast(U8 *) mmap(0, total, PROT_NONE, MAP_SHARED, fd, 0);
+            if (base != MAP_FAILED) {
+                U8 *arena_base = base + M_SHARED_ARENA_HEADER_SIZE;
+
+                if (M_Commit(base, M_SHARED_ARENA_HEADER_SIZE) && M_Commit(arena_base, to_commit)) {
+                    M_SharedArenaHeader *header = cast(M_SharedArenaHeader *) base;
+
+                    header->magic   = M_SHARED_ARENA_MAGIC;
+                    header->version = M_SHARED_ARENA_VERSION;
+                    header->limit   = to_reserve;
+
+                    result = cast(M_Arena *) arena_base;
+
+                    __M_InitArenaBlock(result, to_reserve, to_commit, M_ARENA_DONT_GROW | M_ARENA_SHARED);
+
+                    // decommitting shared memory would revert to the contents of the file
+                    // rather than zero, so treat the whole thing as mapped
+                    //
+                    result->mapped_size = to_reserve;
+                    result->zero_offset = M_ARENA_MIN_OFFSET;
+
+                    M_PublishSharedArena(result);
+                    __M_RegisterArena(result);
+                }
+                else {
+                    munmap(base, total);
+                }
+            }
+        }
+
+        if (result) {
+            handle->v[0] = cast(U64) fd;
+        }
+        else {
+            Log_Error("Failed to create shared arena (%d)", errno);
+            close(fd);
+        }
+    }
+    else {
+        Log_Error("Failed to open shared arena file '%.*s' (%d)", Sv(path), errno);
+    }
+
+    return result;
+}
+
+M_SharedView M_OpenSharedView(OS_Handle handle) {
+    M_SharedView result = ZERO(M_SharedView);
+
+    M_SharedArenaHeader header = ZERO(M_SharedArenaHeader);
+    Str8 data = Str8_Wrap(sizeof(M_SharedArenaHeader), cast(U8 *) &header);
+
+    if (FS_ReadFile(handle, data, 0) == data.count) {
+        if (header.magic == M_SHARED_ARENA_MAGIC && header.version == M_SHARED_ARENA_VERSION) {
+            int fd = cast(int) handle.v[0];
+
+            U64 total = M_SHARED_ARENA_HEADER_SIZE + header.limit;
+
+            U8 *base = cast(U8 *) mmap(0, total, PROT_READ, MAP_SHARED, fd, 0);
+            if (base != MAP_FAILED) {
+                result.base  = base + M_SHARED_ARENA_HEADER_SIZE;
+                result.limit = header.limit;
+            }
+        }
+    }
+
+    if (!result.base) { Log_Error("Failed to open shared arena view"); }
+
+    return result;
+}
+
+M_SharedView M_OpenSharedViewFromPath(Str8 path) {
+    M_SharedView result = ZERO(M_SharedView);
+
+    // the mapping keeps the shared memory alive, so the file can be closed straight away
+    //
+    OS_Handle file = FS_OpenFile(path, FS_ACCESS_READ);
+    if (OS_HandleValid(file)) {
+        result = M_OpenSharedView(file);
+        FS_CloseFile(file);
+    }
+
+    return result;
+}
+
+void M_CloseSharedView(M_SharedView view) {
+    if (view.base) { munmap(view.base - M_SHARED_ARENA_HEADER_SIZE, M_SHARED_ARENA_HEADER_SIZE + view.limit); }
+}
+
+#else
+
+M_Arena *M_AllocSharedArena(U64 limit, Str8 path, OS_Handle *handle) {
+    (void) limit;
+    (void) path;
+    (void) handle;
+
+    M_Arena *result = 0;
+
+    Log_Error("Shared arenas are not supported on this platform");
+    return result;
+}
+
+M_SharedView M_OpenSharedView(OS_Handle handle) {
+    (void) handle;
+
+    M_SharedView result = ZERO(M_SharedView);
+    return result;
+}
+
+M_SharedView M_OpenSharedViewFromPath(Str8 path) {
+    (void) path;
+
+    M_SharedView result = ZERO(M_SharedView);
+    return result;
+}
+
+void M_CloseSharedView(M_SharedView view) {
+    (void) view;
+}
+
+#endif
+
+// fixed-size object pools
+//
+#if !defined(M_POOL_CHUNK_SIZE)
+    #define M_POOL_CHUNK_SIZE KB(16)
+#endif
+
+#define M_POOL_TAG_SHIFT 48
+#define M_POOL_PTR_MASK  ((1ULL << M_POOL_TAG_SHIFT) - 1)
+
+internal M_PoolNode *__M_PoolNodeFromTagged(void *tagged) {
+    M_PoolNode *result = cast(M_PoolNode *) (cast(U64) tagged & M_POOL_PTR_MASK);
+    return result;
+}
+
+internal void *__M_PoolTagged(M_PoolNode *node, void *previous) {
+    U64 tag = (cast(U64) previous >> M_POOL_TAG_SHIFT) + 1;
+
+    void *result = cast(void *) ((tag << M_POOL_TAG_SHIFT) | cast(U64) node);
+    return result;
+}
+
+// pushes the list of nodes from 'first' to 'last' onto the free list
+//
+internal void __M_PoolPushFree(M_Pool *pool, M_PoolNode *first, M_PoolNode *last) {
+    Assert((cast(U64) first & ~M_POOL_PTR_MASK) == 0);
+
+    if (pool->flags & M_POOL_THREAD_SAFE) {
+        for (;;) {
+            void *head = pool->free_list;
+
+            last->next = __M_PoolNodeFromTagged(head);
+            if (AtomicCompareExchange_Ptr(&pool->free_list, __M_PoolTagged(first, head), head)) { break; }
+        }
+    }
+    else {
+        last->next      = cast(M_PoolNode *) pool->free_list;
+        pool->free_list = first;
+    }
+}
+
+internal M_PoolNode *__M_PoolPopFree(M_Pool *pool) {
+    M_PoolNode *result = 0;
+
+    if (pool->flags & M_POOL_THREAD_SAFE) {
+        for (;;) {
+            void *head = pool->free_list;
+
+            M_PoolNode *node = __M_PoolNodeFromTagged(head);
+            if (!node) { break; }
+
+            // the node may have been popped and re-used by another thread between reading the
+            // head and reading its next pointer, in that case the tag will have changed and the
+            // exchange will fail. the memory is never returned to the system while the pool is in
+            // use so the read itself is always valid
+            //
+            M_PoolNode *next = node->next;
+            if (AtomicCompareExchange_Ptr(&pool->free_list, __M_PoolTagged(next, head), head)) {
+                result = node;
+                break;
+            }
+        }
+    }
+    else {
+        result = cast(M_PoolNode *) pool->free_list;
+        if (result) { pool->free_list = result->next; }
+    }
+
+    return result;
+}
+
+// takes a chunk, either a spare one from a previous reset or a new one from the arena, and returns
+// its first element directly while adding the rest of them to the free list
+//
+internal M_PoolNode *__M_PoolRefill(M_Pool *pool) {
+    M_PoolNode *result = 0;
+
+    B32 thread_safe = (pool->flags & M_POOL_THREAD_SAFE) != 0;
+
+    if (thread_safe) {
+        while (!AtomicCompareExchange_U32(&pool->lock, 1, 0)) { SpinPause(); }
+
+        // another thread may have refilled the free list while we were waiting for the lock
+        //
+        result = __M_PoolPopFree(pool);
+    }
+
+    if (!result) {
+        U64 header = AlignUp(sizeof(M_PoolChunk), pool->alignment);
+
+        M_PoolChunk *chunk = pool->spare_chunks;
+        if (chunk) {
+            pool->spare_chunks = chunk->next;
+        }
+        else {
+            // only the pool lock is held here, so the arena can't be shared with anything else
+            // unless it supports concurrent pushes itself
+            //
+            B32 exclusive = thread_safe && (pool->arena->flags & M_ARENA_CONCURRENT) == 0;
+            Assert(!exclusive || M_GetArenaOffset(pool->arena) == pool->arena_offset);
+
+            U64 size = header + (pool->chunk_count * pool->element_size);
+            chunk = cast(M_PoolChunk *) M_ArenaPushFrom(pool->arena, size, M_ARENA_NO_ZERO, pool->alignment);
+
+            pool->arena_offset = M_GetArenaOffset(pool->arena);
+        }
+
+        SLL_Push(pool->chunks, chunk);
+
+        U8 *elements = cast(U8 *) chunk + header;
+
+        result = cast(M_PoolNode *) elements;
+
+        if (pool->chunk_count > 1) {
+            M_PoolNode *first = cast(M_PoolNode *) (elements + pool->element_size);
+            M_PoolNode *last  = first;
+
+            for (U32 it = 2; it < pool->chunk_count; ++it) {
+                M_PoolNode *node = cast(M_PoolNode *) (elements + (it * pool->element_size));
+
+                last->next = node;
+                last       = node;
+            }
+
+            __M_PoolPushFree(pool, first, last);
+        }
+    }
+
+    if (thread_safe) { AtomicExchange_U32(&pool->lock, 0); }
+
+    return result;
+}
+
+M_Pool *M_AllocPool(M_Arena *arena, U64 element_size, U64 alignment, M_PoolFlags flags) {
+    M_Pool *result = M_ArenaPush(arena, M_Pool);
+
+    alignment = Clamp(AlignOf(M_PoolNode), alignment, 4096);
+
+    result->arena        = arena;
+    result->element_size = AlignUp(Max(element_size, sizeof(M_PoolNode)), alignment);
+    result->alignment    = alignment;
+    result->chunk_count  = cast(U32) Max(M_POOL_CHUNK_SIZE / result->element_size, 1);
+    result->flags        = flags;
+    result->arena_offset = M_GetArenaOffset(arena);
+
+    return result;
+}
+
+void *M_PoolAlloc(M_Pool *pool, M_ArenaFlags flags) {
+    void *result = __M_PoolPopFree(pool);
+    if (!result) { result = __M_PoolRefill(pool); }
+
+    Assert(result != 0);
+
+    if ((flags & M_ARENA_NO_ZERO) == 0) { M_ZeroSize(result, pool->element_size); }
+
+    return result;
+}
+
+void M_PoolFree(M_Pool *pool, void *ptr) {
+    if (ptr) {
+        M_PoolNode *node = cast(M_PoolNode *) ptr;
+        __M_PoolPushFree(pool, node, node);
+    }
+}
+
+void M_ResetPool(M_Pool *pool) {
+    // all of the chunks become spare, the free list only contains elements from the chunks so it
+    // can just be discarded
+    //
+    while (pool->chunks) {
+        M_PoolChunk *chunk = pool->chunks;
+        SLL_Pop(pool->chunks);
+
+        SLL_Push(pool->spare_chunks, chunk);
+    }
+
+    pool->free_list = 0;
+}
+
+// growable arrays
+//
+M_Array *M_AllocArray(U64 limit, U64 element_size, U64 alignment) {
+    M_Arena *arena  = M_AllocArenaArgs(limit, M_ARENA_COMMIT_SIZE, M_ARENA_DONT_GROW);
+    M_Array *result = M_ArenaPush(arena, M_Array);
+
+    result->arena = arena;
+
+    // elements begin at the first aligned offset after the header, the element size is always
+    // a multiple of the alignment so every push after that is contiguous
+    //
+    result->data  = M_ArenaPush(arena, U8, 0, 0, Max(alignment, 1));
+    result->count = 0;
+
+    result->element_size = element_size;
+
+    Assert(alignment == 0 || (element_size % alignment) == 0);
+
+    return result;
+}
+
+void M_ReleaseArray(M_Array *array) {
+    M_ReleaseArena(array->arena);
+}
+
+void *M_ArrayPushFrom(M_Array *array, U64 count, M_ArenaFlags flags) {
+    U8 *result = cast(U8 *) M_ArenaPushFrom(array->arena, count * array->element_size, flags, 1);
+
+    if (result) {
+        Assert(result == array->data + (array->count * array->element_size));
+        array->count += count;
+    }
+
+    return result;
+}
+
+void *M_ArrayInsertFrom(M_Array *array, U64 index, U64 count, M_ArenaFlags flags) {
+    U8 *result = 0;
+
+    Assert(index <= array->count);
+
+    U64 tail = array->count - index;
+    if (M_ArrayPushFrom(array, count, M_ARENA_NO_ZERO)) {
+        U64 size = array->element_size;
+
+        result = array->data + (index * size);
+        M_MoveSize(result + (count * size), result, tail * size);
+
+        if ((flags & M_ARENA_NO_ZERO) == 0) { M_ZeroSize(result, count * size); }
+    }
+
+    return result;
+}
+
+void M_ArrayRemoveFrom(M_Array *array, U64 index, U64 count) {
+    Assert(index + count <= array->count);
+
+    U64 size = array->element_size;
+    U64 tail = array->count - (index + count);
+
+    U8 *dst = array->data + (index * size);
+    M_MoveSize(dst, dst + (count * size), tail * size);
+
+    M_ArenaPopSize(array->arena, count * size);
+    array->count -= count;
+}
+
+void M_ArrayRemoveSwap(M_Array *array, U64 index) {
+    Assert(index < array->count);
+
+    U64 size = array->element_size;
+    U64 last = array->count - 1;
+
+    if (index != last) { M_CopySize(array->data + (index * size), array->data + (last * size), size); }
+
+    M_ArenaPopSize(array->arena, size);
+    array->count -= 1;
+}
+
+void M_ArrayClear(M_Array *array) {
+    M_ArenaPopSize(array->arena, array->count * array->element_size);
+    array->count = 0;
+}
+
+//
+// --------------------------------------------------------------------------------
+// :impl_strings
+// --------------------------------------------------------------------------------
+//
+
+Str8 Str8_Wrap(S64 count, U8 *data) {
+    Str8 result;
+    result.count = count;
+    result.data  = data;
+
+    return result;
+}
+
+internal S64 CountLengthZ(U8 *zstr) {
+    S64 result = 0;
+
+    while (zstr[result]) {
+        result += 1;
+    }
+
+    return result;
+}
+
+Str8 Str8_WrapZ(U8 *zstr) {
+    Str8 result;
+    result.count = CountLengthZ(zstr);
+    result.data  = zstr;
+
+    return result;
+}
+
+Str8 Str8_WrapRange(U8 *start, U8 *end) {
+    Str8 result;
+
+    Assert(start <= end);
+
+    result.count = cast(S64) (end - start);
+    result.data  = start;
+
+    return result;
+}
+
+// will be null-terminated
+//
+Str8 Str8_Copy(M_Arena *arena, Str8 str) {
+    Str8 result;
+    result.count = str.count;
+    result.data  = cast(U8 *) M_CopySize(M_ArenaPush(arena, U8, str.count + 1), str.data, str.count);
+
+    return result;
+}
+
+Str8 Str8_Concat(M_Arena *arena, Str8 a, Str8 b) {
+    Str8 result;
+    result.count = (a.count + b.count);
+    result.data  = M_ArenaPush(arena, U8, result.count + 1);
+
+    M_CopySize(result.data          , a.data, a.count);
+    M_CopySize(result.data + a.count, b.data, b.count);
+
+    return result;
+}
+
+// string equality
+//
+B32 Str8_Equal(Str8 a, Str8 b, Str8_EqualFlags flags) {
+    B32 result;
+
+    B32 ignore_case = (flags & STR8_EQUAL_FLAG_IGNORE_CASE) != 0;
+    B32 inexact_rhs = (flags & STR8_EQUAL_FLAG_INEXACT_RHS) != 0;
+
+    result = (a.count == b.count) || inexact_rhs;
+
+    if (result) {
+        S64 count = Min(a.count, b.count);
+
+        for (S64 it = 0; it < count; ++it) {
+            U8 ca, cb;
+            if (ignore_case) {
+                ca = Chr_ToUppercase(a.data[it]);
+                cb = Chr_ToUppercase(b.data[it]);
+            }
+            else {
+                ca = a.data[it];
+                cb = b.data[it];
+            }
+
+            if (ca != cb) {
+                result = false;
+                break;
+            }
+        }
+    }
+
+    return result;
+}
+
+// @todo: probably want to move away from vsnprintf to allow us to have custom type
+// printing etc.
+//
+#include <stdio.h> // vsnprintf
+
+#if !defined(STR8_INITIAL_FORMAT_GUESS_SIZE)
+    #define STR8_INITIAL_FORMAT_GUESS_SIZE 1024
+#endif
+
+internal S64 Str8_ProcessFormat(U8 *buffer, S64 count, const char *format, va_list args) {
+    S64 result = vsnprintf((char *) buffer, count, format, args);
+    return result;
+}
+
+Str8 Str8_FormatArgs(M_Arena *arena, const char *format, va_list args) {
+    Str8 result;
+
+    va_list copy;
+    va_copy(copy, args);
+
+    S64 buffer_size = STR8_INITIAL_FORMAT_GUESS_SIZE;
+    U8 *buffer      = M_ArenaPush(arena, U8, buffer_size);
+
+    S64 count = Str8_ProcessFormat(buffer, buffer_size, format, args);
+    if (count >= buffer_size) {
+        // not enough space in the initial guess so pop the entire buffer, push the
+        // correct size and process format again
+        //
+        M_ArenaPopLast(arena);
+
+        result.count = count;
+        result.data  = M_ArenaPush(arena, U8, result.count + 1);
+
+        Str8_ProcessFormat(result.data, result.count + 1, format, copy);
+    }
+    else if (count < 0) {
+        // error occurred
+        //
+        M_ArenaPopLast(arena);
+
+        result.count = 0;
+        result.data  = 0;
+    }
+    else {
+        // initial size was enough, pop any unused portion of the initial buffer
+        //
+        result.count = count;
+        result.data  = buffer;
+
+        // we keep the null-terminating byte
+        //
+        M_ArenaPopSize(arena, buffer_size - count - 1);
+    }
+
+    return result;
+}
+
+Str8 Str8_Format(M_Arena *arena, const char *format, ...) {
+    Str8 result;
+
+    va_list args;
+    va_start(args, format);
+
+    result = Str8_FormatArgs(arena, format, args);
+
+    va_end(args);
+
+    return result;
+}
+
+// string slicing, all counts are in bytes
+//
+Str8 Str8_Prefix(Str8 str, S64 count) {
+    Str8 result;
+    result.count = Min(str.count, count);
+    result.data  = str.data;
+
+    return result;
+}
+
+Str8 Str8_Suffix(Str8 str, S64 count) {
+    Str8 result;
+    result.count = Min(str.count, count);
+    result.data  = str.data + (str.count - result.count);
+
+    return result;
+}
+
+Str8 Str8_Advance(Str8 str, S64 count) {
+    Str8 result;
+    result.count = str.count - Min(str.count, count);
+    result.data  = str.data  + Min(str.count, count);
+
+    return result;
+}
+
+Str8 Str8_Remove(Str8 str, S64 count) {
+    Str8 result;
+    result.count = str.count - Min(str.count, count);
+    result.data  = str.data;
+
+    return result;
+}
+
+Str8 Str8_Slice(Str8 str, S64 start, S64 end) {
+    Str8 result;
+
+    Assert(start <= end);
+
+    result.count = Min(str.count, end - start);
+    result.data  = str.data + Min(str.count, start);
+
+    return result;
+}
+
+// these are ascii only and are meant to be used with char literals
+//
+// including the found character
+//
+Str8 Str8_RemoveAfterFirst(Str8 str, U8 chr) {
+    Str8 result = str;
+
+    for (S64 it = 0; it < str.count; ++it) {
+        if (str.data[it] == chr) {
+            result = Str8_Prefix(str, it);
+            break;
+        }
+    }
+
+    return result;
+}
+
+Str8 Str8_RemoveAfterLast(Str8 str, U8 chr) {
+    Str8 result = str;
+
+    for (S64 it = str.count - 1; it >= 0; --it) {
+        if (str.data[it] == chr) {
+            result = Str8_Prefix(str, it);
+            break;
+        }
+    }
+
+    return result;
+}
+
+Str8 Str8_RemoveBeforeFirst(Str8 str, U8 chr) {
+    Str8 result = str;
+
+    for (S64 it = 0; it < str.count; ++it) {
+        if (str.data[it] == chr) {
+            result = Str8_Suffix(str, str.count - it - 1);
+            break;
+        }
+    }
+
+    return result;
+}
+
+Str8 Str8_RemoveBeforeLast(Str8 str, U8 chr) {
+    Str8 result = str;
+
+    for (S64 it = str.count - 1; it >= 0; --it) {
+        if (str.data[it] == chr) {
+            result = Str8_Suffix(str, str.count - it - 1);
+            break;
+        }
+    }
+
+    return result;
+}
+
+Str8 Str8_GetBasename(Str8 path) {
+    Str8 result = path;
+
+    for (S64 it = path.count - 1; it >= 0; --it) {
+        if (Chr_IsPathSeparator(path.data[it])) {
+            result = Str8_Suffix(path, path.count - it - 1);
+            break;
+        }
+    }
+
+    return result;
+}
+
+Str8 Str8_GetDirname(Str8 path) {
+    // if a path separator isn't found, use 'current working directory'
+    //
+    Str8 result = Sl(".");
+
+    for (S64 it = path.count - 1; it >= 0; --it) {
+        if (Chr_IsPathSeparator(path.data[it])) {
+            result = Str8_Prefix(path, it);
+            break;
+        }
+    }
+
+    return result;
+}
+
+Str8 Str8_GetExtension(Str8 path) {
+    Str8 result = Sl(""); // if '.' is not found, no extension
+
+    for (S64 it = path.count - 1; it >= 0; --it) {
+        if (path.data[it] == '.') {
+            result = Str8_Suffix(path, path.count - it - 1);
+            break;
+        }
+    }
+
+    return result;
+}
+
+Str8 Str8_StripExtension(Str8 path) {
+    Str8 result = path;
+
+    for (S64 it = path.count - 1; it >= 0; --it) {
+        if (path.data[it] == '.') {
+            result = Str8_Prefix(path, it);
+            break;
+        }
+    }
+
+    return result;
+}
+
+Codepoint UTF8_Decode(Str8 str) {
+    Codepoint result;
+
+    local_persist const U8 lengths[] = {
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+        0, 0, 0, 0, 0, 0, 0, 0, 2, 2, 2, 2, 3, 3, 4, 0
+    };
+
+    local_persist const U32 masks[] = { 0x00, 0x7F, 0x1F, 0x0F, 0x07 };
+
+    if (str.count > 0) {
+        U8 *data = str.data;
+
+        U32 len   = lengths[data[0] >> 3];
+        U32 avail = cast(U32) Min(len, str.count);
+
+        U32 codepoint = data[0] & masks[len];
+
+        for (U32 it = 1; it < avail; ++it) {
+            codepoint <<= 6;
+            codepoint  |= (data[it] & 0x3F);
+        }
+
+        // don't go past the end of the string, may produce invalid codepoints
+        //
+        result.count = avail;
+        result.value = codepoint;
+    }
+    else {
+        result.value = '?';
+        result.count =  1 ;
+    }
+
+    return result;
+}
+
+U32 UTF8_Encode(U8 *output, U32 codepoint) {
+    U32 result;
+
+    if (codepoint <= 0x7F) {
+        output[0] = cast(U8) codepoint;
+        result    = 1;
+    }
+    else if (codepoint <= 0x7FF) {
+        output[0] = ((codepoint >> 6) & 0x1F) | 0xC0;
+        output[1] = ((codepoint >> 0) & 0x3F) | 0x80;
+        result    = 2;
+    }
+    else if (codepoint <= 0xFFFF) {
+        output[0] = ((codepoint >> 12) & 0x0F) | 0xE0;
+        output[1] = ((codepoint >>  6) & 0x3F) | 0x80;
+        output[2] = ((codepoint >>  0) & 0x3F) | 0x80;
+        result    = 3;
+    }
+    else if (codepoint <= 0x10FFFF) {
+        output[0] = ((codepoint >> 18) & 0x07) | 0xF0;
+        output[1] = ((codepoint >> 12) & 0x3F) | 0x80;
+        output[2] = ((codepoint >>  6) & 0x3F) | 0x80;
+        output[3] = ((codepoint >>  0) & 0x3F) | 0x80;
+        result    = 4;
+    }
+    else {
+        output[0] = '?';
+        result    =  1 ;
+    }
+
+    return result;
+}
+
+// character utilities
+//
+B32 Chr_IsWhitespace(U8 c) {
+    B32 result = (c == ' ') || (c == '\n') || (c == '\r') || (c == '\t') || (c == '\f') || (c == '\v');
+    return result;
+}
+
+B32 Chr_IsAlpha(U8 c) {
+    B32 result = Chr_IsUppercase(c) || Chr_IsLowercase(c);
+    return result;
+}
+
+B32 Chr_IsUppercase(U8 c) {
+    B32 result = (c >= 'A' && c <= 'Z');
+    return result;
+}
+
+B32 Chr_IsLowercase(U8 c) {
+    B32 result = (c >= 'a' && c <= 'z');
+    return result;
+}
+
+B32 Chr_IsNumber(U8 c) {
+    B32 result = (c >= '0' && c <= '9');
+    return result;
+}
+
+B32 Chr_IsHex(U8 c) {
+    B32 result = Chr_IsNumber(c) || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+    return result;
+}
+
+B32 Chr_IsSlash(U8 c) {
+    B32 result = (c == '/') || (c == '\\');
+    return result;
+}
+
+B32 Chr_IsPathSeparator(U8 c) {
+#if OS_WINDOWS
+    B32 result = (c == '/') || (c == '\\');
+#else
+    B32 result = (c == '/');
+#endif
+
+    return result;
+}
+
+U8 Chr_ToUppercase(U8 c) {
+    U8 result = Chr_IsLowercase(c) ? (c - ('a' - 'A')) : c;
+    return result;
+}
+
+U8 Chr_ToLowercase(U8 c) {
+    U8 result = Chr_IsUppercase(c) ? (c + ('a' - 'A')) : c;
+    return result;
+}
+
+// string interning
+//
+// slots hold the id in the low 32 bits and the top 32 bits of the hash in the high 32 bits so
+// most mismatches are rejected without touching the string, zero is an empty slot. tables are
+// never modified once they are too full, a larger table is built and published in its place and
+// the old one is left in the arena for any readers still probing it
+//
+#define STR8_INTERN_TABLE_INIT 256
+
+struct Str8_InternTable {
+    U64 mask;
+    volatile U64 *slots;
+};
+
+internal void __Str8_LockInterner(Str8_Interner *interner) {
+    while (!AtomicCompareExchange_U32(&interner->lock, 1, 0)) { SpinPause(); }
+}
+
+internal void __Str8_UnlockInterner(Str8_Interner *interner) {
+    AtomicExchange_U32(&interner->lock, 0);
+}
+
+internal Str8_InternTable *__Str8_AllocInternTable(M_Arena *arena, U64 capacity) {
+    Str8_InternTable *result = M_ArenaPush(arena, Str8_InternTable);
+
+    result->mask  = capacity - 1;
+    result->slots = M_ArenaPush(arena, U64, capacity);
+
+    return result;
+}
+
+internal void __Str8_InternTableInsert(Str8_InternTable *table, U64 hash, U32 id) {
+    U64 index = hash & table->mask;
+    while (table->slots[index] != 0) { index = (index + 1) & table->mask; }
+
+    // releases the string written for 'id' to any thread that acquires the slot
+    //
+    AtomicStore_U64(&table->slots[index], (hash & 0xFFFFFFFF00000000ULL) | id);
+}
+
+internal U32 __Str8_InternTableFind(Str8_Interner *interner, Str8_InternTable *table, Str8 str, U64 hash) {
+    U32 result = 0;
+
+    Str8 *strings = M_ArrayItems(interner->strings, Str8);
+    U64   tag     = hash & 0xFFFFFFFF00000000ULL;
+
+    for (U64 index = hash & table->mask;; index = (index + 1) & table->mask) {
+        U64 slot = AtomicLoad_U64(&table->slots[index]);
+        if (slot == 0) { break; }
+
+        if ((slot & 0xFFFFFFFF00000000ULL) == tag) {
+            U32   id    = cast(U32) slot;
+            Str8 *entry = &strings[id - 1];
+
+            if (entry->count == str.count && M_CompareSize(entry->data, str.data, str.count)) {
+                result = id;
+                break;
+            }
+        }
+    }
+
+    return result;
+}
+
+Str8_Interner *Str8_AllocInterner(U64 limit) {
+    M_Arena *arena = M_AllocArena(limit);
+    M_SetArenaName(arena, S("intern"));
+
+    Str8_Interner *result = M_ArenaPush(arena, Str8_Interner);
+
+    result->arena   = arena;
+    result->strings = M_AllocArrayT(STR8_INTERN_MAX_COUNT * sizeof(Str8), Str8);
+    result->table   = __Str8_AllocInternTable(arena, STR8_INTERN_TABLE_INIT);
+
+    return result;
+}
+
+void Str8_ReleaseInterner(Str8_Interner *interner) {
+    M_ReleaseArray(interner->strings);
+    M_ReleaseArena(interner->arena);
+}
+
+U32 Str8_FindInternId(Str8_Interner *interner, Str8 str) {
+    Str8_InternTable *table = cast(Str8_InternTable *) AtomicLoad_Ptr(cast(void *volatile *) &interner->table);
+
+    U32 result = __Str8_InternTableFind(interner, table, str, Hash_Str8(str));
+    return result;
+}
+
+U32 Str8_InternId(Str8_Interner *interner, Str8 str) {
+    U64 hash = Hash_Str8(str);
+
+    Str8_InternTable *table = cast(Str8_InternTable *) AtomicLoad_Ptr(cast(void *volatile *) &interner->table);
+
+    U32 result = __Str8_InternTableFind(interner, table, str, hash);
+    if (result == 0) {
+        __Str8_LockInterner(interner);
+
+        // another thread may have interned the same string or grown the table after the
+        // lock-free lookup loaded it, so search again while holding the lock
+        //
+        table  = interner->table;
+        result = __Str8_InternTableFind(interner, table, str, hash);
+
+        if (result == 0) {
+            Str8 *entry = M_ArrayPush(interner->strings, Str8);
+
+            if (entry) {
+                result = interner->count + 1;
+                *entry = Str8_Copy(interner->arena, str);
+
+                // kept at most half full so probe sequences stay short
+                //
+                if ((result << 1) > (table->mask + 1)) {
+                    Str8_InternTable *grown = __Str8_AllocInternTable(interner->arena, (table->mask + 1) << 1);
+
+                    Str8 *strings = M_ArrayItems(interner->strings, Str8);
+                    for (U32 id = 1; id < result; ++id) {
+                        __Str8_InternTableInsert(grown, Hash_Str8(strings[id - 1]), id);
+                    }
+
+                    AtomicStore_Ptr(cast(void *volatile *) &interner->table, grown);
+                    table = grown;
+                }
+
+                __Str8_InternTableInsert(table, hash, result);
+                AtomicStore_U32(&interner->count, result);
+            }
+        }
+
+        __Str8_UnlockInterner(interner);
+    }
+
+    return result;
+}
+
+Str8 Str8_Intern(Str8_Interner *interner, Str8 str) {
+    Str8 result = ZERO(Str8);
+
+    U32 id = Str8_InternId(interner, str);
+    if (id != 0) { result = M_ArrayItems(interner->strings, Str8)[id - 1]; }
+
+    return result;
+}
+
+Str8 Str8_FromInternId(Str8_Interner *interner, U32 id) {
+    Str8 result = ZERO(Str8);
+
+    if (id != 0 && id <= AtomicLoad_U32(&interner->count)) {
+        result = M_ArrayItems(interner->strings, Str8)[id - 1];
+    }
+
+    return result;
+}
+
+//
+// --------------------------------------------------------------------------------
+// :impl_stream
+// --------------------------------------------------------------------------------
+//
+
+internal STREAM_REFILL(Stream_RefillZeros) {
+    Stream_Error result = stream->error;
+
+    local_persist U8 zeros[64];
+
+    stream->start = zeros;
+    stream->end   = zeros + sizeof(zeros);
+    stream->pos   = zeros;
+
+    return result;
+}
+
+internal STREAM_REFILL(Stream_RefillMemory) {
+    Stream_Error result = Stream_Fail(stream, STREAM_ERROR_READ_PAST_END);
+    return result;
+}
+
+void Stream_Zero(Stream_Context *stream) {
+    stream->bit_buffer = 0;
+    stream->bit_count  = 0;
+
+    stream->error = STREAM_ERROR_NONE;
+
+    stream->RefillFunc = Stream_RefillZeros;
+    stream->RefillFunc(stream);
+}
+
+void Stream_FromMemory(Stream_Context *stream, Str8 memory) {
+    stream->bit_buffer = 0;
+    stream->bit_count  = 0;
+
+    stream->error = STREAM_ERROR_NONE;
+
+    stream->start = memory.data;
+    stream->end   = memory.data + memory.count;
+    stream->pos   = memory.data;
+
+    stream->RefillFunc = Stream_RefillMemory;
+}
+
+Stream_Error Stream_Fail(Stream_Context *stream, Stream_Error err) {
+    Stream_Error result;
+
+    stream->error      = err;
+    stream->RefillFunc = Stream_RefillZeros;
+
+    result = stream->RefillFunc(stream);
+    return result;
+}
+
+// Bit functions
+//
+void Stream_RefillBits(Stream_Context *stream) {
+    // @todo: think about how to handle this if we need more than 32-bits
+    // in our bit buffer.
+    //
+    // If we have a larger amount it may cause over-reads where the codec
+    // has specifically put mechanisms in place to prevent them. This could
+    // potentially cause a refill call when it was unexpected by client code
+    // and will desync the entire bitstream
+    //
+    // for example in PNG during the DEFLATE stage a BTYPE of 0 will first
+    // align the bitstream to a byte boundary and then read two 16 bit
+    // values, as 32-bits is the maximum it will read this guarantees the
+    // bit buffer/count will be zero after. Thus when copying literals directly
+    // (which updates the streams 'pos') there is no worry about having to
+    // flush the bit buffer or over-reading.
+    //
+    // One option could be to fill the bit buffer without actually consuming bytes
+    // and only update the "pos" pointer when consuming bits instead. However,
+    // this has the issue of having to do a "dummy" refill to lookahead if
+    // we reach the end of the stream section
+    //
+    // We could just require the max number of bits to be provided to the
+    // this refill bits call
+    //
+
+    for (; stream->bit_count <= 24; stream->bit_count += 8) {
+        if (stream->pos == stream->end) {
+            // We have run out of bytes to put into the bit buffer so
+            // attempt to refill, if on failure it will produce the virtual
+            // zero stream and pad the extra bytes to zero
+            //
+            stream->RefillFunc(stream);
+        }
+
+        stream->bit_buffer |= (*stream->pos++ << stream->bit_count);
+    }
+}
+
+void Stream_ConsumeBits(Stream_Context *stream, U32 count) {
+    Assert(stream->bit_count >= count);
+
+    stream->bit_buffer >>= count;
+    stream->bit_count   -= count;
+}
+
+U32 Stream_PeekBits(Stream_Context *stream, U32 count) {
+    Assert(count < 32);
+
+    if (stream->bit_count < count) {
+        // Not enough bit, refill!
+        //
+        Stream_RefillBits(stream);
+    }
+
+    // this works with zero count
+    //
+    U32 result = stream->bit_buffer & ((1ULL << count) - 1);
+    return result;
+}
+
+// This will peek and then consume 'count' bits in one go
+//
+U32 Stream_ReadBits(Stream_Context *stream, U32 count) {
+    U32 result = Stream_PeekBits(stream, count);
+
+    Stream_ConsumeBits(stream, count);
+    return result;
+}
+
+//
+// --------------------------------------------------------------------------------
+// :impl_logging
+// --------------------------------------------------------------------------------
+//
+
+#if !defined(LOG_CONTEXT_ARENA_SIZE)
+    #define LOG_CONTEXT_ARENA_SIZE MB(64)
+#endif
+
+#if !defined(LOG_INTERN_ARENA_SIZE)
+    #define LOG_INTERN_ARENA_SIZE MB(8)
+#endif
+
+thread_static Log_Context *__thread_logger;
+
+// file and function names are shared by every thread's logger, they come from a small fixed set
+// of call sites so are interned rather than copied for every message
+//
+global_var Str8_Interner *__log_interner;
+
+Str8 Log_StrFromLevel(S32 level) {
+    Str8 result = S("Custom");
+
+    switch (level) {
+        case LOG_DEBUG: { result = S("Debug");   } break;
+        case LOG_INFO:  { result = S("Info");    } break;
+        case LOG_WARN:  { result = S("Warning"); } break;
+        case LOG_ERROR: { result = S("Error");   } break;
+        default: {} break;
+    }
+
+    return result;
+}
+
+void Log_Init() {
+    if (AtomicLoad_Ptr(cast(void *volatile *) &__log_interner) == 0) {
+        Str8_Interner *interner = Str8_AllocInterner(LOG_INTERN_ARENA_SIZE);
+
+        if (!AtomicCompareExchange_Ptr(cast(void *volatile *) &__log_interner, interner, 0)) {
+            Str8_ReleaseInterner(interner);
+        }
+    }
+
+    if (__thread_logger == 0) {
+        M_Arena *arena  = M_AllocArena(LOG_CONTEXT_ARENA_SIZE);
+        M_SetArenaName(arena, S("log"));
+
+        __thread_logger = M_ArenaPush(arena, Log_Context);
+        __thread_logger->arena = arena;
+
+        // Push a default scope for logging messages to
+        //
+        Log_PushScope();
+    }
+}
+
+void Log_PushScope() {
+    U64 offset = M_GetArenaOffset(__thread_logger->arena);
+
+    Log_Scope *scope = M_ArenaPush(__thread_logger->arena, Log_Scope);
+    scope->offset    = offset;
+
+    SLL_Push(__thread_logger->scopes, scope);
+}
+
+Log_MessageArray Log_PopScope(M_Arena *arena) {
+    Log_MessageArray result = ZERO(Log_MessageArray);
+
+    Log_Scope *scope = __thread_logger->scopes;
+    Log_MessageList *messages = &scope->messages;
+
+    // Copy all of the messages into the result array, then
+    // remove pop the logger arena position back to the offset
+    //
+    if (messages->num_messages != 0) {
+        result.count = messages->num_messages;
+        result.items = M_ArenaPush(arena, Log_Message, result.count);
+
+        Log_Message *src = messages->first;
+        for (U32 it = 0; it < result.count; ++it) {
+            Log_Message *dst = &result.items[it];
+
+            dst->next = dst + 1;
+
+            dst->code = src->code;
+
+            dst->file = Str8_Copy(arena, src->file);
+            dst->func = Str8_Copy(arena, src->func);
+            dst->line = src->line;
+
+            dst->message = Str8_Copy(arena, src->message);
+
+            src = src->next;
+        }
+
+        result.items[result.count - 1].next = 0;
+    }
+
+    __thread_logger->scopes = scope->next;
+    M_ArenaPopTo(__thread_logger->arena, scope->offset);
+
+    if (__thread_logger->scopes == 0) {
+        // If all scopes have been popped, push a default scope
+        // so there is always one valid
+        //
+        Log_PushScope();
+    }
+
+    return result;
+}
+
+void Log_PushMessageArgs(S32 code, Str8 file, U32 line, Str8 func, const char *format, va_list args) {
+    Assert(__thread_logger != 0);
+
+    Log_Message *node = M_ArenaPush(__thread_logger->arena, Log_Message);
+
+    node->code = code;
+
+    node->file = Str8_Intern(__log_interner, file);
+    node->func = Str8_Intern(__log_interner, func);
+    node->line = line;
+
+    // only once the interner is full
+    //
+    if (node->file.data == 0) { node->file = Str8_Copy(__thread_logger->arena, file); }
+    if (node->func.data == 0) { node->func = Str8_Copy(__thread_logger->arena, func); }
+
+    node->message = Str8_FormatArgs(__thread_logger->arena, format, args);
+
+    // Pull the top scope and push the message onto its list
+    //
+    Log_MessageList *messages = &__thread_logger->scopes->messages;
+
+    SLL_Enqueue(messages->first, messages->last, node);
+    messages->num_messages += 1;
+}
+
+void Log_PushMessage(S32 code, Str8 file, U32 line, Str8 func, const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+
+    Log_PushMessageArgs(code, file, line, func, format, args);
+
+    va_end(args);
+}
+
+//
+// --------------------------------------------------------------------------------
+// :impl_filesystem
+// --------------------------------------------------------------------------------
+//
+
+#if OS_WINDOWS
+
+//
+// :windows_filesystem
+//
+
+internal void Win32_ListPathRecurse(M_Arena *arena, FS_List *list, Str8 path, FS_ListFlags flags) {
+    M_Temp temp  = M_AcquireTemp(1, &arena);
+
+    // we have to append the wildcard to search
+    //
+    Str8 search_path = Sf(temp.arena, "%.*s\\*", Sv(path));
+    WCHAR *wpath     = Win32_WideFromStr8(temp.arena, search_path);
+
+    B32 recurse        = (flags & FS_LIST_RECURSIVE)      != 0;
+    B32 include_hidden = (flags & FS_LIST_INCLUDE_HIDDEN) != 0;
+
+    WIN32_FIND_DATAW find_data;
+    HANDLE find = FindFirstFileW(wpath, &find_data);
+
+    while (find != INVALID_HANDLE_VALUE) {
+        Str8 basename = Win32_Str8FromWide(temp.arena, find_data.cFileName);
+
+        B32 should_skip = false;
+        B32 is_hidden   = true;
+
+        if (basename.count == 2 && basename.data[0] == '.' && basename.data[1] == '.') {
+            // always skip relative ..
+            //
+            should_skip = true;
+        }
+        else if (basename.count && basename.data[0] == '.') {
+            // always skip relative . or if not including hidden files skip "unix-style" hidden files
+            // beginning with a .
+            //
+            should_skip = ((basename.count == 1) || !include_hidden);
+        }
+        else {
+            is_hidden = (find_data.dwFileAttributes & FILE_ATTRIBUTE_HIDDEN);
+        }
+
+        should_skip = should_skip || (!include_hidden && is_hidden);
+
+        if (!should_skip) {
+            // Create and fill out the entry for the list
+            //
+            FS_Entry *entry = M_ArenaPush(arena, FS_Entry);
+
+            FILETIME *ct = &find_data.ftCreationTime;
+            FILETIME *at = &find_data.ftLastAccessTime;
+            FILETIME *wt = &find_data.ftLastWriteTime;
+
+            B32 is_dir = (find_data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY);
+
+            entry->path   = Sf(arena, "%.*s/%.*s", Sv(path), Sv(basename));
+            entry->size   = Compose_U64(find_data.nFileSizeHigh, find_data.nFileSizeLow);
+            entry->props |= is_hidden ? FS_PROPERTY_IS_HIDDEN    : 0;
+            entry->props |= is_dir    ? FS_PROPERTY_IS_DIRECTORY : 0;
+
+            entry->times.written  = Compose_U64(wt->dwHighDateTime, wt->dwLowDateTime);
+            entry->times.accessed = Compose_U64(at->dwHighDateTime, at->dwLowDateTime);
+            entry->times.created  = Compose_U64(ct->dwHighDateTime, ct->dwLowDateTime);
+
+            SLL_Enqueue(list->first, list->last, entry);
+
+            list->num_entries += 1;
+
+            if (recurse && is_dir) { Win32_ListPathRecurse(arena, list, entry->path, flags); }
+        }
+
+        if (!FindNextFileW(find, &find_data)) {
+            break;
+        }
+    }
+
+    M_ReleaseTemp(temp);
+}
+
+FS_List FS_ListPath(M_Arena *arena, Str8 path, FS_ListFlags flags) {
+    FS_List result = ZERO(FS_List);
+
+    Win32_ListPathRecurse(arena, &result, path, flags);
+    return result;
+}
+
+OS_Handle FS_OpenFile(Str8 path, FS_Access access) {
+    OS_Handle result = OS_NilHandle();
+
+    DWORD dwAccess   = 0;
+    DWORD dwCreation = OPEN_EXISTING;
+
+    if (access & FS_ACCESS_READ) {
+        dwAccess   |= GENERIC_READ;
+        dwCreation  = OPEN_EXISTING;
+    }
+
+    if (access & FS_ACCESS_WRITE) {
+        dwAccess   |= GENERIC_WRITE;
+        dwCreation  = OPEN_ALWAYS;
+    }
+
+    // resolve relative path and convert to UTF-16
+    //
+    M_Temp temp  = M_AcquireTemp(0, 0);
+    WCHAR *wpath = Win32_WideFromStr8(temp.arena, path);
+
+    HANDLE hFile = CreateFileW(wpath, dwAccess, FILE_SHARE_READ, 0, dwCreation, FILE_ATTRIBUTE_NORMAL, 0);
+
+    if (hFile != INVALID_HANDLE_VALUE) {
+        result.v[0] = cast(U64) hFile;
+    }
+    else {
+        Log_Error("Failed to open file '%.*s' (0x%x)", Sv(path), GetLastError());
+    }
+
+    M_ReleaseTemp(temp);
+
+    return result;
+}
+
+void FS_CloseFile(OS_Handle file) {
+    if (OS_HandleValid(file)) {
+        HANDLE hFile = cast(HANDLE) file.v[0];
+        CloseHandle(hFile);
+    }
+}
+
+B32 FS_RemoveFile(Str8 path) {
+    B32 result;
+
+    M_Temp temp  = M_AcquireTemp(0, 0);
+    WCHAR *wpath = Win32_WideFromStr8(temp.arena, path);
+
+    result = DeleteFileW(wpath);
+    if (!result) {
+        Log_Error("Failed to delete file '%.*s' (0x%x)", Sv(path), GetLastError());
+    }
+
+    M_ReleaseTemp(temp);
+
+    return result;
+}
+
+S64 FS_ReadFile(OS_Handle file, Str8 data, U64 offset) {
+    S64 result = 0;
+
+    if (OS_HandleValid(file)) {
+        HANDLE hFile  = cast(HANDLE) file.v[0];
+        U8 *ptr       = data.data;
+        S64 remaining = data.count;
+
+        OVERLAPPED overlapped = ZERO(OVERLAPPED);
+        overlapped.Offset     = cast(DWORD) (offset >>  0);
+        overlapped.OffsetHigh = cast(DWORD) (offset >> 32);
+
+        while (remaining > 0) {
+            DWORD nread   = 0;
+            DWORD to_read = SaturateCast_U32(remaining);
+
+            if (ReadFile(hFile, ptr, to_read, &nread, &overlapped)) {
+                remaining -= nread;
+                ptr       += nread;
+                offset    += nread;
+
+                overlapped.Offset     = cast(DWORD) (offset >>  0);
+                overlapped.OffsetHigh = cast(DWORD) (offset >> 32);
+            }
+            else {
+                Log_Error("Failed to read %d bytes at offset %lld (0x%x)", to_read, offset, GetLastError());
+                break;
+            }
+        }
+
+        result = cast(S64) (ptr - data.data);
+    }
+    else {
+        Log_Error("Invalid file handle");
+    }
+
+    return result;
+}
+
+S64 FS_WriteFile(OS_Handle file, Str8 data, U64 offset) {
+    S64 result = 0;
+
+    if (OS_HandleValid(file)) {
+        HANDLE hFile  = cast(HANDLE) file.v[0];
+        U8 *ptr       = data.data;
+        S64 remaining = data.count;
+
+        OVERLAPPED overlapped = ZERO(OVERLAPPED);
+        overlapped.Offset     = cast(DWORD) (offset >>  0);
+        overlapped.OffsetHigh = cast(DWORD) (offset >> 32);
+
+        while (remaining > 0) {
+            DWORD nwritten = 0;
+            DWORD to_write = SaturateCast_U32(remaining);
+
+            if (WriteFile(hFile, ptr, to_write, &nwritten, &overlapped)) {
+                remaining -= nwritten;
+                ptr       += nwritten;
+                offset    += nwritten;
+
+                overlapped.Offset     = cast(DWORD) (offset >>  0);
+                overlapped.OffsetHigh = cast(DWORD) (offset >> 32);
+            }
+            else {
+                Log_Error("Failed to write %d bytes at offset %lld (0x%x)", to_write, offset, GetLastError());
+                break;
+            }
+        }
+
+        result = cast(S64) (ptr - data.data);
+    }
+    else {
+        Log_Error("Invalid file handle");
+    }
+
+    return result;
+}
+
+S64 FS_AppendFile(OS_Handle file, Str8 data) {
+    S64 result = 0;
+
+    if (OS_HandleValid(file)) {
+        HANDLE hFile = cast(HANDLE) file.v[0];
+
+        FILE_STANDARD_INFO info;
+        if (GetFileInformationByHandleEx(hFile, FileStandardInfo, &info, sizeof(FILE_STANDARD_INFO))) {
+            U64 offset = info.EndOfFile.QuadPart;
+            result     = FS_WriteFile(file, data, offset);
+        }
+        else {
+            Log_Error("Failed to get end-of-file offset (0x%x)", GetLastError());
+        }
+    }
+    else {
+        Log_Error("Invalid file handle");
+    }
+
+    return result;
+}
+
+FS_Properties FS_PropertiesFromHandle(OS_Handle file) {
+    FS_Properties result = 0;
+
+    if (OS_HandleValid(file)) {
+        HANDLE hFile = cast(HANDLE) file.v[0];
+
+        BY_HANDLE_FILE_INFORMATION info;
+        if (GetFileInformationByHandle(hFile, &info)) {
+            DWORD attrs = info.dwFileAttributes;
+
+            M_Temp temp   = M_AcquireTemp(0, 0);
+            Str8 path     = FS_PathFromHandle(temp.arena, file);
+            Str8 basename = Str8_GetBasename(path);
+
+            result |= (attrs & FILE_ATTRIBUTE_DIRECTORY)          ? FS_PROPERTY_IS_DIRECTORY : 0;
+            result |= (attrs & FILE_ATTRIBUTE_HIDDEN)             ? FS_PROPERTY_IS_HIDDEN    : 0;
+            result |= (basename.count && basename.data[0] == '.') ? FS_PROPERTY_IS_HIDDEN    : 0;
+
+            M_ReleaseTemp(temp);
+        }
+        else {
+            Log_Error("Failed to get file handle information (0x%x)", GetLastError());
+        }
+    }
+    else {
+        Log_Error("Invalid file handle");
+    }
+
+    return result;
+}
+
+FS_Time FS_TimeFromHandle(OS_Handle file) {
+    FS_Time result = ZERO(FS_Time);
+
+    if (OS_HandleValid(file)) {
+        HANDLE hFile = cast(HANDLE) file.v[0];
+
+        FILETIME ct, at, wt;
+        if (GetFileTime(hFile, &ct, &at, &wt)) {
+            result.created  = Compose_U64(ct.dwHighDateTime, ct.dwLowDateTime);
+            result.accessed = Compose_U64(at.dwHighDateTime, at.dwLowDateTime);
+            result.written  = Compose_U64(wt.dwHighDateTime, wt.dwLowDateTime);
+        }
+        else {
+            Log_Error("Failed to get file times (0x%x)", GetLastError());
+        }
+    }
+    else {
+        Log_Error("Invalid file handle");
+    }
+
+    return result;
+}
+
+Str8 FS_PathFromHandle(M_Arena *arena, OS_Handle file) {
+    Str8 result = ZERO(Str8);
+
+    if (OS_HandleValid(file)) {
+        HANDLE hFile = cast(HANDLE) file.v[0];
+        M_Temp temp  = M_AcquireTemp(1, &arena);
+
+        // Push a 1KiB buffer as an initial guess, if that is too small the
+        // FILE_NAME_INFO will contain how long we need to make the buffer so pop
+        // last and retry with the correct length
+        //
+        DWORD dwBufferSize    = KB(1);
+        U8 *lpFileInformation = M_ArenaPush(temp.arena, U8, dwBufferSize);
+
+        if (!GetFileInformationByHandleEx(hFile, FileNameInfo, lpFileInformation, dwBufferSize)) {
+            DWORD err = GetLastError();
+            if (err == ERROR_MORE_DATA) {
+                FILE_NAME_INFO *name_info = cast(FILE_NAME_INFO *) lpFileInformation;
+                dwBufferSize = name_info->FileNameLength + sizeof(FILE_NAME_INFO) + 2;
+
+                M_ArenaPopLast(temp.arena);
+
+                lpFileInformation = M_ArenaPush(temp.arena, U8, dwBufferSize);
+                if (!GetFileInformationByHandleEx(hFile, FileNameInfo, lpFileInformation, dwBufferSize)) {
+                    Log_Error("Failed to get file handle name information (0x%x)", GetLastError());
+                    lpFileInformation = 0;
+                }
+            }
+            else {
+                Log_Error("Failed to get file handle name information (0x%x)", err);
+                lpFileInformation = 0;
+            }
+        }
+
+        if (lpFileInformation) {
+            // We got the filename
+            //
+            FILE_NAME_INFO *name_info = cast(FILE_NAME_INFO *) lpFileInformation;
+            result = Win32_Str8FromWide(arena, name_info->FileName);
+        }
+
+        M_ReleaseTemp(temp);
+    }
+    else {
+        Log_Error("Invalid file handle");
+    }
+
+    return result;
+}
+
+U64 FS_SizeFromHandle(OS_Handle file) {
+    U64 result = 0;
+
+    if (OS_HandleValid(file)) {
+        HANDLE hFile = cast(HANDLE) file.v[0];
+
+        LARGE_INTEGER size;
+        if (GetFileSizeEx(hFile, &size)) {
+            result = size.QuadPart;
+        }
+        else {
+            Log_Error("Failed to get file size (0x%x)", GetLastError());
+        }
+    }
+    else {
+        Log_Error("Invalid file handle");
+    }
+
+    return result;
+}
+
+FS_Properties FS_PropertiesFromPath(Str8 path) {
+    FS_Properties result = 0;
+
+    M_Temp temp  = M_AcquireTemp(0, 0);
+    WCHAR *wpath = Win32_WideFromStr8(temp.arena, path);
+
+    DWORD attrs = GetFileAttributesW(wpath);
+    if (attrs != INVALID_FILE_ATTRIBUTES) {
+        result |= (attrs & FILE_ATTRIBUTE_DIRECTORY) ? FS_PROPERTY_IS_DIRECTORY : 0;
+        result |= (attrs & FILE_ATTRIBUTE_HIDDEN)    ? FS_PROPERTY_IS_HIDDEN    : 0;
+    }
+    else {
+        Log_Error("Failed to get file attributes for '%.*s' (0x%x)", Sv(path), GetLastError());
+    }
+
+    M_ReleaseTemp(temp);
+
+    return result;
+}
+
+FS_Time FS_TimeFromPath(Str8 path) {
+    FS_Time result = ZERO(FS_Time);
+
+    M_Temp temp  = M_AcquireTemp(0, 0);
+    WCHAR *wpath = Win32_WideFromStr8(temp.arena, path);
+
+    WIN32_FILE_ATTRIBUTE_DATA attrs;
+    if (GetFileAttributesExW(wpath, GetFileExInfoStandard, &attrs)) {
+        FILETIME *ct = &attrs.ftCreationTime;
+        FILETIME *at = &attrs.ftLastAccessTime;
+        FILETIME *wt = &attrs.ftLastWriteTime;
+
+        result.created  = Compose_U64(ct->dwHighDateTime, ct->dwLowDateTime);
+        result.accessed = Compose_U64(at->dwHighDateTime, at->dwLowDateTime);
+        result.written  = Compose_U64(wt->dwHighDateTime, wt->dwLowDateTime);
+    }
+    else {
+        Log_Error("Failed to get file attributes for '%.*s' (0x%x)", Sv(path), GetLastError());
+    }
+
+    M_ReleaseTemp(temp);
+
+    return result;
+}
+
+U64 FS_SizeFromPath(Str8 path) {
+    U64 result = 0;
+
+    M_Temp temp  = M_AcquireTemp(0, 0);
+    WCHAR *wpath = Win32_WideFromStr8(temp.arena, path);
+
+    WIN32_FILE_ATTRIBUTE_DATA attrs;
+    if (GetFileAttributesExW(wpath, GetFileExInfoStandard, &attrs)) {
+        result = Compose_U64(attrs.nFileSizeHigh, attrs.nFileSizeLow);
+    }
+    else {
+        Log_Error("Failed to get file attributes for '%.*s' (0x%x)", Sv(path), GetLastError());
+    }
+
+    M_ReleaseTemp(temp);
+
+    return result;
+}
+
+B32 FS_CreateDirectory(Str8 path) {
+    B32 result = true;
+
+    M_Temp temp  = M_AcquireTemp(0, 0);
+    WCHAR *wpath = Win32_WideFromStr8(temp.arena, path);
+
+    U64 it = 0;
+    while (wpath[it] != 0) {
+        if (wpath[it] == L'/' || wpath[it] == L'\\') {
+            // We temporarily null-terminate this segment to create parent directories
+            //
+            WCHAR sep = wpath[it];
+            wpath[it] = L'\0';
+
+            if (!CreateDirectoryW(wpath, 0)) {
+                DWORD err = GetLastError();
+                if (err != ERROR_ALREADY_EXISTS) {
+                    Str8 dir = Win32_Str8FromWide(temp.arena, wpath);
+                    Log_Error("Failed to create directory '%.*s' (0x%x)", Sv(dir), err);
+
+                    result = false;
+                    break;
+                }
+            }
+
+            // restore the separator
+            //
+            wpath[it] = sep;
+        }
+
+        it += 1;
+    }
+
+    if (result) {
+        // We successfully created all of the parent directories (or they already existed) so
+        // create the final directory
+        //
+        if (!CreateDirectoryW(wpath, 0)) {
+            DWORD err = GetLastError();
+            if (err == ERROR_ALREADY_EXISTS) {
+                DWORD attrs = GetFileAttributesW(wpath);
+                if ((attrs & FILE_ATTRIBUTE_DIRECTORY) == 0) {
+                    Log_Error("Attempted to create directory at '%.*s', but a file was found", Sv(path));
+                    result = false;
+                }
+            }
+            else {
+                Log_Error("Failed to create directory '%.*s' (0x%x)", Sv(path), err);
+                result = false;
+            }
+        }
+    }
+
+    M_ReleaseTemp(temp);
+
+    return result;
+}
+
+B32 FS_RemoveDirectory(Str8 path) {
+    B32 result;
+
+    M_Temp temp  = M_AcquireTemp(0, 0);
+    WCHAR *wpath = Win32_WideFromStr8(temp.arena, path);
+
+    result = RemoveDirectoryW(wpath);
+    M_ReleaseTemp(temp);
+
+    return result;
+}
+
+Str8 FS_GetPath(M_Arena *arena, FS_PathType type) {
+    Str8 result = ZERO(Str8);
+
+    if (type < FS_PATH_COUNT) {
+        result = Str8_Copy(arena, __windows->cached_paths[type]);
+    }
+
+    return result;
+}
+
+#elif OS_MACOS
+    #error "macOS filesystem subsystem not implemented"
+#elif OS_LINUX
+
+//
+// :linux_filesystem
+//
+
+#include <fcntl.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <dirent.h>
+#include <linux/limits.h>
+
+#define LINUX_DENTS_BUFFER_SIZE 1024
+
+typedef struct linux_dirent64 linux_dirent64_t;
+struct linux_dirent64 {
+    __ino64_t      d_ino;    /* 64-bit inode number */
+    __off64_t      d_off;    /* Not an offset; see getdents() */
+    unsigned short d_reclen; /* Size of this dirent */
+    unsigned char  d_type;   /* File type */
+    char           d_name[]; /* Filename (null-terminated) */
+};
+
+internal void Linux_ListPathRecursive(M_Arena *arena, FS_List *list, Str8 path, FS_ListFlags flags) {
+    M_Temp temp = M_AcquireTemp(1, &arena);
+    Str8 zpath  = Str8_Copy(temp.arena, path);
+
+    B32 recurse        = (flags & FS_LIST_RECURSIVE)      != 0;
+    B32 include_hidden = (flags & FS_LIST_INCLUDE_HIDDEN) != 0;
+
+    char *buffer = M_ArenaPush(temp.arena, char, LINUX_DENTS_BUFFER_SIZE);
+
+    int fd = open((const char *) zpath.data, O_RDONLY | O_DIRECTORY);
+    if (fd >= 0) {
+        for (;;) {
+            ssize_t nread = syscall(SYS_getdents64, fd, buffer, LINUX_DENTS_BUFFER_SIZE);
+            if (nread < 0) {
+                Log_Error("Failed to list directory '%.*s' (%d)", Sv(path), errno);
+                break;
+            }
+            else if (nread == 0) {
+                // done
+                //
+                break;
+            }
+
+            for (ssize_t off = 0; off < nread;) {
+                linux_dirent64_t *ent = cast(linux_dirent64_t *) (buffer + off);
+                off += ent->d_reclen;
+
+                B32 should_skip = false;
+                B32 is_hidden   = false;
+                B32 is_dir      = (ent->d_type == DT_DIR);
+
+                Str8 basename   = Sz(ent->d_name);
+
+                if (basename.count == 2 && basename.data[0] == '.' && basename.data[1] == '.') {
+                    // always skip relative '..' entry
+                    //
+                    should_skip = true;
+                }
+                else if (basename.count && basename.data[0] == '.') {
+                    // always skip relative '.' or skip names starting with '.' if
+                    // the user hasn't requested the inclusion of hidden files
+                    //
+                    should_skip = ((basename.count == 1) || !include_hidden);
+                    is_hidden   = true;
+                }
+
+                if (!should_skip) {
+                    FS_Entry *entry = M_ArenaPush(arena, FS_Entry);
+
+                    entry->path = Sf(arena, "%.*s/%.*s", Sv(path), Sv(basename));
+
+                    entry->props |= is_hidden ? FS_PROPERTY_IS_HIDDEN    : 0;
+                    entry->props |= is_dir    ? FS_PROPERTY_IS_DIRECTORY : 0;
+
+                    struct stat stbuf;
+                    if (stat((const char *) entry->path.data, &stbuf) == 0) {
+                        entry->size = stbuf.st_size;
+                        entry->times.written  = (1e9 * stbuf.st_mtim.tv_nsec) + stbuf.st_mtim.tv_sec;
+                        entry->times.accessed = (1e9 * stbuf.st_atim.tv_nsec) + stbuf.st_atim.tv_sec;
+                        entry->times.created  = 0;
+                    }
+
+                    SLL_Enqueue(list->first, list->last, entry);
+
+                    list->num_entries += 1;
+
+                    if (recurse && is_dir) { Linux_ListPathRecursive(arena, list, entry->path, flags); }
+                }
+            }
+        }
+
+        close(fd);
+    }
+    else {
+        Log_Error("Failed to open '%.*s' for reading (%d)", Sv(path), errno);
+    }
+
+    M_ReleaseTemp(temp);
+}
+
+FS_List FS_ListPath(M_Arena *arena, Str8 path, FS_ListFlags flags) {
+    FS_List result = ZERO(FS_List);
+
+    Linux_ListPathRecursive(arena, &result, path, flags);
+    return result;
+}
+
+OS_Handle FS_OpenFile(Str8 path, FS_Access access) {
+    OS_Handle result = OS_NilHandle();
+
+    if (access) {
+        M_Temp temp = M_AcquireTemp(0, 0);
+        Str8 zpath  = Str8_Copy(temp.arena, path);
+
+        int flags = O_RDONLY;
+        mode_t mode = 0;
+
+        if (access & FS_ACCESS_WRITE) {
+            flags = ((access & FS_ACCESS_READ) ? O_RDWR : O_WRONLY) | O_CREAT;
+            mode  = S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH; // 0644 permissions
+        }
+
+        int fd = open((const char *) zpath.data, flags, mode);
+        if (fd >= 0) {
+            result.v[0] = cast(U64) fd;
+        }
+        else {
+            Log_Error("Failed to open file '%.*s' (%d)", Sv(path), errno);
+        }
+
+        M_ReleaseTemp(temp);
+    }
+    return result;
+}
+
+void FS_CloseFile(OS_Handle file) {
+    if (OS_HandleValid(file)) {
+        int fd = cast(int) file.v[0];
+        close(fd);
+    }
+}
+
+B32 FS_RemoveFile(Str8 path) {
+    M_Temp temp = M_AcquireTemp(0, 0);
+    Str8 zpath  = Str8_Copy(temp.arena, path);
+
+    B32 result = unlink((const char *) zpath.data) == 0;
+
+    M_ReleaseTemp(temp);
+    return result;
+}
+
+S64 FS_ReadFile(OS_Handle file, Str8 data, U64 offset) {
+    S64 result = 0;
+
+    if (OS_HandleValid(file)) {
+        int    fd         = cast(int) file.v[0];
+        U8    *ptr        = data.data;
+        ssize_t remaining = data.count;
+
+        while (remaining > 0) {
+            ssize_t nread = pread(fd, ptr, remaining, offset);
+            if (nread >= 0) {
+                remaining -= nread;
+                ptr       += nread;
+                offset    += nread;
+            }
+            else {
+                Log_Error("Failed to read %llu bytes at offset %llu (%d)", remaining, offset, errno);
+                break;
+            }
+        }
+
+        Assert(remaining >= 0);
+
+        result = cast(S64) (ptr - data.data);
+    }
+    else {
+        Log_Error("Invalid file handle");
+    }
+
+    return result;
+}
+
+S64 FS_WriteFile(OS_Handle file, Str8 data, U64 offset) {
+    S64 result = 0;
+
+    if (OS_HandleValid(file)) {
+        int     fd        = cast(int) file.v[0];
+        U8     *ptr       = data.data;
+        ssize_t remaining = data.count;
+
+        while (remaining > 0) {
+            ssize_t nwritten = pwrite(fd, ptr, remaining, offset);
+            if (nwritten >= 0) {
+                remaining -= nwritten;
+                ptr       += nwritten;
+                offset    += nwritten;
+            }
+            else {
+                Log_Error("Failed to read %llu bytes at offset %llu (%d)", remaining, offset, errno);
+                break;
+            }
+        }
+
+        Assert(remaining >= 0);
+
+        result = cast(S64) (ptr - data.data);
+    }
+    else {
+        Log_Error("Invalid file handle");
+    }
+
+    return result;
+}
+
+S64 FS_AppendFile(OS_Handle file, Str8 data) {
+    S64 result = 0;
+
+    if (OS_HandleValid(file)) {
+        int fd = cast(int) file.v[0];
+
+        struct stat stbuf;
+        if (fstat(fd, &stbuf) == 0) {
+            U64 offset = stbuf.st_size;
+            result     = FS_WriteFile(file, data, offset);
+        }
+        else {
+            Log_Error("Failed to get end-of-file offset (%d)", errno);
+        }
+    }
+    else {
+        Log_Error("Invalid file handle");
+    }
+
+    return result;
+}
+
+FS_Properties FS_PropertiesFromHandle(OS_Handle file) {
+    FS_Properties result = 0;
+
+    if (OS_HandleValid(file)) {
+        int fd = cast(int) file.v[0];
+
+        struct stat stbuf;
+        if (fstat(fd, &stbuf) == 0) {
+            M_Temp temp = M_AcquireTemp(0, 0);
+            Str8 path   = FS_PathFromHandle(temp.arena, file);
+
+            B32 is_dir    = ((stbuf.st_mode & S_IFMT) == S_IFDIR);
+            B32 is_hidden = (path.count && path.data[0] == '.');
+
+            result |= is_dir    ? FS_PROPERTY_IS_DIRECTORY : 0;
+            result |= is_hidden ? FS_PROPERTY_IS_HIDDEN    : 0;
+
+            M_ReleaseTemp(temp);
+        }
+        else {
+            Log_Error("Failed to get file descriptor information (%d)", errno);
+        }
+    }
+    else {
+        Log_Error("Invalid file handle");
+    }
+
+    return result;
+}
+
+FS_Time FS_TimeFromHandle(OS_Handle file) {
+    FS_Time result = ZERO(FS_Time);
+
+    if (OS_HandleValid(file)) {
+        int fd = cast(int) file.v[0];
+
+        struct stat stbuf;
+        if (fstat(fd, &stbuf) == 0) {
+            result.written  = (1e9 * stbuf.st_mtim.tv_sec) + stbuf.st_mtim.tv_nsec;
+            result.accessed = (1e9 * stbuf.st_atim.tv_sec) + stbuf.st_mtim.tv_nsec;
+            result.created  = 0; // not available on unix ?
+        }
+        else {
+            Log_Error("fstat failed on '%d' (%d)", fd, errno);
+        }
+    }
+    else {
+        Log_Error("Invalid file handle");
+    }
+
+    return result;
+}
+
+Str8 FS_PathFromHandle(M_Arena *arena, OS_Handle file) {
+    Str8 result = ZERO(Str8);
+
+    if (OS_HandleValid(file)) {
+        M_Temp temp = M_AcquireTemp(1, &arena);
+
+        int  fd      = cast(int) file.v[0];
+        Str8 fd_path = Sf(temp.arena, "/proc/self/fd/%d", fd);
+
+        char *buffer;
+        S64 size = 512;
+
+        ssize_t count;
+        for (;;) {
+            // we have to keep iterating towards the required buffer size
+            // because readlink wont actually tell us
+            //
+            size *= 2;
+            buffer = M_ArenaPush(temp.arena, char, size);
+
+            count = readlink((const char *) fd_path.data, buffer, size);
+            if (count < size) { break; }
+
+            M_ArenaPopLast(temp.arena);
+        }
+
+        if (count > 0) {
+            result.count = count;
+            result.data  = M_ArenaPushCopy(arena, buffer, U8, count + 1);
+        }
+        else {
+            Log_Error("readlink failed on '%.*s' (%d)", Sv(fd_path), errno);
+        }
+
+        M_ReleaseTemp(temp);
+    }
+
+    return result;
+}
+
+U64 FS_SizeFromHandle(OS_Handle file) {
+    S64 result = 0;
+
+    if (OS_HandleValid(file)) {
+        int fd = cast(int) file.v[0];
+
+        struct stat stbuf;
+        if (fstat(fd, &stbuf) == 0) {
+            result = stbuf.st_size;
+        }
+        else {
+            Log_Error("fstat failed on '%d' (%d)", fd, errno);
+        }
+    }
+    else {
+        Log_Error("Invalid file handle");
+    }
+
+    return result;
+}
+
+FS_Properties FS_PropertiesFromPath(Str8 path) {
+    FS_Properties result = 0;
+
+    M_Temp temp = M_AcquireTemp(0, 0);
+    Str8 zpath  = Str8_Copy(temp.arena, path);
+
+    struct stat stbuf;
+    if (stat((const char *) zpath.data, &stbuf) == 0) {
+        B32 is_dir    = ((stbuf.st_mode & S_IFMT) == S_IFDIR);
+        B32 is_hidden = (path.count && path.data[0] == '.');
+
+        result |= is_dir    ? FS_PROPERTY_IS_DIRECTORY : 0;
+        result |= is_hidden ? FS_PROPERTY_IS_HIDDEN    : 0;
+    }
+    else {
+        Log_Error("stat failed on path '%.*s' (%d)", Sv(path), errno);
+    }
+
+    M_ReleaseTemp(temp);
+
+    return result;
+}
+
+FS_Time FS_TimeFromPath(Str8 path) {
+    FS_Time result = ZERO(FS_Time);
+
+    M_Temp temp = M_AcquireTemp(0, 0);
+    Str8 zpath  = Str8_Copy(temp.arena, path);
+
+    struct stat stbuf;
+    if (stat((const char *) zpath.data, &stbuf) == 0) {
+        result.written  = (1e9 * stbuf.st_mtim.tv_sec) + stbuf.st_mtim.tv_nsec;
+        result.accessed = (1e9 * stbuf.st_atim.tv_sec) + stbuf.st_mtim.tv_nsec;
+        result.created  = 0; // not available on unix ?
+    }
+    else {
+        Log_Error("stat failed on path '%.*s' (%d)", Sv(path), errno);
+    }
+
+    M_ReleaseTemp(temp);
+
+    return result;
+}
+
+U64 FS_SizeFromPath(Str8 path) {
+    U64 result = 0;
+
+    M_Temp temp = M_AcquireTemp(0, 0);
+    Str8 zpath  = Str8_Copy(temp.arena, path);
+
+    struct stat stbuf;
+    if (stat((const char *) zpath.data, &stbuf) == 0) {
+        result = stbuf.st_size;
+    }
+    else {
+        Log_Error("stat failed on path '%.*s' (%d)", Sv(path), errno);
+    }
+
+    M_ReleaseTemp(temp);
+
+    return result;
+}
+
+B32 FS_CreateDirectory(Str8 path) {
+    B32 result = true;
+
+    M_Temp temp = M_AcquireTemp(0, 0);
+    Str8 cpy    = Str8_Copy(temp.arena, path);
+
+    char *zpath = cast(char *) cpy.data;
+
+    S64 it = 0;
+    while (zpath[it]) {
+        if (zpath[it] == '/') {
+            zpath[it] = 0;
+
+            mode_t mode = S_IRWXU | S_IRGRP | S_IXGRP | S_IROTH | S_IXOTH; // 0755
+            if (mkdir(zpath, mode) != 0) {
+                if (errno != EEXIST) {
+                    Log_Error("Failed to create directory '%s' (%d)", zpath, errno);
+
+                    result = false;
+                    break;
+                }
+            }
+
+            zpath[it] = '/';
+        }
+
+        it += 1;
+    }
+
+    if (result) {
+        mode_t mode = S_IRWXU | S_IRGRP | S_IXGRP | S_IROTH | S_IXOTH; // 0755
+        if (mkdir(zpath, mode) != 0) {
+            result = false;
+            if (errno == EEXIST) {
+                struct stat stbuf;
+                if (stat(zpath, &stbuf) == 0) {
+                    result = ((stbuf.st_mode & S_IFMT) == S_IFDIR);
+                }
+            }
+        }
+    }
+
+    M_ReleaseTemp(temp);
+
+    return result;
+}
+
+B32 FS_RemoveDirectory(Str8 path) {
+    M_Temp temp = M_AcquireTemp(0, 0);
+    Str8 zpath  = Str8_Copy(temp.arena, path);
+
+    B32 result = rmdir((const char *) zpath.data) == 0;
+
+    M_ReleaseTemp(temp);
+
+    return result;
+}
+
+Str8 FS_GetPath(M_Arena *arena, FS_PathType type) {
+    Str8 result = ZERO(Str8);
+
+    if (type == FS_PATH_WORKING) {
+        M_Temp temp = M_AcquireTemp(1, &arena);
+
+        size_t size  = PATH_MAX;
+        char *buffer = M_ArenaPush(temp.arena, char, size);
+
+        for (;;) {
+            if (getcwd(buffer, size)) {
+                break;
+            }
+            else if (errno != ERANGE) {
+                Log_Error("Failed to get current directory (%d)", errno);
+
+                buffer = 0;
+                break;
+            }
+
+            M_ArenaPopLast(temp.arena);
+
+            size  *= 2;
+            buffer = M_ArenaPush(temp.arena, char, size);
+        }
+
+        if (buffer) { result = Str8_Copy(arena, Sz(buffer)); }
+
+        M_ReleaseTemp(temp);
+    }
+    else if (type < FS_PATH_COUNT) {
+        result = Str8_Copy(arena, __linux_context->cached_paths[type]);
+    }
+
+    return result;
+}
+
+#elif OS_SWITCH
+    #error "Switchbrew filesystem subsystem not implemented"
+#endif
+
+Str8 FS_ReadEntireFile(M_Arena *arena, Str8 path) {
+    Str8 result = ZERO(Str8);
+
+    OS_Handle file = FS_OpenFile(path, FS_ACCESS_READ);
+
+    result.count = FS_SizeFromHandle(file);
+    result.data  = M_ArenaPush(arena, U8, result.count);
+
+    FS_ReadFile(file, result, 0);
+
+    FS_CloseFile(file);
+
+    return result;
+}
+
+//
+// --------------------------------------------------------------------------------
+// :impl_threading
+// --------------------------------------------------------------------------------
+//
+
+#if OS_WINDOWS
+
+//
+// --------------------------------------------------------------------------------
+// :windows_threading
+// --------------------------------------------------------------------------------
+//
+
+internal DWORD Win32_ThreadEntry(LPVOID param) {
+    DWORD result = 0;
+
+    Win32_Object *object = cast(Win32_Object *) param;
+
+    Log_Init();
+
+    T_ThreadProc *TProc  = object->thread.Proc;
+    void         *tparam = object->thread.param;
+
+    TProc(tparam);
+
+    LONG ref = _InterlockedAnd(&object->thread.ref, ~0x2);
+    if ((ref & 0x1) == 0) {
+        CloseHandle(object->thread.handle);
+        Win32_ReleaseObject(object);
+    }
+
+    return result;
+}
+
+void T_CreateThread(T_Thread *thread) {
+    Win32_Object *object = Win32_AllocObject(WIN32_OBJECT_THREAD);
+
+    object->thread.Proc  = thread->Proc;
+    object->thread.param = thread->param;
+
+    DWORD id, flags = CREATE_SUSPENDED;
+
+    HANDLE handle = CreateThread(0, thread->stack_size, Win32_ThreadEntry, object, flags, &id);
+
+    object->thread.handle = handle;
+    object->thread.id     = id;
+    object->thread.ref    = 0x3;
+
+    thread->handle.v[0] = cast(U64) object;
+
+    if (thread->flags & T_THREAD_CREATE_DETACHED) {
+        // Detach the calling thread from the new thread automatically, this way
+        // you don't have to care about managing the returned handle if you
+        // just want to "fire and forget" threads at startup
+        //
+        // Returned handle becomes invalid
+        //
+        T_DetachThread(thread->handle);
+        thread->handle = OS_NilHandle();
+
+        // Always resume the thread if created detached otherwise there wouldn't
+        // be any way for the calling thread to resume the created thread!
+        //
+        ResumeThread(object->thread.handle);
+    }
+    else if ((thread->flags & T_THREAD_CREATE_SUSPENDED) == 0) {
+        // Automatically resume the thread as it wasn't requested to be
+        //
+        ResumeThread(object->thread.handle);
+    }
+}
+
+void T_ResumeThread(OS_Handle thread) {
+    Win32_Object *object = cast(Win32_Object *) thread.v[0];
+    Assert(object->type == WIN32_OBJECT_THREAD);
+
+    ResumeThread(object->thread.handle);
+}
+
+void T_JoinThread(OS_Handle thread) {
+    Win32_Object *object = cast(Win32_Object *) thread.v[0];
+    Assert(object->type == WIN32_OBJECT_THREAD);
+
+    WaitForSingleObject(object->thread.handle, INFINITE);
+}
+
+void T_DetachThread(OS_Handle thread) {
+    Win32_Object *object = cast(Win32_Object *) thread.v[0];
+    Assert(object->type == WIN32_OBJECT_THREAD);
+
+    LONG ref = _InterlockedAnd(&object->thread.ref, ~0x1);
+    if ((ref & 0x2) == 0) {
+        CloseHandle(object->thread.handle);
+        Win32_ReleaseObject(object);
+    }
+}
+
+OS_Handle T_CreateMutex() {
+    OS_Handle result;
+
+    Win32_Object *object = Win32_AllocObject(WIN32_OBJECT_CRITICAL_SECTION);
+
+    // @todo: maybe change to "InitializeCriticalSectionAndSpinCount" for lower latency
+    // exchanges when contention is low
+    //
+    InitializeCriticalSection(&object->critical_section);
+
+    result.v[0] = cast(U64) object;
+    return result;
+}
+
+void T_DeleteMutex(OS_Handle mutex) {
+    Win32_Object *object = cast(Win32_Object *) mutex.v[0];
+    Assert(object->type == WIN32_OBJECT_CRITICAL_SECTION);
+
+    DeleteCriticalSection(&object->critical_section);
+
+    Win32_ReleaseObject(object);
+}
+
+void T_AcquireMutex(OS_Handle mutex) {
+    Win32_Object *object = cast(Win32_Object *) mutex.v[0];
+    Assert(object->type == WIN32_OBJECT_CRITICAL_SECTION);
+
+    EnterCriticalSection(&object->critical_section);
+}
+
+void T_ReleaseMutex(OS_Handle mutex) {
+    Win32_Object *object = cast(Win32_Object *) mutex.v[0];
+    Assert(object->type == WIN32_OBJECT_CRITICAL_SECTION);
+
+    LeaveCriticalSection(&object->critical_section);
+}
+
+OS_Handle T_CreateSemaphore(U32 max) {
+    OS_Handle result;
+
+    // @todo: maybe allow a name, we don't support cross-process semaphores
+    // however
+    //
+    HANDLE hSemaphore = CreateSemaphoreW(0, max, max, 0);
+
+    result.v[0] = cast(U64) hSemaphore;
+    return result;
+}
+
+void T_DeleteSemaphore(OS_Handle semaphore) {
+    HANDLE hSemaphore = cast(HANDLE) semaphore.v[0];
+    CloseHandle(hSemaphore);
+}
+
+void T_WaitSemaphore(OS_Handle semaphore) {
+    HANDLE hSemaphore = cast(HANDLE) semaphore.v[0];
+    WaitForSingleObject(hSemaphore, INFINITE);
+}
+
+void T_SignalSemaphore(OS_Handle semaphore) {
+    HANDLE hSemaphore = cast(HANDLE) semaphore.v[0];
+    ReleaseSemaphore(hSemaphore, 1, 0);
+}
+
+OS_Handle T_CreateRWLock() {
+    OS_Handle result;
+
+    // According to documentation the size of the SRWLock type is pointer sized, however,
+    // I don't know if the pointer has to be in the same memory location so we allocate
+    // it dynamically for now @test!!
+    //
+    Win32_Object *object = Win32_AllocObject(WIN32_OBJECT_SRWLOCK);
+    InitializeSRWLock(&object->srwlock);
+
+    result.v[0] = cast(U64) object;
+    return result;
+}
+
+void T_DeleteRWLock(OS_Handle rwlock) {
+    Win32_Object *object = cast(Win32_Object *) rwlock.v[0];
+    Assert(object->type == WIN32_OBJECT_SRWLOCK);
+
+    Win32_ReleaseObject(object);
+}
+
+void T_AcquireRWLockRead(OS_Handle rwlock) {
+    Win32_Object *object = cast(Win32_Object *) rwlock.v[0];
+    Assert(object->type == WIN32_OBJECT_SRWLOCK);
+
+    AcquireSRWLockShared(&object->srwlock);
+}
+
+void T_ReleaseRWLockRead(OS_Handle rwlock) {
+    Win32_Object *object = cast(Win32_Object *) rwlock.v[0];
+    Assert(object->type == WIN32_OBJECT_SRWLOCK);
+
+    ReleaseSRWLockShared(&object->srwlock);
+}
+
+void T_AcquireRWLockWrite(OS_Handle rwlock) {
+    Win32_Object *object = cast(Win32_Object *) rwlock.v[0];
+    Assert(object->type == WIN32_OBJECT_SRWLOCK);
+
+    AcquireSRWLockExclusive(&object->srwlock);
+}
+
+void T_ReleaseRWLockWrite(OS_Handle rwlock) {
+    Win32_Object *object = cast(Win32_Object *) rwlock.v[0];
+    Assert(object->type == WIN32_OBJECT_SRWLOCK);
+
+    ReleaseSRWLockExclusive(&object->srwlock);
+}
+
+OS_Handle T_CreateConditionVar() {
+    OS_Handle result;
+
+    Win32_Object *object = Win32_AllocObject(WIN32_OBJECT_CONDITION_VAR);
+    InitializeConditionVariable(&object->condition_var);
+
+    result.v[0] = cast(U64) object;
+    return result;
+}
+
+void T_DeleteConditionVar(OS_Handle condvar) {
+    Win32_Object *object = cast(Win32_Object *) condvar.v[0];
+    Assert(object->type == WIN32_OBJECT_CONDITION_VAR);
+
+    Win32_ReleaseObject(object);
+}
+
+void T_WaitConditionVar(OS_Handle condvar, OS_Handle mutex) {
+    Win32_Object *cvar = cast(Win32_Object *) condvar.v[0];
+    Win32_Object *lock = cast(Win32_Object *) mutex.v[0];
+
+    Assert(cvar->type == WIN32_OBJECT_CONDITION_VAR);
+    Assert(lock->type == WIN32_OBJECT_CRITICAL_SECTION);
+
+    SleepConditionVariableCS(&cvar->condition_var, &lock->critical_section, INFINITE);
+}
+
+void T_WaitConditionVarRead(OS_Handle condvar, OS_Handle rwlock) {
+    Win32_Object *cvar = cast(Win32_Object *) condvar.v[0];
+    Win32_Object *lock = cast(Win32_Object *) rwlock.v[0];
+
+    Assert(cvar->type == WIN32_OBJECT_CONDITION_VAR);
+    Assert(lock->type == WIN32_OBJECT_SRWLOCK);
+
+    ULONG flags = CONDITION_VARIABLE_LOCKMODE_SHARED;
+    SleepConditionVariableSRW(&cvar->condition_var, &lock->srwlock, INFINITE, flags);
+}
+
+void T_WaitConditionVarWrite(OS_Handle condvar, OS_Handle rwlock) {
+    Win32_Object *cvar = cast(Win32_Object *) condvar.v[0];
+    Win32_Object *lock = cast(Win32_Object *) rwlock.v[0];
+
+    Assert(cvar->type == WIN32_OBJECT_CONDITION_VAR);
+    Assert(lock->type == WIN32_OBJECT_SRWLOCK);
+
+    SleepConditionVariableSRW(&cvar->condition_var, &lock->srwlock, INFINITE, 0);
+}
+
+void T_WakeConditionVar(OS_Handle condvar) {
+    Win32_Object *object = cast(Win32_Object *) condvar.v[0];
+    Assert(object->type == WIN32_OBJECT_CONDITION_VAR);
+
+    WakeConditionVariable(&object->condition_var);
+}
+
+void T_BroadcastConditionVar(OS_Handle condvar) {
+    Win32_Object *object = cast(Win32_Object *) condvar.v[0];
+    Assert(object->type == WIN32_OBJECT_CONDITION_VAR);
+
+    WakeAllConditionVariable(&object->condition_var);
+}
+
+void T_WaitFutex(T_Futex *futex, U32 value) {
+    for (;;) {
+        WaitOnAddress(futex, &value, sizeof(U32), INFINITE);
+        if (futex[0] != value) { break; }
+    }
+}
+
+void T_WakeFutex(T_Futex *futex) {
+    WakeByAddressSingle(cast(PVOID) futex);
+}
+
+void T_BroadcastFutex(T_Futex *futex) {
+    WakeByAddressAll(cast(PVOID) futex);
+}
+
+#elif OS_MACOS
+    #error "macOS threading subsystem not implemented"
+#elif OS_LINUX
+
+//
+// --------------------------------------------------------------------------------
+// :linux_threading
+// --------------------------------------------------------------------------------
+//
+
+internal void *Linux_ThreadEntry(void *param) {
+    Linux_Object *object = cast(Linux_Object *) param;
+
+    // wait to be resumed if the thread was created suspended
+    //
+    while (object->thread.resume == 0) {
+        Linux_FutexWait(&object->thread.resume, 0);
+    }
+
+    Log_Init();
+
+    T_ThreadProc *TProc  = object->thread.Proc;
+    void         *tparam = object->thread.param;
+
+    TProc(tparam);
+
+    U32 ref = __atomic_fetch_and(&object->thread.ref, ~0x2, __ATOMIC_SEQ_CST);
+    if ((ref & 0x1) == 0) {
+        Linux_ReleaseObject(object);
+    }
+
+    return 0;
+}
+
+void T_CreateThread(T_Thread *thread) {
+    Linux_Object *object = Linux_AllocObject(LINUX_OBJECT_THREAD);
+
+    object->thread.Proc   = thread->Proc;
+    object->thread.param  = thread->param;
+    object->thread.ref    = 0x3;
+    object->thread.joined = false;
+
+    // detached threads are always resumed otherwise there would be no way for the calling
+    // thread to start them
+    //
+    B32 detached  = (thread->flags & T_THREAD_CREATE_DETACHED)  != 0;
+    B32 suspended = (thread->flags & T_THREAD_CREATE_SUSPENDED) != 0;
+
+    object->thread.resume = (detached || !suspended) ? 1 : 0;
+
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+
+    if (thread->stack_size != 0) {
+        size_t stack_size = Max(thread->stack_size, cast(U64) PTHREAD_STACK_MIN);
+        pthread_attr_setstacksize(&attr, AlignUp(stack_size, M_GetPageSize()));
+    }
+
+    int err = pthread_create(&object->thread.handle, &attr, Linux_ThreadEntry, object);
+
+    pthread_attr_destroy(&attr);
+
+    if (err == 0) {
+        thread->handle.v[0] = cast(U64) object;
+
+        if (detached) {
+            // Detach the calling thread from the new thread automatically, this way
+            // you don't have to care about managing the returned handle if you
+            // just want to "fire and forget" threads at startup
+            //
+            // Returned handle becomes invalid
+            //
+            T_DetachThread(thread->handle);
+            thread->handle = OS_NilHandle();
+        }
+    }
+    else {
+        Log_Error("Failed to create thread (%d)", err);
+
+        Linux_ReleaseObject(object);
+        thread->handle = OS_NilHandle();
+    }
+}
+
+void T_ResumeThread(OS_Handle thread) {
+    Linux_Object *object = cast(Linux_Object *) thread.v[0];
+    Assert(object->type == LINUX_OBJECT_THREAD);
+
+    if (AtomicExchange_U32(&object->thread.resume, 1) == 0) {
+        Linux_FutexWake(&object->thread.resume, 1);
+    }
+}
+
+void T_JoinThread(OS_Handle thread) {
+    Linux_Object *object = cast(Linux_Object *) thread.v[0];
+    Assert(object->type == LINUX_OBJECT_THREAD);
+
+    if (!object->thread.joined) {
+        pthread_join(object->thread.handle, 0);
+        object->thread.joined = true;
+    }
+}
+
+void T_DetachThread(OS_Handle thread) {
+    Linux_Object *object = cast(Linux_Object *) thread.v[0];
+    Assert(object->type == LINUX_OBJECT_THREAD);
+
+    // pthreads doesn't allow a joined thread to be detached, it has already been
+    // cleaned up by the join so we only have to release our reference
+    //
+    if (!object->thread.joined) { pthread_detach(object->thread.handle); }
+
+    U32 ref = __atomic_fetch_and(&object->thread.ref, ~0x1, __ATOMIC_SEQ_CST);
+    if ((ref & 0x2) == 0) {
+        Linux_ReleaseObject(object);
+    }
+}
+
+OS_Handle T_CreateMutex() {
+    OS_Handle result;
+
+    Linux_Object *object = Linux_AllocObject(LINUX_OBJECT_MUTEX);
+    object->mutex = 0;
+
+    result.v[0] = cast(U64) object;
+    return result;
+}
+
+void T_DeleteMutex(OS_Handle mutex) {
+    Linux_Object *object = cast(Linux_Object *) mutex.v[0];
+    Assert(object->type == LINUX_OBJECT_MUTEX);
+
+    Linux_ReleaseObject(object);
+}
+
+void T_AcquireMutex(OS_Handle mutex) {
+    Linux_Object *object = cast(Linux_Object *) mutex.v[0];
+    Assert(object->type == LINUX_OBJECT_MUTEX);
+
+    Linux_LockMutex(&object->mutex);
+}
+
+void T_ReleaseMutex(OS_Handle mutex) {
+    Linux_Object *object = cast(Linux_Object *) mutex.v[0];
+    Assert(object->type == LINUX_OBJECT_MUTEX);
+
+    Linux_UnlockMutex(&object->mutex);
+}
+
+OS_Handle T_CreateSemaphore(U32 max) {
+    OS_Handle result;
+
+    // matches windows, the semaphore starts with its full count available
+    //
+    Linux_Object *object = Linux_AllocObject(LINUX_OBJECT_SEMAPHORE);
+
+    object->semaphore.count   = max;
+    object->semaphore.max     = max;
+    object->semaphore.waiters = 0;
+
+    result.v[0] = cast(U64) object;
+    return result;
+}
+
+void T_DeleteSemaphore(OS_Handle semaphore) {
+    Linux_Object *object = cast(Linux_Object *) semaphore.v[0];
+    Assert(object->type == LINUX_OBJECT_SEMAPHORE);
+
+    Linux_ReleaseObject(object);
+}
+
+void T_WaitSemaphore(OS_Handle semaphore) {
+    Linux_Object *object = cast(Linux_Object *) semaphore.v[0];
+    Assert(object->type == LINUX_OBJECT_SEMAPHORE);
+
+    for (;;) {
+        U32 count = object->semaphore.count;
+        if (count != 0) {
+            if (AtomicCompareExchange_U32(&object->semaphore.count, count - 1, count)) { break; }
+        }
+        else {
+            AtomicAdd_U32(&object->semaphore.waiters, 1);
+            Linux_FutexWait(&object->semaphore.count, 0);
+            AtomicAdd_U32(&object->semaphore.waiters, cast(U32) -1);
+        }
+    }
+}
+
+void T_SignalSemaphore(OS_Handle semaphore) {
+    Linux_Object *object = cast(Linux_Object *) semaphore.v[0];
+    Assert(object->type == LINUX_OBJECT_SEMAPHORE);
+
+    for (;;) {
+        U32 count = object->semaphore.count;
+        if (count >= object->semaphore.max) {
+            // like ReleaseSemaphore signalling past the maximum count does nothing
+            //
+            break;
+        }
+
+        if (AtomicCompareExchange_U32(&object->semaphore.count, count + 1, count)) {
+            if (object->semaphore.waiters != 0) { Linux_FutexWake(&object->semaphore.count, 1); }
+            break;
+        }
+    }
+}
+
+OS_Handle T_CreateRWLock() {
+    OS_Handle result;
+
+    Linux_Object *object = Linux_AllocObject(LINUX_OBJECT_RWLOCK);
+    object->rwlock = 0;
+
+    result.v[0] = cast(U64) object;
+    return result;
+}
+
+void T_DeleteRWLock(OS_Handle rwlock) {
+    Linux_Object *object = cast(Linux_Object *) rwlock.v[0];
+    Assert(object->type == LINUX_OBJECT_RWLOCK);
+
+    Linux_ReleaseObject(object);
+}
+
+internal void Linux_LockRWLockRead(T_Futex *rwlock) {
+    for (;;) {
+        U32 state = rwlock[0];
+        if ((state & LINUX_RWLOCK_WRITER) == 0) {
+            if (AtomicCompareExchange_U32(rwlock, state + 1, state)) { break; }
+        }
+        else {
+            // writer holds the lock, flag that there is a waiter so the writer knows
+            // to wake us on release
+            //
+            U32 waiting = state | LINUX_RWLOCK_WAITING;
+            if (state == waiting || AtomicCompareExchange_U32(rwlock, waiting, state)) {
+                Linux_FutexWait(rwlock, waiting);
+            }
+        }
+    }
+}
 
-        B32 should_skip = false;
-        B32 is_hidden   = true;
+internal void Linux_UnlockRWLockRead(T_Futex *rwlock) {
+    U32 state = AtomicAdd_U32(rwlock, cast(U32) -1) - 1;
 
-        if (basename.count == 2 && basename.data[0] == '.' && basename.data[1] == '.') {
-            // always skip relative ..
-            //
-            should_skip = true;
+    if ((state & LINUX_RWLOCK_READERS) == 0 && (state & LINUX_RWLOCK_WAITING)) {
+        // last reader out with writers waiting, if this fails someone else has taken
+        // the lock in the meantime and will do the wake on their release
+        //
+        if (AtomicCompareExchange_U32(rwlock, state & ~LINUX_RWLOCK_WAITING, state)) {
+            Linux_FutexWake(rwlock, INT_MAX);
         }
-        else if (basename.count && basename.data[0] == '.') {
-            // always skip relative . or if not including hidden files skip "unix-style" hidden files
-            // beginning with a .
-            //
-            should_skip = ((basename.count == 1) || !include_hidden);
+    }
+}
+
+internal void Linux_LockRWLockWrite(T_Futex *rwlock) {
+    for (;;) {
+        U32 state = rwlock[0];
+        if ((state & (LINUX_RWLOCK_WRITER | LINUX_RWLOCK_READERS)) == 0) {
+            if (AtomicCompareExchange_U32(rwlock, state | LINUX_RWLOCK_WRITER, state)) { break; }
         }
         else {
-            is_hidden = (find_data.dwFileAttributes & FILE_ATTRIBUTE_HIDDEN);
+            U32 waiting = state | LINUX_RWLOCK_WAITING;
+            if (state == waiting || AtomicCompareExchange_U32(rwlock, waiting, state)) {
+                Linux_FutexWait(rwlock, waiting);
+            }
         }
+    }
+}
 
-        should_skip = should_skip || (!include_hidden && is_hidden);
+internal void Linux_UnlockRWLockWrite(T_Futex *rwlock) {
+    U32 state = AtomicExchange_U32(rwlock, 0);
+    if (state & LINUX_RWLOCK_WAITING) { Linux_FutexWake(rwlock, INT_MAX); }
+}
 
-        if (!should_skip) {
-            // Create and fill out the entry for the list
-            //
-            FS_Entry *entry = M_ArenaPush(arena, FS_Entry);
+void T_AcquireRWLockRead(OS_Handle rwlock) {
+    Linux_Object *object = cast(Linux_Object *) rwlock.v[0];
+    Assert(object->type == LINUX_OBJECT_RWLOCK);
 
-            FILETIME *ct = &find_data.ftCreationTime;
-            FILETIME *at = &find_data.ftLastAccessTime;
-            FILETIME *wt = &find_data.ftLastWriteTime;
+    Linux_LockRWLockRead(&object->rwlock);
+}
 
-            B32 is_dir = (find_data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY);
+void T_ReleaseRWLockRead(OS_Handle rwlock) {
+    Linux_Object *object = cast(Linux_Object *) rwlock.v[0];
+    Assert(object->type == LINUX_OBJECT_RWLOCK);
 
-            entry->path   = Sf(arena, "%.*s/%.*s", Sv(path), Sv(basename));
-            entry->size   = Compose_U64(find_data.nFileSizeHigh, find_data.nFileSizeLow);
-            entry->props |= is_hidden ? FS_PROPERTY_IS_HIDDEN    : 0;
-            entry->props |= is_dir    ? FS_PROPERTY_IS_DIRECTORY : 0;
+    Linux_UnlockRWLockRead(&object->rwlock);
+}
 
-            entry->times.written  = Compose_U64(wt->dwHighDateTime, wt->dwLowDateTime);
-            entry->times.accessed = Compose_U64(at->dwHighDateTime, at->dwLowDateTime);
-            entry->times.created  = Compose_U64(ct->dwHighDateTime, ct->dwLowDateTime);
+void T_AcquireRWLockWrite(OS_Handle rwlock) {
+    Linux_Object *object = cast(Linux_Object *) rwlock.v[0];
+    Assert(object->type == LINUX_OBJECT_RWLOCK);
 
-            SLL_Enqueue(list->first, list->last, entry);
+    Linux_LockRWLockWrite(&object->rwlock);
+}
 
-            list->num_entries += 1;
+void T_ReleaseRWLockWrite(OS_Handle rwlock) {
+    Linux_Object *object = cast(Linux_Object *) rwlock.v[0];
+    Assert(object->type == LINUX_OBJECT_RWLOCK);
 
-            if (recurse && is_dir) { Win32_ListPathRecurse(arena, list, entry->path, flags); }
-        }
+    Linux_UnlockRWLockWrite(&object->rwlock);
+}
 
-        if (!FindNextFileW(find, &find_data)) {
-            break;
-        }
-    }
+OS_Handle T_CreateConditionVar() {
+    OS_Handle result;
 
-    M_ReleaseTemp(temp);
+    Linux_Object *object = Linux_AllocObject(LINUX_OBJECT_CONDITION_VAR);
+    object->condition_var = 0;
+
+    result.v[0] = cast(U64) object;
+    return result;
 }
 
-FS_List FS_ListPath(M_Arena *arena, Str8 path, FS_ListFlags flags) {
-    FS_List result = ZERO(FS_List);
+void T_DeleteConditionVar(OS_Handle condvar) {
+    Linux_Object *object = cast(Linux_Object *) condvar.v[0];
+    Assert(object->type == LINUX_OBJECT_CONDITION_VAR);
 
-    Win32_ListPathRecurse(arena, &result, path, flags);
-    return result;
+    Linux_ReleaseObject(object);
 }
 
-OS_Handle FS_OpenFile(Str8 path, FS_Access access) {
-    OS_Handle result = OS_NilHandle();
+// the sequence number is sampled before the lock is released, this means any wake that
+// happens after releasing the lock will change the value and the futex wait will return
+// immediately rather than missing the wake
+//
+void T_WaitConditionVar(OS_Handle condvar, OS_Handle mutex) {
+    Linux_Object *cvar = cast(Linux_Object *) condvar.v[0];
+    Linux_Object *lock = cast(Linux_Object *) mutex.v[0];
 
-    DWORD dwAccess   = 0;
-    DWORD dwCreation = OPEN_EXISTING;
+    Assert(cvar->type == LINUX_OBJECT_CONDITION_VAR);
+    Assert(lock->type == LINUX_OBJECT_MUTEX);
 
-    if (access & FS_ACCESS_READ) {
-        dwAccess   |= GENERIC_READ;
-        dwCreation  = OPEN_EXISTING;
-    }
+    U32 seq = cvar->condition_var;
 
-    if (access & FS_ACCESS_WRITE) {
-        dwAccess   |= GENERIC_WRITE;
-        dwCreation  = OPEN_ALWAYS;
-    }
+    Linux_UnlockMutex(&lock->mutex);
+    Linux_FutexWait(&cvar->condition_var, seq);
+    Linux_LockMutex(&lock->mutex);
+}
 
-    // resolve relative path and convert to UTF-16
-    //
-    M_Temp temp  = M_AcquireTemp(0, 0);
-    WCHAR *wpath = Win32_WideFromStr8(temp.arena, path);
+void T_WaitConditionVarRead(OS_Handle condvar, OS_Handle rwlock) {
+    Linux_Object *cvar = cast(Linux_Object *) condvar.v[0];
+    Linux_Object *lock = cast(Linux_Object *) rwlock.v[0];
 
-    HANDLE hFile = CreateFileW(wpath, dwAccess, FILE_SHARE_READ, 0, dwCreation, FILE_ATTRIBUTE_NORMAL, 0);
+    Assert(cvar->type == LINUX_OBJECT_CONDITION_VAR);
+    Assert(lock->type == LINUX_OBJECT_RWLOCK);
 
-    if (hFile != INVALID_HANDLE_VALUE) {
-        result.v[0] = cast(U64) hFile;
-    }
-    else {
-        Log_Error("Failed to open file '%.*s' (0x%x)", Sv(path), GetLastError());
-    }
+    U32 seq = cvar->condition_var;
 
-    M_ReleaseTemp(temp);
+    Linux_UnlockRWLockRead(&lock->rwlock);
+    Linux_FutexWait(&cvar->condition_var, seq);
+    Linux_LockRWLockRead(&lock->rwlock);
+}
 
-    return result;
+void T_WaitConditionVarWrite(OS_Handle condvar, OS_Handle rwlock) {
+    Linux_Object *cvar = cast(Linux_Object *) condvar.v[0];
+    Linux_Object *lock = cast(Linux_Object *) rwlock.v[0];
+
+    Assert(cvar->type == LINUX_OBJECT_CONDITION_VAR);
+    Assert(lock->type == LINUX_OBJECT_RWLOCK);
+
+    U32 seq = cvar->condition_var;
+
+    Linux_UnlockRWLockWrite(&lock->rwlock);
+    Linux_FutexWait(&cvar->condition_var, seq);
+    Linux_LockRWLockWrite(&lock->rwlock);
 }
 
-void FS_CloseFile(OS_Handle file) {
-    if (OS_HandleValid(file)) {
-        HANDLE hFile = cast(HANDLE) file.v[0];
-        CloseHandle(hFile);
-    }
+void T_WakeConditionVar(OS_Handle condvar) {
+    Linux_Object *object = cast(Linux_Object *) condvar.v[0];
+    Assert(object->type == LINUX_OBJECT_CONDITION_VAR);
+
+    AtomicAdd_U32(&object->condition_var, 1);
+    Linux_FutexWake(&object->condition_var, 1);
 }
 
-B32 FS_RemoveFile(Str8 path) {
-    B32 result;
+void T_BroadcastConditionVar(OS_Handle condvar) {
+    Linux_Object *object = cast(Linux_Object *) condvar.v[0];
+    Assert(object->type == LINUX_OBJECT_CONDITION_VAR);
 
-    M_Temp temp  = M_AcquireTemp(0, 0);
-    WCHAR *wpath = Win32_WideFromStr8(temp.arena, path);
+    AtomicAdd_U32(&object->condition_var, 1);
+    Linux_FutexWake(&object->condition_var, INT_MAX);
+}
 
-    result = DeleteFileW(wpath);
-    if (!result) {
-        Log_Error("Failed to delete file '%.*s' (0x%x)", Sv(path), GetLastError());
+void T_WaitFutex(T_Futex *futex, U32 value) {
+    while (futex[0] == value) {
+        Linux_FutexWait(futex, value);
     }
+}
 
-    M_ReleaseTemp(temp);
+void T_WakeFutex(T_Futex *futex) {
+    Linux_FutexWake(futex, 1);
+}
 
-    return result;
+void T_BroadcastFutex(T_Futex *futex) {
+    Linux_FutexWake(futex, INT_MAX);
 }
 
-S64 FS_ReadFile(OS_Handle file, Str8 data, U64 offset) {
-    S64 result = 0;
+#elif OS_SWITCH
+    #error "Switchbrew threading subsystem not implemented"
+#endif
 
-    if (OS_HandleValid(file)) {
-        HANDLE hFile  = cast(HANDLE) file.v[0];
-        U8 *ptr       = data.data;
-        S64 remaining = data.count;
+// queues
+//
+// called after every push and pop, pairs with the waiter count being incremented before a parked
+// thread tries one last time so either that attempt succeeds or the waiter is seen here
+//
+internal void _T_QueueWake(volatile U32 *waiters, T_Futex *signal) {
+    AtomicFence();
 
-        OVERLAPPED overlapped = ZERO(OVERLAPPED);
-        overlapped.Offset     = cast(DWORD) (offset >>  0);
-        overlapped.OffsetHigh = cast(DWORD) (offset >> 32);
+    if (AtomicLoad_U32(waiters) != 0) {
+        AtomicAdd_U32(signal, 1);
+        T_WakeFutex(signal);
+    }
+}
 
-        while (remaining > 0) {
-            DWORD nread   = 0;
-            DWORD to_read = SaturateCast_U32(remaining);
+// elements are copied to and from the caller's storage which can have any alignment, the common
+// word sizes are moved directly and anything else goes through M_CopySize
+//
+internal void _T_QueueCopy(U8 *dst, U8 *src, U64 element_size) {
+    switch (element_size) {
+        case 4:  { M_CopyFixed(dst, src, sizeof(U32));     } break;
+        case 8:  { M_CopyFixed(dst, src, sizeof(U64));     } break;
+        case 16: { M_CopyFixed(dst, src, 2 * sizeof(U64)); } break;
+        default: { M_CopySize(dst, src, element_size);     } break;
+    }
+}
 
-            if (ReadFile(hFile, ptr, to_read, &nread, &overlapped)) {
-                remaining -= nread;
-                ptr       += nread;
-                offset    += nread;
+// 'signal' is changed by the other side each time it makes progress
+//
+#define _T_QUEUE_BLOCK(Try, queue, element, waiters, signal) \
+    U32 spins = 0; \
+    B32 done  = Try(queue, element); \
+    while (!done) { \
+        if (spins < T_QUEUE_SPIN_COUNT) { \
+            SpinPause(); \
+            spins += 1; \
+            done = Try(queue, element); \
+        } \
+        else { \
+            U32 value = AtomicLoad_U32(signal); \
+            AtomicAdd_U32(waiters, 1); \
+            done = Try(queue, element); \
+            if (!done) { T_WaitFutex(signal, value); } \
+            AtomicAdd_U32(waiters, cast(U32) -1); \
+        } \
+    }
 
-                overlapped.Offset     = cast(DWORD) (offset >>  0);
-                overlapped.OffsetHigh = cast(DWORD) (offset >> 32);
-            }
-            else {
-                Log_Error("Failed to read %d bytes at offset %lld (0x%x)", to_read, offset, GetLastError());
-                break;
-            }
-        }
+T_SPSCQueue *T_AllocSPSCQueue(M_Arena *arena, U64 element_size, U32 capacity) {
+    Assert(capacity != 0 && capacity <= (1U << 31));
 
-        result = cast(S64) (ptr - data.data);
-    }
-    else {
-        Log_Error("Invalid file handle");
-    }
+    T_SPSCQueue *result = M_ArenaPush(arena, T_SPSCQueue, 1, 0, 64);
+
+    capacity = NextPow2_U32(capacity);
+
+    result->mask         = capacity - 1;
+    result->element_size = element_size;
+    result->data         = M_ArenaPush(arena, U8, capacity * element_size, M_ARENA_NO_ZERO, 64);
 
     return result;
 }
 
-S64 FS_WriteFile(OS_Handle file, Str8 data, U64 offset) {
-    S64 result = 0;
+B32 T_SPSCTryPush(T_SPSCQueue *queue, void *element) {
+    U32 write = queue->write;
 
-    if (OS_HandleValid(file)) {
-        HANDLE hFile  = cast(HANDLE) file.v[0];
-        U8 *ptr       = data.data;
-        S64 remaining = data.count;
+    B32 result = (write - queue->read_cache) <= queue->mask;
+    if (!result) {
+        queue->read_cache = AtomicLoad_U32(&queue->read);
+        result = (write - queue->read_cache) <= queue->mask;
+    }
 
-        OVERLAPPED overlapped = ZERO(OVERLAPPED);
-        overlapped.Offset     = cast(DWORD) (offset >>  0);
-        overlapped.OffsetHigh = cast(DWORD) (offset >> 32);
+    if (result) {
+        _T_QueueCopy(queue->data + ((write & queue->mask) * queue->element_size), cast(U8 *) element, queue->element_size);
+        AtomicStore_U32(&queue->write, write + 1);
 
-        while (remaining > 0) {
-            DWORD nwritten = 0;
-            DWORD to_write = SaturateCast_U32(remaining);
+        _T_QueueWake(&queue->pop_waiters, &queue->pushed);
+    }
 
-            if (WriteFile(hFile, ptr, to_write, &nwritten, &overlapped)) {
-                remaining -= nwritten;
-                ptr       += nwritten;
-                offset    += nwritten;
+    return result;
+}
 
-                overlapped.Offset     = cast(DWORD) (offset >>  0);
-                overlapped.OffsetHigh = cast(DWORD) (offset >> 32);
-            }
-            else {
-                Log_Error("Failed to write %d bytes at offset %lld (0x%x)", to_write, offset, GetLastError());
-                break;
-            }
-        }
+B32 T_SPSCTryPop(T_SPSCQueue *queue, void *element) {
+    U32 read = queue->read;
 
-        result = cast(S64) (ptr - data.data);
+    B32 result = (read != queue->write_cache);
+    if (!result) {
+        queue->write_cache = AtomicLoad_U32(&queue->write);
+        result = (read != queue->write_cache);
     }
-    else {
-        Log_Error("Invalid file handle");
+
+    if (result) {
+        _T_QueueCopy(cast(U8 *) element, queue->data + ((read & queue->mask) * queue->element_size), queue->element_size);
+        AtomicStore_U32(&queue->read, read + 1);
+
+        _T_QueueWake(&queue->push_waiters, &queue->popped);
     }
 
     return result;
 }
 
-S64 FS_AppendFile(OS_Handle file, Str8 data) {
-    S64 result = 0;
+void T_SPSCPush(T_SPSCQueue *queue, void *element) {
+    _T_QUEUE_BLOCK(T_SPSCTryPush, queue, element, &queue->push_waiters, &queue->popped);
+}
 
-    if (OS_HandleValid(file)) {
-        HANDLE hFile = cast(HANDLE) file.v[0];
+void T_SPSCPop(T_SPSCQueue *queue, void *element) {
+    _T_QUEUE_BLOCK(T_SPSCTryPop, queue, element, &queue->pop_waiters, &queue->pushed);
+}
 
-        FILE_STANDARD_INFO info;
-        if (GetFileInformationByHandleEx(hFile, FileStandardInfo, &info, sizeof(FILE_STANDARD_INFO))) {
-            U64 offset = info.EndOfFile.QuadPart;
-            result     = FS_WriteFile(file, data, offset);
-        }
-        else {
-            Log_Error("Failed to get end-of-file offset (0x%x)", GetLastError());
-        }
-    }
-    else {
-        Log_Error("Invalid file handle");
+// each cell starts with its sequence number, which is the position a producer expects when the
+// cell is free and the position plus one once it holds an element for a consumer. consumers
+// advance it by the capacity when they're done so it is free for the next lap
+//
+T_MPMCQueue *T_AllocMPMCQueue(M_Arena *arena, U64 element_size, U32 capacity) {
+    Assert(capacity != 0 && capacity <= (1U << 31));
+
+    T_MPMCQueue *result = M_ArenaPush(arena, T_MPMCQueue, 1, 0, 64);
+
+    capacity = NextPow2_U32(capacity);
+
+    result->mask         = capacity - 1;
+    result->element_size = element_size;
+    result->stride       = AlignUp(sizeof(U64) + element_size, sizeof(U64));
+    result->cells        = M_ArenaPush(arena, U8, capacity * result->stride, M_ARENA_NO_ZERO, 64);
+
+    for (U32 it = 0; it < capacity; ++it) {
+        *cast(volatile U32 *) (result->cells + (it * result->stride)) = it;
     }
 
     return result;
 }
 
-FS_Properties FS_PropertiesFromHandle(OS_Handle file) {
-    FS_Properties result = 0;
+B32 T_MPMCTryPush(T_MPMCQueue *queue, void *element) {
+    B32 result = false;
 
-    if (OS_HandleValid(file)) {
-        HANDLE hFile = cast(HANDLE) file.v[0];
+    U32 position = AtomicLoad_U32(&queue->enqueue);
+    U8 *cell;
 
-        BY_HANDLE_FILE_INFORMATION info;
-        if (GetFileInformationByHandle(hFile, &info)) {
-            DWORD attrs = info.dwFileAttributes;
+    for (;;) {
+        cell = queue->cells + ((position & queue->mask) * queue->stride);
 
-            M_Temp temp   = M_AcquireTemp(0, 0);
-            Str8 path     = FS_PathFromHandle(temp.arena, file);
-            Str8 basename = Str8_GetBasename(path);
+        U32 sequence = AtomicLoad_U32(cast(volatile U32 *) cell);
+        S32 diff     = cast(S32) (sequence - position);
 
-            result |= (attrs & FILE_ATTRIBUTE_DIRECTORY)          ? FS_PROPERTY_IS_DIRECTORY : 0;
-            result |= (attrs & FILE_ATTRIBUTE_HIDDEN)             ? FS_PROPERTY_IS_HIDDEN    : 0;
-            result |= (basename.count && basename.data[0] == '.') ? FS_PROPERTY_IS_HIDDEN    : 0;
+        if (diff == 0) {
+            result = AtomicCompareExchange_U32(&queue->enqueue, position + 1, position);
+            if (result) { break; }
 
-            M_ReleaseTemp(temp);
+            position = AtomicLoad_U32(&queue->enqueue);
+        }
+        else if (diff < 0) {
+            // the cell from the previous lap hasn't been consumed yet
+            //
+            break;
         }
         else {
-            Log_Error("Failed to get file handle information (0x%x)", GetLastError());
+            position = AtomicLoad_U32(&queue->enqueue);
         }
     }
-    else {
-        Log_Error("Invalid file handle");
+
+    if (result) {
+        _T_QueueCopy(cell + sizeof(U64), cast(U8 *) element, queue->element_size);
+        AtomicStore_U32(cast(volatile U32 *) cell, position + 1);
+
+        _T_QueueWake(&queue->pop_waiters, &queue->pushed);
     }
 
     return result;
 }
 
-FS_Time FS_TimeFromHandle(OS_Handle file) {
-    FS_Time result = ZERO(FS_Time);
+B32 T_MPMCTryPop(T_MPMCQueue *queue, void *element) {
+    B32 result = false;
 
-    if (OS_HandleValid(file)) {
-        HANDLE hFile = cast(HANDLE) file.v[0];
+    U32 position = AtomicLoad_U32(&queue->dequeue);
+    U8 *cell;
 
-        FILETIME ct, at, wt;
-        if (GetFileTime(hFile, &ct, &at, &wt)) {
-            result.created  = Compose_U64(ct.dwHighDateTime, ct.dwLowDateTime);
-            result.accessed = Compose_U64(at.dwHighDateTime, at.dwLowDateTime);
-            result.written  = Compose_U64(wt.dwHighDateTime, wt.dwLowDateTime);
+    for (;;) {
+        cell = queue->cells + ((position & queue->mask) * queue->stride);
+
+        U32 sequence = AtomicLoad_U32(cast(volatile U32 *) cell);
+        S32 diff     = cast(S32) (sequence - (position + 1));
+
+        if (diff == 0) {
+            result = AtomicCompareExchange_U32(&queue->dequeue, position + 1, position);
+            if (result) { break; }
+
+            position = AtomicLoad_U32(&queue->dequeue);
+        }
+        else if (diff < 0) {
+            // nothing has been pushed to the cell yet
+            //
+            break;
         }
         else {
-            Log_Error("Failed to get file times (0x%x)", GetLastError());
+            position = AtomicLoad_U32(&queue->dequeue);
         }
     }
-    else {
-        Log_Error("Invalid file handle");
+
+    if (result) {
+        _T_QueueCopy(cast(U8 *) element, cell + sizeof(U64), queue->element_size);
+        AtomicStore_U32(cast(volatile U32 *) cell, position + queue->mask + 1);
+
+        _T_QueueWake(&queue->push_waiters, &queue->popped);
     }
 
     return result;
 }
 
-Str8 FS_PathFromHandle(M_Arena *arena, OS_Handle file) {
-    Str8 result = ZERO(Str8);
+void T_MPMCPush(T_MPMCQueue *queue, void *element) {
+    _T_QUEUE_BLOCK(T_MPMCTryPush, queue, element, &queue->push_waiters, &queue->popped);
+}
 
-    if (OS_HandleValid(file)) {
-        HANDLE hFile = cast(HANDLE) file.v[0];
-        M_Temp temp  = M_AcquireTemp(1, &arena);
+void T_MPMCPop(T_MPMCQueue *queue, void *element) {
+    _T_QUEUE_BLOCK(T_MPMCTryPop, queue, element, &queue->pop_waiters, &queue->pushed);
+}
 
-        // Push a 1KiB buffer as an initial guess, if that is too small the
-        // FILE_NAME_INFO will contain how long we need to make the buffer so pop
-        // last and retry with the correct length
-        //
-        DWORD dwBufferSize    = KB(1);
-        U8 *lpFileInformation = M_ArenaPush(temp.arena, U8, dwBufferSize);
+//
+// --------------------------------------------------------------------------------
+// :impl_jobs
+// --------------------------------------------------------------------------------
+//
+enum {
+    J_STATE_NONE = 0,
+    J_STATE_INITIALISING,
+    J_STATE_RUNNING
+};
 
-        if (!GetFileInformationByHandleEx(hFile, FileNameInfo, lpFileInformation, dwBufferSize)) {
-            DWORD err = GetLastError();
-            if (err == ERROR_MORE_DATA) {
-                FILE_NAME_INFO *name_info = cast(FILE_NAME_INFO *) lpFileInformation;
-                dwBufferSize = name_info->FileNameLength + sizeof(FILE_NAME_INFO) + 2;
+typedef struct _J_Deque _J_Deque;
+struct _J_Deque {
+    // top is shared with thieves while bottom is only written by the owner, they're kept on
+    // separate cache lines so pushes and pops don't contend with steals
+    //
+    volatile U64 top;
+    U8 pad0[56];
 
-                M_ArenaPopLast(temp.arena);
+    volatile U64 bottom;
+    U8 pad1[56];
 
-                lpFileInformation = M_ArenaPush(temp.arena, U8, dwBufferSize);
-                if (!GetFileInformationByHandleEx(hFile, FileNameInfo, lpFileInformation, dwBufferSize)) {
-                    Log_Error("Failed to get file handle name information (0x%x)", GetLastError());
-                    lpFileInformation = 0;
-                }
-            }
-            else {
-                Log_Error("Failed to get file handle name information (0x%x)", err);
-                lpFileInformation = 0;
-            }
-        }
+    J_Job jobs[J_DEQUE_CAPACITY];
+};
 
-        if (lpFileInformation) {
-            // We got the filename
-            //
-            FILE_NAME_INFO *name_info = cast(FILE_NAME_INFO *) lpFileInformation;
-            result = Win32_Str8FromWide(arena, name_info->FileName);
-        }
+typedef struct _J_System _J_System;
+struct _J_System {
+    volatile U32 state;
+    U32 worker_count;
 
-        M_ReleaseTemp(temp);
-    }
-    else {
-        Log_Error("Invalid file handle");
+    _J_Deque *deques;
+
+    // shared queue for submissions from threads which aren't workers
+    //
+    volatile U32 lock;
+    volatile U32 head;
+    volatile U32 tail;
+
+    J_Job queue[J_QUEUE_CAPACITY];
+
+    // sleeping workers wait on 'signal', which is only changed when there are sleepers so
+    // submitting doesn't write to a shared cache line while all of the workers are busy
+    //
+    volatile U32 sleepers;
+    T_Futex      signal;
+};
+
+global_var _J_System __job_system;
+
+thread_static U32 __tls_worker_index; // index plus one, zero when the thread isn't a worker
+thread_static U32 __tls_steal_seed;
+
+// Chase-Lev deque, "Correct and Efficient Work-Stealing for Weak Memory Models", Le et al. 2013
+//
+// indices only ever increase and are stored unsigned, they're compared signed as the owner
+// temporarily moves bottom below top when popping from an empty deque
+//
+internal B32 _J_DequePush(_J_Deque *deque, J_Job *job) {
+    S64 bottom = cast(S64) deque->bottom;
+    S64 top    = cast(S64) AtomicLoad_U64(&deque->top);
+
+    B32 result = (bottom - top) < J_DEQUE_CAPACITY;
+    if (result) {
+        deque->jobs[bottom & (J_DEQUE_CAPACITY - 1)] = *job;
+
+        // release store publishes the job to thieves
+        //
+        AtomicStore_U64(&deque->bottom, cast(U64) (bottom + 1));
     }
 
     return result;
 }
 
-U64 FS_SizeFromHandle(OS_Handle file) {
-    U64 result = 0;
+internal B32 _J_DequePop(_J_Deque *deque, J_Job *job) {
+    S64 bottom = cast(S64) deque->bottom - 1;
 
-    if (OS_HandleValid(file)) {
-        HANDLE hFile = cast(HANDLE) file.v[0];
+    // reserve the bottom job, the exchange is a full barrier so the reservation is visible to
+    // thieves before top is read
+    //
+    AtomicExchange_U64(&deque->bottom, cast(U64) bottom);
 
-        LARGE_INTEGER size;
-        if (GetFileSizeEx(hFile, &size)) {
-            result = size.QuadPart;
-        }
-        else {
-            Log_Error("Failed to get file size (0x%x)", GetLastError());
+    S64 top = cast(S64) AtomicLoad_U64(&deque->top);
+
+    B32 result = (top <= bottom);
+    if (result) {
+        *job = deque->jobs[bottom & (J_DEQUE_CAPACITY - 1)];
+
+        if (top == bottom) {
+            // last job, thieves may be trying to take it as well
+            //
+            result = AtomicCompareExchange_U64(&deque->top, cast(U64) (top + 1), cast(U64) top);
+            AtomicStore_U64(&deque->bottom, cast(U64) (bottom + 1));
         }
     }
     else {
-        Log_Error("Invalid file handle");
+        AtomicStore_U64(&deque->bottom, cast(U64) (bottom + 1));
     }
 
     return result;
 }
 
-FS_Properties FS_PropertiesFromPath(Str8 path) {
-    FS_Properties result = 0;
+internal B32 _J_DequeSteal(_J_Deque *deque, J_Job *job) {
+    B32 result = false;
 
-    M_Temp temp  = M_AcquireTemp(0, 0);
-    WCHAR *wpath = Win32_WideFromStr8(temp.arena, path);
+    S64 top = cast(S64) AtomicLoad_U64(&deque->top);
+    AtomicFence();
+    S64 bottom = cast(S64) AtomicLoad_U64(&deque->bottom);
 
-    DWORD attrs = GetFileAttributesW(wpath);
-    if (attrs != INVALID_FILE_ATTRIBUTES) {
-        result |= (attrs & FILE_ATTRIBUTE_DIRECTORY) ? FS_PROPERTY_IS_DIRECTORY : 0;
-        result |= (attrs & FILE_ATTRIBUTE_HIDDEN)    ? FS_PROPERTY_IS_HIDDEN    : 0;
-    }
-    else {
-        Log_Error("Failed to get file attributes for '%.*s' (0x%x)", Sv(path), GetLastError());
-    }
+    if (top < bottom) {
+        // the job has to be read before the exchange, once top moves the owner can reuse the slot
+        //
+        J_Job stolen = deque->jobs[top & (J_DEQUE_CAPACITY - 1)];
 
-    M_ReleaseTemp(temp);
+        result = AtomicCompareExchange_U64(&deque->top, cast(U64) (top + 1), cast(U64) top);
+        if (result) { *job = stolen; }
+    }
 
     return result;
 }
 
-FS_Time FS_TimeFromPath(Str8 path) {
-    FS_Time result = ZERO(FS_Time);
+internal B32 _J_QueuePush(J_Job *job) {
+    _J_System *system = &__job_system;
 
-    M_Temp temp  = M_AcquireTemp(0, 0);
-    WCHAR *wpath = Win32_WideFromStr8(temp.arena, path);
+    while (!AtomicCompareExchange_U32(&system->lock, 1, 0)) { SpinPause(); }
 
-    WIN32_FILE_ATTRIBUTE_DATA attrs;
-    if (GetFileAttributesExW(wpath, GetFileExInfoStandard, &attrs)) {
-        FILETIME *ct = &attrs.ftCreationTime;
-        FILETIME *at = &attrs.ftLastAccessTime;
-        FILETIME *wt = &attrs.ftLastWriteTime;
+    U32 tail = system->tail;
 
-        result.created  = Compose_U64(ct->dwHighDateTime, ct->dwLowDateTime);
-        result.accessed = Compose_U64(at->dwHighDateTime, at->dwLowDateTime);
-        result.written  = Compose_U64(wt->dwHighDateTime, wt->dwLowDateTime);
-    }
-    else {
-        Log_Error("Failed to get file attributes for '%.*s' (0x%x)", Sv(path), GetLastError());
+    B32 result = (tail - system->head) < J_QUEUE_CAPACITY;
+    if (result) {
+        system->queue[tail & (J_QUEUE_CAPACITY - 1)] = *job;
+        AtomicStore_U32(&system->tail, tail + 1);
     }
 
-    M_ReleaseTemp(temp);
+    AtomicExchange_U32(&system->lock, 0);
 
     return result;
 }
 
-U64 FS_SizeFromPath(Str8 path) {
-    U64 result = 0;
+internal B32 _J_QueuePop(J_Job *job) {
+    _J_System *system = &__job_system;
 
-    M_Temp temp  = M_AcquireTemp(0, 0);
-    WCHAR *wpath = Win32_WideFromStr8(temp.arena, path);
+    B32 result = false;
 
-    WIN32_FILE_ATTRIBUTE_DATA attrs;
-    if (GetFileAttributesExW(wpath, GetFileExInfoStandard, &attrs)) {
-        result = Compose_U64(attrs.nFileSizeHigh, attrs.nFileSizeLow);
-    }
-    else {
-        Log_Error("Failed to get file attributes for '%.*s' (0x%x)", Sv(path), GetLastError());
-    }
+    // the shared queue is usually empty so check before taking the lock
+    //
+    if (AtomicLoad_U32(&system->head) != AtomicLoad_U32(&system->tail)) {
+        while (!AtomicCompareExchange_U32(&system->lock, 1, 0)) { SpinPause(); }
 
-    M_ReleaseTemp(temp);
+        U32 head = system->head;
+
+        result = (head != system->tail);
+        if (result) {
+            *job = system->queue[head & (J_QUEUE_CAPACITY - 1)];
+            AtomicStore_U32(&system->head, head + 1);
+        }
+
+        AtomicExchange_U32(&system->lock, 0);
+    }
 
     return result;
 }
 
-B32 FS_CreateDirectory(Str8 path) {
-    B32 result = true;
+// 'index' is the calling worker or J_WORKER_NONE, its own deque is checked first followed by
+// the shared queue and then the other workers' deques starting from a random victim
+//
+internal B32 _J_FindJob(U32 index, J_Job *job) {
+    _J_System *system = &__job_system;
 
-    M_Temp temp  = M_AcquireTemp(0, 0);
-    WCHAR *wpath = Win32_WideFromStr8(temp.arena, path);
+    B32 result = false;
 
-    U64 it = 0;
-    while (wpath[it] != 0) {
-        if (wpath[it] == L'/' || wpath[it] == L'\\') {
-            // We temporarily null-terminate this segment to create parent directories
-            //
-            WCHAR sep = wpath[it];
-            wpath[it] = L'\0';
+    if (index != J_WORKER_NONE) { result = _J_DequePop(&system->deques[index], job); }
+    if (!result) { result = _J_QueuePop(job); }
 
-            if (!CreateDirectoryW(wpath, 0)) {
-                DWORD err = GetLastError();
-                if (err != ERROR_ALREADY_EXISTS) {
-                    Str8 dir = Win32_Str8FromWide(temp.arena, wpath);
-                    Log_Error("Failed to create directory '%.*s' (0x%x)", Sv(dir), err);
+    if (!result) {
+        U32 seed = __tls_steal_seed;
+        if (seed == 0) { seed = cast(U32) Hash_U64(cast(U64) &__tls_steal_seed) | 1; }
 
-                    result = false;
-                    break;
-                }
-            }
+        // xorshift32
+        //
+        seed ^= (seed << 13);
+        seed ^= (seed >> 17);
+        seed ^= (seed <<  5);
 
-            // restore the separator
-            //
-            wpath[it] = sep;
-        }
+        __tls_steal_seed = seed;
 
-        it += 1;
-    }
+        U32 count  = system->worker_count;
+        U32 victim = seed % count;
 
-    if (result) {
-        // We successfully created all of the parent directories (or they already existed) so
-        // create the final directory
-        //
-        if (!CreateDirectoryW(wpath, 0)) {
-            DWORD err = GetLastError();
-            if (err == ERROR_ALREADY_EXISTS) {
-                DWORD attrs = GetFileAttributesW(wpath);
-                if ((attrs & FILE_ATTRIBUTE_DIRECTORY) == 0) {
-                    Log_Error("Attempted to create directory at '%.*s', but a file was found", Sv(path));
-                    result = false;
-                }
-            }
-            else {
-                Log_Error("Failed to create directory '%.*s' (0x%x)", Sv(path), err);
-                result = false;
-            }
+        for (U32 it = 0; !result && it < count; ++it) {
+            if (victim != index) { result = _J_DequeSteal(&system->deques[victim], job); }
+
+            victim += 1;
+            if (victim == count) { victim = 0; }
         }
     }
 
-    M_ReleaseTemp(temp);
-
     return result;
 }
 
-B32 FS_RemoveDirectory(Str8 path) {
-    B32 result;
+internal void _J_RunJob(J_Job *job) {
+    job->Proc(job->param);
 
-    M_Temp temp  = M_AcquireTemp(0, 0);
-    WCHAR *wpath = Win32_WideFromStr8(temp.arena, path);
+    if (job->counter) {
+        if (AtomicAdd_U32(job->counter, cast(U32) -1) == 1) { T_BroadcastFutex(job->counter); }
+    }
+}
 
-    result = RemoveDirectoryW(wpath);
-    M_ReleaseTemp(temp);
+internal void _J_WakeWorkers(U32 count) {
+    _J_System *system = &__job_system;
 
-    return result;
-}
+    // pairs with the sleeper count being incremented before a worker checks for jobs one last
+    // time, either the worker sees the new jobs or the sleeper is seen here
+    //
+    AtomicFence();
 
-Str8 FS_GetPath(M_Arena *arena, FS_PathType type) {
-    Str8 result = ZERO(Str8);
+    if (AtomicLoad_U32(&system->sleepers) != 0) {
+        AtomicAdd_U32(&system->signal, 1);
 
-    if (type < FS_PATH_COUNT) {
-        result = Str8_Copy(arena, __windows->cached_paths[type]);
+        if (count == 1) {
+            T_WakeFutex(&system->signal);
+        }
+        else {
+            T_BroadcastFutex(&system->signal);
+        }
     }
-
-    return result;
 }
 
-#elif OS_MACOS
-    #error "macOS filesystem subsystem not implemented"
-#elif OS_LINUX
-
-//
-// :linux_filesystem
-//
-
-#include <fcntl.h>
-#include <errno.h>
-#include <unistd.h>
-#include <sys/stat.h>
-#include <sys/syscall.h>
-#include <dirent.h>
-#include <linux/limits.h>
+internal T_THREAD_PROC(_J_WorkerThread) {
+    _J_System *system = &__job_system;
 
-#define LINUX_DENTS_BUFFER_SIZE 1024
+    U32 index = cast(U32) (cast(U64) param);
 
-typedef struct linux_dirent64 linux_dirent64_t;
-struct linux_dirent64 {
-    __ino64_t      d_ino;    /* 64-bit inode number */
-    __off64_t      d_off;    /* Not an offset; see getdents() */
-    unsigned short d_reclen; /* Size of this dirent */
-    unsigned char  d_type;   /* File type */
-    char           d_name[]; /* Filename (null-terminated) */
-};
+    __tls_worker_index = index + 1;
 
-internal void Linux_ListPathRecursive(M_Arena *arena, FS_List *list, Str8 path, FS_ListFlags flags) {
-    M_Temp temp = M_AcquireTemp(1, &arena);
-    Str8 zpath  = Str8_Copy(temp.arena, path);
+    // the logging context has already been initialised by the thread entry, create the temp arenas
+    // up front as well so the first job to use them doesn't pay for it
+    //
+    M_ReleaseTemp(M_AcquireTemp(0, 0));
 
-    B32 recurse        = (flags & FS_LIST_RECURSIVE)      != 0;
-    B32 include_hidden = (flags & FS_LIST_INCLUDE_HIDDEN) != 0;
+    U32 spins = 0;
 
-    char *buffer = M_ArenaPush(temp.arena, char, LINUX_DENTS_BUFFER_SIZE);
+    for (;;) {
+        J_Job job;
 
-    int fd = open((const char *) zpath.data, O_RDONLY | O_DIRECTORY);
-    if (fd >= 0) {
-        for (;;) {
-            ssize_t nread = syscall(SYS_getdents64, fd, buffer, LINUX_DENTS_BUFFER_SIZE);
-            if (nread < 0) {
-                Log_Error("Failed to list directory '%.*s' (%d)", Sv(path), errno);
-                break;
-            }
-            else if (nread == 0) {
-                // done
-                //
-                break;
-            }
+        if (_J_FindJob(index, &job)) {
+            _J_RunJob(&job);
+            spins = 0;
+        }
+        else if (spins < J_SPIN_COUNT) {
+            SpinPause();
+            spins += 1;
+        }
+        else {
+            M_TrimTempArenas();
 
-            for (ssize_t off = 0; off < nread;) {
-                linux_dirent64_t *ent = cast(linux_dirent64_t *) (buffer + off);
-                off += ent->d_reclen;
+            U32 signal = AtomicLoad_U32(&system->signal);
+            AtomicAdd_U32(&system->sleepers, 1);
 
-                B32 should_skip = false;
-                B32 is_hidden   = false;
-                B32 is_dir      = (ent->d_type == DT_DIR);
+            B32 found = _J_FindJob(index, &job);
+            if (!found) { T_WaitFutex(&system->signal, signal); }
 
-                Str8 basename   = Sz(ent->d_name);
+            AtomicAdd_U32(&system->sleepers, cast(U32) -1);
 
-                if (basename.count == 2 && basename.data[0] == '.' && basename.data[1] == '.') {
-                    // always skip relative '..' entry
-                    //
-                    should_skip = true;
-                }
-                else if (basename.count && basename.data[0] == '.') {
-                    // always skip relative '.' or skip names starting with '.' if
-                    // the user hasn't requested the inclusion of hidden files
-                    //
-                    should_skip = ((basename.count == 1) || !include_hidden);
-                    is_hidden   = true;
-                }
+            if (found) { _J_RunJob(&job); }
 
-                if (!should_skip) {
-                    FS_Entry *entry = M_ArenaPush(arena, FS_Entry);
+            spins = 0;
+        }
+    }
+}
 
-                    entry->path = Sf(arena, "%.*s/%.*s", Sv(path), Sv(basename));
+void J_Init(U32 worker_count) {
+    _J_System *system = &__job_system;
 
-                    entry->props |= is_hidden ? FS_PROPERTY_IS_HIDDEN    : 0;
-                    entry->props |= is_dir    ? FS_PROPERTY_IS_DIRECTORY : 0;
+    if (AtomicLoad_U32(&system->state) != J_STATE_RUNNING) {
+        if (AtomicCompareExchange_U32(&system->state, J_STATE_INITIALISING, J_STATE_NONE)) {
+            if (worker_count == 0) { worker_count = OS_GetSystemInfo()->num_logical_cores; }
 
-                    struct stat stbuf;
-                    if (stat((const char *) entry->path.data, &stbuf) == 0) {
-                        entry->size = stbuf.st_size;
-                        entry->times.written  = (1e9 * stbuf.st_mtim.tv_nsec) + stbuf.st_mtim.tv_sec;
-                        entry->times.accessed = (1e9 * stbuf.st_atim.tv_nsec) + stbuf.st_atim.tv_sec;
-                        entry->times.created  = 0;
-                    }
+            worker_count = Clamp(1, worker_count, J_MAX_WORKERS);
 
-                    SLL_Enqueue(list->first, list->last, entry);
+            // workers run for the lifetime of the process so the deques are never released
+            //
+            M_Arena *arena = M_AllocArena(J_MAX_WORKERS * sizeof(_J_Deque) + MB(1));
+            M_SetArenaName(arena, S("jobs"));
 
-                    list->num_entries += 1;
+            system->deques       = M_ArenaPush(arena, _J_Deque, worker_count, 0, 64);
+            system->worker_count = worker_count;
 
-                    if (recurse && is_dir) { Linux_ListPathRecursive(arena, list, entry->path, flags); }
-                }
+            __tls_worker_index = 1;
+
+            AtomicStore_U32(&system->state, J_STATE_RUNNING);
+
+            for (U32 it = 1; it < worker_count; ++it) {
+                T_Thread thread = ZERO(T_Thread);
+
+                thread.Proc  = _J_WorkerThread;
+                thread.param = cast(void *) cast(U64) it;
+                thread.flags = T_THREAD_CREATE_DETACHED;
+
+                T_CreateThread(&thread);
             }
         }
-
-        close(fd);
-    }
-    else {
-        Log_Error("Failed to open '%.*s' for reading (%d)", Sv(path), errno);
+        else {
+            while (AtomicLoad_U32(&system->state) != J_STATE_RUNNING) { SpinPause(); }
+        }
     }
-
-    M_ReleaseTemp(temp);
 }
 
-FS_List FS_ListPath(M_Arena *arena, Str8 path, FS_ListFlags flags) {
-    FS_List result = ZERO(FS_List);
+U32 J_GetWorkerCount() {
+    U32 result = __job_system.worker_count;
+    return result;
+}
 
-    Linux_ListPathRecursive(arena, &result, path, flags);
+U32 J_GetWorkerIndex() {
+    U32 result = __tls_worker_index - 1; // wraps to J_WORKER_NONE
     return result;
 }
 
-OS_Handle FS_OpenFile(Str8 path, FS_Access access) {
-    OS_Handle result = OS_NilHandle();
+void J_Submit(J_Proc *Proc, void *param, J_Counter *counter) {
+    J_Job job;
+    job.Proc    = Proc;
+    job.param   = param;
+    job.counter = counter;
 
-    if (access) {
-        M_Temp temp = M_AcquireTemp(0, 0);
-        Str8 zpath  = Str8_Copy(temp.arena, path);
+    J_SubmitJobs(&job, 1, counter);
+}
 
-        int flags = O_RDONLY;
-        mode_t mode = 0;
+void J_SubmitJobs(J_Job *jobs, U32 count, J_Counter *counter) {
+    J_Init(0);
 
-        if (access & FS_ACCESS_WRITE) {
-            flags = ((access & FS_ACCESS_READ) ? O_RDWR : O_WRONLY) | O_CREAT;
-            mode  = S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH; // 0644 permissions
-        }
+    _J_System *system = &__job_system;
 
-        int fd = open((const char *) zpath.data, flags, mode);
-        if (fd >= 0) {
-            result.v[0] = cast(U64) fd;
+    if (counter) { AtomicAdd_U32(counter, count); }
+
+    U32 index  = __tls_worker_index;
+    U32 pushed = 0;
+
+    // with a single worker there are no background threads, queued jobs would only be run when
+    // worker zero waits so jobs which are never waited on would never run at all
+    //
+    B32 inline_jobs = (system->worker_count == 1);
+
+    for (U32 it = 0; it < count; ++it) {
+        J_Job job   = jobs[it];
+        job.counter = counter;
+
+        B32 queued = false;
+        if (!inline_jobs) { queued = index ? _J_DequePush(&system->deques[index - 1], &job) : _J_QueuePush(&job); }
+
+        if (queued) {
+            pushed += 1;
         }
         else {
-            Log_Error("Failed to open file '%.*s' (%d)", Sv(path), errno);
-        }
+            // full, or there is nobody else to run it, get the workers started on what has been
+            // queued so far before running the job here
+            //
+            if (pushed != 0) { _J_WakeWorkers(pushed); }
 
-        M_ReleaseTemp(temp);
+            pushed = 0;
+            _J_RunJob(&job);
+        }
     }
-    return result;
+
+    if (pushed != 0) { _J_WakeWorkers(pushed); }
 }
 
-void FS_CloseFile(OS_Handle file) {
-    if (OS_HandleValid(file)) {
-        int fd = cast(int) file.v[0];
-        close(fd);
+void J_Wait(J_Counter *counter) {
+    U32 index = __tls_worker_index - 1;
+    U32 spins = 0;
+    U32 value;
+
+    while ((value = AtomicLoad_U32(counter)) != 0) {
+        J_Job job;
+
+        if (_J_FindJob(index, &job)) {
+            _J_RunJob(&job);
+            spins = 0;
+        }
+        else if (spins < J_SPIN_COUNT) {
+            SpinPause();
+            spins += 1;
+        }
+        else {
+            // nothing left to help with, the remaining jobs are running on other workers and the
+            // last to complete will wake us
+            //
+            T_WaitFutex(counter, value);
+        }
     }
 }
 
-B32 FS_RemoveFile(Str8 path) {
-    M_Temp temp = M_AcquireTemp(0, 0);
-    Str8 zpath  = Str8_Copy(temp.arena, path);
+// parallel for
+//
+typedef struct _J_ForRange _J_ForRange;
+struct _J_ForRange {
+    J_ForProc *Proc;
+    void      *param;
 
-    B32 result = unlink((const char *) zpath.data) == 0;
+    U64 start;
+    U64 end;
+};
 
-    M_ReleaseTemp(temp);
-    return result;
+internal J_PROC(_J_ForJob) {
+    _J_ForRange *range = cast(_J_ForRange *) param;
+    range->Proc(range->param, range->start, range->end);
 }
 
-S64 FS_ReadFile(OS_Handle file, Str8 data, U64 offset) {
-    S64 result = 0;
+void ParallelFor(U64 count, U64 grain, J_ForProc *Proc, void *param) {
+    J_Init(0);
 
-    if (OS_HandleValid(file)) {
-        int    fd         = cast(int) file.v[0];
-        U8    *ptr        = data.data;
-        ssize_t remaining = data.count;
+    if (grain == 0) {
+        // a few ranges per worker so stealing can even out uneven amounts of work
+        //
+        grain = count / (4 * __job_system.worker_count);
+    }
 
-        while (remaining > 0) {
-            ssize_t nread = pread(fd, ptr, remaining, offset);
-            if (nread >= 0) {
-                remaining -= nread;
-                ptr       += nread;
-                offset    += nread;
-            }
-            else {
-                Log_Error("Failed to read %llu bytes at offset %llu (%d)", remaining, offset, errno);
-                break;
-            }
-        }
+    // the number of jobs has to fit in 32-bits
+    //
+    grain = Max(grain, 1 + (count / U32_MAX));
 
-        Assert(remaining >= 0);
+    U64 ranges = (count + grain - 1) / grain;
 
-        result = cast(S64) (ptr - data.data);
-    }
-    else {
-        Log_Error("Invalid file handle");
-    }
+    if (ranges > 1) {
+        M_Temp temp = M_AcquireTemp(0, 0);
 
-    return result;
-}
+        U32 count_jobs = cast(U32) (ranges - 1);
 
-S64 FS_WriteFile(OS_Handle file, Str8 data, U64 offset) {
-    S64 result = 0;
+        _J_ForRange *items = M_ArenaPush(temp.arena, _J_ForRange, count_jobs, M_ARENA_NO_ZERO);
+        J_Job       *jobs  = M_ArenaPush(temp.arena, J_Job,       count_jobs, M_ARENA_NO_ZERO);
 
-    if (OS_HandleValid(file)) {
-        int     fd        = cast(int) file.v[0];
-        U8     *ptr       = data.data;
-        ssize_t remaining = data.count;
+        for (U32 it = 0; it < count_jobs; ++it) {
+            _J_ForRange *range = &items[it];
 
-        while (remaining > 0) {
-            ssize_t nwritten = pwrite(fd, ptr, remaining, offset);
-            if (nwritten >= 0) {
-                remaining -= nwritten;
-                ptr       += nwritten;
-                offset    += nwritten;
-            }
-            else {
-                Log_Error("Failed to read %llu bytes at offset %llu (%d)", remaining, offset, errno);
-                break;
-            }
+            range->Proc  = Proc;
+            range->param = param;
+            range->start = (it + 1) * grain;
+            range->end   = Min(range->start + grain, count);
+
+            jobs[it].Proc    = _J_ForJob;
+            jobs[it].param   = range;
+            jobs[it].counter = 0;
         }
 
-        Assert(remaining >= 0);
+        J_Counter counter = 0;
+        J_SubmitJobs(jobs, count_jobs, &counter);
 
-        result = cast(S64) (ptr - data.data);
+        Proc(param, 0, grain);
+
+        J_Wait(&counter);
+
+        M_ReleaseTemp(temp);
     }
-    else {
-        Log_Error("Invalid file handle");
+    else if (count != 0) {
+        Proc(param, 0, count);
     }
-
-    return result;
 }
 
-S64 FS_AppendFile(OS_Handle file, Str8 data) {
-    S64 result = 0;
+// parallel sorting
+//
+#if !defined(PARALLEL_SORT_THRESHOLD)
+    #define PARALLEL_SORT_THRESHOLD 65536
+#endif
 
-    if (OS_HandleValid(file)) {
-        int fd = cast(int) file.v[0];
+#if !defined(PARALLEL_SORT_MAX_WORKERS)
+    #define PARALLEL_SORT_MAX_WORKERS 64
+#endif
 
-        struct stat stbuf;
-        if (fstat(fd, &stbuf) == 0) {
-            U64 offset = stbuf.st_size;
-            result     = FS_WriteFile(file, data, offset);
-        }
-        else {
-            Log_Error("Failed to get end-of-file offset (%d)", errno);
-        }
-    }
-    else {
-        Log_Error("Invalid file handle");
-    }
+typedef struct _ParallelSortJob _ParallelSortJob;
+struct _ParallelSortJob {
+    _SortContext ctx;
 
-    return result;
-}
+    U8 *array;
+    U8 *scratch;
+    S64 count;
 
-FS_Properties FS_PropertiesFromHandle(OS_Handle file) {
-    FS_Properties result = 0;
+    ParallelSortFlags flags;
+    U32 workers;
 
-    if (OS_HandleValid(file)) {
-        int fd = cast(int) file.v[0];
+    // current merge pass
+    //
+    U8 *src;
+    U8 *dst;
+    U32 width;
+};
 
-        struct stat stbuf;
-        if (fstat(fd, &stbuf) == 0) {
-            M_Temp temp = M_AcquireTemp(0, 0);
-            Str8 path   = FS_PathFromHandle(temp.arena, file);
+internal S64 _ParallelSortChunk(_ParallelSortJob *job, U32 index) {
+    S64 result = (job->count * index) / job->workers;
+    return result;
+}
 
-            B32 is_dir    = ((stbuf.st_mode & S_IFMT) == S_IFDIR);
-            B32 is_hidden = (path.count && path.data[0] == '.');
+// number of elements taken from the left run in the first 'd' elements of their stable merge,
+// the split is too early while the next left element doesn't order strictly after the last
+// right element taken, as ties always take from the left
+//
+internal S64 _ParallelSortCoRank(_SortContext *ctx, U8 *l, S64 lcount, U8 *r, S64 rcount, S64 d) {
+    U64 size = ctx->element_size;
 
-            result |= is_dir    ? FS_PROPERTY_IS_DIRECTORY : 0;
-            result |= is_hidden ? FS_PROPERTY_IS_HIDDEN    : 0;
+    S64 lo = Max(0, d - rcount);
+    S64 hi = Min(d, lcount);
 
-            M_ReleaseTemp(temp);
+    while (lo < hi) {
+        S64 i = lo + ((hi - lo) >> 1);
+        S64 j = d - i;
+
+        if (j > 0 && !_SortLess(ctx, r + ((j - 1) * size), l + (i * size))) {
+            lo = i + 1;
         }
         else {
-            Log_Error("Failed to get file descriptor information (%d)", errno);
+            hi = i;
         }
     }
-    else {
-        Log_Error("Invalid file handle");
-    }
 
-    return result;
+    return lo;
 }
 
-FS_Time FS_TimeFromHandle(OS_Handle file) {
-    FS_Time result = ZERO(FS_Time);
+internal J_FOR_PROC(_ParallelSortPartitions) {
+    _ParallelSortJob *job = cast(_ParallelSortJob *) param;
+    U64 size = job->ctx.element_size;
 
-    if (OS_HandleValid(file)) {
-        int fd = cast(int) file.v[0];
+    for (U64 index = start; index < end; ++index) {
+        S64 begin = _ParallelSortChunk(job, cast(U32) index);
+        S64 last  = _ParallelSortChunk(job, cast(U32) index + 1);
 
-        struct stat stbuf;
-        if (fstat(fd, &stbuf) == 0) {
-            result.written  = (1e9 * stbuf.st_mtim.tv_sec) + stbuf.st_mtim.tv_nsec;
-            result.accessed = (1e9 * stbuf.st_atim.tv_sec) + stbuf.st_mtim.tv_nsec;
-            result.created  = 0; // not available on unix ?
+        if (job->flags & PARALLEL_SORT_STABLE) {
+            _MergeSort(job->array + (begin * size), last - begin, job->ctx.Compare, size);
         }
         else {
-            Log_Error("fstat failed on '%d' (%d)", fd, errno);
+            _QuickSort(job->array + (begin * size), last - begin, job->ctx.Compare, size);
         }
     }
-    else {
-        Log_Error("Invalid file handle");
-    }
-
-    return result;
 }
 
-Str8 FS_PathFromHandle(M_Arena *arena, OS_Handle file) {
-    Str8 result = ZERO(Str8);
+// each pass merges pairs of runs 'width' partitions long, with every merge split evenly between
+// the 2 * width partitions it covers
+//
+internal J_FOR_PROC(_ParallelSortMerges) {
+    _ParallelSortJob *job = cast(_ParallelSortJob *) param;
 
-    if (OS_HandleValid(file)) {
-        M_Temp temp = M_AcquireTemp(1, &arena);
+    _SortContext *ctx = &job->ctx;
+    U64 size = ctx->element_size;
 
-        int  fd      = cast(int) file.v[0];
-        Str8 fd_path = Sf(temp.arena, "/proc/self/fd/%d", fd);
+    for (U64 index = start; index < end; ++index) {
+        U32 group = job->width << 1;
+        U32 first = cast(U32) index & ~(group - 1);
+        U32 part  = cast(U32) index &  (group - 1);
 
-        char *buffer;
-        S64 size = 512;
+        S64 lbegin = _ParallelSortChunk(job, first);
+        S64 middle = _ParallelSortChunk(job, first + job->width);
+        S64 rend   = _ParallelSortChunk(job, first + group);
 
-        ssize_t count;
-        for (;;) {
-            // we have to keep iterating towards the required buffer size
-            // because readlink wont actually tell us
-            //
-            size *= 2;
-            buffer = M_ArenaPush(temp.arena, char, size);
+        U8 *l = job->src + (lbegin * size);
+        U8 *r = job->src + (middle * size);
 
-            count = readlink((const char *) fd_path.data, buffer, size);
-            if (count < size) { break; }
+        S64 lcount = middle - lbegin;
+        S64 rcount = rend   - middle;
+        S64 total  = lcount + rcount;
 
-            M_ArenaPopLast(temp.arena);
-        }
+        S64 d0 = (total * part) / group;
+        S64 d1 = (total * (part + 1)) / group;
 
-        if (count > 0) {
-            result.count = count;
-            result.data  = M_ArenaPushCopy(arena, buffer, U8, count + 1);
+        S64 i0 = _ParallelSortCoRank(ctx, l, lcount, r, rcount, d0);
+        S64 i1 = _ParallelSortCoRank(ctx, l, lcount, r, rcount, d1);
+
+        U8 *out = job->dst + ((lbegin + d0) * size);
+
+        U8 *lstart = l + (i0 * size);
+        U8 *lend   = l + (i1 * size);
+        U8 *rstart = r + ((d0 - i0) * size);
+        U8 *rfinal = r + ((d1 - i1) * size);
+
+        if (lstart == lend) {
+            if (rstart != rfinal) { M_CopySize(out, rstart, cast(U64) (rfinal - rstart)); }
         }
         else {
-            Log_Error("readlink failed on '%.*s' (%d)", Sv(fd_path), errno);
+            _MergeSortMerge(ctx, out, lstart, lend, rstart, rfinal);
+        }
+    }
+}
+
+internal J_FOR_PROC(_ParallelSortCopyBack) {
+    _ParallelSortJob *job = cast(_ParallelSortJob *) param;
+    U64 size = job->ctx.element_size;
+
+    for (U64 index = start; index < end; ++index) {
+        S64 begin = _ParallelSortChunk(job, cast(U32) index);
+        S64 last  = _ParallelSortChunk(job, cast(U32) index + 1);
+
+        if (last > begin) {
+            M_CopySize(job->array + (begin * size), job->src + (begin * size), (last - begin) * size);
         }
+    }
+}
 
-        M_ReleaseTemp(temp);
+void _ParallelSort(void *array, S64 count, CompareFunc *Compare, U64 element_size, U32 workers, ParallelSortFlags flags) {
+    if (workers == 0) {
+        J_Init(0);
+        workers = J_GetWorkerCount();
     }
 
-    return result;
-}
+    workers = Min(workers, PARALLEL_SORT_MAX_WORKERS);
+    // keep at least a quarter of the threshold in each partition
+    //
+    workers = cast(U32) Min(cast(U64) workers, cast(U64) count / (PARALLEL_SORT_THRESHOLD >> 2));
+    workers = (workers > 1) ? (1U << (31 - CountLeadingZeros_U32(workers))) : 1;
 
-U64 FS_SizeFromHandle(OS_Handle file) {
-    S64 result = 0;
+    if ((count >= PARALLEL_SORT_THRESHOLD) && (workers > 1)) {
+        M_Temp temp = M_AcquireTemp(0, 0);
 
-    if (OS_HandleValid(file)) {
-        int fd = cast(int) file.v[0];
+        _ParallelSortJob job = ZERO(_ParallelSortJob);
 
-        struct stat stbuf;
-        if (fstat(fd, &stbuf) == 0) {
-            result = stbuf.st_size;
-        }
-        else {
-            Log_Error("fstat failed on '%d' (%d)", fd, errno);
+        job.ctx.Compare      = Compare;
+        job.ctx.element_size = element_size;
+
+        job.array   = cast(U8 *) array;
+        job.scratch = M_ArenaPush(temp.arena, U8, count * element_size, M_ARENA_NO_ZERO, _SORT_SCRATCH_ALIGNMENT);
+        job.count   = count;
+        job.flags   = flags;
+        job.workers = workers;
+
+        ParallelFor(workers, 1, _ParallelSortPartitions, &job);
+
+        job.src = job.array;
+        job.dst = job.scratch;
+
+        for (job.width = 1; job.width < workers; job.width <<= 1) {
+            ParallelFor(workers, 1, _ParallelSortMerges, &job);
+
+            U8 *swap = job.src;
+            job.src  = job.dst;
+            job.dst  = swap;
         }
+
+        if (job.src != job.array) { ParallelFor(workers, 1, _ParallelSortCopyBack, &job); }
+
+        M_ReleaseTemp(temp);
+    }
+    else if (flags & PARALLEL_SORT_STABLE) {
+        _MergeSort(array, count, Compare, element_size);
     }
     else {
-        Log_Error("Invalid file handle");
+        _QuickSort(array, count, Compare, element_size);
     }
+}
+
+//
+// --------------------------------------------------------------------------------
+// :impl_hash
+// --------------------------------------------------------------------------------
+//
+#define HASH_SECRET0 0x2D358DCCAA6C78A5ULL
+#define HASH_SECRET1 0x8BB84B93962EACC9ULL
+#define HASH_SECRET2 0x4B33A62ED433D4A3ULL
+#define HASH_SECRET3 0x4D5A2DA51DE1AA47ULL
+
+// the whole hash is built from this, a 128-bit multiply folded back down to 64 bits
+//
+internal U64 __Hash_Mix(U64 a, U64 b) {
+    U64 hi;
+    U64 lo = MulWide_U64(a, b, &hi);
 
+    U64 result = lo ^ hi;
     return result;
 }
 
-FS_Properties FS_PropertiesFromPath(Str8 path) {
-    FS_Properties result = 0;
+// inputs can start at any address so accessing them through a plain pointer cast would be
+// undefined, the words are copied through a local instead which compiles down to a single
+// unaligned load or store
+//
+internal U64 __Hash_Read64(U8 *data) {
+    U64 result;
 
-    M_Temp temp = M_AcquireTemp(0, 0);
-    Str8 zpath  = Str8_Copy(temp.arena, path);
+#if COMPILER_MSVC
+    result = *cast(U64 __unaligned *) data;
+#else
+    __builtin_memcpy(&result, data, sizeof(U64));
+#endif
 
-    struct stat stbuf;
-    if (stat((const char *) zpath.data, &stbuf) == 0) {
-        B32 is_dir    = ((stbuf.st_mode & S_IFMT) == S_IFDIR);
-        B32 is_hidden = (path.count && path.data[0] == '.');
+    return result;
+}
 
-        result |= is_dir    ? FS_PROPERTY_IS_DIRECTORY : 0;
-        result |= is_hidden ? FS_PROPERTY_IS_HIDDEN    : 0;
-    }
-    else {
-        Log_Error("stat failed on path '%.*s' (%d)", Sv(path), errno);
-    }
+internal U64 __Hash_Read32(U8 *data) {
+    U32 value;
 
-    M_ReleaseTemp(temp);
+#if COMPILER_MSVC
+    value = *cast(U32 __unaligned *) data;
+#else
+    __builtin_memcpy(&value, data, sizeof(U32));
+#endif
+
+    U64 result = value;
+    return result;
+}
+
+internal void __Hash_Write64(U8 *data, U64 value) {
+#if COMPILER_MSVC
+    *cast(U64 __unaligned *) data = value;
+#else
+    __builtin_memcpy(data, &value, sizeof(U64));
+#endif
+}
 
+internal U64 __Hash_Seed(U64 seed) {
+    U64 result = seed ^ __Hash_Mix(seed ^ HASH_SECRET0, HASH_SECRET1);
     return result;
 }
 
-FS_Time FS_TimeFromPath(Str8 path) {
-    FS_Time result = ZERO(FS_Time);
+// large inputs are consumed 48 bytes at a time across three independent lanes so the multiplies
+// can overlap
+//
+internal void __Hash_Block(U64 *seed, U64 *see1, U64 *see2, U8 *data) {
+    *seed = __Hash_Mix(__Hash_Read64(data +  0) ^ HASH_SECRET1, __Hash_Read64(data +  8) ^ *seed);
+    *see1 = __Hash_Mix(__Hash_Read64(data + 16) ^ HASH_SECRET2, __Hash_Read64(data + 24) ^ *see1);
+    *see2 = __Hash_Mix(__Hash_Read64(data + 32) ^ HASH_SECRET3, __Hash_Read64(data + 40) ^ *see2);
+}
 
-    M_Temp temp = M_AcquireTemp(0, 0);
-    Str8 zpath  = Str8_Copy(temp.arena, path);
+// hashes the final 'count' bytes (at most 48) of an input that was 'total' bytes long, when the
+// input was longer than 16 bytes the final 16 bytes are read even if they start before 'data'
+//
+internal U64 __Hash_Tail(U64 seed, U8 *data, U64 count, U64 total) {
+    U64 a, b;
 
-    struct stat stbuf;
-    if (stat((const char *) zpath.data, &stbuf) == 0) {
-        result.written  = (1e9 * stbuf.st_mtim.tv_sec) + stbuf.st_mtim.tv_nsec;
-        result.accessed = (1e9 * stbuf.st_atim.tv_sec) + stbuf.st_mtim.tv_nsec;
-        result.created  = 0; // not available on unix ?
+    if (total <= 16) {
+        if (count >= 4) {
+            // two overlapping pairs of 4 byte reads cover every length from 4 to 16
+            //
+            U64 offset = (count >> 3) << 2;
+
+            a = (__Hash_Read32(data) << 32) | __Hash_Read32(data + offset);
+            b = (__Hash_Read32(data + count - 4) << 32) | __Hash_Read32(data + count - 4 - offset);
+        }
+        else if (count > 0) {
+            a = (cast(U64) data[0] << 16) | (cast(U64) data[count >> 1] << 8) | data[count - 1];
+            b = 0;
+        }
+        else {
+            a = b = 0;
+        }
     }
     else {
-        Log_Error("stat failed on path '%.*s' (%d)", Sv(path), errno);
+        while (count > 16) {
+            seed = __Hash_Mix(__Hash_Read64(data) ^ HASH_SECRET1, __Hash_Read64(data + 8) ^ seed);
+
+            data  += 16;
+            count -= 16;
+        }
+
+        a = __Hash_Read64(data + count - 16);
+        b = __Hash_Read64(data + count - 8);
     }
 
-    M_ReleaseTemp(temp);
+    a ^= HASH_SECRET1;
+    b ^= seed;
+
+    a = MulWide_U64(a, b, &b);
 
+    U64 result = __Hash_Mix(a ^ HASH_SECRET0 ^ total, b ^ HASH_SECRET1);
     return result;
 }
 
-U64 FS_SizeFromPath(Str8 path) {
-    U64 result = 0;
+U64 Hash_MemorySeed(void *data, U64 size, U64 seed) {
+    U8 *ptr   = cast(U8 *) data;
+    U64 count = size;
 
-    M_Temp temp = M_AcquireTemp(0, 0);
-    Str8 zpath  = Str8_Copy(temp.arena, path);
+    seed = __Hash_Seed(seed);
 
-    struct stat stbuf;
-    if (stat((const char *) zpath.data, &stbuf) == 0) {
-        result = stbuf.st_size;
-    }
-    else {
-        Log_Error("stat failed on path '%.*s' (%d)", Sv(path), errno);
+    if (count > 48) {
+        U64 see1 = seed;
+        U64 see2 = seed;
+
+        do {
+            __Hash_Block(&seed, &see1, &see2, ptr);
+
+            ptr   += 48;
+            count -= 48;
+        }
+        while (count > 48);
+
+        seed ^= (see1 ^ see2);
     }
 
-    M_ReleaseTemp(temp);
+    U64 result = __Hash_Tail(seed, ptr, count, size);
+    return result;
+}
 
+U64 Hash_Memory(void *data, U64 size) {
+    U64 result = Hash_MemorySeed(data, size, HASH_DEFAULT_SEED);
     return result;
 }
 
-B32 FS_CreateDirectory(Str8 path) {
-    B32 result = true;
+U64 Hash_Str8Seed(Str8 str, U64 seed) {
+    U64 result = Hash_MemorySeed(str.data, cast(U64) str.count, seed);
+    return result;
+}
 
-    M_Temp temp = M_AcquireTemp(0, 0);
-    Str8 cpy    = Str8_Copy(temp.arena, path);
+U64 Hash_Str8(Str8 str) {
+    U64 result = Hash_MemorySeed(str.data, cast(U64) str.count, HASH_DEFAULT_SEED);
+    return result;
+}
 
-    char *zpath = cast(char *) cpy.data;
+// converts the ascii lowercase bytes in 'word' to uppercase 8 at a time, each byte has 'a' and
+// 'z' + 1 subtracted from its low 7 bits with the high bit of the byte as a borrow guard, so the
+// high bit survives only for bytes in 'a'..'z'. bytes with their own high bit set are excluded
+//
+internal U64 __Hash_UppercaseWord(U64 word) {
+    const U64 ones = 0x0101010101010101ULL;
+    const U64 high = 0x8080808080808080ULL;
+
+    U64 low7   = word & ~high;
+    U64 ge_a   = (low7 + ((0x80 - 'a') * ones)) & high;
+    U64 gt_z   = (low7 + ((0x80 - 'z' - 1) * ones)) & high;
+    U64 letter = ge_a & ~gt_z & ~word;
 
+    U64 result = word ^ (letter >> 2); // 0x80 >> 2 is the 0x20 case bit
+    return result;
+}
+
+internal void __Hash_Uppercase(U8 *dst, U8 *src, S64 count) {
     S64 it = 0;
-    while (zpath[it]) {
-        if (zpath[it] == '/') {
-            zpath[it] = 0;
+    for (; it + 8 <= count; it += 8) {
+        __Hash_Write64(dst + it, __Hash_UppercaseWord(__Hash_Read64(src + it)));
+    }
 
-            mode_t mode = S_IRWXU | S_IRGRP | S_IXGRP | S_IROTH | S_IXOTH; // 0755
-            if (mkdir(zpath, mode) != 0) {
-                if (errno != EEXIST) {
-                    Log_Error("Failed to create directory '%s' (%d)", zpath, errno);
+    for (; it < count; ++it) { dst[it] = Chr_ToUppercase(src[it]); }
+}
 
-                    result = false;
-                    break;
-                }
-            }
+U64 Hash_Str8IgnoreCase(Str8 str) {
+    U64 result;
 
-            zpath[it] = '/';
-        }
+    U8 folded[256];
 
-        it += 1;
+    if (str.count <= cast(S64) sizeof(folded)) {
+        __Hash_Uppercase(folded, str.data, str.count);
+        result = Hash_MemorySeed(folded, cast(U64) str.count, HASH_DEFAULT_SEED);
     }
+    else {
+        Hash_State state;
+        Hash_Begin(&state, HASH_DEFAULT_SEED);
 
-    if (result) {
-        mode_t mode = S_IRWXU | S_IRGRP | S_IXGRP | S_IROTH | S_IXOTH; // 0755
-        if (mkdir(zpath, mode) != 0) {
-            result = false;
-            if (errno == EEXIST) {
-                struct stat stbuf;
-                if (stat(zpath, &stbuf) == 0) {
-                    result = ((stbuf.st_mode & S_IFMT) == S_IFDIR);
-                }
-            }
+        for (S64 offset = 0; offset < str.count; offset += sizeof(folded)) {
+            S64 count = Min(str.count - offset, cast(S64) sizeof(folded));
+
+            __Hash_Uppercase(folded, str.data + offset, count);
+            Hash_Update(&state, folded, cast(U64) count);
         }
-    }
 
-    M_ReleaseTemp(temp);
+        result = Hash_Finish(&state);
+    }
 
     return result;
 }
 
-B32 FS_RemoveDirectory(Str8 path) {
-    M_Temp temp = M_AcquireTemp(0, 0);
-    Str8 zpath  = Str8_Copy(temp.arena, path);
-
-    B32 result = rmdir((const char *) zpath.data) == 0;
+// murmur3 finaliser
+//
+U64 Hash_U64(U64 x) {
+    U64 result = x;
 
-    M_ReleaseTemp(temp);
+    result ^= (result >> 33);
+    result *= 0xFF51AFD7ED558CCDULL;
+    result ^= (result >> 33);
+    result *= 0xC4CEB9FE1A85EC53ULL;
+    result ^= (result >> 33);
 
     return result;
 }
 
-Str8 FS_GetPath(M_Arena *arena, FS_PathType type) {
-    Str8 result = ZERO(Str8);
-
-    M_Temp temp = M_AcquireTemp(1, &arena);
+void Hash_Begin(Hash_State *state, U64 seed) {
+    state->seed  = __Hash_Seed(seed);
+    state->see1  = state->seed;
+    state->see2  = state->seed;
+    state->total = 0;
+    state->count = 0;
+}
 
-    switch (type) {
-        case FS_PATH_EXE: {
-            char *buffer;
-            S64 size = 512;
+// a block is only consumed once it is known that more data follows it, the final 1 to 48 bytes
+// always go through the tail in Hash_Finish exactly like the single call version
+//
+void Hash_Update(Hash_State *state, void *data, U64 size) {
+    U8 *ptr = cast(U8 *) data;
 
-            ssize_t count;
-            for (;;) {
-                // we have to keep iterating towards the required buffer size
-                // because readlink wont actually tell us
-                //
-                size *= 2;
-                buffer = M_ArenaPush(temp.arena, char, size);
+    state->total += size;
 
-                count = readlink("/proc/self/exe", buffer, size);
-                if (count < size) { break; }
+    U8 *pending = state->buffer + 16;
 
-                M_ArenaPopLast(temp.arena);
-            }
+    if ((state->count + size) <= 48) {
+        M_CopySize(pending + state->count, ptr, size);
+        state->count += cast(U32) size;
+    }
+    else {
+        U8 *last = 0;
 
-            if (count > 0) {
-                while (buffer[count] != '/') { count -= 1; }
+        if (state->count) {
+            U64 fill = 48 - state->count;
+            M_CopySize(pending + state->count, ptr, fill);
 
-                buffer[count] = 0;
+            ptr  += fill;
+            size -= fill;
 
-                result.count = count;
-                result.data  = M_ArenaPushCopy(arena, buffer, U8, count + 1);
-            }
-            else {
-                Log_Error("readlink failed on /proc/self/exe (%d)", errno);
-            }
+            __Hash_Block(&state->seed, &state->see1, &state->see2, pending);
+            last = pending;
         }
-        break;
-        case FS_PATH_USER: {
-            // @todo: this can be changed to use our own loaded environment variables
-            // which we can get by reading /proc/self/environ on an init call
-            //
-            if (__environ) {
-                Str8 home_dir = ZERO(Str8);
-                Str8 xdg_dir  = ZERO(Str8);
-
-                for (U32 it = 0; __environ[it] != 0; it += 1) {
-                    Str8 env = Sz(__environ[it]);
-                    if (Str8_Equal(env, S("XDG_DATA_HOME"), STR8_EQUAL_FLAG_INEXACT_RHS)) {
-                        xdg_dir = Str8_RemoveBeforeFirst(env, '=');
-
-                        // we only really need this, $HOME is a fallback if
-                        // this is unset
-                        //
-                        break;
-                    }
-                    else if (Str8_Equal(env, S("HOME"), STR8_EQUAL_FLAG_INEXACT_RHS)) {
-                        home_dir = Str8_RemoveBeforeFirst(env, '=');
-                    }
-                }
 
-                if (xdg_dir.count || home_dir.count) {
-                    if (!xdg_dir.count) {
-                        // this is the defined default as per specifiction
-                        //
-                        result = Sf(arena, "%.*s/.local/share", Sv(home_dir));
-                    }
-                    else {
-                        result = Str8_Copy(arena, xdg_dir);
-                    }
-                }
-                else {
-                    Log_Error("Failed to get user home directory");
-                }
-            }
-            else {
-                Log_Error("__environ variable was null");
-            }
+        while (size > 48) {
+            __Hash_Block(&state->seed, &state->see1, &state->see2, ptr);
+            last = ptr;
+
+            ptr  += 48;
+            size -= 48;
         }
-        break;
-        case FS_PATH_TEMP: {
-            Str8 temp_dir = Sl("/tmp");
 
-            if (__environ) {
-                // look for $TEMP or $TMP set by user and use that if it is
-                // set, otherwise we fallback to the globally available /tmp
-                //
-                for (U32 it = 0; __environ[it] != 0; it += 1) {
-                    Str8 env = Sz(__environ[it]);
-                    if (Str8_Equal(env, S("TEMP"), STR8_EQUAL_FLAG_INEXACT_RHS)) {
-                        temp_dir = Str8_RemoveBeforeFirst(env, '=');
-                        break;
-                    }
-                    else if (Str8_Equal(env, S("TMP"), STR8_EQUAL_FLAG_INEXACT_RHS)) {
-                        temp_dir = Str8_RemoveBeforeFirst(env, '=');
-                        break;
-                    }
-                }
+        M_CopySize(state->buffer, last + 32, 16);
+        M_CopySize(pending, ptr, size);
 
-            }
+        state->count = cast(U32) size;
+    }
+}
 
-            result = Str8_Copy(arena, temp_dir);
-        }
-        break;
-        case FS_PATH_WORKING: {
-            size_t size  = PATH_MAX;
-            char *buffer = M_ArenaPush(temp.arena, char, size);
+void Hash_UpdateStr8(Hash_State *state, Str8 str) {
+    Hash_Update(state, str.data, cast(U64) str.count);
+}
 
-            for (;;) {
-                if (getcwd(buffer, size)) {
-                    break;
-                }
-                else if (errno != ERANGE) {
-                    Log_Error("Failed to get current directory (%d)", errno);
+U64 Hash_Finish(Hash_State *state) {
+    U64 seed = state->seed;
+    if (state->total > 48) { seed ^= (state->see1 ^ state->see2); }
 
-                    buffer = 0;
-                    break;
-                }
+    U64 result = __Hash_Tail(seed, state->buffer + 16, state->count, state->total);
+    return result;
+}
 
-                M_ArenaPopLast(temp.arena);
+//
+// --------------------------------------------------------------------------------
+// :impl_hash_map
+// --------------------------------------------------------------------------------
+//
+#define HM_GROUP_SIZE 16
 
-                size  *= 2;
-                buffer = M_ArenaPush(temp.arena, char, size);
-            }
+#define HM_CTRL_EMPTY   0x80
+#define HM_CTRL_DELETED 0xFE
 
-            if (buffer) { result = Str8_Copy(arena, Sz(buffer)); }
-        }
-        break;
-        default: {} break;
-    }
+// tables are rebuilt when they are 7/8 full including tombstones
+//
+#define HM_MaxLoad(capacity) ((capacity) - ((capacity) >> 3))
 
-    M_ReleaseTemp(temp);
+// group matching, returns a 16-bit mask with bit 'n' set when the control byte 'n' matches
+//
+#if ARCH_AMD64
+
+internal U32 __HM_MatchByte(U8 *group, U8 value) {
+    __m128i ctrl  = _mm_load_si128(cast(__m128i *) group);
+    __m128i match = _mm_cmpeq_epi8(ctrl, _mm_set1_epi8(cast(char) value));
 
+    U32 result = cast(U32) _mm_movemask_epi8(match);
     return result;
 }
 
-#elif OS_SWITCH
-    #error "Switchbrew filesystem subsystem not implemented"
-#endif
+// empty and deleted are the only control bytes with the high bit set
+//
+internal U32 __HM_MatchEmptyOrDeleted(U8 *group) {
+    __m128i ctrl = _mm_load_si128(cast(__m128i *) group);
 
-Str8 FS_ReadEntireFile(M_Arena *arena, Str8 path) {
-    Str8 result = ZERO(Str8);
+    U32 result = cast(U32) _mm_movemask_epi8(ctrl);
+    return result;
+}
 
-    OS_Handle file = FS_OpenFile(path, FS_ACCESS_READ);
+#elif ARCH_AARCH64
 
-    result.count = FS_SizeFromHandle(file);
-    result.data  = M_ArenaPush(arena, U8, result.count);
+// neon doesn't have a movemask, so each lane is masked with its bit in the byte and the halves
+// are summed horizontally
+//
+internal U32 __HM_MoveMask(uint8x16_t match) {
+    const U8 bits[16] = { 1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128 };
 
-    FS_ReadFile(file, result, 0);
+    uint8x16_t masked = vandq_u8(match, vld1q_u8(bits));
 
-    FS_CloseFile(file);
+    U32 result = cast(U32) vaddv_u8(vget_low_u8(masked)) | (cast(U32) vaddv_u8(vget_high_u8(masked)) << 8);
+    return result;
+}
+
+internal U32 __HM_MatchByte(U8 *group, U8 value) {
+    uint8x16_t match = vceqq_u8(vld1q_u8(group), vdupq_n_u8(value));
 
+    U32 result = __HM_MoveMask(match);
     return result;
 }
 
-//
-// --------------------------------------------------------------------------------
-// :impl_threading
-// --------------------------------------------------------------------------------
-//
+internal U32 __HM_MatchEmptyOrDeleted(U8 *group) {
+    uint8x16_t match = vcltzq_s8(vreinterpretq_s8_u8(vld1q_u8(group)));
+
+    U32 result = __HM_MoveMask(match);
+    return result;
+}
 
-#if OS_WINDOWS
+#endif
 
+// the top 57 bits of the hash select the group and the bottom 7 bits are stored in the
+// control byte
 //
-// --------------------------------------------------------------------------------
-// :windows_threading
-// --------------------------------------------------------------------------------
-//
-
-internal DWORD Win32_ThreadEntry(LPVOID param) {
-    DWORD result = 0;
-
-    Win32_Object *object = cast(Win32_Object *) param;
+internal U64 __HM_Hash(HM_Map *map, U64 key_u64, Str8 key_str8) {
+    U64 result = (map->key_type == HM_KEY_STR8) ? Hash_Str8(key_str8) : Hash_U64(key_u64);
+    return result;
+}
 
-    Log_Init();
+internal U8 *__HM_Slot(HM_Map *map, U64 index) {
+    U8 *result = map->slots + (index * map->slot_size);
+    return result;
+}
 
-    T_ThreadProc *TProc  = object->thread.Proc;
-    void         *tparam = object->thread.param;
+internal U64 __HM_KeySize(HM_KeyType key_type) {
+    U64 result = (key_type == HM_KEY_STR8) ? sizeof(Str8) : sizeof(U64);
+    return result;
+}
 
-    TProc(tparam);
+internal B32 __HM_KeyEqual(HM_Map *map, U8 *slot, U64 key_u64, Str8 key_str8) {
+    B32 result;
 
-    LONG ref = _InterlockedAnd(&object->thread.ref, ~0x2);
-    if ((ref & 0x1) == 0) {
-        CloseHandle(object->thread.handle);
-        Win32_ReleaseObject(object);
+    if (map->key_type == HM_KEY_STR8) {
+        Str8 *key = cast(Str8 *) slot;
+        result = (key->count == key_str8.count) && M_CompareSize(key->data, key_str8.data, key_str8.count);
+    }
+    else {
+        result = (*cast(U64 *) slot == key_u64);
     }
 
     return result;
 }
 
-void T_CreateThread(T_Thread *thread) {
-    Win32_Object *object = Win32_AllocObject(WIN32_OBJECT_THREAD);
+// returns the index of the slot holding 'key' or -1 if it isn't in the map, groups are probed
+// in triangular order which visits every group when the group count is a power of two
+//
+internal S64 __HM_FindIndex(HM_Map *map, U64 hash, U64 key_u64, Str8 key_str8) {
+    S64 result = -1;
 
-    object->thread.Proc  = thread->Proc;
-    object->thread.param = thread->param;
+    if (map->capacity != 0) {
+        U64 group_mask = (map->capacity / HM_GROUP_SIZE) - 1;
+        U64 group      = (hash >> 7) & group_mask;
 
-    DWORD id, flags = CREATE_SUSPENDED;
+        U8 h2 = cast(U8) (hash & 0x7F);
 
-    HANDLE handle = CreateThread(0, thread->stack_size, Win32_ThreadEntry, object, flags, &id);
+        for (U64 probe = 1; result < 0; ++probe) {
+            U8 *ctrl = map->ctrl + (group * HM_GROUP_SIZE);
 
-    object->thread.handle = handle;
-    object->thread.id     = id;
-    object->thread.ref    = 0x3;
+            for (U32 match = __HM_MatchByte(ctrl, h2); match != 0; match &= (match - 1)) {
+                U64 index = (group * HM_GROUP_SIZE) + CountTrailingZeros_U32(match);
 
-    thread->handle.v[0] = cast(U64) object;
+                if (__HM_KeyEqual(map, __HM_Slot(map, index), key_u64, key_str8)) {
+                    result = cast(S64) index;
+                    break;
+                }
+            }
 
-    if (thread->flags & T_THREAD_CREATE_DETACHED) {
-        // Detach the calling thread from the new thread automatically, this way
-        // you don't have to care about managing the returned handle if you
-        // just want to "fire and forget" threads at startup
-        //
-        // Returned handle becomes invalid
-        //
-        T_DetachThread(thread->handle);
-        thread->handle = OS_NilHandle();
+            // a group with an empty slot terminates the probe sequence because an insert
+            // would have used it rather than moving on to the next group
+            //
+            if (result < 0 && __HM_MatchByte(ctrl, HM_CTRL_EMPTY) != 0) { break; }
 
-        // Always resume the thread if created detached otherwise there wouldn't
-        // be any way for the calling thread to resume the created thread!
-        //
-        ResumeThread(object->thread.handle);
-    }
-    else if ((thread->flags & T_THREAD_CREATE_SUSPENDED) == 0) {
-        // Automatically resume the thread as it wasn't requested to be
-        //
-        ResumeThread(object->thread.handle);
+            group = (group + probe) & group_mask;
+        }
     }
-}
-
-void T_ResumeThread(OS_Handle thread) {
-    Win32_Object *object = cast(Win32_Object *) thread.v[0];
-    Assert(object->type == WIN32_OBJECT_THREAD);
 
-    ResumeThread(object->thread.handle);
+    return result;
 }
 
-void T_JoinThread(OS_Handle thread) {
-    Win32_Object *object = cast(Win32_Object *) thread.v[0];
-    Assert(object->type == WIN32_OBJECT_THREAD);
+// finds the first empty or deleted slot in the probe sequence of 'hash', the table must not
+// be full which the load factor guarantees
+//
+internal U64 __HM_FindInsertIndex(HM_Map *map, U64 hash) {
+    U64 result = 0;
 
-    WaitForSingleObject(object->thread.handle, INFINITE);
-}
+    U64 group_mask = (map->capacity / HM_GROUP_SIZE) - 1;
+    U64 group      = (hash >> 7) & group_mask;
 
-void T_DetachThread(OS_Handle thread) {
-    Win32_Object *object = cast(Win32_Object *) thread.v[0];
-    Assert(object->type == WIN32_OBJECT_THREAD);
+    for (U64 probe = 1;; ++probe) {
+        U32 match = __HM_MatchEmptyOrDeleted(map->ctrl + (group * HM_GROUP_SIZE));
+        if (match != 0) {
+            result = (group * HM_GROUP_SIZE) + CountTrailingZeros_U32(match);
+            break;
+        }
 
-    LONG ref = _InterlockedAnd(&object->thread.ref, ~0x1);
-    if ((ref & 0x2) == 0) {
-        CloseHandle(object->thread.handle);
-        Win32_ReleaseObject(object);
+        group = (group + probe) & group_mask;
     }
+
+    return result;
 }
 
-OS_Handle T_CreateMutex() {
-    OS_Handle result;
+internal void __HM_Rebuild(HM_Map *map, U64 capacity) {
+    U8 *old_ctrl  = map->ctrl;
+    U8 *old_slots = map->slots;
 
-    Win32_Object *object = Win32_AllocObject(WIN32_OBJECT_CRITICAL_SECTION);
+    U64 old_capacity = map->capacity;
 
-    // @todo: maybe change to "InitializeCriticalSectionAndSpinCount" for lower latency
-    // exchanges when contention is low
-    //
-    InitializeCriticalSection(&object->critical_section);
+    map->ctrl  = M_ArenaPush(map->arena, U8, capacity, M_ARENA_NO_ZERO, HM_GROUP_SIZE);
+    map->slots = M_ArenaPush(map->arena, U8, capacity * map->slot_size, M_ARENA_NO_ZERO, 8);
 
-    result.v[0] = cast(U64) object;
-    return result;
-}
+    M_FillSize(map->ctrl, HM_CTRL_EMPTY, capacity);
 
-void T_DeleteMutex(OS_Handle mutex) {
-    Win32_Object *object = cast(Win32_Object *) mutex.v[0];
-    Assert(object->type == WIN32_OBJECT_CRITICAL_SECTION);
+    map->capacity    = capacity;
+    map->tombstones  = 0;
+    map->growth_left = HM_MaxLoad(capacity) - map->count;
 
-    DeleteCriticalSection(&object->critical_section);
+    for (U64 it = 0; it < old_capacity; ++it) {
+        if ((old_ctrl[it] & 0x80) == 0) {
+            U8 *slot = old_slots + (it * map->slot_size);
 
-    Win32_ReleaseObject(object);
-}
+            U64  key_u64  = 0;
+            Str8 key_str8 = ZERO(Str8);
 
-void T_AcquireMutex(OS_Handle mutex) {
-    Win32_Object *object = cast(Win32_Object *) mutex.v[0];
-    Assert(object->type == WIN32_OBJECT_CRITICAL_SECTION);
+            if (map->key_type == HM_KEY_STR8) { key_str8 = *cast(Str8 *) slot; }
+            else                              { key_u64  = *cast(U64  *) slot; }
 
-    EnterCriticalSection(&object->critical_section);
+            U64 hash  = __HM_Hash(map, key_u64, key_str8);
+            U64 index = __HM_FindInsertIndex(map, hash);
+
+            map->ctrl[index] = cast(U8) (hash & 0x7F);
+            M_CopySize(__HM_Slot(map, index), slot, map->slot_size);
+        }
+    }
 }
 
-void T_ReleaseMutex(OS_Handle mutex) {
-    Win32_Object *object = cast(Win32_Object *) mutex.v[0];
-    Assert(object->type == WIN32_OBJECT_CRITICAL_SECTION);
+internal U64 __HM_CapacityFor(U64 count) {
+    U64 result = HM_GROUP_SIZE;
+    while (HM_MaxLoad(result) < count) { result <<= 1; }
 
-    LeaveCriticalSection(&object->critical_section);
+    return result;
 }
 
-OS_Handle T_CreateSemaphore(U32 max) {
-    OS_Handle result;
+HM_Map *HM_AllocMap(M_Arena *arena, HM_KeyType key_type, U64 value_size, HM_MapFlags flags) {
+    HM_Map *result = M_ArenaPush(arena, HM_Map);
 
-    // @todo: maybe allow a name, we don't support cross-process semaphores
-    // however
-    //
-    HANDLE hSemaphore = CreateSemaphoreW(0, max, max, 0);
+    result->arena = arena;
+
+    result->value_size = cast(U32) value_size;
+    result->slot_size  = cast(U32) AlignUp(__HM_KeySize(key_type) + value_size, 8);
+
+    result->key_type = key_type;
+    result->flags    = flags;
 
-    result.v[0] = cast(U64) hSemaphore;
     return result;
 }
 
-void T_DeleteSemaphore(OS_Handle semaphore) {
-    HANDLE hSemaphore = cast(HANDLE) semaphore.v[0];
-    CloseHandle(hSemaphore);
+void HM_Reserve(HM_Map *map, U64 count) {
+    U64 capacity = __HM_CapacityFor(count);
+    if (capacity > map->capacity) { __HM_Rebuild(map, capacity); }
 }
 
-void T_WaitSemaphore(OS_Handle semaphore) {
-    HANDLE hSemaphore = cast(HANDLE) semaphore.v[0];
-    WaitForSingleObject(hSemaphore, INFINITE);
-}
+void HM_Clear(HM_Map *map) {
+    if (map->capacity != 0) { M_FillSize(map->ctrl, HM_CTRL_EMPTY, map->capacity); }
 
-void T_SignalSemaphore(OS_Handle semaphore) {
-    HANDLE hSemaphore = cast(HANDLE) semaphore.v[0];
-    ReleaseSemaphore(hSemaphore, 1, 0);
+    map->count       = 0;
+    map->tombstones  = 0;
+    map->growth_left = HM_MaxLoad(map->capacity);
 }
 
-OS_Handle T_CreateRWLock() {
-    OS_Handle result;
+internal void *__HM_Insert(HM_Map *map, U64 key_u64, Str8 key_str8) {
+    U64 hash = __HM_Hash(map, key_u64, key_str8);
+    S64 find = __HM_FindIndex(map, hash, key_u64, key_str8);
 
-    // According to documentation the size of the SRWLock type is pointer sized, however,
-    // I don't know if the pointer has to be in the same memory location so we allocate
-    // it dynamically for now @test!!
-    //
-    Win32_Object *object = Win32_AllocObject(WIN32_OBJECT_SRWLOCK);
-    InitializeSRWLock(&object->srwlock);
+    U8 *result;
 
-    result.v[0] = cast(U64) object;
-    return result;
-}
+    if (find >= 0) {
+        result = __HM_Slot(map, find) + __HM_KeySize(map->key_type);
+    }
+    else {
+        if (map->growth_left == 0) {
+            // if a large part of the load is tombstones rebuilding at the same size is enough to
+            // reclaim them, otherwise double the size
+            //
+            U64 capacity = map->capacity;
+            if (map->count + 1 > (HM_MaxLoad(capacity) >> 1)) { capacity = __HM_CapacityFor(map->count + 1); }
 
-void T_DeleteRWLock(OS_Handle rwlock) {
-    Win32_Object *object = cast(Win32_Object *) rwlock.v[0];
-    Assert(object->type == WIN32_OBJECT_SRWLOCK);
+            __HM_Rebuild(map, Max(capacity, map->capacity));
+        }
 
-    Win32_ReleaseObject(object);
-}
+        U64 index = __HM_FindInsertIndex(map, hash);
 
-void T_AcquireRWLockRead(OS_Handle rwlock) {
-    Win32_Object *object = cast(Win32_Object *) rwlock.v[0];
-    Assert(object->type == WIN32_OBJECT_SRWLOCK);
+        if (map->ctrl[index] == HM_CTRL_DELETED) { map->tombstones  -= 1; }
+        else                                     { map->growth_left -= 1; }
 
-    AcquireSRWLockShared(&object->srwlock);
-}
+        map->ctrl[index] = cast(U8) (hash & 0x7F);
+        map->count += 1;
 
-void T_ReleaseRWLockRead(OS_Handle rwlock) {
-    Win32_Object *object = cast(Win32_Object *) rwlock.v[0];
-    Assert(object->type == WIN32_OBJECT_SRWLOCK);
+        U8 *slot = __HM_Slot(map, index);
 
-    ReleaseSRWLockShared(&object->srwlock);
-}
+        if (map->key_type == HM_KEY_STR8) {
+            if (map->flags & HM_MAP_COPY_KEYS) { key_str8 = Str8_Copy(map->arena, key_str8); }
+            *cast(Str8 *) slot = key_str8;
+        }
+        else {
+            *cast(U64 *) slot = key_u64;
+        }
 
-void T_AcquireRWLockWrite(OS_Handle rwlock) {
-    Win32_Object *object = cast(Win32_Object *) rwlock.v[0];
-    Assert(object->type == WIN32_OBJECT_SRWLOCK);
+        result = slot + __HM_KeySize(map->key_type);
+        M_ZeroSize(result, map->value_size);
+    }
 
-    AcquireSRWLockExclusive(&object->srwlock);
+    return result;
 }
 
-void T_ReleaseRWLockWrite(OS_Handle rwlock) {
-    Win32_Object *object = cast(Win32_Object *) rwlock.v[0];
-    Assert(object->type == WIN32_OBJECT_SRWLOCK);
+internal B32 __HM_Remove(HM_Map *map, U64 key_u64, Str8 key_str8) {
+    U64 hash  = __HM_Hash(map, key_u64, key_str8);
+    S64 index = __HM_FindIndex(map, hash, key_u64, key_str8);
 
-    ReleaseSRWLockExclusive(&object->srwlock);
-}
+    B32 result = (index >= 0);
+    if (result) {
+        U8 *group = map->ctrl + (index & ~cast(S64) (HM_GROUP_SIZE - 1));
 
-OS_Handle T_CreateConditionVar() {
-    OS_Handle result;
+        // if the group still has an empty slot no probe sequence can have continued past it, so
+        // the slot can be emptied directly rather than leaving a tombstone
+        //
+        if (__HM_MatchByte(group, HM_CTRL_EMPTY) != 0) {
+            map->ctrl[index]  = HM_CTRL_EMPTY;
+            map->growth_left += 1;
+        }
+        else {
+            map->ctrl[index] = HM_CTRL_DELETED;
+            map->tombstones += 1;
+        }
 
-    Win32_Object *object = Win32_AllocObject(WIN32_OBJECT_CONDITION_VAR);
-    InitializeConditionVariable(&object->condition_var);
+        map->count -= 1;
+    }
 
-    result.v[0] = cast(U64) object;
     return result;
 }
 
-void T_DeleteConditionVar(OS_Handle condvar) {
-    Win32_Object *object = cast(Win32_Object *) condvar.v[0];
-    Assert(object->type == WIN32_OBJECT_CONDITION_VAR);
+// integer keys don't use the string key so pass an empty one
+//
+void *HM_InsertU64(HM_Map *map, U64 key) {
+    Str8 none = ZERO(Str8);
 
-    Win32_ReleaseObject(object);
+    void *result = __HM_Insert(map, key, none);
+    return result;
 }
 
-void T_WaitConditionVar(OS_Handle condvar, OS_Handle mutex) {
-    Win32_Object *cvar = cast(Win32_Object *) condvar.v[0];
-    Win32_Object *lock = cast(Win32_Object *) mutex.v[0];
+void *HM_FindU64(HM_Map *map, U64 key) {
+    void *result = 0;
+    Str8  none   = ZERO(Str8);
 
-    Assert(cvar->type == WIN32_OBJECT_CONDITION_VAR);
-    Assert(lock->type == WIN32_OBJECT_CRITICAL_SECTION);
+    S64 index = __HM_FindIndex(map, Hash_U64(key), key, none);
+    if (index >= 0) { result = __HM_Slot(map, index) + sizeof(U64); }
 
-    SleepConditionVariableCS(&cvar->condition_var, &lock->critical_section, INFINITE);
+    return result;
 }
 
-void T_WaitConditionVarRead(OS_Handle condvar, OS_Handle rwlock) {
-    Win32_Object *cvar = cast(Win32_Object *) condvar.v[0];
-    Win32_Object *lock = cast(Win32_Object *) rwlock.v[0];
+B32 HM_RemoveU64(HM_Map *map, U64 key) {
+    Str8 none = ZERO(Str8);
 
-    Assert(cvar->type == WIN32_OBJECT_CONDITION_VAR);
-    Assert(lock->type == WIN32_OBJECT_SRWLOCK);
+    B32 result = __HM_Remove(map, key, none);
+    return result;
+}
 
-    ULONG flags = CONDITION_VARIABLE_LOCKMODE_SHARED;
-    SleepConditionVariableSRW(&cvar->condition_var, &lock->srwlock, INFINITE, flags);
+void *HM_InsertStr8(HM_Map *map, Str8 key) {
+    void *result = __HM_Insert(map, 0, key);
+    return result;
 }
 
-void T_WaitConditionVarWrite(OS_Handle condvar, OS_Handle rwlock) {
-    Win32_Object *cvar = cast(Win32_Object *) condvar.v[0];
-    Win32_Object *lock = cast(Win32_Object *) rwlock.v[0];
+void *HM_FindStr8(HM_Map *map, Str8 key) {
+    void *result = 0;
 
-    Assert(cvar->type == WIN32_OBJECT_CONDITION_VAR);
-    Assert(lock->type == WIN32_OBJECT_SRWLOCK);
+    S64 index = __HM_FindIndex(map, Hash_Str8(key), 0, key);
+    if (index >= 0) { result = __HM_Slot(map, index) + sizeof(Str8); }
 
-    SleepConditionVariableSRW(&cvar->condition_var, &lock->srwlock, INFINITE, 0);
+    return result;
 }
 
-void T_WakeConditionVar(OS_Handle condvar) {
-    Win32_Object *object = cast(Win32_Object *) condvar.v[0];
-    Assert(object->type == WIN32_OBJECT_CONDITION_VAR);
-
-    WakeConditionVariable(&object->condition_var);
+B32 HM_RemoveStr8(HM_Map *map, Str8 key) {
+    B32 result = __HM_Remove(map, 0, key);
+    return result;
 }
 
-void T_BroadcastConditionVar(OS_Handle condvar) {
-    Win32_Object *object = cast(Win32_Object *) condvar.v[0];
-    Assert(object->type == WIN32_OBJECT_CONDITION_VAR);
+B32 HM_Next(HM_Map *map, HM_Iter *iter) {
+    B32 result = false;
 
-    WakeAllConditionVariable(&object->condition_var);
-}
+    while (iter->index < map->capacity) {
+        U64 index = iter->index++;
 
-void T_WaitFutex(T_Futex *futex, U32 value) {
-    for (;;) {
-        WaitOnAddress(futex, &value, sizeof(U32), INFINITE);
-        if (futex[0] != value) { break; }
-    }
-}
+        if ((map->ctrl[index] & 0x80) == 0) {
+            U8 *slot = __HM_Slot(map, index);
 
-void T_WakeFutex(T_Futex *futex) {
-    WakeByAddressSingle(cast(PVOID) futex);
-}
+            if (map->key_type == HM_KEY_STR8) { iter->key_str8 = *cast(Str8 *) slot; }
+            else                              { iter->key_u64  = *cast(U64  *) slot; }
 
-void T_BroadcastFutex(T_Futex *futex) {
-    WakeByAddressAll(cast(PVOID) futex);
-}
+            iter->value = slot + __HM_KeySize(map->key_type);
 
-#elif OS_MACOS
-    #error "macOS threading subsystem not implemented"
-#elif OS_LINUX
-    #error "Linux threading subsystem not implemented"
-#elif OS_SWITCH
-    #error "Switchbrew threading subsystem not implemented"
-#endif
+            result = true;
+            break;
+        }
+    }
+
+    return result;
+}
 
 #endif  // CORE_C_
 
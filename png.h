@@ -644,7 +644,7 @@ internal B32 __ZLIB_Decompress(__PNG_Decoder *decoder, Str8 zbuffer) {
                     dist  = dist_base[v];
                     dist += Stream_ReadBits(stream, dist_extra[v]);
 
-                    if (zpos + len <= zend) { M_CopySize(zpos, zpos - dist, len); }
+                    if (zpos + len <= zend) { M_CopySizeForward(zpos, zpos - dist, len); }
 
                     // Always update the decode buffer position to catch overwrite
                     // errors
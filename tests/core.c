@@ -8,6 +8,15 @@
 
 #include <stdio.h>
 
+#if OS_LINUX
+    #include <sys/wait.h>
+#endif
+
+#if LANG_CPP
+    #include <string>
+    #include <unordered_map>
+#endif
+
 typedef struct ListNode ListNode;
 struct ListNode {
     ListNode *next;
@@ -46,281 +55,1055 @@ internal COMPARE_FUNC(CompareListNode) {
     return (node_a->value - node_b->value);
 }
 
-global_var U32 thread_sum = 0; // don't do this, but only one extra thread
-
-internal T_THREAD_PROC(TestThreadProc) {
-    (void) param;
+internal COMPARE_FUNC(CompareU32) {
+    U32 ai = *cast(U32 *) a;
+    U32 bi = *cast(U32 *) b;
 
-    for (U32 it = 0; it < 10; ++it) {
-        thread_sum += it;
-    }
+    return (ai > bi) - (ai < bi);
 }
 
-internal int ExecuteTests(int argc, char **argv) {
-    // ... do nothing for now
-    //
-    (void) argc;
-    (void) argv;
+internal COMPARE_FUNC(CompareF32) {
+    F32 af = *cast(F32 *) a;
+    F32 bf = *cast(F32 *) b;
 
-    OS_Init();
+    return (af > bf) - (af < bf);
+}
 
-    // Basic platform macros
-    //
+internal COMPARE_FUNC(CompareU8) {
+    U8 ai = *cast(U8 *) a;
+    U8 bi = *cast(U8 *) b;
 
-    printf("-- Basic information\n");
-    printf("  OS       : %s\n", OS_WINDOWS ? "Windows" : OS_MACOS ? "macOS" : OS_LINUX ? "Linux" : "Switchbrew");
-    printf("  Compiler : %s\n", COMPILER_MSVC ? "cl.exe" : COMPILER_CLANG ? "clang" : "gcc");
-    printf("  Arch     : %s\n", ARCH_AMD64 ? "amd64" : "aarch64");
-    printf("  Language : %s\n", LANG_CPP ? "C++" : "C");
+    return (ai > bi) - (ai < bi);
+}
 
-    printf("\n");
+typedef struct SortRecord SortRecord;
+struct SortRecord {
+    U64 key;
+    U64 index;
+};
 
-    // Utility macros
-    //
-    printf("-- Utility macros\n");
-    {
-        U32 arr[12];
+internal COMPARE_FUNC(CompareSortRecord) {
+    SortRecord *ar = cast(SortRecord *) a;
+    SortRecord *br = cast(SortRecord *) b;
 
-        ExpectIntValue(cast(U32) 1.234f, 1);
-        ExpectIntValue(ArraySize(arr), 12);
-        ExpectIntValue(OffsetTo(ListNode, prev), 8);
-        ExpectIntValue(AlignOf(U32), 4);
-    }
-    printf("\n");
+    return (ar->key > br->key) - (ar->key < br->key);
+}
 
-    // Linked list macro testing
-    //
-    printf("-- Linked List macros\n");
-    {
-        ListNode nodes[10];
-        for (U32 it = 0; it < ArraySize(nodes); ++it) {
-            nodes[it].value = it;
-        }
+global_var U32 sort_misaligned = 0;
 
-        // Queue
-        //
-        ListNode *head = 0;
-        ListNode *tail = 0;
+// counts comparisons made on elements which aren't aligned for their type, this is called from
+// the parallel sort workers as well so the count is atomic
+//
+internal COMPARE_FUNC(CompareSortRecordAligned) {
+    if ((cast(U64) a | cast(U64) b) & (AlignOf(SortRecord) - 1)) { AtomicAdd_U32(&sort_misaligned, 1); }
 
-        SLL_Enqueue(head, tail, &nodes[5]);
-        SLL_EnqueueN(head, tail, &nodes[2], next);
+    S32 result = CompareSortRecord(a, b);
+    return result;
+}
 
-        SLL_EnqueueFront(head, tail, &nodes[4]);
-        SLL_EnqueueFrontN(head, tail, &nodes[3], next);
+// odd sized to go through the generic swap
+//
+typedef struct SortWide SortWide;
+struct SortWide {
+    U32 key;
+    U8  payload[19];
+};
 
-        S32 queue_expect[] = { 3, 4, 5 };
+internal COMPARE_FUNC(CompareSortWide) {
+    SortWide *aw = cast(SortWide *) a;
+    SortWide *bw = cast(SortWide *) b;
 
-        printf("Queue : \n");
-        for (int it = 0; head->next != 0; it += 1) {
-            ListNode *n = head;
-            SLL_Dequeue(head, tail);
+    return (aw->key > bw->key) - (aw->key < bw->key);
+}
 
-            ExpectIntValue(n->value, queue_expect[it]);
-        }
+SORT_DEFINE(SortIntTyped,    int,        *a < *b)
+SORT_DEFINE(SortU32Typed,    U32,        *a < *b)
+SORT_DEFINE(SortRecordTyped, SortRecord, a->key < b->key)
+SORT_DEFINE(SortWideTyped,   SortWide,   a->key < b->key)
+
+typedef U32 SortPattern;
+enum {
+    SORT_PATTERN_RANDOM = 0,
+    SORT_PATTERN_SORTED,
+    SORT_PATTERN_REVERSED,
+    SORT_PATTERN_DUPLICATES,
+    SORT_PATTERN_ORGAN_PIPE,
+    SORT_PATTERN_SAWTOOTH,
+    SORT_PATTERN_COUNT
+};
 
-        ExpectIntValue(head->value, 2);
+global_var const char *sort_pattern_names[] = {
+    "random", "sorted", "reversed", "duplicates", "organ pipe", "sawtooth"
+};
 
-        SLL_DequeueN(head, tail, next);
+internal U32 SortPatternValue(SortPattern pattern, U32 index, U32 count) {
+    U32 result = 0;
 
-        Assert(head == 0 && tail == 0);
-        printf("queue is now empty\n\n");
+    switch (pattern) {
+        case SORT_PATTERN_RANDOM:     { result = cast(U32) Hash_U64(index);                        } break;
+        case SORT_PATTERN_SORTED:     { result = index;                                            } break;
+        case SORT_PATTERN_REVERSED:   { result = count - index;                                    } break;
+        case SORT_PATTERN_DUPLICATES: { result = cast(U32) Hash_U64(index) & 15;                   } break;
+        case SORT_PATTERN_ORGAN_PIPE: { result = (index < (count >> 1)) ? index : (count - index); } break;
+        case SORT_PATTERN_SAWTOOTH:   { result = index % 1000;                                     } break;
+    }
 
-        // Stack
-        //
-        S32 stack_expect[] = { 5, 6, 2 };
+    return result;
+}
 
-        SLL_Push(head,  &nodes[7]);
-        SLL_PushN(head, &nodes[2], next);
-        SLL_PushN(head, &nodes[6], next);
-        SLL_Push(head,  &nodes[5]);
+// checks 'values' is in order and that it still has the same contents by comparing an order
+// independent checksum against the original pattern
+//
+internal B32 SortedU32(U32 *values, U32 count, SortPattern pattern) {
+    B32 result = true;
 
-        printf("Stack :\n");
-        for (int it = 0; head->next != 0; it += 1) {
-            ListNode *n = head;
-            SLL_PopN(head, next);
+    U64 expected = 0;
+    U64 actual   = 0;
 
-            ExpectIntValue(n->value, stack_expect[it]);
-        }
+    for (U32 it = 0; it < count; ++it) {
+        expected += Hash_U64(SortPatternValue(pattern, it, count));
+        actual   += Hash_U64(values[it]);
 
-        ExpectIntValue(head->value, 7);
+        if (it != 0) { result = result && (values[it - 1] <= values[it]); }
+    }
 
-        SLL_Pop(head);
+    result = result && (expected == actual);
+    return result;
+}
 
-        Assert(head == 0);
-        printf("stack is now empty\n\n");
+// shared fixture for the comparison and radix sorts, every pattern is generated at each of the
+// counts and sorted by 'SortProc', which sorts whichever of the arrays it supports. the arrays
+// named in 'flags' are then checked to be in order with their payloads intact
+//
+typedef U32 SortFixtureFlags;
+enum {
+    SORT_FIXTURE_VALUES  = (1 << 0),
+    SORT_FIXTURE_RECORDS = (1 << 1),
+    SORT_FIXTURE_WIDES   = (1 << 2),
+    SORT_FIXTURE_BYTES   = (1 << 3),
+    SORT_FIXTURE_STABLE  = (1 << 4), // records with equal keys must keep their original order
+
+    SORT_FIXTURE_ALL = SORT_FIXTURE_VALUES | SORT_FIXTURE_RECORDS | SORT_FIXTURE_WIDES | SORT_FIXTURE_BYTES
+};
 
-        printf("DList :\n");
+#define SORT_FIXTURE_MAX_COUNT 50000
 
-        S32 dlist_expect[] = { 8, 4, 3, 6, 7, 2 };
-        S32 dlist_expect_after[] = { 8, 3, 6, 7 };
+global_var U32 sort_fixture_counts[] = { 0, 1, 2, 3, 23, 24, 25, 129, 1000, SORT_FIXTURE_MAX_COUNT };
 
-        DLL_InsertFront(head, tail, &nodes[4]);
-        DLL_InsertFrontNP(head, tail, &nodes[8], next, prev);
+typedef struct SortFixture SortFixture;
+struct SortFixture {
+    M_Arena *arena;
 
-        DLL_InsertBack(head, tail, &nodes[6]);
-        DLL_InsertBackNP(head, tail, &nodes[2], next, prev);
+    U32        *values;
+    SortRecord *records;
+    SortWide   *wides;
+    U8         *bytes;
+};
 
-        DLL_Insert(head, tail, &nodes[4], &nodes[3]);
-        DLL_InsertNP(head, tail, &nodes[6], &nodes[7], next, prev);
+#define SORT_FIXTURE_PROC(name) void name(SortFixture *fixture, U32 count)
+typedef SORT_FIXTURE_PROC(SortFixtureProc);
 
-        int x = 0;
-        for (ListNode *n = head; n != 0; n = n->next) {
-            ExpectIntValue(n->value, dlist_expect[x]);
-            x += 1;
-        }
+internal SortFixture SortFixtureAlloc(M_Arena *arena) {
+    SortFixture result;
 
-        DLL_Remove(head, tail, &nodes[4]);
-        DLL_RemoveNP(head, tail, &nodes[2], next, prev);
+    result.arena   = arena;
+    result.values  = M_ArenaPush(arena, U32,        SORT_FIXTURE_MAX_COUNT);
+    result.records = M_ArenaPush(arena, SortRecord, SORT_FIXTURE_MAX_COUNT);
+    result.wides   = M_ArenaPush(arena, SortWide,   SORT_FIXTURE_MAX_COUNT);
+    result.bytes   = M_ArenaPush(arena, U8,         SORT_FIXTURE_MAX_COUNT);
 
-        printf("After removal :\n");
-        x = 0;
-        for (ListNode *n = head; n != 0; n = n->next) {
-            ExpectIntValue(n->value, dlist_expect_after[x]);
-            x += 1;
-        }
-    }
-    printf("\n");
+    return result;
+}
 
-    printf("-- Intrinsics\n");
-    {
-        U32 v0 = 0x78;
-        U64 v1 = 0x1F800;
+internal B32 SortFixtureRun(SortFixture *fixture, SortFixtureProc *SortProc, SortFixtureFlags flags) {
+    B32 result = true;
 
-        ExpectIntValue(CountLeadingZeros_U32(v0), 25);
-        ExpectIntValue(CountLeadingZeros_U64(v1), 47);
+    U32        *values  = fixture->values;
+    SortRecord *records = fixture->records;
+    SortWide   *wides   = fixture->wides;
+    U8         *bytes   = fixture->bytes;
 
-        ExpectIntValue(CountTrailingZeros_U32(v0), 3);
-        ExpectIntValue(CountTrailingZeros_U64(v1), 11);
+    for (U32 p = 0; p < SORT_PATTERN_COUNT; ++p) {
+        for (U32 c = 0; c < ArraySize(sort_fixture_counts); ++c) {
+            U32 count = sort_fixture_counts[c];
 
-        U32 v2 = 0xFF00FF00;
-        U64 v3 = 0x00FF00FF;
+            for (U32 it = 0; it < count; ++it) {
+                U32 value = SortPatternValue(p, it, count);
 
-        ExpectIntValue(RotateLeft_U32(v2, 5), 0xE01FE01F);
-        ExpectIntValue(RotateLeft_U64(v3, 17), 0x1FE01FE0000);
+                values[it]        = value;
+                records[it].key   = value;
+                records[it].index = it;
+                wides[it].key     = value;
+                bytes[it]         = cast(U8) value;
 
-        ExpectIntValue(RotateRight_U32(v2, 5), 0x7F807F8);
-        ExpectIntValue(RotateRight_U64(v3, 17), 0x807F80000000007F);
+                M_FillSize(wides[it].payload, cast(U8) value, sizeof(wides[it].payload));
+            }
 
-        U32 v4 = 0x26B5;
-        U64 v5 = 0x240C1C6222;
+            SortProc(fixture, count);
 
-        ExpectIntValue(PopCount_U32(v4), 8);
-        ExpectIntValue(PopCount_U64(v5), 12);
-    }
-    printf("\n");
+            if (flags & SORT_FIXTURE_VALUES) { result = result && SortedU32(values, count, p); }
 
-    printf("-- Atomics\n");
-    {
-        // This isn't really a test for the atomics as there isn't any thread contention but
-        // proves the produce correct results and as they are just using the compiler intrinsics
-        // they are likely produce the correct interlocked instructions
-        //
+            for (U32 it = 0; it < count; ++it) {
+                // payloads must move with their keys
+                //
+                if (flags & SORT_FIXTURE_RECORDS) {
+                    result = result && (SortPatternValue(p, cast(U32) records[it].index, count) == records[it].key);
+                }
 
-        volatile U32 v0 = 100;
-        U32 v1 = AtomicAdd_U32(&v0, 25);
+                if (flags & SORT_FIXTURE_WIDES) {
+                    U8 key = cast(U8) wides[it].key;
+                    result = result && (wides[it].payload[0] == key) && (wides[it].payload[18] == key);
+                }
 
-        ExpectIntValue(v0, 125);
-        ExpectIntValue(v1, 100);
+                if (it != 0) {
+                    if (flags & SORT_FIXTURE_RECORDS) {
+                        if ((flags & SORT_FIXTURE_STABLE) && records[it - 1].key == records[it].key) {
+                            result = result && (records[it - 1].index < records[it].index);
+                        }
+                        else {
+                            result = result && (records[it - 1].key <= records[it].key);
+                        }
+                    }
+
+                    if (flags & SORT_FIXTURE_WIDES) { result = result && (wides[it - 1].key <= wides[it].key); }
+                    if (flags & SORT_FIXTURE_BYTES) { result = result && (bytes[it - 1] <= bytes[it]); }
+                }
+            }
+        }
+    }
 
-        volatile U64 v2 = 44000 | (1ULL << 35);
-        U64 v3 = AtomicAdd_U64(&v2, 444);
+    return result;
+}
 
-        ExpectIntValue(v2, 44444 | (1ULL << 35));
-        ExpectIntValue(v3, 44000 | (1ULL << 35));
+internal SORT_FIXTURE_PROC(SortFixtureQuick) {
+    QuickSort(fixture->values,  count, CompareU32);
+    QuickSort(fixture->records, count, CompareSortRecord);
+    QuickSort(fixture->wides,   count, CompareSortWide);
+    QuickSort(fixture->bytes,   count, CompareU8);
+}
 
-        U32 v4 = AtomicExchange_U32(&v0, 1000);
+internal SORT_FIXTURE_PROC(SortFixtureMerge) {
+    MergeSort(fixture->values,  count, CompareU32);
+    MergeSort(fixture->records, count, CompareSortRecord);
+    MergeSort(fixture->wides,   count, CompareSortWide);
+    MergeSort(fixture->bytes,   count, CompareU8);
+}
 
-        ExpectIntValue(v0, 1000);
-        ExpectIntValue(v4, 125);
+internal SORT_FIXTURE_PROC(SortFixtureTyped) {
+    SortU32Typed(fixture->values, count);
+    SortRecordTyped(fixture->records, count);
+    SortWideTyped(fixture->wides, count);
+}
 
-        U64 v5 = AtomicExchange_U64(&v2, 4344);
+#if LANG_CPP
+internal SORT_FIXTURE_PROC(SortFixtureTemplate) {
+    Sort(fixture->values, count);
+    Sort(fixture->wides, count, [](const SortWide &a, const SortWide &b) { return a.key < b.key; });
 
-        ExpectIntValue(v2, 4344);
-        ExpectIntValue(v5, 44444 | (1ULL << 35));
+    // sorted descending and then reversed so the check shows the functor was actually used
+    //
+    Sort(fixture->records, count, [](const SortRecord &a, const SortRecord &b) { return a.key > b.key; });
 
-        void *v6 = (void *) 0x3939393939;
-        void *v7 = AtomicExchange_Ptr(&v6, (void *) 0x4545454545);
+    for (U32 it = 0; it < (count >> 1); ++it) {
+        SortRecord t = fixture->records[it];
+        fixture->records[it] = fixture->records[count - it - 1];
+        fixture->records[count - it - 1] = t;
+    }
+}
+#endif
 
-        ExpectIntValue((U64) v6, 0x4545454545);
-        ExpectIntValue((U64) v7, 0x3939393939);
+// the record keys and indices are sorted as radix pairs and then written back into the records
+//
+internal SORT_FIXTURE_PROC(SortFixtureRadix) {
+    M_Temp temp = M_AcquireTemp(1, &fixture->arena);
 
-        volatile U32 v8 = 10;
+    RadixSort_U32(temp.arena, fixture->values, count);
 
-        ExpectTrue(AtomicCompareExchange_U32(&v8, 100, 10));
-        ExpectFalse(AtomicCompareExchange_U32(&v8, 20,  10));
-        ExpectIntValue(v8, 100);
+    U32 *keys    = M_ArenaPush(temp.arena, U32, count, M_ARENA_NO_ZERO);
+    U32 *indices = M_ArenaPush(temp.arena, U32, count, M_ARENA_NO_ZERO);
 
-        volatile U64 v9 = 2020;
-        ExpectTrue(AtomicCompareExchange_U64(&v9, 4040, 2020));
-        ExpectFalse(AtomicCompareExchange_U64(&v9, 10,   2020));
-        ExpectIntValue(v9, 4040);
+    for (U32 it = 0; it < count; ++it) {
+        keys[it]    = cast(U32) fixture->records[it].key;
+        indices[it] = cast(U32) fixture->records[it].index;
+    }
 
-        void *v10 = (void *) 0x10101010;
+    RadixSortPairs_U32(temp.arena, keys, indices, count);
 
-        ExpectTrue(AtomicCompareExchange_Ptr(&v10, (void *) 0x20202020, (void *) 0x10101010));
-        ExpectFalse(AtomicCompareExchange_Ptr(&v10, (void *) 0x30303030, (void *) 0x10101010));
-        ExpectIntValue((U64) v10, 0x20202020);
+    for (U32 it = 0; it < count; ++it) {
+        fixture->records[it].key   = keys[it];
+        fixture->records[it].index = indices[it];
     }
-    printf("\n");
 
-    printf("-- Utilities\n");
-    {
-        U64 v0 = cast(U64) U32_MAX + 3333333333ULL;
-        U32 v1 = cast(U32) U16_MAX + 333333ULL;
-        U16 v2 = cast(U64) U8_MAX  + 124ULL;
+    M_ReleaseTemp(temp);
+}
 
-        ExpectIntValue(SaturateCast_U32(v0), U32_MAX);
-        ExpectIntValue(SaturateCast_U16(v1), U16_MAX);
-        ExpectIntValue(SaturateCast_U8 (v2), U8_MAX);
+global_var U32 thread_sum = 0; // don't do this, but only one extra thread
 
-        U64 v3 = 333;
-        U32 v4 = 333;
-        U16 v5 = 124;
+internal T_THREAD_PROC(TestThreadProc) {
+    (void) param;
 
-        ExpectIntValue(SafeTruncate_U32(v3), 333);
-        ExpectIntValue(SafeTruncate_U16(v4), 333);
-        ExpectIntValue(SafeTruncate_U8 (v5), 124);
+    for (U32 it = 0; it < 10; ++it) {
+        thread_sum += it;
+    }
+}
 
-        // these will all fail with an assertion
-        //
-        // SafeTruncate_U32(v0);
-        // SafeTruncate_U16(v1);
-        // SafeTruncate_U8(v2);
-        //
+typedef struct ThreadShared ThreadShared;
+struct ThreadShared {
+    OS_Handle mutex;
+    OS_Handle rwlock;
+    OS_Handle sem;
 
-        ExpectFloatValue(SafeRatio0_F32(1, 4), 0.25f);
-        ExpectFloatValue(SafeRatio0_F64(1, 4), 0.25);
+    U32 counter;
+    U32 rw_counter;
 
-        ExpectFloatValue(SafeRatio1_F32(1, 4), 0.25f);
-        ExpectFloatValue(SafeRatio1_F64(1, 4), 0.25);
+    T_Futex go;
+};
 
-        ExpectFloatValue(SafeRatio0_F32(1, 0), 0.0f);
-        ExpectFloatValue(SafeRatio0_F64(1, 0), 0.0);
+internal T_THREAD_PROC(TestContendedProc) {
+    ThreadShared *shared = cast(ThreadShared *) param;
 
-        ExpectFloatValue(SafeRatio1_F32(1, 0), 1.0f);
-        ExpectFloatValue(SafeRatio1_F64(1, 0), 1.0);
+    T_WaitFutex(&shared->go, 0);
 
-        ExpectIntValue(NextPow2_U32(135), 256);
-        ExpectIntValue(NextPow2_U64((1ULL << 33ULL) - 1), (1ULL << 33ULL));
+    for (U32 it = 0; it < 10000; ++it) {
+        T_AcquireMutex(shared->mutex);
+        shared->counter += 1;
+        T_ReleaseMutex(shared->mutex);
 
-        ExpectIntValue(PrevPow2_U32(4519), 4096);
-        ExpectIntValue(PrevPow2_U64((1ULL << 35ULL) - 1), (1ULL << 34ULL));
+        T_AcquireRWLockWrite(shared->rwlock);
+        shared->rw_counter += 1;
+        T_ReleaseRWLockWrite(shared->rwlock);
 
-        ExpectIntValue(NearestPow2_U32(3049), 2048);
-        ExpectIntValue(NearestPow2_U64((1ULL << 35ULL) - 1), (1ULL << 35ULL));
+        T_AcquireRWLockRead(shared->rwlock);
+        T_ReleaseRWLockRead(shared->rwlock);
+    }
 
-        U32 s = 10, d = 0;
+    T_WaitSemaphore(shared->sem);
+}
 
-        M_CopySize(&d, &s, sizeof(U32));
-        ExpectIntValue(d, 10);
+typedef struct CondVarShared CondVarShared;
+struct CondVarShared {
+    OS_Handle mutex;
+    OS_Handle rwlock;
+    OS_Handle condvar;
 
-        M_FillSize(&d, 0xFF, sizeof(U32));
-        ExpectIntValue(d, U32_MAX);
+    B32 use_rwlock;
 
-        M_ZeroSize(&d, sizeof(U32));
-        ExpectIntValue(d, 0);
+    U32 items;    // produced but not yet consumed
+    U32 consumed;
+    B32 done;
 
-        int some_array[]  = {
+    B32 ready;         // set once to release all of the readers
+    volatile U32 woken;
+};
+
+// waits on the condition variable while holding either the mutex or the rwlock for writing
+//
+internal T_THREAD_PROC(TestCondVarConsumer) {
+    CondVarShared *shared = cast(CondVarShared *) param;
+
+    for (;;) {
+        if (shared->use_rwlock) {
+            T_AcquireRWLockWrite(shared->rwlock);
+            while (shared->items == 0 && !shared->done) { T_WaitConditionVarWrite(shared->condvar, shared->rwlock); }
+        }
+        else {
+            T_AcquireMutex(shared->mutex);
+            while (shared->items == 0 && !shared->done) { T_WaitConditionVar(shared->condvar, shared->mutex); }
+        }
+
+        B32 finished = (shared->items == 0);
+        if (!finished) {
+            shared->items    -= 1;
+            shared->consumed += 1;
+        }
+
+        if (shared->use_rwlock) {
+            T_ReleaseRWLockWrite(shared->rwlock);
+        }
+        else {
+            T_ReleaseMutex(shared->mutex);
+        }
+
+        if (finished) { break; }
+    }
+}
+
+internal T_THREAD_PROC(TestCondVarReader) {
+    CondVarShared *shared = cast(CondVarShared *) param;
+
+    T_AcquireRWLockRead(shared->rwlock);
+    while (!shared->ready) { T_WaitConditionVarRead(shared->condvar, shared->rwlock); }
+    T_ReleaseRWLockRead(shared->rwlock);
+
+    AtomicAdd_U32(&shared->woken, 1);
+}
+
+typedef struct PoolShared PoolShared;
+struct PoolShared {
+    M_Pool *pool;
+    U32 errors;
+
+    T_Futex go;
+};
+
+internal T_THREAD_PROC(TestPoolProc) {
+    PoolShared *shared = cast(PoolShared *) param;
+
+    T_WaitFutex(&shared->go, 0);
+
+    U64 *held[32];
+    U64  id = cast(U64) &held[0]; // each thread has its own stack so this is unique
+
+    for (U32 round = 0; round < 2000; ++round) {
+        for (U32 it = 0; it < ArraySize(held); ++it) {
+            held[it]  = cast(U64 *) M_PoolAlloc(shared->pool, M_ARENA_NO_ZERO);
+            *held[it] = (id << 8) | it;
+        }
+
+        // if any element was handed out to two threads at once one of them will have
+        // overwritten the marker
+        //
+        for (U32 it = 0; it < ArraySize(held); ++it) {
+            if (*held[it] != ((id << 8) | it)) { AtomicAdd_U32(&shared->errors, 1); }
+            M_PoolFree(shared->pool, held[it]);
+        }
+    }
+}
+
+typedef struct ConcurrentShared ConcurrentShared;
+struct ConcurrentShared {
+    M_Arena *arena;
+    U32 errors;
+    U32 next_id;
+
+    T_Futex go;
+};
+
+internal T_THREAD_PROC(TestConcurrentArenaProc) {
+    ConcurrentShared *shared = cast(ConcurrentShared *) param;
+
+    T_WaitFutex(&shared->go, 0);
+
+    U64 *values[4096];
+    U64  id = cast(U64) &values[0];
+
+    for (U32 it = 0; it < ArraySize(values); ++it) {
+        // mix of sizes and alignments so the reservations don't all line up
+        //
+        U32 count = 1 + (it & 7);
+
+        values[it] = M_ArenaPush(shared->arena, U64, count, 0, (it & 1) ? 8 : 32);
+        for (U32 v = 0; v < count; ++v) { values[it][v] = id + it; }
+
+        if ((it & 1023) == 0) {
+            // push a large allocation every so often which goes to the side-chain
+            //
+            U8 *large = M_ArenaPush(shared->arena, U8, MB(2), M_ARENA_NO_ZERO);
+            large[MB(2) - 1] = 1;
+        }
+    }
+
+    for (U32 it = 0; it < ArraySize(values); ++it) {
+        U32 count = 1 + (it & 7);
+        for (U32 v = 0; v < count; ++v) {
+            if (values[it][v] != id + it) { AtomicAdd_U32(&shared->errors, 1); }
+        }
+    }
+}
+
+typedef struct QueueShared QueueShared;
+struct QueueShared {
+    T_SPSCQueue *spsc;
+    T_SPSCQueue *reply;
+
+    T_MPMCQueue *mpmc;
+    T_MPMCQueue *mpmc_reply;
+
+    U32 count;   // per producer
+    U32 threads; // producers, also the number of consumers
+
+    volatile U32 next_id;
+    volatile U32 errors;
+
+    volatile U64 sum;
+
+    T_Futex go;
+};
+
+internal T_THREAD_PROC(TestSPSCProducer) {
+    QueueShared *shared = cast(QueueShared *) param;
+
+    for (U64 it = 0; it < shared->count; ++it) { T_SPSCPush(shared->spsc, &it); }
+}
+
+// echoes values back for the latency benchmarks until it receives U64_MAX
+//
+internal T_THREAD_PROC(TestSPSCEcho) {
+    QueueShared *shared = cast(QueueShared *) param;
+
+    U64 value = 0;
+    while (value != U64_MAX) {
+        T_SPSCPop(shared->spsc, &value);
+        T_SPSCPush(shared->reply, &value);
+    }
+}
+
+internal T_THREAD_PROC(TestMPMCEcho) {
+    QueueShared *shared = cast(QueueShared *) param;
+
+    U64 value = 0;
+    while (value != U64_MAX) {
+        T_MPMCPop(shared->mpmc, &value);
+        T_MPMCPush(shared->mpmc_reply, &value);
+    }
+}
+
+internal T_THREAD_PROC(TestMPMCProducer) {
+    QueueShared *shared = cast(QueueShared *) param;
+
+    T_WaitFutex(&shared->go, 0);
+
+    // producer id in the top bits so consumers can check each producer's values arrive in order
+    //
+    U64 id = AtomicAdd_U32(&shared->next_id, 1);
+
+    for (U64 it = 0; it < shared->count; ++it) {
+        U64 value = (id << 32) | it;
+        T_MPMCPush(shared->mpmc, &value);
+    }
+}
+
+internal T_THREAD_PROC(TestMPMCConsumer) {
+    QueueShared *shared = cast(QueueShared *) param;
+
+    T_WaitFutex(&shared->go, 0);
+
+    U64 last[8];
+    for (U32 it = 0; it < ArraySize(last); ++it) { last[it] = U64_MAX; }
+
+    U64 sum = 0;
+
+    for (U32 it = 0; it < shared->count; ++it) {
+        U64 value;
+        T_MPMCPop(shared->mpmc, &value);
+
+        U32 id  = cast(U32) (value >> 32);
+        U64 seq = value & 0xFFFFFFFF;
+
+        if (id >= ArraySize(last) || (last[id] != U64_MAX && seq <= last[id])) {
+            AtomicAdd_U32(&shared->errors, 1);
+        }
+        else {
+            last[id] = seq;
+        }
+
+        sum += seq;
+    }
+
+    AtomicAdd_U64(&shared->sum, sum);
+}
+
+typedef struct JobShared JobShared;
+struct JobShared {
+    volatile U32 sum;
+    volatile U32 errors;
+
+    U32 *values;
+    U32 *workers;
+
+    T_Futex go;
+};
+
+internal J_PROC(TestJobAdd) {
+    JobShared *shared = cast(JobShared *) param;
+    AtomicAdd_U32(&shared->sum, 1);
+}
+
+internal J_FOR_PROC(TestJobFor) {
+    JobShared *shared = cast(JobShared *) param;
+
+    U32 worker = J_GetWorkerIndex();
+    if (worker >= J_GetWorkerCount()) { AtomicAdd_U32(&shared->errors, 1); }
+
+    // temp arenas are per worker so can be used from any job
+    //
+    M_Temp temp = M_AcquireTemp(0, 0);
+    U32 *scratch = M_ArenaPush(temp.arena, U32, end - start, M_ARENA_NO_ZERO);
+
+    for (U64 it = start; it < end; ++it) { scratch[it - start] = cast(U32) (it * it); }
+    for (U64 it = start; it < end; ++it) {
+        shared->values[it]  += scratch[it - start];
+        shared->workers[it]  = worker;
+    }
+
+    M_ReleaseTemp(temp);
+}
+
+typedef struct JobTree JobTree;
+struct JobTree {
+    JobShared *shared;
+    U32 depth;
+};
+
+// each node submits two children and waits on them, so workers have to run other jobs while
+// they wait or the tree deadlocks once it is deeper than the worker count
+//
+internal J_PROC(TestJobTree) {
+    JobTree *node = cast(JobTree *) param;
+
+    if (node->depth == 0) {
+        AtomicAdd_U32(&node->shared->sum, 1);
+    }
+    else {
+        JobTree children[2];
+        children[0].shared = node->shared;
+        children[0].depth  = node->depth - 1;
+        children[1]        = children[0];
+
+        J_Counter counter = 0;
+        J_Submit(TestJobTree, &children[0], &counter);
+        J_Submit(TestJobTree, &children[1], &counter);
+        J_Wait(&counter);
+    }
+}
+
+// threads which aren't workers submitting through the shared queue while the workers are busy
+//
+internal T_THREAD_PROC(TestJobSubmitProc) {
+    JobShared *shared = cast(JobShared *) param;
+
+    T_WaitFutex(&shared->go, 0);
+
+    if (J_GetWorkerIndex() != J_WORKER_NONE) { AtomicAdd_U32(&shared->errors, 1); }
+
+    for (U32 it = 0; it < 64; ++it) {
+        J_Job jobs[256];
+        for (U32 j = 0; j < ArraySize(jobs); ++j) {
+            jobs[j].Proc  = TestJobAdd;
+            jobs[j].param = shared;
+        }
+
+        J_Counter counter = 0;
+        J_SubmitJobs(jobs, ArraySize(jobs), &counter);
+        J_Wait(&counter);
+
+        if (counter != 0) { AtomicAdd_U32(&shared->errors, 1); }
+    }
+}
+
+// pushes right around the size of a growth block into an arena which is nearly full, some of
+// these look like they fit the current block but lose the race for the space and have to grow
+//
+internal T_THREAD_PROC(TestConcurrentNearBlockProc) {
+    ConcurrentShared *shared = cast(ConcurrentShared *) param;
+
+    T_WaitFutex(&shared->go, 0);
+
+    U8 *values[16];
+    U8  id = cast(U8) AtomicAdd_U32(&shared->next_id, 1);
+
+    for (U32 it = 0; it < ArraySize(values); ++it) {
+        U64 size = (M_ARENA_GROW_RESERVE_SIZE - M_ARENA_MIN_OFFSET) + ((it & 1) ? KB(4) : 0) - ((it & 2) ? KB(4) : 0);
+
+        values[it] = M_ArenaPush(shared->arena, U8, size, M_ARENA_NO_ZERO);
+        if (values[it]) {
+            values[it][0]        = id;
+            values[it][size - 1] = id;
+        }
+    }
+
+    for (U32 it = 0; it < ArraySize(values); ++it) {
+        U64 size = (M_ARENA_GROW_RESERVE_SIZE - M_ARENA_MIN_OFFSET) + ((it & 1) ? KB(4) : 0) - ((it & 2) ? KB(4) : 0);
+
+        if (!values[it] || values[it][0] != id || values[it][size - 1] != id) { AtomicAdd_U32(&shared->errors, 1); }
+    }
+}
+
+typedef struct InternShared InternShared;
+struct InternShared {
+    Str8_Interner *interner;
+    Str8 *keys;
+    U32   count;
+
+    U32 ids[4][1024];
+
+    T_Futex go;
+};
+
+internal T_THREAD_PROC(TestInternProc) {
+    InternShared *shared = cast(InternShared *) param;
+
+    T_WaitFutex(&shared->go, 0);
+
+    // each thread walks the keys in a different order so they race to insert the same strings
+    //
+    U32 index = cast(U32) AtomicAdd_U32(&shared->go, 1) - 1;
+    U32 step  = 1 + (index * 2);
+
+    for (U32 it = 0; it < shared->count; ++it) {
+        U32 k = (it * step) % shared->count;
+        shared->ids[index][k] = Str8_InternId(shared->interner, shared->keys[k]);
+    }
+}
+
+internal int ExecuteTests(int argc, char **argv) {
+    // ... do nothing for now
+    //
+    (void) argc;
+    (void) argv;
+
+    OS_Init();
+
+    // Basic platform macros
+    //
+
+    printf("-- Basic information\n");
+    printf("  OS       : %s\n", OS_WINDOWS ? "Windows" : OS_MACOS ? "macOS" : OS_LINUX ? "Linux" : "Switchbrew");
+    printf("  Compiler : %s\n", COMPILER_MSVC ? "cl.exe" : COMPILER_CLANG ? "clang" : "gcc");
+    printf("  Arch     : %s\n", ARCH_AMD64 ? "amd64" : "aarch64");
+    printf("  Language : %s\n", LANG_CPP ? "C++" : "C");
+
+    printf("\n");
+
+    printf("-- System information\n");
+    {
+        OS_SystemInfo *info = OS_GetSystemInfo();
+
+        printf("    page size      = %llu\n", info->page_size);
+        printf("    huge page size = %llu\n", info->huge_page_size);
+        printf("    logical cores  = %u\n",   info->num_logical_cores);
+        printf("    physical cores = %u\n",   info->num_physical_cores);
+        printf("    cache line     = %u\n",   info->cache_line_size);
+        printf("    l1/l2/l3       = %llu/%llu/%llu\n", info->l1_cache_size, info->l2_cache_size, info->l3_cache_size);
+        printf("    features       = 0x%x\n", info->features);
+
+        ExpectIntValue(info->page_size, M_GetPageSize());
+        ExpectTrue(info->num_logical_cores  >= 1);
+        ExpectTrue(info->num_physical_cores >= 1);
+        ExpectTrue(info->num_physical_cores <= info->num_logical_cores);
+        ExpectTrue(info->cache_line_size    != 0);
+
+#if ARCH_AMD64
+        ExpectTrue((info->features & OS_CPU_FEATURE_SSE2) != 0);
+#elif ARCH_AARCH64
+        ExpectTrue((info->features & OS_CPU_FEATURE_NEON) != 0);
+#endif
+    }
+    printf("\n");
+
+    // Utility macros
+    //
+    printf("-- Utility macros\n");
+    {
+        U32 arr[12];
+
+        ExpectIntValue(cast(U32) 1.234f, 1);
+        ExpectIntValue(ArraySize(arr), 12);
+        ExpectIntValue(OffsetTo(ListNode, prev), 8);
+        ExpectIntValue(AlignOf(U32), 4);
+    }
+    printf("\n");
+
+    // Linked list macro testing
+    //
+    printf("-- Linked List macros\n");
+    {
+        ListNode nodes[10];
+        for (U32 it = 0; it < ArraySize(nodes); ++it) {
+            nodes[it].value = it;
+        }
+
+        // Queue
+        //
+        ListNode *head = 0;
+        ListNode *tail = 0;
+
+        SLL_Enqueue(head, tail, &nodes[5]);
+        SLL_EnqueueN(head, tail, &nodes[2], next);
+
+        SLL_EnqueueFront(head, tail, &nodes[4]);
+        SLL_EnqueueFrontN(head, tail, &nodes[3], next);
+
+        S32 queue_expect[] = { 3, 4, 5 };
+
+        printf("Queue : \n");
+        for (int it = 0; head->next != 0; it += 1) {
+            ListNode *n = head;
+            SLL_Dequeue(head, tail);
+
+            ExpectIntValue(n->value, queue_expect[it]);
+        }
+
+        ExpectIntValue(head->value, 2);
+
+        SLL_DequeueN(head, tail, next);
+
+        Assert(head == 0 && tail == 0);
+        printf("queue is now empty\n\n");
+
+        // Stack
+        //
+        S32 stack_expect[] = { 5, 6, 2 };
+
+        SLL_Push(head,  &nodes[7]);
+        SLL_PushN(head, &nodes[2], next);
+        SLL_PushN(head, &nodes[6], next);
+        SLL_Push(head,  &nodes[5]);
+
+        printf("Stack :\n");
+        for (int it = 0; head->next != 0; it += 1) {
+            ListNode *n = head;
+            SLL_PopN(head, next);
+
+            ExpectIntValue(n->value, stack_expect[it]);
+        }
+
+        ExpectIntValue(head->value, 7);
+
+        SLL_Pop(head);
+
+        Assert(head == 0);
+        printf("stack is now empty\n\n");
+
+        printf("DList :\n");
+
+        S32 dlist_expect[] = { 8, 4, 3, 6, 7, 2 };
+        S32 dlist_expect_after[] = { 8, 3, 6, 7 };
+
+        DLL_InsertFront(head, tail, &nodes[4]);
+        DLL_InsertFrontNP(head, tail, &nodes[8], next, prev);
+
+        DLL_InsertBack(head, tail, &nodes[6]);
+        DLL_InsertBackNP(head, tail, &nodes[2], next, prev);
+
+        DLL_Insert(head, tail, &nodes[4], &nodes[3]);
+        DLL_InsertNP(head, tail, &nodes[6], &nodes[7], next, prev);
+
+        int x = 0;
+        for (ListNode *n = head; n != 0; n = n->next) {
+            ExpectIntValue(n->value, dlist_expect[x]);
+            x += 1;
+        }
+
+        DLL_Remove(head, tail, &nodes[4]);
+        DLL_RemoveNP(head, tail, &nodes[2], next, prev);
+
+        printf("After removal :\n");
+        x = 0;
+        for (ListNode *n = head; n != 0; n = n->next) {
+            ExpectIntValue(n->value, dlist_expect_after[x]);
+            x += 1;
+        }
+    }
+    printf("\n");
+
+    printf("-- Intrinsics\n");
+    {
+        U32 v0 = 0x78;
+        U64 v1 = 0x1F800;
+
+        ExpectIntValue(CountLeadingZeros_U32(v0), 25);
+        ExpectIntValue(CountLeadingZeros_U64(v1), 47);
+
+        ExpectIntValue(CountTrailingZeros_U32(v0), 3);
+        ExpectIntValue(CountTrailingZeros_U64(v1), 11);
+
+        U32 v2 = 0xFF00FF00;
+        U64 v3 = 0x00FF00FF;
+
+        ExpectIntValue(RotateLeft_U32(v2, 5), 0xE01FE01F);
+        ExpectIntValue(RotateLeft_U64(v3, 17), 0x1FE01FE0000);
+
+        ExpectIntValue(RotateRight_U32(v2, 5), 0x7F807F8);
+        ExpectIntValue(RotateRight_U64(v3, 17), 0x807F80000000007F);
+
+        U32 v4 = 0x26B5;
+        U64 v5 = 0x240C1C6222;
+
+        ExpectIntValue(PopCount_U32(v4), 8);
+        ExpectIntValue(PopCount_U64(v5), 12);
+    }
+    printf("\n");
+
+    printf("-- Atomics\n");
+    {
+        // This isn't really a test for the atomics as there isn't any thread contention but
+        // proves the produce correct results and as they are just using the compiler intrinsics
+        // they are likely produce the correct interlocked instructions
+        //
+
+        volatile U32 v0 = 100;
+        U32 v1 = AtomicAdd_U32(&v0, 25);
+
+        ExpectIntValue(v0, 125);
+        ExpectIntValue(v1, 100);
+
+        volatile U64 v2 = 44000 | (1ULL << 35);
+        U64 v3 = AtomicAdd_U64(&v2, 444);
+
+        ExpectIntValue(v2, 44444 | (1ULL << 35));
+        ExpectIntValue(v3, 44000 | (1ULL << 35));
+
+        U32 v4 = AtomicExchange_U32(&v0, 1000);
+
+        ExpectIntValue(v0, 1000);
+        ExpectIntValue(v4, 125);
+
+        U64 v5 = AtomicExchange_U64(&v2, 4344);
+
+        ExpectIntValue(v2, 4344);
+        ExpectIntValue(v5, 44444 | (1ULL << 35));
+
+        void *v6 = (void *) 0x3939393939;
+        void *v7 = AtomicExchange_Ptr(&v6, (void *) 0x4545454545);
+
+        ExpectIntValue((U64) v6, 0x4545454545);
+        ExpectIntValue((U64) v7, 0x3939393939);
+
+        volatile U32 v8 = 10;
+
+        ExpectTrue(AtomicCompareExchange_U32(&v8, 100, 10));
+        ExpectFalse(AtomicCompareExchange_U32(&v8, 20,  10));
+        ExpectIntValue(v8, 100);
+
+        volatile U64 v9 = 2020;
+        ExpectTrue(AtomicCompareExchange_U64(&v9, 4040, 2020));
+        ExpectFalse(AtomicCompareExchange_U64(&v9, 10,   2020));
+        ExpectIntValue(v9, 4040);
+
+        void *v10 = (void *) 0x10101010;
+
+        ExpectTrue(AtomicCompareExchange_Ptr(&v10, (void *) 0x20202020, (void *) 0x10101010));
+        ExpectFalse(AtomicCompareExchange_Ptr(&v10, (void *) 0x30303030, (void *) 0x10101010));
+        ExpectIntValue((U64) v10, 0x20202020);
+
+        void *v11 = (void *) 0x50505050;
+        AtomicStore_Ptr(&v11, (void *) 0x60606060);
+
+        ExpectIntValue((U64) AtomicLoad_Ptr(&v11), 0x60606060);
+    }
+    printf("\n");
+
+    printf("-- Utilities\n");
+    {
+        U64 v0 = cast(U64) U32_MAX + 3333333333ULL;
+        U32 v1 = cast(U32) U16_MAX + 333333ULL;
+        U16 v2 = cast(U64) U8_MAX  + 124ULL;
+
+        ExpectIntValue(SaturateCast_U32(v0), U32_MAX);
+        ExpectIntValue(SaturateCast_U16(v1), U16_MAX);
+        ExpectIntValue(SaturateCast_U8 (v2), U8_MAX);
+
+        U64 v3 = 333;
+        U32 v4 = 333;
+        U16 v5 = 124;
+
+        ExpectIntValue(SafeTruncate_U32(v3), 333);
+        ExpectIntValue(SafeTruncate_U16(v4), 333);
+        ExpectIntValue(SafeTruncate_U8 (v5), 124);
+
+        // these will all fail with an assertion
+        //
+        // SafeTruncate_U32(v0);
+        // SafeTruncate_U16(v1);
+        // SafeTruncate_U8(v2);
+        //
+
+        ExpectFloatValue(SafeRatio0_F32(1, 4), 0.25f);
+        ExpectFloatValue(SafeRatio0_F64(1, 4), 0.25);
+
+        ExpectFloatValue(SafeRatio1_F32(1, 4), 0.25f);
+        ExpectFloatValue(SafeRatio1_F64(1, 4), 0.25);
+
+        ExpectFloatValue(SafeRatio0_F32(1, 0), 0.0f);
+        ExpectFloatValue(SafeRatio0_F64(1, 0), 0.0);
+
+        ExpectFloatValue(SafeRatio1_F32(1, 0), 1.0f);
+        ExpectFloatValue(SafeRatio1_F64(1, 0), 1.0);
+
+        ExpectIntValue(NextPow2_U32(135), 256);
+        ExpectIntValue(NextPow2_U64((1ULL << 33ULL) - 1), (1ULL << 33ULL));
+
+        ExpectIntValue(PrevPow2_U32(4519), 4096);
+        ExpectIntValue(PrevPow2_U64((1ULL << 35ULL) - 1), (1ULL << 34ULL));
+
+        ExpectIntValue(NearestPow2_U32(3049), 2048);
+        ExpectIntValue(NearestPow2_U64((1ULL << 35ULL) - 1), (1ULL << 35ULL));
+
+        U32 s = 10, d = 0;
+
+        M_CopySize(&d, &s, sizeof(U32));
+        ExpectIntValue(d, 10);
+
+        M_FillSize(&d, 0xFF, sizeof(U32));
+        ExpectIntValue(d, U32_MAX);
+
+        M_ZeroSize(&d, sizeof(U32));
+        ExpectIntValue(d, 0);
+
+        {
+            // exercise the vector paths, including the unaligned head and tail and each size
+            // boundary between the scalar and wide kernels
+            //
+            static U8 src[4200], dst[4200];
+
+            U64 sizes[] = { 0, 1, 15, 16, 17, 31, 32, 33, 63, 64, 65, 127, 128, 129, 200, 1000, 4099 };
+
+            B32 copy_ok = true, fill_ok = true, compare_ok = true;
+
+            for (U32 it = 0; it < sizeof(src); ++it) { src[it] = cast(U8) ((it * 7) + 3); }
+
+            for (U32 s = 0; s < ArraySize(sizes); ++s) {
+                for (U32 offset = 0; offset < 4; ++offset) {
+                    U64 size = sizes[s];
+
+                    M_ZeroSize(dst, sizeof(dst));
+                    M_CopySize(dst + offset, src + (3 - offset), size);
+
+                    for (U64 it = 0; it < sizeof(dst); ++it) {
+                        U8 expected = (it >= offset && it < offset + size) ? src[(3 - offset) + (it - offset)] : 0;
+                        if (dst[it] != expected) { copy_ok = false; }
+                    }
+
+                    if (!M_CompareSize(dst + offset, src + (3 - offset), size)) { compare_ok = false; }
+
+                    if (size != 0) {
+                        dst[offset + size - 1] ^= 0x80;
+                        if (M_CompareSize(dst + offset, src + (3 - offset), size)) { compare_ok = false; }
+
+                        dst[offset + size - 1] ^= 0x80;
+                        dst[offset] ^= 0x01;
+                        if (M_CompareSize(dst + offset, src + (3 - offset), size)) { compare_ok = false; }
+                    }
+
+                    M_ZeroSize(dst, sizeof(dst));
+                    M_FillSize(dst + offset, 0xA5, size);
+
+                    for (U64 it = 0; it < sizeof(dst); ++it) {
+                        U8 expected = (it >= offset && it < offset + size) ? 0xA5 : 0;
+                        if (dst[it] != expected) { fill_ok = false; }
+                    }
+                }
+            }
+
+            ExpectTrue(copy_ok);
+            ExpectTrue(fill_ok);
+            ExpectTrue(compare_ok);
+
+            // overlapping forward copy repeats the pattern as an lz77 back-reference would
+            //
+            U8 pattern[64] = { 'a', 'b', 'c' };
+            M_CopySizeForward(pattern + 3, pattern, 61);
+
+            B32 forward_ok = true;
+            for (U32 it = 0; it < ArraySize(pattern); ++it) {
+                if (pattern[it] != ('a' + (it % 3))) { forward_ok = false; }
+            }
+
+            ExpectTrue(forward_ok);
+        }
+
+        int some_array[]  = {
             4,   41,  86, 100, 100,
             32,  48,  48, 84,  31,
             56,  70,  81, 44,  32,
@@ -334,471 +1117,2438 @@ internal int ExecuteTests(int argc, char **argv) {
             4,   8,   2,  3,   4
         };
 
-        int other_array[] = {
-            93,  100, 11, 14,  12,
-            87,  90,  56, 79,  100,
-            77,  55,  19, 92,  91,
-            9,   68,  70, 58,  48,
-            50,  12,  43, 47,  86,
-            55,  72,  72, 7,   65,
-            1,   45,  32, 25,  71,
-            86,  14,  81, 6,   90,
-            36,  74,  61, 27,  1,
-            31,  38,  39, 83,  76,
-            100, 91,  58, 38,  88,
-        };
+        int other_array[] = {
+            93,  100, 11, 14,  12,
+            87,  90,  56, 79,  100,
+            77,  55,  19, 92,  91,
+            9,   68,  70, 58,  48,
+            50,  12,  43, 47,  86,
+            55,  72,  72, 7,   65,
+            1,   45,  32, 25,  71,
+            86,  14,  81, 6,   90,
+            36,  74,  61, 27,  1,
+            31,  38,  39, 83,  76,
+            100, 91,  58, 38,  88,
+        };
+
+
+        printf("    Unsorted: { ");
+
+        for (U64 it = 0; it < ArraySize(some_array); ++it) {
+            printf("%d ", some_array[it]);
+        }
+
+        printf("}\n");
+
+        MergeSort(some_array, ArraySize(some_array), CompareInt);
+
+        printf("    Sorted:   { ");
+
+        U32 total = 0;
+        for (U64 it = 0; it < ArraySize(some_array); ++it) {
+            printf("%d ", some_array[it]);
+
+            if (it != 0) { total += (some_array[it - 1] <= some_array[it]); }
+        }
+
+        printf("}\n");
+
+        ExpectIntValue(total, ArraySize(some_array) - 1);
+
+        printf("    Unsorted: { ");
+
+        for (U64 it = 0; it < ArraySize(other_array); ++it) {
+            printf("%d ", other_array[it]);
+        }
+
+        printf("}\n");
+
+        QuickSort(other_array, ArraySize(other_array), CompareInt);
+
+        printf("    Sorted:   { ");
+
+        total = 0;
+        for (U64 it = 0; it < ArraySize(other_array); ++it) {
+            printf("%d ", other_array[it]);
+
+            if (it != 0) { total += (other_array[it - 1] <= other_array[it]); }
+        }
+
+        printf("}\n");
+
+        ExpectIntValue(total, ArraySize(other_array) - 1);
+
+        ListNode nodes[10];
+
+        nodes[0].value = 22;
+        nodes[1].value = 9302;
+        nodes[2].value = 2;
+        nodes[3].value = 39;
+        nodes[4].value = 190;
+        nodes[5].value = 0;
+        nodes[6].value = 459;
+        nodes[7].value = 387;
+        nodes[8].value = 548;
+        nodes[9].value = 879;
+
+        printf("Before sort:\n");
+        for (U32 it = 0; it < 10; ++it) {
+            printf("    node[%d].value = %d\n", it, nodes[it].value);
+        }
+
+        QuickSort(nodes, ArraySize(nodes), CompareListNode);
+
+        printf("After sort:\n");
+        for (U32 it = 0; it < 10; ++it) {
+            printf("    node[%d].value = %d\n", it, nodes[it].value);
+        }
+
+        // Byte/bit swapping
+        //
+        U8  x8  = 0xF0;
+        U16 x16 = 0xFF00;
+        U32 x32 = 0xFFFF0000;
+        U64 x64 = 0xFF00FF00FF00FF00;
+
+        ExpectIntValue(SwapBytes_U16(x16), 0x00FF);
+        ExpectIntValue(SwapBytes_U32(x32), 0x0000FFFF);
+        ExpectIntValue(SwapBytes_U64(x64), 0x00FF00FF00FF00FF);
+
+        ExpectIntValue(ReverseBits_U8(x8),   0x0F);
+        ExpectIntValue(ReverseBits_U16(x16), 0x00FF);
+        ExpectIntValue(ReverseBits_U32(x32), 0x0000FFFF);
+        ExpectIntValue(ReverseBits_U64(x64), 0x00FF00FF00FF00FF);
+    }
+    printf("\n");
+
+    printf("-- Arena\n");
+    {
+        M_Arena *arena = M_AllocArena(GB(8));
+
+        ExpectIntValue(arena->committed, M_ARENA_COMMIT_SIZE);
+
+        U32 *single = M_ArenaPush(arena, U32);
+        ExpectIntValue(arena->offset, M_ARENA_MIN_OFFSET + 4);
+
+        single[0] = 22;
+
+        U32 *array = M_ArenaPush(arena, U32, 32);
+        ExpectIntValue(arena->offset, M_ARENA_MIN_OFFSET + 132);
+
+        for (U32 it = 0; it < 32; ++it) {
+            array[it] = it;
+        }
+
+        M_ArenaPop(arena, U32, 32);
+        ExpectIntValue(arena->offset, M_ARENA_MIN_OFFSET + 4);
+
+        U32 *arrayflag = M_ArenaPush(arena, U32, 32, M_ARENA_NO_ZERO);
+
+        for (U32 it = 0; it < 32; ++it) {
+            ExpectIntValue(arrayflag[it], it);
+        }
+
+        M_ArenaPop(arena, U32, 32);
+
+        U32 *arrayalign = M_ArenaPush(arena, U32, 32, 0, 8);
+
+        ExpectIntValue((U64) arrayalign & 7, 0);
+        ExpectIntValue(arena->offset, M_ARENA_MIN_OFFSET + 136);
+
+        M_ArenaPopLast(arena);
+        ExpectIntValue(arena->offset, M_ARENA_MIN_OFFSET + 4);
+
+        M_ArenaPop(arena, U32);
+
+        ExpectIntValue(arena->offset, M_ARENA_MIN_OFFSET);
+
+        U32 *a = M_ArenaPush(arena, U32, 10);
+
+        for (U32 it = 0; it < 10; ++it) { a[it] = it; }
+
+        U32 *b = M_ArenaPushCopy(arena, a, U32, 10);
+
+        ExpectTrue(M_CompareSize(a, b, 10 * sizeof(U32)));
+
+        M_Temp tempa = M_AcquireTemp(0, 0);
+        M_Temp tempb = M_AcquireTemp(1, &tempa.arena);
+
+        ExpectTrue(tempa.arena != tempb.arena);
+
+        M_ArenaPush(tempa.arena, U32, 256);
+        M_ReleaseTemp(tempa);
+
+        // don't do this in production code, just testing to make sure the
+        // arena was reset correctly
+        //
+        ExpectIntValue(tempa.arena->offset, M_ARENA_MIN_OFFSET);
+
+        {
+            // nested temps keep their memory committed until the outermost temp is released
+            //
+            M_Temp outer = M_AcquireTemp(0, 0);
+            M_ArenaPush(outer.arena, U8, MB(16), M_ARENA_NO_ZERO);
+
+            M_Temp inner = M_AcquireTemp(0, 0);
+            ExpectTrue(inner.arena == outer.arena);
+
+            M_ArenaPush(inner.arena, U8, MB(16), M_ARENA_NO_ZERO);
+            M_ReleaseTemp(inner);
+
+            ExpectTrue(M_GetArenaStats(outer.arena).committed >= MB(32));
+
+            M_ReleaseTemp(outer);
+
+            // alternating large and small scopes keep the large region committed rather than
+            // decommitting it after each small scope and committing it again
+            //
+            U64 committed = M_GetArenaStats(outer.arena).committed;
+            U64 commits   = M_GetArenaStats(outer.arena).commits;
+
+            B32 flat = true;
+            for (U32 it = 0; it < 8; ++it) {
+                outer = M_AcquireTemp(0, 0);
+                M_ArenaPush(outer.arena, U8, MB(32), M_ARENA_NO_ZERO);
+                M_ReleaseTemp(outer);
+
+                for (U32 small = 0; small < 4; ++small) {
+                    outer = M_AcquireTemp(0, 0);
+                    M_ArenaPush(outer.arena, U8, KB(4));
+                    M_ArenaPopTo(outer.arena, outer.offset);
+                    M_ArenaPush(outer.arena, U8, KB(4));
+                    M_ReleaseTemp(outer);
+                }
+
+                flat = flat && (M_GetArenaStats(outer.arena).committed == committed);
+            }
+
+            ExpectTrue(flat);
+            ExpectIntValue(M_GetArenaStats(outer.arena).commits, commits);
+
+            // once only small scopes are used the retained size decays back down
+            //
+            for (U32 it = 0; it < 8 * M_ARENA_RETAIN_WINDOW; ++it) {
+                outer = M_AcquireTemp(0, 0);
+                M_ArenaPush(outer.arena, U8, KB(4));
+                M_ReleaseTemp(outer);
+            }
+
+            ExpectTrue(M_GetArenaStats(outer.arena).committed <= M_TEMP_ARENA_RETAIN_SIZE);
+
+            // idle trimming releases memory even while a temp is still active
+            //
+            outer = M_AcquireTemp(0, 0);
+            M_ArenaPush(outer.arena, U8, MB(8), M_ARENA_NO_ZERO);
+            M_ArenaPopTo(outer.arena, outer.offset);
+
+            M_TrimTempArenas();
+            ExpectTrue(M_GetArenaStats(outer.arena).committed <= M_TEMP_ARENA_RETAIN_SIZE);
+
+            M_ReleaseTemp(outer);
+
+            // more arenas can be made available for deep conflict chains
+            //
+            M_SetTempArenaCount(4);
+
+            M_Arena *conflicts[3];
+            for (U32 it = 0; it < 3; ++it) {
+                M_Temp temp   = M_AcquireTemp(it, conflicts);
+                conflicts[it] = temp.arena;
+            }
+
+            M_Temp last = M_AcquireTemp(3, conflicts);
+            ExpectTrue(last.arena != conflicts[0] && last.arena != conflicts[1] && last.arena != conflicts[2]);
+
+            M_SetTempArenaCount(M_TEMP_ARENA_COUNT);
+        }
+
+        {
+            // pushes that straddle the known-zero offset must still clear the dirty part, and
+            // decommitted memory must come back zeroed after a reset
+            //
+            U64 base = M_GetArenaOffset(arena);
+
+            U8 *dirty = M_ArenaPush(arena, U8, KB(256), M_ARENA_NO_ZERO);
+            M_FillSize(dirty, 0xCD, KB(256));
+
+            M_ArenaPopTo(arena, base);
+
+            U8 *straddle = M_ArenaPush(arena, U8, KB(512));
+
+            B32 zeroed = true;
+            for (U64 it = 0; it < KB(512); ++it) { if (straddle[it] != 0) { zeroed = false; break; } }
+
+            ExpectTrue(zeroed);
+            ExpectTrue(arena->zero_offset >= arena->offset);
+
+            M_FillSize(straddle, 0xCD, KB(512));
+            M_ResetArena(arena);
+
+            U8 *reset = M_ArenaPush(arena, U8, KB(512));
+
+            zeroed = true;
+            for (U64 it = 0; it < KB(512); ++it) { if (reset[it] != 0) { zeroed = false; break; } }
+
+            ExpectTrue(zeroed);
+        }
+
+        {
+            // huge page backed arena, whether the system actually provides huge pages depends on
+            // its configuration so we only print that
+            //
+            M_Arena *huge = M_AllocArenaArgs(MB(64), 0, M_ARENA_HUGE_TLB | M_ARENA_PREFAULT);
+
+            U8 *data = M_ArenaPush(huge, U8, MB(5));
+            M_FillSize(data, 0x11, MB(5));
+
+            M_ArenaStats stats = M_GetArenaStats(huge);
+
+            printf("    huge arena committed = %llu, huge page bytes = %llu\n", stats.committed, stats.huge_page_bytes);
+
+            ExpectIntValue(stats.chain_length, 1);
+            ExpectIntValue(stats.offset, M_ARENA_MIN_OFFSET + MB(5));
+            ExpectIntValue(stats.committed % M_GetPageSize(), 0);
+            ExpectTrue(stats.committed >= MB(5) + M_ARENA_MIN_OFFSET);
+
+            if (huge->flags & (M_ARENA_HUGE_PAGES | M_ARENA_HUGE_TLB)) {
+                ExpectIntValue((U64) huge & (OS_GetSystemInfo()->huge_page_size - 1), 0);
+            }
+
+            M_ResetArena(huge);
+
+            stats = M_GetArenaStats(huge);
+            ExpectIntValue(stats.offset, M_ARENA_MIN_OFFSET);
+
+            M_ReleaseArena(huge);
+        }
+
+        {
+            // commit policy, fixed steps commit exactly what is needed rounded to the step and
+            // geometric steps double up to the maximum
+            //
+            M_Arena *fixed = M_AllocArena(GB(1));
+            M_SetArenaCommitPolicy(fixed, M_ARENA_COMMIT_SIZE, M_ARENA_COMMIT_SIZE);
+
+            M_ArenaPush(fixed, U8, MB(1), M_ARENA_NO_ZERO);
+            ExpectIntValue(fixed->committed, AlignUp(MB(1) + M_ARENA_MIN_OFFSET, M_ARENA_COMMIT_SIZE));
+            ExpectIntValue(fixed->commit_step, M_ARENA_COMMIT_SIZE);
+
+            M_Arena *geometric = M_AllocArena(GB(1));
+            M_SetArenaCommitPolicy(geometric, M_ARENA_COMMIT_SIZE, MB(1));
+
+            for (U32 it = 0; it < 64; ++it) { M_ArenaPush(geometric, U8, KB(64), M_ARENA_NO_ZERO); }
+
+            ExpectIntValue(geometric->commit_step, MB(1));
+
+            // repeatedly growing and popping shouldn't decommit and recommit each iteration
+            //
+            U64 base = M_GetArenaOffset(geometric);
+
+            M_ArenaPush(geometric, U8, MB(16), M_ARENA_NO_ZERO);
+            M_ArenaPopTo(geometric, base);
+
+            U64 committed = geometric->committed;
+
+            B32 stable = true;
+            for (U32 it = 0; it < 16; ++it) {
+                M_ArenaPush(geometric, U8, MB(16), M_ARENA_NO_ZERO);
+                M_ArenaPopTo(geometric, base);
+
+                if (geometric->committed != committed) { stable = false; }
+            }
+
+            ExpectTrue(stable);
+
+            // once the arena is only lightly used the retained size decays and memory is returned
+            //
+            for (U32 it = 0; it < 16 * M_ARENA_RETAIN_WINDOW; ++it) {
+                M_ArenaPush(geometric, U8, KB(1));
+                M_ResetArena(geometric);
+            }
+
+            ExpectTrue(geometric->committed < committed);
+            ExpectTrue(geometric->committed <= M_ARENA_COMMIT_SIZE * 2);
+
+            M_ReleaseArena(fixed);
+            M_ReleaseArena(geometric);
+        }
+
+        {
+            // growth blocks released by a reset are recycled by the next growth
+            //
+            M_FlushBlockCache();
+
+            M_Arena *chained = M_AllocArena(MB(1));
+
+            for (U32 it = 0; it < 4; ++it) { M_ArenaPush(chained, U8, KB(768)); }
+
+            M_BlockCacheStats before = M_GetBlockCacheStats();
+            M_ResetArena(chained);
+
+            M_BlockCacheStats after = M_GetBlockCacheStats();
+            ExpectIntValue(after.cached_blocks, before.cached_blocks + 3);
+
+            for (U32 it = 0; it < 4; ++it) { M_ArenaPush(chained, U8, KB(768)); }
+
+            M_BlockCacheStats reused = M_GetBlockCacheStats();
+            ExpectIntValue(reused.hits, after.hits + 3);
+            ExpectIntValue(reused.cached_blocks, before.cached_blocks);
+
+            // with no budget nothing is cached
+            //
+            M_SetBlockCacheBudget(0);
+            M_ResetArena(chained);
+
+            ExpectIntValue(M_GetBlockCacheStats().cached_blocks, 0);
+
+            M_SetBlockCacheBudget(M_BLOCK_CACHE_BUDGET);
+            M_ReleaseArena(chained);
+        }
+
+        {
+            // fixed-size pools re-use freed elements and hand out zeroed memory
+            //
+            M_Pool *pool = M_AllocPool(arena, 24, 16, 0);
+
+            ExpectIntValue(pool->element_size, 32);
+
+            U8 *a = cast(U8 *) M_PoolAlloc(pool, 0);
+            U8 *b = cast(U8 *) M_PoolAlloc(pool, 0);
+
+            ExpectTrue(a != b);
+            ExpectIntValue((U64) a & 15, 0);
+
+            M_FillSize(a, 0xAB, 24);
+            M_PoolFree(pool, a);
+
+            U8 *c = cast(U8 *) M_PoolAlloc(pool, 0);
+            ExpectTrue(c == a);
+            ExpectIntValue(c[0], 0);
+
+            // allocate past a single chunk then reset, the chunks are re-used rather than taking
+            // more memory from the arena
+            //
+            for (U32 it = 0; it < 2 * pool->chunk_count; ++it) { M_PoolAlloc(pool, M_ARENA_NO_ZERO); }
+
+            U64 offset = M_GetArenaOffset(arena);
+
+            M_ResetPool(pool);
+
+            for (U32 it = 0; it < 2 * pool->chunk_count; ++it) { M_PoolAlloc(pool, M_ARENA_NO_ZERO); }
+
+            ExpectIntValue(M_GetArenaOffset(arena), offset);
+        }
+
+        {
+            // oversized allocations go to the side-chain, small allocations keep using the
+            // current block and pops release the large blocks in order
+            //
+            M_Arena *mixed = M_AllocArena(KB(512));
+
+            U8 *small = M_ArenaPush(mixed, U8, KB(256));
+
+            U64 before_large = M_GetArenaOffset(mixed);
+
+            U8 *large = M_ArenaPush(mixed, U8, MB(4), 0, 64);
+            ExpectIntValue((U64) large & 63, 0);
+
+            U8 *after = M_ArenaPush(mixed, U8, 64);
+
+            M_ArenaStats stats = M_GetArenaStats(mixed);
+            ExpectIntValue(stats.chain_length, 1);
+            ExpectIntValue(stats.large_blocks, 1);
+
+            ExpectTrue(after > small && after < small + KB(512));
+
+            M_FillSize(large, 0xEE, MB(4));
+
+            U64 after_large = M_GetArenaOffset(mixed);
+
+            M_ArenaPush(mixed, U8, MB(2));
+            ExpectIntValue(M_GetArenaStats(mixed).large_blocks, 2);
+
+            M_ArenaPopLast(mixed);
+            ExpectIntValue(M_GetArenaStats(mixed).large_blocks, 1);
+
+            M_ArenaPopTo(mixed, after_large);
+            ExpectIntValue(M_GetArenaStats(mixed).large_blocks, 1);
+
+            M_ArenaPopTo(mixed, before_large);
+            ExpectIntValue(M_GetArenaStats(mixed).large_blocks, 0);
+
+            M_ArenaPush(mixed, U8, MB(3));
+            M_ResetArena(mixed);
+
+            stats = M_GetArenaStats(mixed);
+            ExpectIntValue(stats.large_blocks, 0);
+            ExpectIntValue(stats.offset, M_ARENA_MIN_OFFSET);
+
+            M_ReleaseArena(mixed);
+        }
+
+        // growable arrays keep element addresses stable as they grow
+        //
+        {
+            M_Array *array = M_AllocArrayT(GB(1), U32);
+
+            U32 *first = M_ArrayPush(array, U32);
+            *first = 0;
+
+            for (U32 it = 1; it < 100000; ++it) {
+                U32 *value = M_ArrayPush(array, U32, 1, M_ARENA_NO_ZERO);
+                *value = it;
+            }
+
+            U32 *items = M_ArrayItems(array, U32);
+
+            ExpectTrue(items == first);
+            ExpectIntValue(array->count, 100000);
+            ExpectIntValue(items[99999], 99999);
+
+            U32 *inserted = M_ArrayInsert(array, U32, 10, 3);
+            ExpectTrue(inserted == &items[10]);
+            ExpectIntValue(array->count, 100003);
+            ExpectTrue(items[10] == 0 && items[11] == 0 && items[12] == 0);
+            ExpectIntValue(items[13], 10);
+            ExpectIntValue(items[100002], 99999);
+
+            M_ArrayRemove(array, 10, 3);
+            ExpectIntValue(array->count, 100000);
+
+            B32 ordered = true;
+            for (U32 it = 0; it < array->count; ++it) { ordered = ordered && (items[it] == it); }
+            ExpectTrue(ordered);
+
+            M_ArrayRemove(array, 0);
+            ExpectIntValue(items[0], 1);
+
+            M_ArrayRemoveSwap(array, 0);
+            ExpectIntValue(items[0], 99999);
+            ExpectIntValue(array->count, 99998);
+            ExpectIntValue(items[array->count - 1], 99998);
+
+            M_ArrayClear(array);
+            ExpectIntValue(array->count, 0);
+
+            // popped memory is zeroed again when pushed
+            //
+            U32 *reused = M_ArrayPush(array, U32, 4);
+            ExpectTrue(reused == first && reused[0] == 0 && reused[3] == 0);
+
+            M_ReleaseArray(array);
+
+            // overlapping moves in both directions
+            //
+            U8 bytes[64];
+            for (U32 it = 0; it < 64; ++it) { bytes[it] = cast(U8) it; }
+
+            M_MoveSize(bytes + 3, bytes, 40);
+            ExpectTrue(bytes[3] == 0 && bytes[42] == 39 && bytes[43] == 43);
+
+            M_MoveSize(bytes, bytes + 3, 40);
+            ExpectTrue(bytes[0] == 0 && bytes[39] == 39 && bytes[40] == 37);
+        }
+
+        // persistent arenas can be saved and loaded at a different address, data is referenced
+        // by offset rather than pointer
+        //
+        {
+            M_Arena *persistent = M_AllocArenaArgs(MB(64), M_ARENA_COMMIT_SIZE, M_ARENA_DONT_GROW);
+
+            U32 *values = M_ArenaPush(persistent, U32, 100000);
+            for (U32 it = 0; it < 100000; ++it) { values[it] = it * 3; }
+
+            U64 values_offset = M_ArenaOffsetFromPointer(persistent, values);
+            ExpectTrue(M_ArenaPointerFromOffset(persistent, values_offset) == values);
+
+            Str8 *name = M_ArenaPush(persistent, Str8);
+            *name = S("persistent");
+
+            U64 name_offset = M_ArenaOffsetFromPointer(persistent, name);
+            U64 saved_size  = M_GetArenaOffset(persistent);
+
+            ExpectTrue(M_ArenaSave(persistent, S("arena.snapshot"), 7));
+            M_ReleaseArena(persistent);
+
+            // failed loads log an error so capture them in their own scope
+            //
+            Log_PushScope();
+            ExpectTrue(M_ArenaLoad(S("arena.snapshot"), 8) == 0);
+
+            M_Temp temp = M_AcquireTemp(0, 0);
+            ExpectIntValue(Log_PopScope(temp.arena).count, 1);
+
+            M_Arena *loaded = M_ArenaLoad(S("arena.snapshot"), 7);
+            ExpectTrue(loaded != 0);
+            ExpectIntValue(M_GetArenaOffset(loaded), saved_size);
+
+            U32 *loaded_values = cast(U32 *) M_ArenaPointerFromOffset(loaded, values_offset);
+
+            B32 equal = true;
+            for (U32 it = 0; it < 100000; ++it) { equal = equal && (loaded_values[it] == it * 3); }
+            ExpectTrue(equal);
+
+            // the loaded arena can continue to be allocated from, and pushes are still zeroed
+            // even after resetting over the loaded data
+            //
+            U8 *extra = M_ArenaPush(loaded, U8, MB(1));
+            ExpectTrue(extra[0] == 0 && extra[MB(1) - 1] == 0);
+
+            M_ResetArena(loaded);
+
+            U32 *cleared = M_ArenaPush(loaded, U32, 1000);
+
+            B32 zeroed = true;
+            for (U32 it = 0; it < 1000; ++it) { zeroed = zeroed && (cleared[it] == 0); }
+            ExpectTrue(zeroed);
+
+            M_ReleaseArena(loaded);
+
+            // corrupting the data should cause the load to be rejected, but only if the data is
+            // verified which mapped snapshots skip unless M_ARENA_LOAD_VERIFY is enabled
+            //
+            OS_Handle file = FS_OpenFile(S("arena.snapshot"), FS_ACCESS_WRITE);
+            FS_WriteFile(file, S("corrupt"), KB(64) + name_offset);
+            FS_CloseFile(file);
+
+            if (M_ARENA_LOAD_VERIFY || !OS_LINUX) {
+                Log_PushScope();
+                ExpectTrue(M_ArenaLoad(S("arena.snapshot"), 7) == 0);
+                ExpectIntValue(Log_PopScope(temp.arena).count, 1);
+            }
+            else {
+                M_Arena *unverified = M_ArenaLoad(S("arena.snapshot"), 7);
+                ExpectTrue(unverified != 0);
+
+                M_ReleaseArena(unverified);
+            }
+
+            // corrupting the header is always rejected
+            //
+            U32 flags = 0xFFFFFFFF;
+
+            file = FS_OpenFile(S("arena.snapshot"), FS_ACCESS_WRITE);
+            FS_WriteFile(file, Str8_Wrap(sizeof(U32), cast(U8 *) &flags), 3 * sizeof(U32));
+            FS_CloseFile(file);
+
+            Log_PushScope();
+            ExpectTrue(M_ArenaLoad(S("arena.snapshot"), 7) == 0);
+            ExpectIntValue(Log_PopScope(temp.arena).count, 1);
+
+            M_ReleaseTemp(temp);
+
+            ExpectTrue(FS_RemoveFile(S("arena.snapshot")));
+        }
+
+#if OS_LINUX
+        // shared arenas can be read by another process, the child waits for the data to be
+        // published and then verifies it in place
+        //
+        {
+            OS_Handle handle;
+            M_Arena *shared = M_AllocSharedArena(MB(64), S(""), &handle);
+            ExpectTrue(shared != 0);
+
+            pid_t child = fork();
+            if (child == 0) {
+                M_SharedView view = M_OpenSharedView(handle);
+
+                U64 *values = 0;
+                while (!values) {
+                    // the first value is the offset of the array, written before publishing
+                    //
+                    if (M_SharedViewOffset(view) > M_ARENA_MIN_OFFSET + sizeof(U64)) {
+                        U64 *first = cast(U64 *) M_SharedViewPointer(view, M_ARENA_MIN_OFFSET);
+                        values = cast(U64 *) M_SharedViewPointer(view, *first);
+                    }
+                    else {
+                        SpinPause();
+                    }
+                }
+
+                int status = 0;
+                for (U64 it = 0; it < 65536; ++it) {
+                    if (values[it] != it * it) { status = 1; }
+                }
+
+                if (M_SharedViewCommitted(view) < 65536 * sizeof(U64)) { status = 1; }
+
+                M_CloseSharedView(view);
+                _exit(status);
+            }
+
+            U64 *first  = M_ArenaPush(shared, U64);
+            U64 *values = M_ArenaPush(shared, U64, 65536);
+
+            for (U64 it = 0; it < 65536; ++it) { values[it] = it * it; }
+
+            *first = M_ArenaOffsetFromPointer(shared, values);
+            M_PublishSharedArena(shared);
+
+            int status = -1;
+            waitpid(child, &status, 0);
+
+            ExpectTrue(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+
+            // named shared arenas can be opened by path instead
+            //
+            OS_Handle named_handle;
+            M_Arena *named = M_AllocSharedArena(MB(1), S("/dev/shm/core_test_shared"), &named_handle);
+
+            U32 *magic = M_ArenaPush(named, U32);
+            *magic = 0xC0FFEE;
+
+            M_PublishSharedArena(named);
+
+            M_SharedView view = M_OpenSharedViewFromPath(S("/dev/shm/core_test_shared"));
+            ExpectTrue(view.base != 0);
+            ExpectIntValue(M_SharedViewOffset(view), M_GetArenaOffset(named));
+            ExpectIntValue(*cast(U32 *) M_SharedViewPointer(view, M_ARENA_MIN_OFFSET), 0xC0FFEE);
+
+            M_CloseSharedView(view);
+
+            M_ReleaseArena(named);
+            FS_CloseFile(named_handle);
+            ExpectTrue(FS_RemoveFile(S("/dev/shm/core_test_shared")));
+
+            M_ReleaseArena(shared);
+            FS_CloseFile(handle);
+        }
+#endif
+
+        // instrumentation, counters are only collected when compiled in
+        //
+        {
+            M_Arena *named = M_AllocArena(MB(16));
+            M_SetArenaName(named, S("instrumented"));
+
+            U64 start = M_GetArenaOffset(named);
+
+            M_ArenaPush(named, U8, KB(8));
+            M_ArenaPush(named, U8, KB(8));
+            M_ArenaPopTo(named, start);
+            M_ResetArena(named);
+
+            M_ArenaStats stats = M_GetArenaStats(named);
+            if (M_ARENA_INSTRUMENT) {
+                ExpectStrValue(stats.name, "instrumented");
+                ExpectIntValue(stats.pushes, 2);
+                ExpectIntValue(stats.pops, 1);
+                ExpectIntValue(stats.resets, 1);
+                ExpectTrue(stats.high_water >= start + KB(16));
+
+                Str8 dump = M_DumpArenaStats(arena);
+                ExpectTrue(dump.count != 0);
+
+                // the dump only reads the summary published by the owning thread, which should
+                // match the chain at this point
+                //
+                Str8 line = Sf(arena, "%-*s : reserved %llu, committed %llu, offset %llu,", M_ARENA_INFO_NAME_SIZE,
+                        "instrumented", stats.reserved, stats.committed, stats.offset);
+
+                B32 found = false;
+                for (S64 it = 0; !found && it < dump.count; ++it) {
+                    found = Str8_Equal(Str8_Prefix(Str8_Advance(dump, it), line.count), line, 0);
+                }
+
+                ExpectTrue(found);
+            }
+            else {
+                ExpectIntValue(stats.name.count, 0);
+                ExpectIntValue(stats.pushes, 0);
+                ExpectIntValue(M_DumpArenaStats(arena).count, 0);
+            }
+
+            M_ReleaseArena(named);
+        }
+
+        M_ResetArena(arena);
+        M_ReleaseArena(arena);
+
+        // should cause an access violation
+        //
+        // printf("current offset = %llu\n", arena->offset);
+    }
+    printf("\n");
+
+    printf("-- Strings\n");
+    {
+        Str8 test = S("Some/path/with/file.txt");
+
+        Str8 before_first = Str8_RemoveBeforeFirst(test, '/');
+        Str8 before_last  = Str8_RemoveBeforeLast(test, '/');
+
+        Str8 after_first = Str8_RemoveAfterFirst(test, '/');
+        Str8 after_last  = Str8_RemoveAfterLast(test, '/');
+
+        ExpectStrValue(before_first, "path/with/file.txt");
+        ExpectStrValue(before_last,  "file.txt");
+        ExpectStrValue(after_first,  "Some");
+        ExpectStrValue(after_last,   "Some/path/with");
+
+        Str8 dirname  = Str8_GetDirname(test);
+        Str8 basename = Str8_GetBasename(test);
+        Str8 ext      = Str8_GetExtension(test);
+
+        Str8 noext = Str8_StripExtension(basename);
+
+        ExpectStrValue(dirname,  "Some/path/with");
+        ExpectStrValue(basename, "file.txt");
+        ExpectStrValue(ext,      "txt");
+        ExpectStrValue(noext,    "file");
+
+        Str8 hira_a = Sl("\xE3\x81\x82");
+
+        Codepoint c = UTF8_Decode(hira_a);
+
+        ExpectIntValue(c.count, 3);
+        ExpectIntValue(c.value, 0x3042);
+
+        U8 value[4] = { 0 };
+        U32 count = UTF8_Encode(value, c.value);
+
+        ExpectIntValue(count, 3);
+        ExpectIntValue(*(U32 *) value, 0x8281e3);
+
+        M_Temp temp = M_AcquireTemp(0, 0);
+        Str8 cpy = Str8_Copy(temp.arena, test);
+        ExpectStrValue(cpy, "Some/path/with/file.txt");
+
+        Str8 con = Str8_Concat(temp.arena, noext, ext);
+        ExpectStrValue(con, "filetxt");
+
+        Str8 range = Str8_WrapRange(dirname.data, dirname.data + 4);
+        ExpectStrValue(range, "Some");
+
+        Str8 formatted = Sf(temp.arena, "Hello, %s! %d With a REALLY LONG ENDING", "Sailor", 69105);
+        ExpectStrValue(formatted, "Hello, Sailor! 69105 With a REALLY LONG ENDING");
+
+        Str8 advanced = Str8_Advance(test, 5);
+        Str8 removed  = Str8_Remove(test,  9);
+        Str8 sliced   = Str8_Slice(test, 5, 9);
+
+        ExpectStrValue(advanced, "path/with/file.txt");
+        ExpectStrValue(removed,  "Some/path/with");
+        ExpectStrValue(sliced,   "path");
+
+        M_ReleaseTemp(temp);
+    }
+    printf("\n");
+
+    printf("-- Characters\n");
+    {
+        ExpectTrue(Chr_IsWhitespace(' '));
+        ExpectTrue(Chr_IsWhitespace('\n'));
+        ExpectFalse(Chr_IsWhitespace('d'));
+
+        ExpectTrue(Chr_IsAlpha('a'));
+        ExpectTrue(Chr_IsAlpha('p'));
+        ExpectTrue(Chr_IsAlpha('I'));
+
+        ExpectFalse(Chr_IsAlpha(';'));
+        ExpectFalse(Chr_IsAlpha(','));
+
+        ExpectTrue(Chr_IsHex('0'));
+        ExpectTrue(Chr_IsHex('7'));
+        ExpectTrue(Chr_IsHex('a'));
+        ExpectTrue(Chr_IsHex('F'));
+
+        ExpectFalse(Chr_IsHex('i'));
+        ExpectFalse(Chr_IsHex('p'));
+
+        ExpectTrue(Chr_IsSlash('/'));
+        ExpectTrue(Chr_IsSlash('\\'));
+
+        ExpectTrue(Chr_IsPathSeparator('/'));
+#if OS_WINDOWS
+        ExpectTrue(Chr_IsPathSeparator('\\'));
+#endif
+
+        ExpectIntValue(Chr_ToUppercase('a'), 'A');
+        ExpectIntValue(Chr_ToLowercase('A'), 'a');
+    }
+    printf("\n");
+
+    printf("-- Logging\n");
+    {
+        Log_PushScope();
+
+        Log_Debug("Hello, %d", 69105);
+        Log_Info("Other INFO");
+
+        Log_Warn("WARNING SOMETHING ISN'T RIGHT!");
+
+        Log_Error("Error failed");
+
+        const char *expected_messages[] = {
+            ("Hello, 69105"),
+            ("Other INFO"),
+            ("WARNING SOMETHING ISN'T RIGHT!"),
+            ("Error failed")
+        };
+
+        M_Temp temp = M_AcquireTemp(0, 0);
+        Log_MessageArray messages = Log_PopScope(temp.arena);
+
+        ExpectTrue(messages.count == ArraySize(expected_messages));
+
+        for (U32 it = 0; it < messages.count; ++it) {
+            Log_Message *n = &messages.items[it];
+            ExpectStrValue(n->message, expected_messages[it]);
+            ExpectIntValue(n->code, cast(S32) it - 4); // LOG_* codes are negative
+        }
+
+        ExpectStrValue(Log_StrFromLevel(LOG_ERROR), "Error");
+
+        M_ReleaseTemp(temp);
+    }
+    printf("\n");
+
+    printf("-- Stream\n");
+    {
+        U8 values[] = { 0, 1, 2, 3, 4 };
+
+        Stream_Context zstream;
+        Stream_Zero(&zstream);
+
+        U32 *zero = Stream_Read(&zstream, U32);
+        ExpectIntValue(zero[0], 0);
+
+        Stream_Context mstream;
+
+        Str8 data;
+        data.count = ArraySize(values);
+        data.data  = values;
+
+        Stream_FromMemory(&mstream, data);
+
+        U32 x = 0;
+        while (mstream.pos != mstream.end) {
+            ExpectIntValue(mstream.pos[0], values[x]);
+            mstream.pos += 1;
+            x += 1;
+        }
+
+        U32 bit_pattern = 0xCACACACA;
+
+        data.count = sizeof(bit_pattern);
+        data.data  = cast(U8 *) &bit_pattern;
+
+        Stream_FromMemory(&mstream, data);
+
+        for (U32 it = 0; it < 32; it += 4) {
+            U64 bits = Stream_ReadBits(&mstream, 4);
+
+            ExpectIntValue(bits, (U32) (((it >> 2) & 1) ? 0xC : 0xA));
+        }
+
+        ExpectIntValue(mstream.bit_buffer, 0);
+        ExpectIntValue(mstream.bit_count,  0);
+    }
+    printf("\n");
+
+    printf("-- File System\n");
+    {
+        M_Temp temp = M_AcquireTemp(0, 0);
+
+        // system paths
+        //
+        Str8 exe_path     = FS_GetPath(temp.arena, FS_PATH_EXE);
+        Str8 user_path    = FS_GetPath(temp.arena, FS_PATH_USER);
+        Str8 temp_path    = FS_GetPath(temp.arena, FS_PATH_TEMP);
+        Str8 working_path = FS_GetPath(temp.arena, FS_PATH_WORKING);
+
+        printf("    exe     path = %.*s\n", Sv(exe_path));
+        printf("    user    path = %.*s\n", Sv(user_path));
+        printf("    temp    path = %.*s\n", Sv(temp_path));
+        printf("    working path = %.*s\n", Sv(working_path));
+
+#if OS_LINUX
+        // the working directory isn't cached so changes to it are picked up
+        //
+        if (chdir(cast(const char *) Str8_Copy(temp.arena, exe_path).data) == 0) {
+            ExpectTrue(Str8_Equal(FS_GetPath(temp.arena, FS_PATH_WORKING), exe_path, 0));
+
+            chdir(cast(const char *) Str8_Copy(temp.arena, working_path).data);
+        }
+
+        ExpectTrue(Str8_Equal(FS_GetPath(temp.arena, FS_PATH_WORKING), working_path, 0));
+#endif
+
+        // directory listing
+        //
+        FS_List list = FS_ListPath(temp.arena, exe_path, FS_LIST_RECURSIVE);
+
+        printf("    list of %.*s:\n", Sv(exe_path));
+
+        U32 it = 0;
+        for (FS_Entry *e = list.first; e != 0; e = e->next) {
+            printf("      [%2d] = %.*s%c\n", it, Sv(e->path), (e->props & FS_PROPERTY_IS_DIRECTORY) ? '*' : ' ');
+            it += 1;
+        }
+
+        // writing a file
+        //
+        OS_Handle file = FS_OpenFile(S("test.txt"), FS_ACCESS_WRITE);
+
+        U64 offset = 0;
+
+        offset += FS_WriteFile(file, S("Hello, World! | "), offset);
+        offset += FS_WriteFile(file, S("Hello, World! | "), offset);
+        offset += FS_WriteFile(file, S("Hello, World! | "), offset);
+
+        FS_AppendFile(file, S("End of file"));
+
+        ExpectIntValue(FS_PropertiesFromHandle(file), 0);
+        ExpectIntValue(FS_SizeFromHandle(file), 59); // should be 59 bytes long after writing
+
+        Str8 path = FS_PathFromHandle(temp.arena, file);
+        Str8 basename = Str8_GetBasename(path);
+        printf("    full path from handle is %.*s\n", Sv(path));
+        ExpectStrValue(basename, "test.txt");
+
+        FS_Time times = FS_TimeFromHandle(file);
+
+        printf("    times from handle:\n");
+        printf("      written:  %llu\n", times.written);
+        printf("      accessed: %llu\n", times.accessed);
+        printf("      created:  %llu\n", times.created);
+
+        FS_CloseFile(file);
+
+        // reading a file
+        //
+        Str8 contents = FS_ReadEntireFile(temp.arena, S("test.txt"));
+        ExpectStrValue(contents, "Hello, World! | Hello, World! | Hello, World! | End of file");
+
+        ExpectTrue(FS_CreateDirectory(S("test_dir")));
+
+        // from path
+        //
+        ExpectIntValue(FS_PropertiesFromPath(S("test_dir")), FS_PROPERTY_IS_DIRECTORY);
+        ExpectIntValue(FS_SizeFromPath(S("test.txt")), 59); // still 59 bytes after reading
+
+        times = FS_TimeFromPath(S("test_dir"));
+
+        printf("    times from path:\n");
+        printf("      written:  %llu\n", times.written);
+        printf("      accessed: %llu\n", times.accessed);
+        printf("      created:  %llu\n", times.created);
+
+        // cleanup
+        //
+        ExpectTrue(FS_RemoveFile(S("test.txt")));
+        ExpectTrue(FS_RemoveDirectory(S("test_dir")));
+
+        M_ReleaseTemp(temp);
+    }
+    printf("\n");
+
+    printf("-- Threading\n");
+    {
+        // This is not robust, just making sure basic stuff works. We can implement
+        // something more substantial later
+        //
+
+        T_Thread thread = ZERO(T_Thread);
+        thread.Proc  = TestThreadProc;
+        thread.param = 0;
+        thread.flags = 0;
+
+        OS_Handle mutex   = T_CreateMutex();
+        OS_Handle sem     = T_CreateSemaphore(10);
+        OS_Handle rwlock  = T_CreateRWLock();
+        OS_Handle condvar = T_CreateConditionVar();
+
+        T_CreateThread(&thread);
+        ExpectTrue(OS_HandleValid(thread.handle));
+
+        T_JoinThread(thread.handle);
+        T_DetachThread(thread.handle);
+
+        ExpectIntValue(thread_sum, 45);
+
+        // contended locks, threads are created suspended and held on a futex so they
+        // all hammer the locks at the same time
+        //
+        ThreadShared shared = ZERO(ThreadShared);
+        shared.mutex  = mutex;
+        shared.rwlock = rwlock;
+        shared.sem    = sem;
+
+        T_Thread workers[4];
+        for (U32 it = 0; it < ArraySize(workers); ++it) {
+            workers[it]       = thread;
+            workers[it].Proc  = TestContendedProc;
+            workers[it].param = &shared;
+            workers[it].flags = T_THREAD_CREATE_SUSPENDED;
+
+            T_CreateThread(&workers[it]);
+            T_ResumeThread(workers[it].handle);
+        }
+
+        AtomicExchange_U32(&shared.go, 1);
+        T_BroadcastFutex(&shared.go);
+
+        for (U32 it = 0; it < ArraySize(workers); ++it) {
+            T_JoinThread(workers[it].handle);
+            T_DetachThread(workers[it].handle);
+        }
+
+        ExpectIntValue(shared.counter,    40000);
+        ExpectIntValue(shared.rw_counter, 40000);
+
+        // each worker took one count from the semaphore, this will deadlock if the count
+        // isn't restored correctly
+        //
+        for (U32 it = 0; it < ArraySize(workers); ++it) { T_SignalSemaphore(sem); }
+        for (U32 it = 0; it < 10; ++it) { T_WaitSemaphore(sem); }
+
+        // condition variables, consumers wait while holding the mutex or write lock and are woken
+        // one at a time for each item then all at once when production is done
+        //
+        for (U32 variant = 0; variant < 2; ++variant) {
+            CondVarShared cv = ZERO(CondVarShared);
+            cv.mutex      = mutex;
+            cv.rwlock     = rwlock;
+            cv.condvar    = condvar;
+            cv.use_rwlock = (variant == 1);
+
+            for (U32 it = 0; it < ArraySize(workers); ++it) {
+                workers[it]       = thread;
+                workers[it].Proc  = TestCondVarConsumer;
+                workers[it].param = &cv;
+
+                T_CreateThread(&workers[it]);
+            }
+
+            for (U32 it = 0; it < 10000; ++it) {
+                if (cv.use_rwlock) {
+                    T_AcquireRWLockWrite(rwlock);
+                    cv.items += 1;
+                    T_ReleaseRWLockWrite(rwlock);
+                }
+                else {
+                    T_AcquireMutex(mutex);
+                    cv.items += 1;
+                    T_ReleaseMutex(mutex);
+                }
+
+                T_WakeConditionVar(condvar);
+            }
+
+            if (cv.use_rwlock) {
+                T_AcquireRWLockWrite(rwlock);
+                cv.done = true;
+                T_ReleaseRWLockWrite(rwlock);
+            }
+            else {
+                T_AcquireMutex(mutex);
+                cv.done = true;
+                T_ReleaseMutex(mutex);
+            }
+
+            T_BroadcastConditionVar(condvar);
+
+            for (U32 it = 0; it < ArraySize(workers); ++it) {
+                T_JoinThread(workers[it].handle);
+                T_DetachThread(workers[it].handle);
+            }
+
+            ExpectIntValue(cv.consumed, 10000);
+            ExpectIntValue(cv.items,    0);
+        }
+
+        // shared readers waiting on the same condition are all released by a single broadcast
+        //
+        {
+            CondVarShared cv = ZERO(CondVarShared);
+            cv.rwlock  = rwlock;
+            cv.condvar = condvar;
+
+            for (U32 it = 0; it < ArraySize(workers); ++it) {
+                workers[it]       = thread;
+                workers[it].Proc  = TestCondVarReader;
+                workers[it].param = &cv;
+
+                T_CreateThread(&workers[it]);
+            }
+
+            T_AcquireRWLockWrite(rwlock);
+            cv.ready = true;
+            T_ReleaseRWLockWrite(rwlock);
+
+            T_BroadcastConditionVar(condvar);
+
+            for (U32 it = 0; it < ArraySize(workers); ++it) {
+                T_JoinThread(workers[it].handle);
+                T_DetachThread(workers[it].handle);
+            }
+
+            ExpectIntValue(cv.woken, ArraySize(workers));
+        }
+
+        // lock-free pool shared between all of the workers
+        //
+        M_Arena *pool_arena = M_AllocArena(GB(1));
+
+        PoolShared pool_shared = ZERO(PoolShared);
+        pool_shared.pool = M_AllocPool(pool_arena, sizeof(U64), 8, M_POOL_THREAD_SAFE);
+
+        for (U32 it = 0; it < ArraySize(workers); ++it) {
+            workers[it].Proc  = TestPoolProc;
+            workers[it].param = &pool_shared;
+
+            T_CreateThread(&workers[it]);
+            T_ResumeThread(workers[it].handle);
+        }
+
+        AtomicExchange_U32(&pool_shared.go, 1);
+        T_BroadcastFutex(&pool_shared.go);
+
+        for (U32 it = 0; it < ArraySize(workers); ++it) {
+            T_JoinThread(workers[it].handle);
+            T_DetachThread(workers[it].handle);
+        }
+
+        ExpectIntValue(pool_shared.errors, 0);
+
+        M_ReleaseArena(pool_arena);
+
+        // thread-safe pools can share an M_ARENA_CONCURRENT arena with other threads pushing to
+        // it directly while the pool refills
+        //
+        {
+            M_Arena *shared_arena = M_AllocArenaArgs(GB(1), M_ARENA_COMMIT_SIZE, M_ARENA_CONCURRENT);
+
+            PoolShared shared_pool = ZERO(PoolShared);
+            shared_pool.pool = M_AllocPool(shared_arena, KB(1), 8, M_POOL_THREAD_SAFE);
+
+            ConcurrentShared pushers = ZERO(ConcurrentShared);
+            pushers.arena = shared_arena;
+
+            for (U32 it = 0; it < ArraySize(workers); ++it) {
+                workers[it].Proc  = (it & 1) ? TestConcurrentArenaProc : TestPoolProc;
+                workers[it].param = (it & 1) ? cast(void *) &pushers : cast(void *) &shared_pool;
+
+                T_CreateThread(&workers[it]);
+                T_ResumeThread(workers[it].handle);
+            }
+
+            AtomicExchange_U32(&shared_pool.go, 1);
+            AtomicExchange_U32(&pushers.go, 1);
+
+            T_BroadcastFutex(&shared_pool.go);
+            T_BroadcastFutex(&pushers.go);
+
+            for (U32 it = 0; it < ArraySize(workers); ++it) {
+                T_JoinThread(workers[it].handle);
+                T_DetachThread(workers[it].handle);
+            }
+
+            ExpectIntValue(shared_pool.errors, 0);
+            ExpectIntValue(pushers.errors, 0);
+
+            M_ReleaseArena(shared_arena);
+        }
+
+        // concurrent arena pushed to by all of the workers, small enough to force growth
+        //
+        ConcurrentShared concurrent = ZERO(ConcurrentShared);
+        concurrent.arena = M_AllocArenaArgs(KB(256), M_ARENA_COMMIT_SIZE, M_ARENA_CONCURRENT);
+
+        for (U32 it = 0; it < ArraySize(workers); ++it) {
+            workers[it].Proc  = TestConcurrentArenaProc;
+            workers[it].param = &concurrent;
+
+            T_CreateThread(&workers[it]);
+            T_ResumeThread(workers[it].handle);
+        }
+
+        AtomicExchange_U32(&concurrent.go, 1);
+        T_BroadcastFutex(&concurrent.go);
+
+        for (U32 it = 0; it < ArraySize(workers); ++it) {
+            T_JoinThread(workers[it].handle);
+            T_DetachThread(workers[it].handle);
+        }
+
+        ExpectIntValue(concurrent.errors, 0);
+
+        M_ArenaStats concurrent_stats = M_GetArenaStats(concurrent.arena);
+        ExpectTrue(concurrent_stats.chain_length > 1);
+        ExpectIntValue(concurrent_stats.large_blocks, 4 * (4096 / 1024));
+
+        M_ResetArena(concurrent.arena);
+
+        concurrent_stats = M_GetArenaStats(concurrent.arena);
+        ExpectIntValue(concurrent_stats.chain_length, 1);
+        ExpectIntValue(concurrent_stats.large_blocks, 0);
+
+        M_ReleaseArena(concurrent.arena);
+
+        // near block-size pushes racing for the last of the space in a nearly full arena, this is
+        // repeated a few times as only the pushes made before the first growth can lose the race
+        //
+        for (U32 round = 0; round < 8; ++round) {
+            ConcurrentShared near = ZERO(ConcurrentShared);
+            near.arena = M_AllocArenaArgs(MB(8), M_ARENA_COMMIT_SIZE, M_ARENA_CONCURRENT);
+
+            M_ArenaPush(near.arena, U8, MB(5), M_ARENA_NO_ZERO);
+
+            for (U32 it = 0; it < ArraySize(workers); ++it) {
+                workers[it].Proc  = TestConcurrentNearBlockProc;
+                workers[it].param = &near;
+
+                T_CreateThread(&workers[it]);
+                T_ResumeThread(workers[it].handle);
+            }
+
+            AtomicExchange_U32(&near.go, 1);
+            T_BroadcastFutex(&near.go);
+
+            for (U32 it = 0; it < ArraySize(workers); ++it) {
+                T_JoinThread(workers[it].handle);
+                T_DetachThread(workers[it].handle);
+            }
+
+            ExpectIntValue(near.errors, 0);
+
+            M_ReleaseArena(near.arena);
+        }
+
+        T_DeleteMutex(mutex);
+        T_DeleteSemaphore(sem);
+        T_DeleteRWLock(rwlock);
+        T_DeleteConditionVar(condvar);
+    }
+
+    printf("-- Queues\n");
+    {
+        M_Arena *arena = M_AllocArena(GB(1));
+
+        T_Thread blank = ZERO(T_Thread);
+
+        // single threaded behaviour, capacity is rounded up to a power of two
+        //
+        {
+            T_SPSCQueue *spsc = T_AllocSPSCQueue(arena, sizeof(U32), 5);
+            T_MPMCQueue *mpmc = T_AllocMPMCQueue(arena, sizeof(U32), 5);
+
+            ExpectIntValue(spsc->mask, 7);
+            ExpectIntValue(mpmc->mask, 7);
+
+            U32 value = 0;
+            ExpectFalse(T_SPSCTryPop(spsc, &value));
+            ExpectFalse(T_MPMCTryPop(mpmc, &value));
+
+            // several laps so the indices and sequence numbers wrap around the cells
+            //
+            B32 spsc_ok = true;
+            B32 mpmc_ok = true;
+
+            for (U32 lap = 0; lap < 4; ++lap) {
+                for (U32 it = 0; it < 8; ++it) {
+                    value = (lap * 8) + it;
+
+                    spsc_ok = spsc_ok && T_SPSCTryPush(spsc, &value);
+                    mpmc_ok = mpmc_ok && T_MPMCTryPush(mpmc, &value);
+                }
+
+                spsc_ok = spsc_ok && !T_SPSCTryPush(spsc, &value);
+                mpmc_ok = mpmc_ok && !T_MPMCTryPush(mpmc, &value);
+
+                for (U32 it = 0; it < 8; ++it) {
+                    U32 expected = (lap * 8) + it;
+
+                    spsc_ok = spsc_ok && T_SPSCTryPop(spsc, &value) && (value == expected);
+                    mpmc_ok = mpmc_ok && T_MPMCTryPop(mpmc, &value) && (value == expected);
+                }
+
+                spsc_ok = spsc_ok && !T_SPSCTryPop(spsc, &value);
+                mpmc_ok = mpmc_ok && !T_MPMCTryPop(mpmc, &value);
+            }
+
+            ExpectTrue(spsc_ok);
+            ExpectTrue(mpmc_ok);
+
+            // elements which aren't a multiple of 8 bytes
+            //
+            T_MPMCQueue *wide = T_AllocMPMCQueue(arena, sizeof(SortWide), 4);
+
+            SortWide in = ZERO(SortWide);
+            in.key = 1234;
+            for (U32 it = 0; it < ArraySize(in.payload); ++it) { in.payload[it] = cast(U8) it; }
+
+            for (U32 it = 0; it < 4; ++it) { T_MPMCPush(wide, &in); }
+            ExpectFalse(T_MPMCTryPush(wide, &in));
+
+            SortWide out;
+            for (U32 it = 0; it < 4; ++it) { T_MPMCPop(wide, &out); }
+
+            ExpectIntValue(out.key, 1234);
+            ExpectIntValue(out.payload[18], 18);
+
+            // elements can be pushed from and popped to storage of any alignment
+            //
+            T_SPSCQueue *words = T_AllocSPSCQueue(arena, sizeof(U64), 4);
+
+            U8 unaligned[32];
+            for (U32 it = 0; it < ArraySize(unaligned); ++it) { unaligned[it] = cast(U8) it; }
+
+            B32 copied = T_SPSCTryPush(words, unaligned + 1) && T_SPSCTryPop(words, unaligned + 13);
+            for (U32 it = 0; it < sizeof(U64); ++it) { copied = copied && (unaligned[13 + it] == (1 + it)); }
+
+            ExpectTrue(copied);
+        }
+
+        // spsc throughput, a small ring so both sides park on the futexes as well
+        //
+        {
+            QueueShared shared = ZERO(QueueShared);
+            shared.spsc  = T_AllocSPSCQueue(arena, sizeof(U64), 64);
+            shared.count = 1000000;
+
+            T_Thread producer = blank;
+            producer.Proc  = TestSPSCProducer;
+            producer.param = &shared;
+
+            U64 start = OS_GetTicks();
+
+            T_CreateThread(&producer);
+
+            B32 ordered = true;
+            for (U64 it = 0; it < shared.count; ++it) {
+                U64 value;
+                T_SPSCPop(shared.spsc, &value);
+
+                ordered = ordered && (value == it);
+            }
+
+            F64 elapsed = OS_TicksToSeconds(OS_GetTicks() - start);
+
+            T_JoinThread(producer.handle);
+            T_DetachThread(producer.handle);
+
+            ExpectTrue(ordered);
+
+            printf("    spsc throughput: %.1fM elements/s\n", (shared.count / elapsed) / 1e6);
+        }
+
+        // mpmc stress, producers and consumers all started at once on a queue small enough that
+        // both sides are constantly full or empty
+        //
+        {
+            QueueShared shared = ZERO(QueueShared);
+            shared.mpmc    = T_AllocMPMCQueue(arena, sizeof(U64), 16);
+            shared.count   = 100000;
+            shared.threads = 4;
+
+            T_Thread threads[8];
+            for (U32 it = 0; it < 2 * shared.threads; ++it) {
+                threads[it]       = blank;
+                threads[it].Proc  = (it & 1) ? TestMPMCConsumer : TestMPMCProducer;
+                threads[it].param = &shared;
+
+                T_CreateThread(&threads[it]);
+            }
+
+            U64 start = OS_GetTicks();
+
+            AtomicExchange_U32(&shared.go, 1);
+            T_BroadcastFutex(&shared.go);
+
+            for (U32 it = 0; it < 2 * shared.threads; ++it) {
+                T_JoinThread(threads[it].handle);
+                T_DetachThread(threads[it].handle);
+            }
+
+            F64 elapsed = OS_TicksToSeconds(OS_GetTicks() - start);
+
+            U64 expected = cast(U64) shared.threads * ((cast(U64) shared.count * (shared.count - 1)) / 2);
+
+            ExpectIntValue(shared.errors, 0);
+            ExpectTrue(shared.sum == expected);
+            ExpectFalse(T_MPMCTryPop(shared.mpmc, &expected));
+
+            printf("    mpmc throughput %ux%u: %.1fM elements/s\n", shared.threads, shared.threads,
+                    ((shared.threads * shared.count) / elapsed) / 1e6);
+        }
+
+        // round trip latency between two threads
+        //
+        {
+            QueueShared shared = ZERO(QueueShared);
+            shared.spsc       = T_AllocSPSCQueue(arena, sizeof(U64), 2);
+            shared.reply      = T_AllocSPSCQueue(arena, sizeof(U64), 2);
+            shared.mpmc       = T_AllocMPMCQueue(arena, sizeof(U64), 2);
+            shared.mpmc_reply = T_AllocMPMCQueue(arena, sizeof(U64), 2);
+
+            T_Thread echo[2];
+            echo[0] = blank;
+            echo[0].Proc  = TestSPSCEcho;
+            echo[0].param = &shared;
+
+            echo[1] = echo[0];
+            echo[1].Proc = TestMPMCEcho;
+
+            T_CreateThread(&echo[0]);
+            T_CreateThread(&echo[1]);
+
+            U32 trips = 20000;
+            B32 echoed = true;
+
+            U64 start = OS_GetTicks();
+            for (U64 it = 0; it < trips; ++it) {
+                U64 value = it;
+                T_SPSCPush(shared.spsc, &value);
+                T_SPSCPop(shared.reply, &value);
+
+                echoed = echoed && (value == it);
+            }
+            F64 spsc = OS_TicksToSeconds(OS_GetTicks() - start);
+
+            start = OS_GetTicks();
+            for (U64 it = 0; it < trips; ++it) {
+                U64 value = it;
+                T_MPMCPush(shared.mpmc, &value);
+                T_MPMCPop(shared.mpmc_reply, &value);
+
+                echoed = echoed && (value == it);
+            }
+            F64 mpmc = OS_TicksToSeconds(OS_GetTicks() - start);
+
+            U64 stop = U64_MAX;
+            T_SPSCPush(shared.spsc, &stop);
+            T_MPMCPush(shared.mpmc, &stop);
+
+            for (U32 it = 0; it < ArraySize(echo); ++it) {
+                T_JoinThread(echo[it].handle);
+                T_DetachThread(echo[it].handle);
+            }
+
+            ExpectTrue(echoed);
+
+            printf("    round trip latency: spsc %.0fns, mpmc %.0fns\n", (spsc * 1e9) / trips, (mpmc * 1e9) / trips);
+        }
+
+        M_ReleaseArena(arena);
+    }
+
+    printf("-- Jobs\n");
+    {
+#if OS_LINUX
+        // only the first initialisation has any effect so a single worker is tested in a child
+        // process, there are no background workers so jobs that are never waited on must still run
+        //
+        {
+            pid_t child = fork();
+            if (child == 0) {
+                J_Init(1);
+
+                JobShared single = ZERO(JobShared);
 
+                J_Submit(TestJobAdd, &single, 0);
 
-        printf("    Unsorted: { ");
+                J_Job jobs[8];
+                for (U32 it = 0; it < ArraySize(jobs); ++it) {
+                    jobs[it].Proc  = TestJobAdd;
+                    jobs[it].param = &single;
+                }
 
-        for (U64 it = 0; it < ArraySize(some_array); ++it) {
-            printf("%d ", some_array[it]);
+                J_SubmitJobs(jobs, ArraySize(jobs), 0);
+
+                _exit((J_GetWorkerCount() == 1 && single.sum == 9) ? 0 : 1);
+            }
+
+            int status = -1;
+            waitpid(child, &status, 0);
+
+            ExpectTrue(WIFEXITED(status) && WEXITSTATUS(status) == 0);
         }
+#endif
 
-        printf("}\n");
+        // explicit worker count so stealing is exercised regardless of how many cores the machine
+        // has, this also sets the workers used by the parallel sorts below
+        //
+        J_Init(4);
+        J_Init(8); // only the first call has any effect
 
-        MergeSort(some_array, ArraySize(some_array), CompareInt);
+        ExpectIntValue(J_GetWorkerCount(), 4);
+        ExpectIntValue(J_GetWorkerIndex(), 0);
 
-        printf("    Sorted:   { ");
+        M_Arena *arena = M_AllocArena(GB(1));
 
-        U32 total = 0;
-        for (U64 it = 0; it < ArraySize(some_array); ++it) {
-            printf("%d ", some_array[it]);
+        JobShared shared = ZERO(JobShared);
 
-            if (it != 0) { total += (some_array[it - 1] <= some_array[it]); }
+        // basic submission, including more jobs than fit in a deque so some are run inline
+        //
+        {
+            U32    count = J_DEQUE_CAPACITY + 1000;
+            J_Job *jobs  = M_ArenaPush(arena, J_Job, count);
+
+            for (U32 it = 0; it < count; ++it) {
+                jobs[it].Proc  = TestJobAdd;
+                jobs[it].param = &shared;
+            }
+
+            J_Counter counter = 0;
+            J_SubmitJobs(jobs, count, &counter);
+            J_Submit(TestJobAdd, &shared, &counter);
+            J_Wait(&counter);
+
+            ExpectIntValue(counter, 0);
+            ExpectIntValue(shared.sum, count + 1);
+
+            // waiting on a counter with nothing submitted returns immediately
+            //
+            J_Wait(&counter);
         }
 
-        printf("}\n");
+        // parallel for, values are accumulated so each element must be covered exactly once
+        //
+        {
+            U32 count = 1000003;
 
-        ExpectIntValue(total, ArraySize(some_array) - 1);
+            shared.values  = M_ArenaPush(arena, U32, count);
+            shared.workers = M_ArenaPush(arena, U32, count);
 
-        printf("    Unsorted: { ");
+            ParallelFor(count, 0,    TestJobFor, &shared);
+            ParallelFor(count, 4096, TestJobFor, &shared);
+            ParallelFor(count, 1,    TestJobFor, &shared);
 
-        for (U64 it = 0; it < ArraySize(other_array); ++it) {
-            printf("%d ", other_array[it]);
+            B32 covered = true;
+            for (U32 it = 0; it < count; ++it) { covered = covered && (shared.values[it] == 3 * (it * it)); }
+
+            ExpectTrue(covered);
+            ExpectIntValue(shared.errors, 0);
+
+            // small counts are run directly on the calling thread
+            //
+            ParallelFor(0, 0, TestJobFor, &shared);
+            ParallelFor(7, 8, TestJobFor, &shared);
+
+            ExpectIntValue(shared.values[6], 4 * 36);
+            ExpectIntValue(shared.workers[6], 0);
         }
 
-        printf("}\n");
+        // nested jobs waiting on their own children, deeper than the worker count
+        //
+        {
+            shared.sum = 0;
 
-        QuickSort(other_array, ArraySize(other_array), CompareInt);
+            JobTree root;
+            root.shared = &shared;
+            root.depth  = 12;
 
-        printf("    Sorted:   { ");
+            J_Counter counter = 0;
+            J_Submit(TestJobTree, &root, &counter);
+            J_Wait(&counter);
 
-        total = 0;
-        for (U64 it = 0; it < ArraySize(other_array); ++it) {
-            printf("%d ", other_array[it]);
+            ExpectIntValue(shared.sum, 1 << 12);
+        }
 
-            if (it != 0) { total += (other_array[it - 1] <= other_array[it]); }
+        // stress, threads which aren't workers submit through the shared queue while worker zero
+        // is submitting to its own deque and all of them are waiting while helping
+        //
+        {
+            shared.sum = 0;
+            shared.go  = 0;
+
+            T_Thread blank = ZERO(T_Thread);
+
+            T_Thread threads[4];
+            for (U32 it = 0; it < ArraySize(threads); ++it) {
+                threads[it]       = blank;
+                threads[it].Proc  = TestJobSubmitProc;
+                threads[it].param = &shared;
+
+                T_CreateThread(&threads[it]);
+            }
+
+            AtomicExchange_U32(&shared.go, 1);
+            T_BroadcastFutex(&shared.go);
+
+            JobTree root;
+            root.shared = &shared;
+            root.depth  = 10;
+
+            for (U32 it = 0; it < 16; ++it) {
+                J_Counter counter = 0;
+                J_Submit(TestJobTree, &root, &counter);
+                J_Wait(&counter);
+            }
+
+            for (U32 it = 0; it < ArraySize(threads); ++it) {
+                T_JoinThread(threads[it].handle);
+                T_DetachThread(threads[it].handle);
+            }
+
+            ExpectIntValue(shared.sum, (ArraySize(threads) * 64 * 256) + (16 << 10));
+            ExpectIntValue(shared.errors, 0);
         }
 
-        printf("}\n");
+        // contention benchmark, tiny jobs so the cost is dominated by the deques and waking
+        //
+        {
+            U32    count = 1000000;
+            J_Job *jobs  = M_ArenaPush(arena, J_Job, 1024);
 
-        ExpectIntValue(total, ArraySize(other_array) - 1);
+            for (U32 it = 0; it < 1024; ++it) {
+                jobs[it].Proc  = TestJobAdd;
+                jobs[it].param = &shared;
+            }
 
-        ListNode nodes[10];
+            shared.sum = 0;
 
-        nodes[0].value = 22;
-        nodes[1].value = 9302;
-        nodes[2].value = 2;
-        nodes[3].value = 39;
-        nodes[4].value = 190;
-        nodes[5].value = 0;
-        nodes[6].value = 459;
-        nodes[7].value = 387;
-        nodes[8].value = 548;
-        nodes[9].value = 879;
+            U64 start = OS_GetTicks();
+            for (U32 it = 0; it < count; it += 1024) {
+                J_Counter counter = 0;
+                J_SubmitJobs(jobs, 1024, &counter);
+                J_Wait(&counter);
+            }
+            F64 batched = OS_TicksToSeconds(OS_GetTicks() - start);
 
-        printf("Before sort:\n");
-        for (U32 it = 0; it < 10; ++it) {
-            printf("    node[%d].value = %d\n", it, nodes[it].value);
+            start = OS_GetTicks();
+            for (U32 it = 0; it < count / 16; ++it) {
+                J_Counter counter = 0;
+                J_Submit(TestJobAdd, &shared, &counter);
+                J_Wait(&counter);
+            }
+            F64 single = OS_TicksToSeconds(OS_GetTicks() - start);
+
+            ExpectIntValue(shared.sum, ((count + 1023) & ~1023) + (count / 16));
+
+            shared.values = M_ArenaPush(arena, U32, count);
+
+            start = OS_GetTicks();
+            ParallelFor(count, 1, TestJobFor, &shared);
+            F64 fine = OS_TicksToSeconds(OS_GetTicks() - start);
+
+            start = OS_GetTicks();
+            ParallelFor(count, 0, TestJobFor, &shared);
+            F64 coarse = OS_TicksToSeconds(OS_GetTicks() - start);
+
+            printf("    jobs %u workers: batched %.1fns/job, submit + wait %.1fns/job\n", J_GetWorkerCount(),
+                    (batched * 1e9) / count, (single * 1e9) / (count / 16));
+
+            printf("    parallel for %u: grain 1 %.3fms, default grain %.3fms\n", count, fine * 1000, coarse * 1000);
         }
 
-        QuickSort(nodes, ArraySize(nodes), CompareListNode);
+        M_ReleaseArena(arena);
+    }
 
-        printf("After sort:\n");
-        for (U32 it = 0; it < 10; ++it) {
-            printf("    node[%d].value = %d\n", it, nodes[it].value);
+    printf("-- Sorting\n");
+    {
+        M_Arena *arena = M_AllocArena(GB(1));
+
+        SortFixture fixture = SortFixtureAlloc(arena);
+
+        ExpectTrue(SortFixtureRun(&fixture, SortFixtureQuick, SORT_FIXTURE_ALL));
+
+        // merge sort must also keep records with equal keys in their original order
+        //
+        ExpectTrue(SortFixtureRun(&fixture, SortFixtureMerge, SORT_FIXTURE_ALL | SORT_FIXTURE_STABLE));
+
+        // the merge scratch comes from the same temp arena as the caller's, an odd sized push in
+        // the caller's scope must not leave the elements passed to the comparison misaligned
+        //
+        {
+            M_Temp temp = M_AcquireTemp(0, 0);
+            Str8_Copy(temp.arena, S("abc"));
+
+            for (U32 it = 0; it < 1000; ++it) {
+                fixture.records[it].key   = SortPatternValue(SORT_PATTERN_RANDOM, it, 1000);
+                fixture.records[it].index = it;
+            }
+
+            sort_misaligned = 0;
+            MergeSort(fixture.records, 1000, CompareSortRecordAligned);
+
+            ExpectIntValue(sort_misaligned, 0);
+
+            M_ReleaseTemp(temp);
         }
 
-        // Byte/bit swapping
+        // typed sorts
         //
-        U8  x8  = 0xF0;
-        U16 x16 = 0xFF00;
-        U32 x32 = 0xFFFF0000;
-        U64 x64 = 0xFF00FF00FF00FF00;
+        ExpectTrue(SortFixtureRun(&fixture, SortFixtureTyped, SORT_FIXTURE_VALUES | SORT_FIXTURE_RECORDS | SORT_FIXTURE_WIDES));
 
-        ExpectIntValue(SwapBytes_U16(x16), 0x00FF);
-        ExpectIntValue(SwapBytes_U32(x32), 0x0000FFFF);
-        ExpectIntValue(SwapBytes_U64(x64), 0x00FF00FF00FF00FF);
+#if LANG_CPP
+        ExpectTrue(SortFixtureRun(&fixture, SortFixtureTemplate, SORT_FIXTURE_VALUES | SORT_FIXTURE_RECORDS | SORT_FIXTURE_WIDES));
+#endif
 
-        ExpectIntValue(ReverseBits_U8(x8),   0x0F);
-        ExpectIntValue(ReverseBits_U16(x16), 0x00FF);
-        ExpectIntValue(ReverseBits_U32(x32), 0x0000FFFF);
-        ExpectIntValue(ReverseBits_U64(x64), 0x00FF00FF00FF00FF);
+        // radix sorts, the pairs are stable
+        //
+        ExpectTrue(SortFixtureRun(&fixture, SortFixtureRadix, SORT_FIXTURE_VALUES | SORT_FIXTURE_RECORDS | SORT_FIXTURE_STABLE));
+
+        S32 s32[] = { 5, -1, 2147483647, 0, -2147483647 - 1, -300, 300, 1 };
+        RadixSort_S32(arena, s32, ArraySize(s32));
+
+        B32 radix_s32 = true;
+        for (U32 it = 1; it < ArraySize(s32); ++it) { radix_s32 = radix_s32 && (s32[it - 1] <= s32[it]); }
+
+        ExpectTrue(radix_s32);
+        ExpectIntValue(s32[0], -2147483647 - 1);
+
+        S64 s64[] = { 1LL << 40, -(1LL << 40), 0, -1, 1, 9000000000LL, -9000000000LL };
+        RadixSort_S64(arena, s64, ArraySize(s64));
+
+        B32 radix_s64 = true;
+        for (U32 it = 1; it < ArraySize(s64); ++it) { radix_s64 = radix_s64 && (s64[it - 1] <= s64[it]); }
+
+        ExpectTrue(radix_s64);
+
+        U64 u64[] = { 0xFFFFFFFFFFFFFFFFULL, 1, 0x8000000000000000ULL, 0, 0x00000000FFFFFFFFULL, 0x0000000100000000ULL };
+        RadixSort_U64(arena, u64, ArraySize(u64));
+
+        B32 radix_u64 = true;
+        for (U32 it = 1; it < ArraySize(u64); ++it) { radix_u64 = radix_u64 && (u64[it - 1] <= u64[it]); }
+
+        ExpectTrue(radix_u64);
+
+        F32 f32[] = { 1.5f, -0.25f, 0.0f, -1000.0f, 3.0e38f, -3.0e38f, 0.125f, -0.0f, 7.0f };
+        U32 f32_indices[ArraySize(f32)];
+        for (U32 it = 0; it < ArraySize(f32); ++it) { f32_indices[it] = it; }
+
+        RadixSortPairs_F32(arena, f32, f32_indices, ArraySize(f32));
+
+        B32 radix_f32 = true;
+        for (U32 it = 1; it < ArraySize(f32); ++it) { radix_f32 = radix_f32 && (f32[it - 1] <= f32[it]); }
+
+        ExpectTrue(radix_f32);
+        ExpectTrue(f32[0] == -3.0e38f);
+        ExpectIntValue(f32_indices[0], 5);
+        ExpectIntValue(f32_indices[ArraySize(f32) - 1], 4);
+
+        // keys only version against a comparison sort, the signed zeroes compare equal so they
+        // are checked separately as the radix sort orders them by their sign bit
+        //
+        {
+            U32 inf_bits[] = { 0x7F800000, 0xFF800000 };
+
+            F32 infs[2];
+            M_CopySize(infs, inf_bits, sizeof(infs));
+
+            F32 keys[]   = { 2.5f, -0.0f, infs[0], -7.0f, 0.0f, infs[1], -0.5f, 1.0e-40f, -1.0e-40f, 100.0f, -0.0f, 0.0f, -3.0e38f };
+            F32 sorted[ArraySize(keys)];
+
+            M_CopySize(sorted, keys, sizeof(keys));
+
+            RadixSort_F32(arena, keys, ArraySize(keys));
+            QuickSort(sorted, ArraySize(sorted), CompareF32);
+
+            B32 matches = true;
+            for (U32 it = 0; it < ArraySize(keys); ++it) { matches = matches && (keys[it] == sorted[it]); }
+
+            ExpectTrue(matches);
+            ExpectTrue(keys[0] == infs[1]);
+            ExpectTrue(keys[ArraySize(keys) - 1] == infs[0]);
+
+            U32 zero_bits[4];
+            M_CopySize(zero_bits, keys + 5, sizeof(zero_bits));
+
+            ExpectIntValue(zero_bits[0], 0x80000000);
+            ExpectIntValue(zero_bits[1], 0x80000000);
+            ExpectIntValue(zero_bits[2], 0);
+            ExpectIntValue(zero_bits[3], 0);
+        }
+
+        // benchmarks
+        //
+        {
+            U32  count = 1000000;
+            U32 *bench = M_ArenaPush(arena, U32, count);
+
+            for (U32 p = 0; p < SORT_PATTERN_COUNT; ++p) {
+                for (U32 it = 0; it < count; ++it) { bench[it] = SortPatternValue(p, it, count); }
+
+                U64 start = OS_GetTicks();
+                QuickSort(bench, count, CompareU32);
+                F64 elapsed = OS_TicksToSeconds(OS_GetTicks() - start);
+
+                B32 sorted = SortedU32(bench, count, p);
+                ExpectTrue(sorted);
+
+                printf("    quick sort %u %s: %.3fms\n", count, sort_pattern_names[p], elapsed * 1000);
+
+                for (U32 it = 0; it < count; ++it) { bench[it] = SortPatternValue(p, it, count); }
+
+                start = OS_GetTicks();
+                MergeSort(bench, count, CompareU32);
+                elapsed = OS_TicksToSeconds(OS_GetTicks() - start);
+
+                sorted = SortedU32(bench, count, p);
+                ExpectTrue(sorted);
+
+                printf("    merge sort %u %s: %.3fms\n", count, sort_pattern_names[p], elapsed * 1000);
+
+                for (U32 it = 0; it < count; ++it) { bench[it] = SortPatternValue(p, it, count); }
+
+                start = OS_GetTicks();
+                RadixSort_U32(arena, bench, count);
+                elapsed = OS_TicksToSeconds(OS_GetTicks() - start);
+
+                sorted = SortedU32(bench, count, p);
+                ExpectTrue(sorted);
+
+                printf("    radix sort %u %s: %.3fms\n", count, sort_pattern_names[p], elapsed * 1000);
+            }
+
+            // parallel sorts, the worker count is given explicitly so the parallel path is taken
+            // regardless of how many cores the machine has
+            //
+            {
+                for (U32 it = 0; it < count; ++it) { bench[it] = SortPatternValue(SORT_PATTERN_RANDOM, it, count); }
+
+                U64 start = OS_GetTicks();
+                _ParallelSort(bench, count, CompareU32, sizeof(U32), 8, 0);
+                F64 parallel = OS_TicksToSeconds(OS_GetTicks() - start);
+
+                B32 sorted = SortedU32(bench, count, SORT_PATTERN_RANDOM);
+                ExpectTrue(sorted);
+
+                for (U32 it = 0; it < count; ++it) { bench[it] = SortPatternValue(SORT_PATTERN_RANDOM, it, count); }
+
+                start = OS_GetTicks();
+                ParallelSort(bench, count, CompareU32, 0);
+                F64 pooled = OS_TicksToSeconds(OS_GetTicks() - start);
+
+                sorted = SortedU32(bench, count, SORT_PATTERN_RANDOM);
+                ExpectTrue(sorted);
+
+                printf("    parallel sort %u random: 8 workers %.3fms, %u job workers %.3fms\n",
+                        count, parallel * 1000, J_GetWorkerCount(), pooled * 1000);
+
+                // stable with lots of duplicate keys and an uneven split across the workers
+                //
+                U32         stable_count = 300007;
+                SortRecord *rows         = M_ArenaPush(arena, SortRecord, stable_count);
+
+                for (U32 p = 0; p < SORT_PATTERN_COUNT; ++p) {
+                    for (U32 it = 0; it < stable_count; ++it) {
+                        rows[it].key   = SortPatternValue(p, it, stable_count) & 0xFFF;
+                        rows[it].index = it;
+                    }
+
+                    _ParallelSort(rows, stable_count, CompareSortRecord, sizeof(SortRecord), 4, PARALLEL_SORT_STABLE);
+
+                    B32 stable = true;
+                    for (U32 it = 1; it < stable_count; ++it) {
+                        if (rows[it - 1].key == rows[it].key) {
+                            stable = stable && (rows[it - 1].index < rows[it].index);
+                        }
+                        else {
+                            stable = stable && (rows[it - 1].key < rows[it].key);
+                        }
+                    }
+
+                    ExpectTrue(stable);
+                }
+
+                // the merge passes compare elements in the scratch buffer, which must stay aligned
+                // after an odd sized push in the caller's temp scope
+                //
+                {
+                    M_Temp temp = M_AcquireTemp(0, 0);
+                    Str8_Copy(temp.arena, S("abc"));
+
+                    for (U32 it = 0; it < stable_count; ++it) {
+                        rows[it].key   = SortPatternValue(SORT_PATTERN_RANDOM, it, stable_count);
+                        rows[it].index = it;
+                    }
+
+                    sort_misaligned = 0;
+                    _ParallelSort(rows, stable_count, CompareSortRecordAligned, sizeof(SortRecord), 4, PARALLEL_SORT_STABLE);
+
+                    ExpectIntValue(sort_misaligned, 0);
+
+                    M_ReleaseTemp(temp);
+                }
+            }
+
+            // inlined comparison against the callback
+            //
+            {
+                int *ints = M_ArenaPush(arena, int, count);
+
+                for (U32 it = 0; it < count; ++it) { ints[it] = cast(int) (Hash_U64(it) & 0x3FFFFFFF); }
+
+                U64 start = OS_GetTicks();
+                QuickSort(ints, count, CompareInt);
+                F64 callback = OS_TicksToSeconds(OS_GetTicks() - start);
+
+                for (U32 it = 0; it < count; ++it) { ints[it] = cast(int) (Hash_U64(it) & 0x3FFFFFFF); }
+
+                start = OS_GetTicks();
+                SortIntTyped(ints, count);
+                F64 inlined = OS_TicksToSeconds(OS_GetTicks() - start);
+
+                B32 ordered = true;
+                for (U32 it = 1; it < count; ++it) { ordered = ordered && (ints[it - 1] <= ints[it]); }
+
+                ExpectTrue(ordered);
+
+                printf("    %u ints: CompareInt callback %.3fms, SORT_DEFINE %.3fms", count, callback * 1000, inlined * 1000);
+
+#if LANG_CPP
+                for (U32 it = 0; it < count; ++it) { ints[it] = cast(int) (Hash_U64(it) & 0x3FFFFFFF); }
+
+                start = OS_GetTicks();
+                Sort(ints, count, [](int a, int b) { return a < b; });
+                F64 templated = OS_TicksToSeconds(OS_GetTicks() - start);
+
+                printf(", Sort template %.3fms", templated * 1000);
+#endif
+                printf("\n");
+            }
+
+            // 64-bit keys with an index payload against sorting records with quick sort
+            //
+            U64        *keys    = M_ArenaPush(arena, U64,        count);
+            U64        *payload = M_ArenaPush(arena, U64,        count);
+            SortRecord *rows    = M_ArenaPush(arena, SortRecord, count);
+
+            for (U32 it = 0; it < count; ++it) {
+                keys[it]    = Hash_U64(it);
+                payload[it] = it;
+
+                rows[it].key   = keys[it];
+                rows[it].index = it;
+            }
+
+            U64 start = OS_GetTicks();
+            RadixSortPairs_U64(arena, keys, payload, count);
+            F64 radix = OS_TicksToSeconds(OS_GetTicks() - start);
+
+            start = OS_GetTicks();
+            QuickSort(rows, count, CompareSortRecord);
+            F64 quick = OS_TicksToSeconds(OS_GetTicks() - start);
+
+            B32 matched = true;
+            for (U32 it = 0; it < count; ++it) {
+                matched = matched && (keys[it] == rows[it].key) && (payload[it] == rows[it].index);
+            }
+
+            ExpectTrue(matched);
+
+            printf("    %u u64 pairs: radix sort %.3fms, quick sort %.3fms\n", count, radix * 1000, quick * 1000);
+        }
+
+        M_ReleaseArena(arena);
     }
     printf("\n");
 
-    printf("-- Arena\n");
+    printf("-- Hash\n");
     {
-        M_Arena *arena = M_AllocArena(GB(8));
+        M_Arena *arena = M_AllocArena(GB(1));
 
-        ExpectIntValue(arena->committed, M_ARENA_COMMIT_SIZE);
+        U8 *data = M_ArenaPush(arena, U8, 512);
+        for (U32 it = 0; it < 512; ++it) { data[it] = cast(U8) ((it * 131) ^ (it >> 3)); }
 
-        U32 *single = M_ArenaPush(arena, U32);
-        ExpectIntValue(arena->offset, 68);
+        ExpectTrue(Hash_Str8(S("core")) == Hash_Memory((void *) "core", 4));
+        ExpectTrue(Hash_Str8(S("core")) != Hash_Str8(S("Core")));
+        ExpectTrue(Hash_Str8Seed(S("core"), 1) != Hash_Str8Seed(S("core"), 2));
 
-        single[0] = 22;
+        // every length hashes differently, even when the content is all zero
+        //
+        U8 zeros[64] = { 0 };
 
-        U32 *array = M_ArenaPush(arena, U32, 32);
-        ExpectIntValue(arena->offset, 196);
+        B32 distinct = true;
+        for (U32 it = 1; it < 64; ++it) {
+            distinct = distinct && (Hash_Memory(zeros, it) != Hash_Memory(zeros, it - 1));
+        }
 
-        for (U32 it = 0; it < 32; ++it) {
-            array[it] = it;
+        ExpectTrue(distinct);
+
+        // streaming must match the single call version for every length and chunk size, this
+        // covers the boundaries at 16 and 48 bytes and tails which read back into the previous block
+        //
+        U32 chunks[] = { 1, 3, 16, 47, 48, 49, 100 };
+
+        B32 streamed = true;
+        for (U32 size = 0; size <= 300; ++size) {
+            U64 expected = Hash_MemorySeed(data, size, 1234);
+
+            for (U32 c = 0; c < ArraySize(chunks); ++c) {
+                Hash_State state;
+                Hash_Begin(&state, 1234);
+
+                for (U32 offset = 0; offset < size; offset += chunks[c]) {
+                    Hash_Update(&state, data + offset, Min(chunks[c], size - offset));
+                }
+
+                streamed = streamed && (Hash_Finish(&state) == expected);
+            }
         }
 
-        M_ArenaPop(arena, U32, 32);
-        ExpectIntValue(arena->offset, 68);
+        ExpectTrue(streamed);
 
-        U32 *arrayflag = M_ArenaPush(arena, U32, 32, M_ARENA_NO_ZERO);
+        // streaming a string in pieces matches hashing the whole string
+        //
+        {
+            Str8 str = Str8_Wrap(300, data);
 
-        for (U32 it = 0; it < 32; ++it) {
-            ExpectIntValue(arrayflag[it], it);
+            B32 matched = true;
+            for (S64 split = 0; split <= str.count; split += 7) {
+                Hash_State state;
+                Hash_Begin(&state, HASH_DEFAULT_SEED);
+
+                Hash_UpdateStr8(&state, Str8_Prefix(str, split));
+                Hash_UpdateStr8(&state, Str8_Advance(str, split));
+
+                matched = matched && (Hash_Finish(&state) == Hash_Str8(str));
+            }
+
+            ExpectTrue(matched);
         }
 
-        M_ArenaPop(arena, U32, 32);
+        // unaligned inputs hash the same as aligned ones
+        //
+        {
+            U8 *copy = M_ArenaPush(arena, U8, 256 + 8);
 
-        U32 *arrayalign = M_ArenaPush(arena, U32, 32, 0, 8);
+            B32 aligned = true;
+            for (U32 offset = 1; offset < 8; ++offset) {
+                M_CopySize(copy + offset, data, 256);
+                aligned = aligned && (Hash_Memory(copy + offset, 256) == Hash_Memory(data, 256));
+            }
 
-        ExpectIntValue((U64) arrayalign & 7, 0);
-        ExpectIntValue(arena->offset, 200);
+            ExpectTrue(aligned);
+        }
 
-        M_ArenaPopLast(arena);
-        ExpectIntValue(arena->offset, 68);
+        // flipping a single input bit should flip about half of the output bits
+        //
+        U64 flipped = 0;
+        U64 base    = Hash_Memory(data, 32);
 
-        M_ArenaPop(arena, U32);
+        for (U32 bit = 0; bit < 256; ++bit) {
+            data[bit >> 3] ^= (1 << (bit & 7));
+            flipped += PopCount_U64(base ^ Hash_Memory(data, 32));
+            data[bit >> 3] ^= (1 << (bit & 7));
+        }
+
+        ExpectTrue(flipped > (256 * 28) && flipped < (256 * 36));
+
+        // case folding matches STR8_EQUAL_FLAG_IGNORE_CASE, only ascii letters are folded so the
+        // characters either side of each letter range and bytes with the high bit set are not
+        //
+        ExpectTrue(Hash_Str8IgnoreCase(S("Hello, World!")) == Hash_Str8IgnoreCase(S("hELLO, wORLD!")));
+        ExpectTrue(Hash_Str8IgnoreCase(S("Hello, World!")) == Hash_Str8(S("HELLO, WORLD!")));
+        ExpectTrue(Hash_Str8IgnoreCase(S("@[`{@[`{")) == Hash_Str8(S("@[`{@[`{")));
+        ExpectTrue(Hash_Str8IgnoreCase(S("\xE1\xFA\xC1\xDA\xE1\xFA\xC1\xDA")) == Hash_Str8(S("\xE1\xFA\xC1\xDA\xE1\xFA\xC1\xDA")));
+
+        Str8 lower = Str8_Wrap(600, M_ArenaPush(arena, U8, 600));
+        Str8 upper = Str8_Wrap(600, M_ArenaPush(arena, U8, 600));
+
+        for (S64 it = 0; it < lower.count; ++it) {
+            lower.data[it] = cast(U8) ('a' + (it % 26));
+            upper.data[it] = cast(U8) ((it & 1) ? ('A' + (it % 26)) : ('a' + (it % 26)));
+        }
+
+        ExpectTrue(Str8_Equal(lower, upper, STR8_EQUAL_FLAG_IGNORE_CASE));
+        ExpectTrue(Hash_Str8IgnoreCase(lower) == Hash_Str8IgnoreCase(upper));
+        ExpectTrue(Hash_Str8(lower) != Hash_Str8(upper));
+
+        // throughput
+        //
+        {
+            U64 size   = MB(64);
+            U8 *buffer = M_ArenaPush(arena, U8, size);
 
-        ExpectIntValue(arena->offset, 64);
+            for (U64 it = 0; it < size; it += 8) { *cast(U64 *) (buffer + it) = Hash_U64(it); }
 
-        U32 *a = M_ArenaPush(arena, U32, 10);
+            U64 check = 0;
+            U32 runs  = 4;
 
-        for (U32 it = 0; it < 10; ++it) { a[it] = it; }
+            U64 start = OS_GetTicks();
+            for (U32 r = 0; r < runs; ++r) { check ^= Hash_MemorySeed(buffer, size, r); }
 
-        U32 *b = M_ArenaPushCopy(arena, a, U32, 10);
+            F64 bulk = OS_TicksToSeconds(OS_GetTicks() - start);
 
-        ExpectTrue(M_CompareSize(a, b, 10 * sizeof(U32)));
+            U32 keys = 1000000;
 
-        M_Temp tempa = M_AcquireTemp(0, 0);
-        M_Temp tempb = M_AcquireTemp(1, &tempa.arena);
+            start = OS_GetTicks();
+            for (U32 k = 0; k < keys; ++k) { check ^= Hash_Memory(buffer + (k & 4095), 24); }
 
-        ExpectTrue(tempa.arena != tempb.arena);
+            F64 small = OS_TicksToSeconds(OS_GetTicks() - start);
 
-        M_ArenaPush(tempa.arena, U32, 256);
-        M_ReleaseTemp(tempa);
+            ExpectTrue(check != 0);
 
-        // don't do this in production code, just testing to make sure the
-        // arena was reset correctly
-        //
-        ExpectIntValue(tempa.arena->offset, 64);
+            printf("    bulk %.2f GB/s, %u 24-byte keys %.2f GB/s (%.2fns per key)\n",
+                    (runs * size) / (bulk * 1e9), keys, (keys * 24) / (small * 1e9), (small * 1e9) / keys);
+        }
 
-        M_ResetArena(arena);
         M_ReleaseArena(arena);
-
-        // should cause an access violation
-        //
-        // printf("current offset = %llu\n", arena->offset);
     }
     printf("\n");
 
-    printf("-- Strings\n");
+    printf("-- Hash Map\n");
     {
-        Str8 test = S("Some/path/with/file.txt");
-
-        Str8 before_first = Str8_RemoveBeforeFirst(test, '/');
-        Str8 before_last  = Str8_RemoveBeforeLast(test, '/');
-
-        Str8 after_first = Str8_RemoveAfterFirst(test, '/');
-        Str8 after_last  = Str8_RemoveAfterLast(test, '/');
+        M_Arena *arena = M_AllocArena(GB(1));
 
-        ExpectStrValue(before_first, "path/with/file.txt");
-        ExpectStrValue(before_last,  "file.txt");
-        ExpectStrValue(after_first,  "Some");
-        ExpectStrValue(after_last,   "Some/path/with");
+        // integer keys
+        //
+        HM_Map *map = HM_AllocMap(arena, HM_KEY_U64, sizeof(U64), 0);
+        ExpectTrue(HM_FindU64(map, 1) == 0);
 
-        Str8 dirname  = Str8_GetDirname(test);
-        Str8 basename = Str8_GetBasename(test);
-        Str8 ext      = Str8_GetExtension(test);
+        for (U64 it = 0; it < 10000; ++it) {
+            U64 *value = cast(U64 *) HM_InsertU64(map, it * 7919);
+            *value = it;
+        }
 
-        Str8 noext = Str8_StripExtension(basename);
+        ExpectIntValue(map->count, 10000);
 
-        ExpectStrValue(dirname,  "Some/path/with");
-        ExpectStrValue(basename, "file.txt");
-        ExpectStrValue(ext,      "txt");
-        ExpectStrValue(noext,    "file");
+        B32 found = true;
+        for (U64 it = 0; it < 10000; ++it) {
+            U64 *value = cast(U64 *) HM_FindU64(map, it * 7919);
+            found = found && value && (*value == it);
+        }
 
-        Str8 hira_a = Sl("\xE3\x81\x82");
+        ExpectTrue(found);
+        ExpectTrue(HM_FindU64(map, 7918) == 0);
 
-        Codepoint c = UTF8_Decode(hira_a);
+        // inserting an existing key returns the existing value
+        //
+        ExpectIntValue(*cast(U64 *) HM_InsertU64(map, 7919 * 5), 5);
+        ExpectIntValue(map->count, 10000);
 
-        ExpectIntValue(c.count, 3);
-        ExpectIntValue(c.value, 0x3042);
+        for (U64 it = 0; it < 10000; it += 2) { HM_RemoveU64(map, it * 7919); }
 
-        U8 value[4];
-        U32 count = UTF8_Encode(value, c.value);
+        ExpectIntValue(map->count, 5000);
+        ExpectFalse(HM_RemoveU64(map, 0));
 
-        ExpectIntValue(count, 3);
-        ExpectIntValue(*(U32 *) value, 0x8281e3);
+        B32 removed = true;
+        for (U64 it = 0; it < 10000; ++it) {
+            B32 present = HM_FindU64(map, it * 7919) != 0;
+            removed = removed && (present == ((it & 1) != 0));
+        }
 
-        M_Temp temp = M_AcquireTemp(0, 0);
-        Str8 cpy = Str8_Copy(temp.arena, test);
-        ExpectStrValue(cpy, "Some/path/with/file.txt");
+        ExpectTrue(removed);
 
-        Str8 con = Str8_Concat(temp.arena, noext, ext);
-        ExpectStrValue(con, "filetxt");
+        // tombstones are reclaimed by re-inserting and rebuilding
+        //
+        U64 capacity = map->capacity;
+        for (U32 round = 0; round < 8; ++round) {
+            for (U64 it = 0; it < 10000; it += 2) { HM_InsertU64(map, (round * 100000) + (it * 7919) + 1); }
+            for (U64 it = 0; it < 10000; it += 2) { HM_RemoveU64(map, (round * 100000) + (it * 7919) + 1); }
+        }
 
-        Str8 range = Str8_WrapRange(dirname.data, dirname.data + 4);
-        ExpectStrValue(range, "Some");
+        ExpectIntValue(map->count, 5000);
+        ExpectIntValue(map->capacity, capacity);
 
-        Str8 formatted = Sf(temp.arena, "Hello, %s! %d With a REALLY LONG ENDING", "Sailor", 69105);
-        ExpectStrValue(formatted, "Hello, Sailor! 69105 With a REALLY LONG ENDING");
+        U64 sum = 0;
+        U32 iterated = 0;
 
-        Str8 advanced = Str8_Advance(test, 5);
-        Str8 removed  = Str8_Remove(test,  9);
-        Str8 sliced   = Str8_Slice(test, 5, 9);
+        HM_Iter it = { 0 };
+        while (HM_Next(map, &it)) {
+            sum      += *cast(U64 *) it.value;
+            iterated += 1;
+        }
 
-        ExpectStrValue(advanced, "path/with/file.txt");
-        ExpectStrValue(removed,  "Some/path/with");
-        ExpectStrValue(sliced,   "path");
+        ExpectIntValue(iterated, 5000);
+        ExpectIntValue(sum, 25000000); // sum of odd numbers below 10000
 
-        M_ReleaseTemp(temp);
-    }
-    printf("\n");
+        HM_Clear(map);
+        ExpectIntValue(map->count, 0);
+        ExpectTrue(HM_FindU64(map, 7919) == 0);
 
-    printf("-- Characters\n");
-    {
-        ExpectTrue(Chr_IsWhitespace(' '));
-        ExpectTrue(Chr_IsWhitespace('\n'));
-        ExpectFalse(Chr_IsWhitespace('d'));
+        HM_Map *reserved = HM_AllocMap(arena, HM_KEY_U64, 0, 0);
+        HM_Reserve(reserved, 1000);
 
-        ExpectTrue(Chr_IsAlpha('a'));
-        ExpectTrue(Chr_IsAlpha('p'));
-        ExpectTrue(Chr_IsAlpha('I'));
+        capacity = reserved->capacity;
+        for (U64 k = 0; k < 1000; ++k) { HM_InsertU64(reserved, k); }
 
-        ExpectFalse(Chr_IsAlpha(';'));
-        ExpectFalse(Chr_IsAlpha(','));
+        ExpectIntValue(reserved->capacity, capacity);
 
-        ExpectTrue(Chr_IsHex('0'));
-        ExpectTrue(Chr_IsHex('7'));
-        ExpectTrue(Chr_IsHex('a'));
-        ExpectTrue(Chr_IsHex('F'));
+        // string keys
+        //
+        HM_Map *strings = HM_AllocMap(arena, HM_KEY_STR8, sizeof(U32), HM_MAP_COPY_KEYS);
 
-        ExpectFalse(Chr_IsHex('i'));
-        ExpectFalse(Chr_IsHex('p'));
+        M_Temp temp = M_AcquireTemp(1, &arena);
 
-        ExpectTrue(Chr_IsSlash('/'));
-        ExpectTrue(Chr_IsSlash('\\'));
+        for (U32 k = 0; k < 1000; ++k) {
+            U32 *value = cast(U32 *) HM_InsertStr8(strings, Sf(temp.arena, "key_%u", k));
+            *value = k;
+        }
 
-        ExpectTrue(Chr_IsPathSeparator('/'));
-#if OS_WINDOWS
-        ExpectTrue(Chr_IsPathSeparator('\\'));
-#endif
+        M_ReleaseTemp(temp);
 
-        ExpectIntValue(Chr_ToUppercase('a'), 'A');
-        ExpectIntValue(Chr_ToLowercase('A'), 'a');
-    }
-    printf("\n");
+        ExpectIntValue(strings->count, 1000);
+        ExpectIntValue(*cast(U32 *) HM_FindStr8(strings, S("key_0")), 0);
+        ExpectIntValue(*cast(U32 *) HM_FindStr8(strings, S("key_999")), 999);
+        ExpectTrue(HM_FindStr8(strings, S("key_1000")) == 0);
+        ExpectTrue(HM_FindStr8(strings, S("")) == 0);
 
-    printf("-- Logging\n");
-    {
-        Log_PushScope();
+        ExpectTrue(HM_RemoveStr8(strings, S("key_500")));
+        ExpectTrue(HM_FindStr8(strings, S("key_500")) == 0);
 
-        Log_Debug("Hello, %d", 69105);
-        Log_Info("Other INFO");
+        // lookup benchmark against a linear scan and std::unordered_map
+        //
+        {
+            U32 count   = 2000;
+            U32 lookups = 200000;
 
-        Log_Warn("WARNING SOMETHING ISN'T RIGHT!");
+            Str8 *keys = M_ArenaPush(arena, Str8, count);
+            for (U32 k = 0; k < count; ++k) { keys[k] = Sf(arena, "benchmark/path/to/asset_%u.png", k); }
 
-        Log_Error("Error failed");
+            HM_Map *bench = HM_AllocMap(arena, HM_KEY_STR8, sizeof(U32), 0);
+            HM_Reserve(bench, count);
 
-        const char *expected_messages[] = {
-            ("Hello, 69105"),
-            ("Other INFO"),
-            ("WARNING SOMETHING ISN'T RIGHT!"),
-            ("Error failed")
-        };
+            for (U32 k = 0; k < count; ++k) { *cast(U32 *) HM_InsertStr8(bench, keys[k]) = k; }
 
-        M_Temp temp = M_AcquireTemp(0, 0);
-        Log_MessageArray messages = Log_PopScope(temp.arena);
+            U64 check_linear = 0;
+            U64 check_map    = 0;
 
-        ExpectTrue(messages.count == ArraySize(expected_messages));
+            U64 start = OS_GetTicks();
+            for (U32 l = 0; l < lookups / 100; ++l) {
+                Str8 key = keys[(l * 7919) % count];
 
-        for (U32 it = 0; it < messages.count; ++it) {
-            Log_Message *n = &messages.items[it];
-            ExpectStrValue(n->message, expected_messages[it]);
-            ExpectIntValue(n->code, cast(S32) it - 4); // LOG_* codes are negative
-        }
+                for (U32 k = 0; k < count; ++k) {
+                    if (Str8_Equal(keys[k], key, 0)) {
+                        check_linear += k;
+                        break;
+                    }
+                }
+            }
 
-        ExpectStrValue(Log_StrFromLevel(LOG_ERROR), "Error");
+            F64 linear = OS_TicksToSeconds(OS_GetTicks() - start) * 100;
 
-        M_ReleaseTemp(temp);
-    }
-    printf("\n");
+            start = OS_GetTicks();
+            for (U32 l = 0; l < lookups; ++l) {
+                check_map += *cast(U32 *) HM_FindStr8(bench, keys[(l * 7919) % count]);
+            }
 
-    printf("-- Stream\n");
-    {
-        U8 values[] = { 0, 1, 2, 3, 4 };
+            F64 hashed = OS_TicksToSeconds(OS_GetTicks() - start);
 
-        Stream_Context zstream;
-        Stream_Zero(&zstream);
+            ExpectIntValue(check_linear * 100, check_map);
 
-        U32 *zero = Stream_Read(&zstream, U32);
-        ExpectIntValue(zero[0], 0);
+            printf("    %u lookups over %u keys: linear scan %.3fms (extrapolated), hash map %.3fms\n",
+                    lookups, count, linear * 1000, hashed * 1000);
 
-        Stream_Context mstream;
+#if LANG_CPP
+            std::unordered_map<std::string, U32> unordered;
+            unordered.reserve(count);
 
-        Str8 data;
-        data.count = ArraySize(values);
-        data.data  = values;
+            for (U32 k = 0; k < count; ++k) { unordered[std::string((char *) keys[k].data, keys[k].count)] = k; }
 
-        Stream_FromMemory(&mstream, data);
+            std::string *std_keys = new std::string[count];
+            for (U32 k = 0; k < count; ++k) { std_keys[k] = std::string((char *) keys[k].data, keys[k].count); }
 
-        U32 x = 0;
-        while (mstream.pos != mstream.end) {
-            ExpectIntValue(mstream.pos[0], values[x]);
-            mstream.pos += 1;
-            x += 1;
-        }
+            U64 check_unordered = 0;
 
-        U32 bit_pattern = 0xCACACACA;
+            start = OS_GetTicks();
+            for (U32 l = 0; l < lookups; ++l) {
+                check_unordered += unordered.find(std_keys[(l * 7919) % count])->second;
+            }
 
-        data.count = sizeof(bit_pattern);
-        data.data  = cast(U8 *) &bit_pattern;
+            F64 standard = OS_TicksToSeconds(OS_GetTicks() - start);
 
-        Stream_FromMemory(&mstream, data);
+            ExpectIntValue(check_unordered, check_map);
 
-        for (U32 it = 0; it < 32; it += 4) {
-            U64 bits = Stream_ReadBits(&mstream, 4);
+            printf("    %u lookups over %u keys: std::unordered_map %.3fms\n", lookups, count, standard * 1000);
 
-            ExpectIntValue(bits, (U32) (((it >> 2) & 1) ? 0xC : 0xA));
+            delete[] std_keys;
+#endif
         }
 
-        ExpectIntValue(mstream.bit_buffer, 0);
-        ExpectIntValue(mstream.bit_count,  0);
+        M_ReleaseArena(arena);
     }
     printf("\n");
 
-    printf("-- File System\n");
+    printf("-- String Interning\n");
     {
-        M_Temp temp = M_AcquireTemp(0, 0);
+        Str8_Interner *interner = Str8_AllocInterner(MB(64));
 
-        // system paths
-        //
-        Str8 exe_path     = FS_GetPath(temp.arena, FS_PATH_EXE);
-        Str8 user_path    = FS_GetPath(temp.arena, FS_PATH_USER);
-        Str8 temp_path    = FS_GetPath(temp.arena, FS_PATH_TEMP);
-        Str8 working_path = FS_GetPath(temp.arena, FS_PATH_WORKING);
+        M_Temp temp = M_AcquireTemp(0, 0);
 
-        printf("    exe     path = %.*s\n", Sv(exe_path));
-        printf("    user    path = %.*s\n", Sv(user_path));
-        printf("    temp    path = %.*s\n", Sv(temp_path));
-        printf("    working path = %.*s\n", Sv(working_path));
+        Str8 a0 = Str8_Intern(interner, Str8_Copy(temp.arena, S("src/core")));
+        Str8 a1 = Str8_Intern(interner, S("src/core"));
+        Str8 b0 = Str8_Intern(interner, S("src/png"));
 
-        // directory listing
-        //
-        FS_List list = FS_ListPath(temp.arena, exe_path, FS_LIST_RECURSIVE);
+        ExpectTrue(a0.data == a1.data);
+        ExpectTrue(a0.data != b0.data);
+        ExpectStrValue(a0, "src/core");
+        ExpectIntValue(interner->count, 2);
 
-        printf("    list of %.*s:\n", Sv(exe_path));
+        U32 id = Str8_FindInternId(interner, S("src/png"));
 
-        U32 it = 0;
-        for (FS_Entry *e = list.first; e != 0; e = e->next) {
-            printf("      [%2d] = %.*s%c\n", it, Sv(e->path), (e->props & FS_PROPERTY_IS_DIRECTORY) ? '*' : ' ');
-            it += 1;
-        }
+        ExpectIntValue(id, 2);
+        ExpectTrue(Str8_FromInternId(interner, id).data == b0.data);
+        ExpectIntValue(Str8_FindInternId(interner, S("src/tests")), 0);
+        ExpectIntValue(Str8_FromInternId(interner, 0).count, 0);
+        ExpectIntValue(Str8_FromInternId(interner, 3).count, 0);
 
-        // writing a file
+        // the empty string is a valid string to intern
         //
-        OS_Handle file = FS_OpenFile(S("test.txt"), FS_ACCESS_WRITE);
-
-        U64 offset = 0;
-
-        offset += FS_WriteFile(file, S("Hello, World! | "), offset);
-        offset += FS_WriteFile(file, S("Hello, World! | "), offset);
-        offset += FS_WriteFile(file, S("Hello, World! | "), offset);
-
-        FS_AppendFile(file, S("End of file"));
-
-        ExpectIntValue(FS_PropertiesFromHandle(file), 0);
-        ExpectIntValue(FS_SizeFromHandle(file), 59); // should be 59 bytes long after writing
+        ExpectIntValue(Str8_InternId(interner, S("")), 3);
 
-        Str8 path = FS_PathFromHandle(temp.arena, file);
-        Str8 basename = Str8_GetBasename(path);
-        printf("    full path from handle is %.*s\n", Sv(path));
-        ExpectStrValue(basename, "test.txt");
+        // grows the table several times, every earlier id must survive the rebuilds
+        //
+        B32 stable = true;
+        for (U32 it = 0; it < 5000; ++it) {
+            Str8 key = Sf(temp.arena, "dir_%u", it);
+            stable = stable && (Str8_InternId(interner, key) == (it + 4));
+        }
 
-        FS_Time times = FS_TimeFromHandle(file);
+        for (U32 it = 0; it < 5000; it += 7) {
+            Str8 key = Sf(temp.arena, "dir_%u", it);
+            stable = stable && (Str8_FindInternId(interner, key) == (it + 4));
+        }
 
-        printf("    times from handle:\n");
-        printf("      written:  %llu\n", times.written);
-        printf("      accessed: %llu\n", times.accessed);
-        printf("      created:  %llu\n", times.created);
+        ExpectTrue(stable);
+        ExpectIntValue(Str8_FindInternId(interner, S("src/core")), 1);
 
-        FS_CloseFile(file);
+        Str8_ReleaseInterner(interner);
 
-        // reading a file
+        // threads racing to intern an overlapping set of strings must all agree on a single id
+        // for each string
         //
-        Str8 contents = FS_ReadEntireFile(temp.arena, S("test.txt"));
-        ExpectStrValue(contents, "Hello, World! | Hello, World! | Hello, World! | End of file");
-
-        ExpectTrue(FS_CreateDirectory(S("test_dir")));
+        InternShared *shared = M_ArenaPush(temp.arena, InternShared);
 
-        // from path
-        //
-        ExpectIntValue(FS_PropertiesFromPath(S("test_dir")), FS_PROPERTY_IS_DIRECTORY);
-        ExpectIntValue(FS_SizeFromPath(S("test.txt")), 59); // still 59 bytes after reading
+        shared->interner = Str8_AllocInterner(MB(64));
+        shared->count    = ArraySize(shared->ids[0]);
+        shared->keys     = M_ArenaPush(temp.arena, Str8, shared->count);
 
-        times = FS_TimeFromPath(S("test_dir"));
+        for (U32 k = 0; k < shared->count; ++k) { shared->keys[k] = Sf(temp.arena, "shared/key/%u", k); }
 
-        printf("    times from path:\n");
-        printf("      written:  %llu\n", times.written);
-        printf("      accessed: %llu\n", times.accessed);
-        printf("      created:  %llu\n", times.created);
+        T_Thread blank = ZERO(T_Thread);
 
-        // cleanup
-        //
-        ExpectTrue(FS_RemoveFile(S("test.txt")));
-        ExpectTrue(FS_RemoveDirectory(S("test_dir")));
+        T_Thread workers[ArraySize(shared->ids)];
+        for (U32 it = 0; it < ArraySize(workers); ++it) {
+            workers[it]       = blank;
+            workers[it].Proc  = TestInternProc;
+            workers[it].param = shared;
 
-        M_ReleaseTemp(temp);
-    }
-    printf("\n");
+            T_CreateThread(&workers[it]);
+        }
 
-    printf("-- Threading\n");
-    {
-        // This is not robust, just making sure basic stuff works. We can implement
-        // something more substantial later
-        //
+        AtomicExchange_U32(&shared->go, 1);
+        T_BroadcastFutex(&shared->go);
 
-        T_Thread thread = ZERO(T_Thread);
-        thread.Proc  = TestThreadProc;
-        thread.param = 0;
-        thread.flags = 0;
+        for (U32 it = 0; it < ArraySize(workers); ++it) {
+            T_JoinThread(workers[it].handle);
+            T_DetachThread(workers[it].handle);
+        }
 
-        OS_Handle mutex   = T_CreateMutex();
-        OS_Handle sem     = T_CreateSemaphore(10);
-        OS_Handle rwlock  = T_CreateRWLock();
-        OS_Handle condvar = T_CreateConditionVar();
+        B32 agreed = true;
+        for (U32 k = 0; k < shared->count; ++k) {
+            U32 expected = shared->ids[0][k];
+            agreed = agreed && (expected != 0) && Str8_Equal(Str8_FromInternId(shared->interner, expected), shared->keys[k], 0);
 
-        T_CreateThread(&thread);
-        ExpectTrue(OS_HandleValid(thread.handle));
+            for (U32 it = 1; it < ArraySize(workers); ++it) {
+                agreed = agreed && (shared->ids[it][k] == expected);
+            }
+        }
 
-        T_JoinThread(thread.handle);
-        T_DetachThread(thread.handle);
+        ExpectTrue(agreed);
+        ExpectIntValue(shared->interner->count, shared->count);
 
-        ExpectIntValue(thread_sum, 45);
+        Str8_ReleaseInterner(shared->interner);
 
-        T_DeleteMutex(mutex);
-        T_DeleteSemaphore(sem);
-        T_DeleteRWLock(rwlock);
-        T_DeleteConditionVar(condvar);
+        M_ReleaseTemp(temp);
     }
+    printf("\n");
 
     printf("-- Leak\n");
     {
@@ -20,15 +20,16 @@ mkdir -p "c/linux"   > /dev/null 2> /dev/null
 mkdir -p "cpp/linux" > /dev/null 2> /dev/null
 
 COMPILER_OPTS="-O0 -g -ggdb -Wall -I.. -Wno-format -Wno-unused-function -Wno-missing-braces"
-LINKER_OPTS=""
+LINKER_OPTS="-lpthread"
+CPP_LINKER_OPTS="$LINKER_OPTS -lstdc++" # c++ benchmarks compare against the standard library
 
 echo "[building core.h tests]"
 
 gcc   $COMPILER_OPTS -Wunused-function "../tests/core.c" -o "c/linux/core_gcc"   $LINKER_OPTS
 clang $COMPILER_OPTS -Wunused-function "../tests/core.c" -o "c/linux/core_clang" $LINKER_OPTS
 
-gcc   $COMPILER_OPTS -x c++ -Wunused-function "../tests/core.c" -o "cpp/linux/core_gcc"   $LINKER_OPTS
-clang $COMPILER_OPTS -x c++ -Wunused-function "../tests/core.c" -o "cpp/linux/core_clang" $LINKER_OPTS
+gcc   $COMPILER_OPTS -x c++ -Wunused-function "../tests/core.c" -o "cpp/linux/core_gcc"   $CPP_LINKER_OPTS
+clang $COMPILER_OPTS -x c++ -Wunused-function "../tests/core.c" -o "cpp/linux/core_clang" $CPP_LINKER_OPTS
 
 echo "[building png.h tests]"
 
@@ -19,7 +19,7 @@ echo [msvc]
 
 echo [building core]
 cl %cl_options% -TC "..\tests\core.c" -Fe"c/windows/core_msvc.exe"   -link %link_options%
-cl %cl_options% -TP "..\tests\core.c" -Fe"cpp/windows/core_msvc.exe" -link %link_options%
+cl %cl_options% -EHsc -TP "..\tests\core.c" -Fe"cpp/windows/core_msvc.exe" -link %link_options%
 
 echo [building png]
 cl %cl_options% -TC "..\tests\png.c" -Fe"c/windows/png_msvc.exe"   -link %link_options%